@@ -0,0 +1,400 @@
+#ifndef UTILITRON_JOBUTIL_H_
+#   define UTILITRON_JOBUTIL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ThreadUtil.hpp"
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#   include <coroutine>
+#   define UTIL_JOB_COROUTINES
+#endif
+
+namespace util {
+
+/**************************************************************************\
+| Asynchronous jobs on the process wide thread pool. A job is a task that  |
+| runs once the jobs it depends on have finished, so work over the same    |
+| buffers can be chained without the submitting thread waiting in between. |
+| Completion can be waited for, turned into a std::shared_future, observed |
+| with a callback, or awaited from a C++20 coroutine. Jobs always run on a |
+| worker thread, never inside submit(), even where the process wide pool   |
+| has no workers. A job whose dependency threw does not run and finishes   |
+| with the same exception.                                                 |
+\**************************************************************************/
+namespace job {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/**The state of a job shared by every handle to it*/
+struct JobState {
+
+    //the task to run, empty for jobs that only join others
+    std::function<void()> task;
+    //the dependencies that have not finished, plus one until the job has
+    //been set up
+    std::size_t pending;
+    //whether the job has finished
+    bool done;
+    //the exception the job or one of its dependencies threw
+    std::exception_ptr error;
+    //the callbacks to run when the job finishes
+    std::vector<std::function<void()> > continuations;
+    //guards the state
+    std::mutex mutex;
+    //signalled when the job finishes
+    std::condition_variable finished;
+};
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return the thread pool jobs run on, which is the process wide pool unless
+that has no workers, as on a single core machine. Then jobs get one worker of
+their own so that they still run asynchronously*/
+inline util::thread::ThreadPool& jobPool() {
+
+    util::thread::ThreadPool& shared = util::thread::defaultPool();
+    if (shared.size() > 0) {
+
+        return shared;
+    }
+
+    static util::thread::ThreadPool fallback(1);
+
+    return fallback;
+}
+
+/**Marks a job as finished and runs its continuations on this thread*/
+inline void finish(const std::shared_ptr<JobState>& state) {
+
+    std::vector<std::function<void()> > continuations;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->done = true;
+        state->task = std::function<void()>();
+        continuations.swap(state->continuations);
+    }
+    state->finished.notify_all();
+
+    for (std::size_t i = 0; i < continuations.size(); ++i) {
+
+        continuations[i]();
+    }
+}
+
+/**Runs the task of a job that is ready, unless a dependency failed*/
+inline void run(const std::shared_ptr<JobState>& state) {
+
+    if (!state->error && state->task) {
+
+        try {
+
+            state->task();
+        }
+        catch (...) {
+
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->error = std::current_exception();
+        }
+    }
+    finish(state);
+}
+
+/**Counts down the dependencies of a job and schedules it once they have all
+finished
+@param error the exception the finished dependency threw, if any*/
+inline void release(
+        const std::shared_ptr<JobState>& state, std::exception_ptr error) {
+
+    bool ready;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (error && !state->error) {
+
+            state->error = error;
+        }
+        ready = --state->pending == 0;
+    }
+    if (!ready) {
+
+        return;
+    }
+
+    //jobs without a task finish as soon as they are ready
+    if (!state->task) {
+
+        run(state);
+
+        return;
+    }
+    jobPool().submit([state]() {
+
+        run(state);
+    });
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/***************************************************************************\
+| A handle to a job. Handles are cheap to copy and every copy refers to the |
+| same job. A default constructed handle refers to a job that has already   |
+| finished.                                                                 |
+\***************************************************************************/
+class Job {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a handle to a job that has already finished*/
+    inline Job() :
+        mState(new detail::JobState()) {
+
+        mState->pending = 0;
+        mState->done = true;
+    }
+
+    /**Creates a job that runs a task once its dependencies have finished
+    @param task the task, or an empty function for a job that only joins its
+    dependencies
+    @param dependencies the jobs that must finish first*/
+    inline Job(
+            const std::function<void()>& task,
+            const std::vector<Job>& dependencies) :
+        mState(new detail::JobState()) {
+
+        mState->task = task;
+        mState->pending = dependencies.size() + 1;
+        mState->done = false;
+
+        std::shared_ptr<detail::JobState> state = mState;
+        for (std::size_t i = 0; i < dependencies.size(); ++i) {
+
+            std::shared_ptr<detail::JobState> dependency =
+                dependencies[i].mState;
+            dependencies[i].onComplete([state, dependency]() {
+
+                detail::release(state, dependency->error);
+            });
+        }
+        detail::release(state, std::exception_ptr());
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return whether the job has finished*/
+    inline bool ready() const {
+
+        std::lock_guard<std::mutex> lock(mState->mutex);
+
+        return mState->done;
+    }
+
+    /**Blocks until the job has finished and rethrows the exception it threw,
+    if any. Tasks should chain with then() rather than wait for other jobs,
+    since a task waiting on a worker thread holds that worker*/
+    inline void wait() const {
+
+        std::unique_lock<std::mutex> lock(mState->mutex);
+        while (!mState->done) {
+
+            mState->finished.wait(lock);
+        }
+        if (mState->error) {
+
+            std::rethrow_exception(mState->error);
+        }
+    }
+
+    /**Calls a function once the job has finished, on the thread that finishes
+    it, or immediately on this thread if it already has. The function must
+    not throw
+    @param callback the function to call*/
+    inline void onComplete(const std::function<void()>& callback) const {
+
+        {
+            std::lock_guard<std::mutex> lock(mState->mutex);
+            if (!mState->done) {
+
+                mState->continuations.push_back(callback);
+
+                return;
+            }
+        }
+        callback();
+    }
+
+    /**Creates a job that runs a task after this one
+    @param task the task to run
+    @return the new job*/
+    inline Job then(const std::function<void()>& task) const {
+
+        return Job(task, std::vector<Job>(1, *this));
+    }
+
+    /**@return a future that becomes ready when the job finishes, holding the
+    exception it threw, if any*/
+    inline std::shared_future<void> future() const {
+
+        std::shared_ptr<std::promise<void> > promise(
+            new std::promise<void>());
+        std::shared_future<void> result = promise->get_future().share();
+        std::shared_ptr<detail::JobState> state = mState;
+        onComplete([promise, state]() {
+
+            if (state->error) {
+
+                promise->set_exception(state->error);
+            }
+            else {
+
+                promise->set_value();
+            }
+        });
+
+        return result;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the state of the job
+    std::shared_ptr<detail::JobState> mState;
+};
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Submits a task to run on the thread pool
+@param task the task to run
+@return the job running the task*/
+inline Job submit(const std::function<void()>& task) {
+
+    return Job(task, std::vector<Job>());
+}
+
+/**Submits a task to run on the thread pool once other jobs have finished
+@param task the task to run
+@param dependencies the jobs that must finish first
+@return the job running the task*/
+inline Job submit(
+        const std::function<void()>& task,
+        const std::vector<Job>& dependencies) {
+
+    return Job(task, dependencies);
+}
+
+/**@return a job that finishes once all the given jobs have, without a task of
+its own
+@param jobs the jobs to join*/
+inline Job whenAll(const std::vector<Job>& jobs) {
+
+    return Job(std::function<void()>(), jobs);
+}
+
+/**Submits a function over the range [0, count) split into the same chunks as
+util::thread::parallelFor(), one job per chunk, without waiting for them. This
+is how bulk util::vec operations are run as jobs, for example
+submitFor(n, chunk, [=](std::size_t b, std::size_t e) { util::vec::normalise(
+v + b, out + b, e - b); }, { upload })
+@param count the size of the range
+@param chunkSize the size of each chunk
+@param function called as function(begin, end) for each chunk
+@param dependencies the jobs that must finish before any chunk runs
+@return a job that finishes once every chunk has*/
+template<typename Function>
+inline Job submitFor(
+        std::size_t count,
+        std::size_t chunkSize,
+        Function function,
+        const std::vector<Job>& dependencies = std::vector<Job>()) {
+
+    if (chunkSize == 0) {
+
+        chunkSize = 1;
+    }
+
+    //the chunks depend on one join of the dependencies rather than each
+    //registering with every dependency
+    Job start = dependencies.size() > 1 ? whenAll(dependencies) :
+        (dependencies.empty() ? Job() : dependencies[0]);
+
+    std::vector<Job> chunks;
+    for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+
+        std::size_t end = begin + chunkSize < count ?
+            begin + chunkSize : count;
+        chunks.push_back(start.then([function, begin, end]() {
+
+            function(begin, end);
+        }));
+    }
+
+    return chunks.empty() ? start : whenAll(chunks);
+}
+
+#ifdef UTIL_JOB_COROUTINES
+
+/****************************************************************************\
+| Suspends a C++20 coroutine until a job finishes, resuming it on the thread |
+| that finishes the job and rethrowing the exception the job threw, if any.  |
+\****************************************************************************/
+struct JobAwaiter {
+
+    //!the job to await
+    Job job;
+
+    inline bool await_ready() const {
+
+        return job.ready();
+    }
+
+    inline void await_suspend(std::coroutine_handle<> handle) const {
+
+        job.onComplete([handle]() {
+
+            handle.resume();
+        });
+    }
+
+    inline void await_resume() const {
+
+        job.wait();
+    }
+};
+
+/**@return an awaiter that lets a coroutine co_await a job*/
+inline JobAwaiter operator co_await(const Job& job) {
+
+    return JobAwaiter{job};
+}
+
+#endif
+
+} } //util //job
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <cmath>
 
+#include "ProfileUtil.hpp"
+
 namespace util {
 
 /*****************************\
@@ -10,6 +12,147 @@ namespace util {
 \*****************************/
 namespace math {
 
+//------------------------------------------------------------------------------
+//                                  ENUMERATORS
+//------------------------------------------------------------------------------
+
+/**The accuracy tiers of the fast trigonometric approximations, from fastest to
+most accurate. Each tier notes the greatest absolute error of the results, for
+sin and cos this holds for angles up to 4096 radians*/
+enum TrigPrecision {
+
+    //!atan2 within 6.1e-4 radians, sin and cos within 6.9e-5
+    TRIG_FAST,
+    //!atan2 within 1.2e-5 radians, sin and cos within 8.0e-7
+    TRIG_MEDIUM,
+    //!atan2 within 6.0e-7 radians, sin and cos within 2.5e-7
+    TRIG_PRECISE
+};
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//pi and its multiples
+static const float PI = 3.14159265358979f;
+static const float HALF_PI = 1.57079632679490f;
+static const float INV_TWO_PI = 0.159154943091895f;
+//2 pi split into two parts with few significant bits, so multiples of them by
+//the number of turns in angles up to 4096 radians are exact, and the remainder
+static const float TWO_PI_HI = 6.28125f;
+static const float TWO_PI_MID = 1.93548202514648438e-3f;
+static const float TWO_PI_LO = -1.74845560252379e-7f;
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/**Minimax polynomial coefficients of the trigonometric approximations. atan()
+approximates atan(x) / x over [0, 1] and sin() approximates sin(x) / x over
+[0, pi / 2], both as polynomials in x squared*/
+template<TrigPrecision P>
+struct TrigPolynomials;
+
+template<>
+struct TrigPolynomials<TRIG_FAST> {
+
+    static const unsigned ATAN_TERMS = 3;
+    static const unsigned SIN_TERMS = 3;
+
+    static inline const float* atan() {
+
+        static const float c[ATAN_TERMS] =
+            { 0.995357955f, -0.288690238f, 0.0793390414f };
+
+        return c;
+    }
+
+    static inline const float* sin() {
+
+        static const float c[SIN_TERMS] =
+            { 0.999696773f, -0.165673079f, 0.00751437718f };
+
+        return c;
+    }
+};
+
+template<>
+struct TrigPolynomials<TRIG_MEDIUM> {
+
+    static const unsigned ATAN_TERMS = 5;
+    static const unsigned SIN_TERMS = 4;
+
+    static inline const float* atan() {
+
+        static const float c[ATAN_TERMS] = { 0.999866329f, -0.330304786f,
+            0.180159295f, -0.0851563509f, 0.0208451142f };
+
+        return c;
+    }
+
+    static inline const float* sin() {
+
+        static const float c[SIN_TERMS] = { 0.999996616f, -0.166648284f,
+            0.00830632523f, -0.00018363654f };
+
+        return c;
+    }
+};
+
+template<>
+struct TrigPolynomials<TRIG_PRECISE> {
+
+    static const unsigned ATAN_TERMS = 7;
+    static const unsigned SIN_TERMS = 5;
+
+    static inline const float* atan() {
+
+        static const float c[ATAN_TERMS] = { 0.999996112f, -0.333173681f,
+            0.198078156f, -0.132333421f, 0.0796236724f, -0.0336042206f,
+            0.00681179329f };
+
+        return c;
+    }
+
+    static inline const float* sin() {
+
+        static const float c[SIN_TERMS] = { 0.999999977f, -0.166666476f,
+            0.00833289982f, -0.000198008978f, 2.5904885e-06f };
+
+        return c;
+    }
+};
+
+//------------------------------------------------------------------------------
+//                                DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Evaluates x * (c[0] + c[1]x^2 + c[2]x^4 ...) with N coefficients*/
+template<unsigned N>
+inline float oddPolynomial(const float* c, float x) {
+
+    float x2 = x * x;
+    float sum = c[N - 1];
+    for (unsigned i = N - 1; i > 0; --i) {
+
+        sum = sum * x2 + c[i - 1];
+    }
+
+    return sum * x;
+}
+
+/**@return the given angle wrapped into [-pi, pi]*/
+inline float wrapAngle(float angle) {
+
+    float k = std::floor(angle * INV_TWO_PI + 0.5f);
+
+    return ((angle - k * TWO_PI_HI) - k * TWO_PI_MID) - k * TWO_PI_LO;
+}
+
+} //detail
+
 //------------------------------------------------------------------------------
 //                                   FUNCTIONS
 //------------------------------------------------------------------------------
@@ -22,6 +165,8 @@ namespace math {
 template<typename T>
 inline T clamp(T v, T lower, T upper) {
 
+    UTIL_PROFILE_PROBE("math::clamp");
+
     if (v < lower) {
 
         return lower;
@@ -42,6 +187,8 @@ greater than the threshold)
 template<typename T>
 inline T clampAbove(T v, T threshold) {
 
+    UTIL_PROFILE_PROBE("math::clampAbove");
+
     if (v < threshold) {
 
         return threshold;
@@ -58,6 +205,8 @@ or less than the threshold)
 template<typename T>
 inline T clampBelow(T v, T threshold) {
 
+    UTIL_PROFILE_PROBE("math::clampBelow");
+
     if (v > threshold) {
 
         return threshold;
@@ -74,6 +223,8 @@ inline T clampBelow(T v, T threshold) {
 template<typename T>
 inline bool withinDistance(T a, T b, T distance) {
 
+    UTIL_PROFILE_PROBE("math::withinDistance");
+
     //return if abs is less than
     return abs(a - b) <= distance;
 }
@@ -86,6 +237,8 @@ inline bool withinDistance(T a, T b, T distance) {
 template<>
 inline bool withinDistance(float a, float b, float distance) {
 
+    UTIL_PROFILE_PROBE("math::withinDistance");
+
     //return if abs is less than
     return fabs(a - b) <= distance;
 }
@@ -98,10 +251,138 @@ inline bool withinDistance(float a, float b, float distance) {
 template<>
 inline bool withinDistance(double a, double b, double distance) {
 
+    UTIL_PROFILE_PROBE("math::withinDistance");
+
     //return if abs is less than
     return fabs(a - b) <= distance;
 }
 
+/**Computes a * b + c with a fused multiply-add instruction, rounding once,
+when the target has one, and with a multiply then an add otherwise, so it is
+never slower than a * b + c. Compile for a target with FMA (for example with
+-mfma or -march=haswell) to use it
+@param a the first factor
+@param b the second factor
+@param c the value to add to the product
+@return a * b + c*/
+inline float multiplyAdd(float a, float b, float c) {
+
+#ifdef FP_FAST_FMAF
+    return std::fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+/**Computes a * b - c * d with each product rounded on its own, even where the
+compiler would otherwise fuse one of them into the subtraction, so that the
+result is zero when the products are equal and negated when the pairs are
+swapped
+@param a the first factor of the first product
+@param b the second factor of the first product
+@param c the first factor of the second product
+@param d the second factor of the second product
+@return a * b - c * d*/
+inline float differenceOfProducts(float a, float b, float c, float d) {
+
+#ifdef FP_FAST_FMAF
+    //adding zero rounds each product in an instruction the compiler does not
+    //fuse any further
+    return std::fma(a, b, 0.0f) - std::fma(c, d, 0.0f);
+#else
+    return a * b - c * d;
+#endif
+}
+
+//-------------------------FAST TRIGONOMETRIC FUNCTIONS-------------------------
+// These are branch free polynomial approximations of the standard functions
+// with the accuracy given by the precision tier. They are written so that the
+// bulk versions in vector/VectorAngles.hpp compute the same results with SIMD.
+
+/**Approximates atan2. Unlike atan2 the sign of a zero y is ignored, so the
+result for a y of -0 on the negative x axis is pi rather than -pi
+@param y the y coordinate
+@param x the x coordinate
+@return the angle of (x, y) from the x axis in [-pi, pi]*/
+template<TrigPrecision P>
+inline float fastAtan2(float y, float x) {
+
+    UTIL_PROFILE_PROBE("math::fastAtan2");
+
+    typedef detail::TrigPolynomials<P> Poly;
+
+    float ax = std::fabs(x);
+    float ay = std::fabs(y);
+
+    //evaluate atan over [0, 1] and use symmetry for the other octants
+    float high = ax > ay ? ax : ay;
+    float low = ax > ay ? ay : ax;
+    float t = high > 0.0f ? low / high : 0.0f;
+
+    float angle = detail::oddPolynomial<Poly::ATAN_TERMS>(Poly::atan(), t);
+    angle = ay > ax ? detail::HALF_PI - angle : angle;
+    angle = x < 0.0f ? detail::PI - angle : angle;
+
+    return y < 0.0f ? -angle : angle;
+}
+
+/**Approximates sin
+@param angle the angle in radians
+@return the sine of the angle*/
+template<TrigPrecision P>
+inline float fastSin(float angle) {
+
+    UTIL_PROFILE_PROBE("math::fastSin");
+
+    typedef detail::TrigPolynomials<P> Poly;
+
+    //fold [-pi, pi] onto [0, pi / 2] and restore the sign afterwards
+    float r = detail::wrapAngle(angle);
+    float folded = detail::HALF_PI - std::fabs(detail::HALF_PI - std::fabs(r));
+    float s = detail::oddPolynomial<Poly::SIN_TERMS>(Poly::sin(), folded);
+
+    return r < 0.0f ? -s : s;
+}
+
+/**Approximates cos
+@param angle the angle in radians
+@return the cosine of the angle*/
+template<TrigPrecision P>
+inline float fastCos(float angle) {
+
+    UTIL_PROFILE_PROBE("math::fastCos");
+
+    typedef detail::TrigPolynomials<P> Poly;
+
+    //cos(r) = sin(pi / 2 - |r|)
+    float r = detail::wrapAngle(angle);
+
+    return detail::oddPolynomial<Poly::SIN_TERMS>(
+        Poly::sin(), detail::HALF_PI - std::fabs(r));
+}
+
+/**Approximates the sine and cosine of an angle at once, sharing the range
+reduction
+@param angle the angle in radians
+@param s returns the sine of the angle
+@param c returns the cosine of the angle*/
+template<TrigPrecision P>
+inline void fastSincos(float angle, float& s, float& c) {
+
+    UTIL_PROFILE_PROBE("math::fastSincos");
+
+    typedef detail::TrigPolynomials<P> Poly;
+
+    float r = detail::wrapAngle(angle);
+    float ar = std::fabs(r);
+    float folded = detail::HALF_PI - std::fabs(detail::HALF_PI - ar);
+
+    s = detail::oddPolynomial<Poly::SIN_TERMS>(Poly::sin(), folded);
+    s = r < 0.0f ? -s : s;
+    c = detail::oddPolynomial<Poly::SIN_TERMS>(
+        Poly::sin(), detail::HALF_PI - ar);
+}
+
 } } //util //math
 
 #endif
@@ -0,0 +1,804 @@
+#ifndef UTILITRON_MEMORYUTIL_H_
+#   define UTILITRON_MEMORYUTIL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#include "MacroUtil.hpp"
+
+namespace util {
+
+/****************************************************************************\
+| Memory allocation utilities: aligned allocation for SIMD data, monotonic   |
+| arenas that are reset in bulk, standard allocators so that containers such |
+| as std::vector can be backed by either, and accounting of the allocations  |
+| made by the formatting functions.                                          |
+\****************************************************************************/
+namespace mem {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the alignment of blocks intended for SIMD data, this is the width of an
+//!AVX-512 register and the size of a cache line
+static const std::size_t SIMD_ALIGNMENT = 64;
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Allocates a block of memory aligned to the given alignment
+@param bytes the size of the block
+@param alignment the alignment of the block, must be a power of two
+@return the block, which must be freed with alignedFree()
+@throws std::bad_alloc if the block could not be allocated*/
+inline void* alignedAllocate(std::size_t bytes, std::size_t alignment) {
+
+    if (alignment < sizeof(void*)) {
+
+        alignment = sizeof(void*);
+    }
+
+    //over allocate and store the pointer malloc returned in front of the
+    //aligned block, a size too close to the limit of size_t would wrap
+    if (bytes > std::numeric_limits<std::size_t>::max() - alignment -
+            sizeof(void*)) {
+
+        throw std::bad_alloc();
+    }
+    void* raw = std::malloc(bytes + alignment + sizeof(void*));
+    if (!raw) {
+
+        throw std::bad_alloc();
+    }
+
+    std::size_t address =
+        reinterpret_cast<std::size_t>(raw) + sizeof(void*) + alignment - 1;
+    void* aligned = reinterpret_cast<void*>(address & ~(alignment - 1));
+    static_cast<void**>(aligned)[-1] = raw;
+
+    return aligned;
+}
+
+/**Frees a block allocated with alignedAllocate()
+@param block the block to free, may be null*/
+inline void alignedFree(void* block) {
+
+    if (block) {
+
+        std::free(static_cast<void**>(block)[-1]);
+    }
+}
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/*******************************\
+| Usage statistics of an arena. |
+\*******************************/
+struct ArenaStats {
+
+    //!the number of bytes currently handed out by the arena
+    std::size_t bytesInUse;
+    //!the greatest value bytesInUse has reached
+    std::size_t peakBytesInUse;
+    //!the number of bytes the arena holds in blocks
+    std::size_t bytesReserved;
+    //!the number of blocks the arena holds
+    std::size_t blockCount;
+    //!the number of allocations made from the arena
+    std::size_t allocationCount;
+    //!the number of times the arena has been reset
+    std::size_t resetCount;
+};
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/****************************************************************************\
+| A monotonic arena. Allocations are carved sequentially out of large blocks |
+| and are never freed individually; instead the whole arena is reset at once |
+| (e.g. at the end of a frame). Blocks are kept across resets so an arena    |
+| that has warmed up makes no further calls to the global allocator.         |
+|                                                                            |
+| An arena is not thread safe, use one arena per thread (see threadArena()). |
+\****************************************************************************/
+class Arena {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new empty arena, no memory is reserved until the first
+    allocation
+    @param blockSize the size of the blocks the arena reserves*/
+    inline explicit Arena(std::size_t blockSize = 64 * 1024) :
+        mBlockSize(blockSize),
+        mBlocks(0),
+        mCurrent(0) {
+
+        mStats.bytesInUse = 0;
+        mStats.peakBytesInUse = 0;
+        mStats.bytesReserved = 0;
+        mStats.blockCount = 0;
+        mStats.allocationCount = 0;
+        mStats.resetCount = 0;
+    }
+
+    //--------------------------------------------------------------------------
+    //                                 DESTRUCTOR
+    //--------------------------------------------------------------------------
+
+    /**Destroys this arena and frees all of its blocks*/
+    inline ~Arena() {
+
+        release();
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**Allocates memory from the arena
+    @param bytes the number of bytes to allocate
+    @param alignment the alignment of the memory, must be a power of two
+    @return the allocated memory
+    @throws std::bad_alloc if a new block could not be allocated*/
+    inline void* allocate(
+            std::size_t bytes, std::size_t alignment = SIMD_ALIGNMENT) {
+
+        void* p = mCurrent ? mCurrent->carve(bytes, alignment) : 0;
+        if (!p) {
+
+            //find a later block (kept from before a reset) that fits
+            while (mCurrent && mCurrent->next) {
+
+                mCurrent = mCurrent->next;
+                p = mCurrent->carve(bytes, alignment);
+                if (p) {
+
+                    break;
+                }
+            }
+        }
+        if (!p) {
+
+            if (bytes > std::numeric_limits<std::size_t>::max() - alignment) {
+
+                throw std::bad_alloc();
+            }
+            addBlock(bytes + alignment);
+            p = mCurrent->carve(bytes, alignment);
+        }
+
+        ++mStats.allocationCount;
+        mStats.bytesInUse += bytes;
+        if (mStats.bytesInUse > mStats.peakBytesInUse) {
+
+            mStats.peakBytesInUse = mStats.bytesInUse;
+        }
+
+        return p;
+    }
+
+    /**Returns memory to the arena. The memory is only reclaimed if it was the
+    most recent allocation, so temporaries freed in reverse order of
+    allocation do not use up the block
+    @param p the memory to return
+    @param bytes the size of the allocation*/
+    inline void deallocate(void* p, std::size_t bytes) {
+
+        mStats.bytesInUse -= bytes;
+
+        if (mCurrent &&
+            static_cast<char*>(p) + bytes == mCurrent->data + mCurrent->used) {
+
+            mCurrent->used = static_cast<char*>(p) - mCurrent->data;
+        }
+    }
+
+    /**Makes all of the memory of the arena available again, any memory
+    allocated from the arena must no longer be used. If the arena grew past one
+    block since the last reset the blocks are merged into a single block so the
+    next cycle is served from contiguous memory*/
+    inline void reset() {
+
+        if (mBlocks && mBlocks->next) {
+
+            std::size_t total = mStats.bytesReserved;
+            release();
+            addBlock(total);
+        }
+        for (Block* block = mBlocks; block; block = block->next) {
+
+            block->used = 0;
+        }
+
+        mCurrent = mBlocks;
+        mStats.bytesInUse = 0;
+        ++mStats.resetCount;
+    }
+
+    /**Frees all of the blocks of the arena, any memory allocated from the
+    arena must no longer be used*/
+    inline void release() {
+
+        while (mBlocks) {
+
+            Block* next = mBlocks->next;
+            alignedFree(mBlocks);
+            mBlocks = next;
+        }
+
+        mCurrent = 0;
+        mStats.bytesInUse = 0;
+        mStats.bytesReserved = 0;
+        mStats.blockCount = 0;
+    }
+
+    /**@return the usage statistics of the arena*/
+    inline const ArenaStats& stats() const {
+
+        return mStats;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                  STRUCTS
+    //--------------------------------------------------------------------------
+
+    /**The header of a block, the block's memory follows it*/
+    struct Block {
+
+        //the next block
+        Block* next;
+        //the memory of the block
+        char* data;
+        //the size of the block
+        std::size_t size;
+        //the number of bytes of the block in use
+        std::size_t used;
+
+        /**@return the given number of bytes from the end of the used region
+        of the block, or null if they do not fit*/
+        inline void* carve(std::size_t bytes, std::size_t alignment) {
+
+            std::size_t address = reinterpret_cast<std::size_t>(data) + used;
+            std::size_t aligned = (address + alignment - 1) & ~(alignment - 1);
+            std::size_t offset = aligned - reinterpret_cast<std::size_t>(data);
+            if (offset > size || bytes > size - offset) {
+
+                return 0;
+            }
+
+            used = offset + bytes;
+
+            return reinterpret_cast<void*>(aligned);
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the size of new blocks
+    std::size_t mBlockSize;
+    //the first block
+    Block* mBlocks;
+    //the block allocations are currently carved from
+    Block* mCurrent;
+    //the usage statistics
+    ArenaStats mStats;
+
+    //--------------------------------------------------------------------------
+    //                          PRIVATE MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    DISALLOW_COPY_AND_ASSIGN(Arena);
+
+    /**Adds a block that holds at least the given number of bytes after the
+    current block and makes it the current block*/
+    inline void addBlock(std::size_t minimumBytes) {
+
+        std::size_t size =
+            minimumBytes > mBlockSize ? minimumBytes : mBlockSize;
+        std::size_t header =
+            (sizeof(Block) + SIMD_ALIGNMENT - 1) & ~(SIMD_ALIGNMENT - 1);
+        if (size > std::numeric_limits<std::size_t>::max() - header) {
+
+            throw std::bad_alloc();
+        }
+
+        Block* block = static_cast<Block*>(
+            alignedAllocate(header + size, SIMD_ALIGNMENT));
+        block->data = reinterpret_cast<char*>(block) + header;
+        block->size = size;
+        block->used = 0;
+
+        if (mCurrent) {
+
+            block->next = mCurrent->next;
+            mCurrent->next = block;
+        }
+        else {
+
+            block->next = mBlocks;
+            mBlocks = block;
+        }
+        mCurrent = block;
+
+        mStats.bytesReserved += size;
+        ++mStats.blockCount;
+    }
+};
+
+/**@return the arena of the calling thread. Each thread has its own arena so
+threads never contend when allocating from it*/
+inline Arena& threadArena() {
+
+    static thread_local Arena arena;
+
+    return arena;
+}
+
+/****************************************************************************\
+| A standard allocator that allocates from an arena, for containers whose    |
+| memory should be released in bulk when the arena is reset. An allocator is |
+| bound to one arena for its whole life, and since arenas are not thread     |
+| safe a container using it must only allocate and free on the thread that   |
+| owns that arena.                                                           |
+\****************************************************************************/
+template<typename T>
+class ArenaAllocator {
+public:
+
+    typedef T value_type;
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new allocator that allocates from the calling thread's arena.
+    The allocator stays bound to that arena, so containers default
+    constructed on one thread must not grow or be freed on another*/
+    inline ArenaAllocator() :
+        mArena(&threadArena()) {
+    }
+
+    /**Creates a new allocator that allocates from the given arena
+    @param arena the arena to allocate from*/
+    inline explicit ArenaAllocator(Arena& arena) :
+        mArena(&arena) {
+    }
+
+    /**Creates a new allocator that allocates from the same arena as the given
+    allocator
+    @param other the allocator to copy the arena from*/
+    template<typename U>
+    inline ArenaAllocator(const ArenaAllocator<U>& other) :
+        mArena(&other.arena()) {
+    }
+
+    //--------------------------------------------------------------------------
+    //                                 OPERATORS
+    //--------------------------------------------------------------------------
+
+    /**@return if this allocator and the other given allocator share an
+    arena*/
+    template<typename U>
+    inline bool operator ==(const ArenaAllocator<U>& other) const {
+
+        return mArena == &other.arena();
+    }
+
+    /**@return if this allocator and the other given allocator do not share an
+    arena*/
+    template<typename U>
+    inline bool operator !=(const ArenaAllocator<U>& other) const {
+
+        return !((*this) == other);
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**Allocates memory for n objects
+    @param n the number of objects
+    @return the memory
+    @throws std::bad_array_new_length if n objects would not fit in size_t
+    bytes
+    @throws std::bad_alloc if a new block could not be allocated*/
+    inline T* allocate(std::size_t n) {
+
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+
+            throw std::bad_array_new_length();
+        }
+
+        std::size_t alignment =
+            alignof(T) > SIMD_ALIGNMENT ? alignof(T) : SIMD_ALIGNMENT;
+
+        return static_cast<T*>(mArena->allocate(n * sizeof(T), alignment));
+    }
+
+    /**Returns memory for n objects to the arena
+    @param p the memory
+    @param n the number of objects*/
+    inline void deallocate(T* p, std::size_t n) {
+
+        mArena->deallocate(p, n * sizeof(T));
+    }
+
+    /**@return the arena this allocator allocates from*/
+    inline Arena& arena() const {
+
+        return *mArena;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the arena to allocate from
+    Arena* mArena;
+};
+
+/***************************************************************************\
+| A standard allocator that allocates blocks aligned for SIMD loads, so the |
+| start of a container's data never straddles a cache line.                 |
+\***************************************************************************/
+template<typename T, std::size_t Alignment = SIMD_ALIGNMENT>
+class AlignedAllocator {
+public:
+
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind {
+
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new aligned allocator*/
+    inline AlignedAllocator() {
+    }
+
+    /**Creates a new aligned allocator from an allocator of another type*/
+    template<typename U>
+    inline AlignedAllocator(const AlignedAllocator<U, Alignment>&) {
+    }
+
+    //--------------------------------------------------------------------------
+    //                                 OPERATORS
+    //--------------------------------------------------------------------------
+
+    /**@return true, aligned allocators are interchangeable*/
+    template<typename U>
+    inline bool operator ==(const AlignedAllocator<U, Alignment>&) const {
+
+        return true;
+    }
+
+    /**@return false, aligned allocators are interchangeable*/
+    template<typename U>
+    inline bool operator !=(const AlignedAllocator<U, Alignment>&) const {
+
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**Allocates memory for n objects
+    @param n the number of objects
+    @return the memory
+    @throws std::bad_array_new_length if n objects would not fit in size_t
+    bytes
+    @throws std::bad_alloc if the memory could not be allocated*/
+    inline T* allocate(std::size_t n) {
+
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+
+            throw std::bad_array_new_length();
+        }
+
+        return static_cast<T*>(alignedAllocate(n * sizeof(T), Alignment));
+    }
+
+    /**Frees memory for n objects
+    @param p the memory*/
+    inline void deallocate(T* p, std::size_t) {
+
+        alignedFree(p);
+    }
+};
+
+//------------------------------------------------------------------------------
+//                              ALLOCATION TRACKING
+//------------------------------------------------------------------------------
+// The string, exception and vector formatting functions allocate through
+// std::string and std::stringstream. Defining UTILITRON_TRACK_ALLOCATIONS marks
+// each of them as an allocation scope, and every allocation made on a thread
+// while it is inside a scope is recorded against the scope's category. The
+// allocations are seen by the replacement global operator new that is defined
+// by the one translation unit that also defines
+// UTILITRON_DEFINE_ALLOCATION_HOOK before including this header. A program
+// that already replaces operator new should call recordAllocation() from its
+// own instead. Nested scopes are recorded against the outermost, so
+// str::centre() counts as one string operation including the allocations of
+// the functions it calls.
+
+/**The kinds of call whose allocations are recorded*/
+enum AllocationCategory {
+
+    //!the util::str functions
+    ALLOCATION_STRING,
+    //!util::ex::Exception::what() and info()
+    ALLOCATION_EXCEPTION,
+    //!the vector toString() functions and stream operators
+    ALLOCATION_VECTOR_FORMAT,
+    //!the number of categories
+    ALLOCATION_CATEGORY_COUNT
+};
+
+/******************************************\
+| The allocations of one category of call. |
+\******************************************/
+struct AllocationStats {
+
+    //!the number of calls made in the category
+    unsigned long long operations;
+    //!the number of allocations made by the calls
+    unsigned long long allocations;
+    //!the total number of bytes the calls allocated
+    unsigned long long bytes;
+};
+
+namespace detail {
+
+/**The totals of every category, shared by all threads*/
+struct AllocationCounters {
+
+    std::atomic<unsigned long long> operations[ALLOCATION_CATEGORY_COUNT];
+    std::atomic<unsigned long long> allocations[ALLOCATION_CATEGORY_COUNT];
+    std::atomic<unsigned long long> bytes[ALLOCATION_CATEGORY_COUNT];
+};
+
+/**@return the allocation totals, which are zero initialised before any
+dynamic initialisation so allocations made during start up are safe to
+record*/
+inline AllocationCounters& allocationCounters() {
+
+    static AllocationCounters counters;
+
+    return counters;
+}
+
+/**@return the category of the scope the calling thread is in, or
+ALLOCATION_CATEGORY_COUNT outside of any scope*/
+inline int& currentAllocationCategory() {
+
+    static thread_local int category = ALLOCATION_CATEGORY_COUNT;
+
+    return category;
+}
+
+} //detail
+
+/**Records an allocation against the allocation scope the calling thread is in,
+if any. This is called by the allocation hook and may be called by a custom
+global operator new
+@param bytes the size of the allocation*/
+inline void recordAllocation(std::size_t bytes) {
+
+    int category = detail::currentAllocationCategory();
+    if (category != ALLOCATION_CATEGORY_COUNT) {
+
+        detail::AllocationCounters& counters = detail::allocationCounters();
+        counters.allocations[category].fetch_add(
+            1, std::memory_order_relaxed);
+        counters.bytes[category].fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+/**@return the allocations recorded for the given category since the start of
+the program or the last resetAllocationStats()
+@param category the category to get the allocations of*/
+inline AllocationStats allocationStats(AllocationCategory category) {
+
+    detail::AllocationCounters& counters = detail::allocationCounters();
+
+    AllocationStats stats;
+    stats.operations =
+        counters.operations[category].load(std::memory_order_relaxed);
+    stats.allocations =
+        counters.allocations[category].load(std::memory_order_relaxed);
+    stats.bytes = counters.bytes[category].load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+/**Sets the recorded allocations of every category back to 0*/
+inline void resetAllocationStats() {
+
+    detail::AllocationCounters& counters = detail::allocationCounters();
+    for (int i = 0; i < ALLOCATION_CATEGORY_COUNT; ++i) {
+
+        counters.operations[i].store(0, std::memory_order_relaxed);
+        counters.allocations[i].store(0, std::memory_order_relaxed);
+        counters.bytes[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**@return whether the library was built with UTILITRON_TRACK_ALLOCATIONS*/
+inline bool allocationTrackingEnabled() {
+
+#ifdef UTILITRON_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/****************************************************************************\
+| Records the allocations the calling thread makes while it exists against a |
+| category, unless the thread is already in an allocation scope.             |
+\****************************************************************************/
+class AllocationScope {
+public:
+
+    /**Enters an allocation scope
+    @param category the category to record allocations against*/
+    inline explicit AllocationScope(AllocationCategory category) :
+        mOutermost(detail::currentAllocationCategory() ==
+            ALLOCATION_CATEGORY_COUNT) {
+
+        if (mOutermost) {
+
+            detail::allocationCounters().operations[category].fetch_add(
+                1, std::memory_order_relaxed);
+            detail::currentAllocationCategory() = category;
+        }
+    }
+
+    /**Leaves the allocation scope*/
+    inline ~AllocationScope() {
+
+        if (mOutermost) {
+
+            detail::currentAllocationCategory() = ALLOCATION_CATEGORY_COUNT;
+        }
+    }
+
+private:
+
+    //whether this scope is not nested in another
+    bool mOutermost;
+
+    DISALLOW_COPY_AND_ASSIGN(AllocationScope);
+};
+
+#ifdef UTILITRON_TRACK_ALLOCATIONS
+
+#define UTIL_ALLOCATION_JOIN_(a, b) a##b
+#define UTIL_ALLOCATION_JOIN(a, b) UTIL_ALLOCATION_JOIN_(a, b)
+
+/**Records the allocations made in the enclosing scope against a category*/
+#define UTIL_ALLOCATION_SCOPE(category)                                   \
+    util::mem::AllocationScope UTIL_ALLOCATION_JOIN(utilAllocationScope, \
+        __LINE__)(category)
+
+#else
+
+#define UTIL_ALLOCATION_SCOPE(category) ((void) 0)
+
+#endif
+
+} } //util //mem
+
+#if defined(UTILITRON_TRACK_ALLOCATIONS) && \
+    defined(UTILITRON_DEFINE_ALLOCATION_HOOK)
+
+//------------------------------------------------------------------------------
+//                                ALLOCATION HOOK
+//------------------------------------------------------------------------------
+// Replacements of the global allocation functions that record each allocation
+// and otherwise behave as the defaults. These are not inline, so exactly one
+// translation unit may define UTILITRON_DEFINE_ALLOCATION_HOOK. They are kept
+// out of line so GCC does not pair the malloc of an inlined operator new with
+// the free of an inlined operator delete and warn that they mismatch.
+
+#ifdef __GNUC__
+#   define UTIL_ALLOCATION_HOOK __attribute__((noinline))
+#else
+#   define UTIL_ALLOCATION_HOOK
+#endif
+
+UTIL_ALLOCATION_HOOK
+void* operator new(std::size_t bytes) {
+
+    util::mem::recordAllocation(bytes);
+    void* block = std::malloc(bytes > 0 ? bytes : 1);
+    if (!block) {
+
+        throw std::bad_alloc();
+    }
+
+    return block;
+}
+
+UTIL_ALLOCATION_HOOK
+void* operator new[](std::size_t bytes) {
+
+    return operator new(bytes);
+}
+
+UTIL_ALLOCATION_HOOK
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept {
+
+    util::mem::recordAllocation(bytes);
+
+    return std::malloc(bytes > 0 ? bytes : 1);
+}
+
+UTIL_ALLOCATION_HOOK
+void* operator new[](std::size_t bytes, const std::nothrow_t& tag) noexcept {
+
+    return operator new(bytes, tag);
+}
+
+UTIL_ALLOCATION_HOOK
+void operator delete(void* block) noexcept {
+
+    std::free(block);
+}
+
+UTIL_ALLOCATION_HOOK
+void operator delete[](void* block) noexcept {
+
+    std::free(block);
+}
+
+UTIL_ALLOCATION_HOOK
+void operator delete(void* block, std::size_t) noexcept {
+
+    std::free(block);
+}
+
+UTIL_ALLOCATION_HOOK
+void operator delete[](void* block, std::size_t) noexcept {
+
+    std::free(block);
+}
+
+UTIL_ALLOCATION_HOOK
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+
+    std::free(block);
+}
+
+UTIL_ALLOCATION_HOOK
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+
+    std::free(block);
+}
+
+#endif
+
+#endif
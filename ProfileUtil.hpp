@@ -0,0 +1,363 @@
+#ifndef UTILITRON_PROFILEUTIL_H_
+#   define UTILITRON_PROFILEUTIL_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef UTILITRON_PROFILE
+#   include <algorithm>
+#   include <atomic>
+#   include <chrono>
+#   include <iomanip>
+#   include <map>
+#   include <mutex>
+#   if defined(__x86_64__) || defined(__i386__)
+#       include <x86intrin.h>
+#   elif defined(_M_X64) || defined(_M_IX86)
+#       include <intrin.h>
+#   endif
+#endif
+
+#include "MacroUtil.hpp"
+
+namespace util {
+
+/****************************************************************************\
+| Call counting for the utility functions. Define UTILITRON_PROFILE before   |
+| including any Utilitron header to count every call to the instrumented     |
+| util::vec, util::math and util::str functions, and also define             |
+| UTILITRON_PROFILE_CYCLES to time them. Each thread counts into its own     |
+| block of counters which are only added together when collect() or report() |
+| is called. Without UTILITRON_PROFILE the probes compile to nothing and     |
+| collect() returns no results.                                              |
+\****************************************************************************/
+namespace profile {
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/**The totals of one probe across every thread*/
+struct ProbeStats {
+
+    //!the name of the probe, usually the function it is in
+    std::string name;
+    //!the number of times the probe was passed
+    unsigned long long calls;
+    //!the time spent in the probed scope, in processor timestamp ticks (or
+    //!nanoseconds where there is no timestamp counter), or 0 without
+    //!UTILITRON_PROFILE_CYCLES
+    unsigned long long cycles;
+};
+
+#ifdef UTILITRON_PROFILE
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of counters each thread has, the last is kept for the probes
+//!registered once the others are taken so their calls are reported apart
+static const std::size_t MAX_PROBES = 512;
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return the current value of the processor timestamp counter*/
+inline unsigned long long ticks() {
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+    return __rdtsc();
+#else
+    return static_cast<unsigned long long>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/**The counters of one thread. Only the owning thread writes them, relaxed
+atomics let other threads read them while it runs*/
+struct ThreadCounters {
+
+    //the calls of each probe
+    std::atomic<unsigned long long> calls[MAX_PROBES];
+    //the cycles spent in each probe
+    std::atomic<unsigned long long> cycles[MAX_PROBES];
+
+    inline ThreadCounters();
+
+    inline ~ThreadCounters();
+
+    DISALLOW_COPY_AND_ASSIGN(ThreadCounters);
+};
+
+/**The probe names and the counters of every thread*/
+struct Registry {
+
+    //guards every member
+    std::mutex mutex;
+    //the names of the probes in probe order
+    std::vector<std::string> names;
+    //the probe of each name
+    std::map<std::string, std::size_t> probes;
+    //the counters of the running threads
+    std::vector<ThreadCounters*> threads;
+    //the number of probes registered to the overflow counter
+    std::size_t overflowed;
+    //the counts of the threads that have exited
+    unsigned long long retiredCalls[MAX_PROBES];
+    unsigned long long retiredCycles[MAX_PROBES];
+
+    inline Registry() : overflowed(0) {
+
+        std::fill(retiredCalls, retiredCalls + MAX_PROBES, 0ULL);
+        std::fill(retiredCycles, retiredCycles + MAX_PROBES, 0ULL);
+    }
+};
+
+/**@return the process wide probe registry*/
+inline Registry& registry() {
+
+    static Registry instance;
+
+    return instance;
+}
+
+inline ThreadCounters::ThreadCounters() {
+
+    for (std::size_t i = 0; i < MAX_PROBES; ++i) {
+
+        calls[i].store(0, std::memory_order_relaxed);
+        cycles[i].store(0, std::memory_order_relaxed);
+    }
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threads.push_back(this);
+}
+
+inline ThreadCounters::~ThreadCounters() {
+
+    //fold the counts into the retired totals so they outlive the thread
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (std::size_t i = 0; i < MAX_PROBES; ++i) {
+
+        r.retiredCalls[i] += calls[i].load(std::memory_order_relaxed);
+        r.retiredCycles[i] += cycles[i].load(std::memory_order_relaxed);
+    }
+    r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+}
+
+/**@return the counters of the calling thread*/
+inline ThreadCounters& threadCounters() {
+
+    thread_local ThreadCounters counters;
+
+    return counters;
+}
+
+/**@return the probe with the given name, registering it on first use*/
+inline std::size_t registerProbe(const char* name) {
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::map<std::string, std::size_t>::iterator found = r.probes.find(name);
+    if (found != r.probes.end()) {
+
+        return found->second;
+    }
+
+    //the last counter is only for probes that do not fit
+    std::size_t probe = MAX_PROBES - 1;
+    if (r.names.size() < MAX_PROBES - 1) {
+
+        probe = r.names.size();
+        r.names.push_back(name);
+    }
+    else {
+
+        ++r.overflowed;
+    }
+    r.probes[name] = probe;
+
+    return probe;
+}
+
+/************************************************************************\
+| Counts a call to a probe and, with UTILITRON_PROFILE_CYCLES, times the |
+| scope it is declared in.                                               |
+\************************************************************************/
+class Scope {
+public:
+
+    /**Counts a call to the given probe*/
+    inline explicit Scope(std::size_t probe) :
+        mCounters(threadCounters()),
+        mProbe(probe) {
+
+        std::atomic<unsigned long long>& calls = mCounters.calls[mProbe];
+        calls.store(calls.load(std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+#ifdef UTILITRON_PROFILE_CYCLES
+        mStart = ticks();
+#endif
+    }
+
+    /**Adds the time spent in the scope to the probe*/
+    inline ~Scope() {
+
+#ifdef UTILITRON_PROFILE_CYCLES
+        std::atomic<unsigned long long>& cycles = mCounters.cycles[mProbe];
+        cycles.store(cycles.load(std::memory_order_relaxed) +
+            (ticks() - mStart), std::memory_order_relaxed);
+#endif
+    }
+
+private:
+
+    //the counters of the thread the scope is on
+    ThreadCounters& mCounters;
+    //the probe being counted
+    std::size_t mProbe;
+#ifdef UTILITRON_PROFILE_CYCLES
+    //the timestamp the scope was entered at
+    unsigned long long mStart;
+#endif
+
+    DISALLOW_COPY_AND_ASSIGN(Scope);
+};
+
+} //detail
+
+#define UTIL_PROFILE_JOIN_(a, b) a##b
+#define UTIL_PROFILE_JOIN(a, b) UTIL_PROFILE_JOIN_(a, b)
+
+/**Counts each pass through the enclosing scope under the given name, probes
+with the same name share their counts*/
+#define UTIL_PROFILE_PROBE(name)                                             \
+    static const std::size_t UTIL_PROFILE_JOIN(utilProfileProbe, __LINE__) = \
+        util::profile::detail::registerProbe(name);                          \
+    util::profile::detail::Scope UTIL_PROFILE_JOIN(utilProfileScope,         \
+        __LINE__)(UTIL_PROFILE_JOIN(utilProfileProbe, __LINE__))
+
+#else
+
+#define UTIL_PROFILE_PROBE(name) ((void) 0)
+
+#endif
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return whether the library was built with UTILITRON_PROFILE*/
+inline bool enabled() {
+
+#ifdef UTILITRON_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**Adds together the counters of every thread, including threads that have
+exited. If more probes are passed than there are counters for, the totals of
+the probes that did not fit are added together into a last entry named
+"(overflow of N probes)"
+@return the totals of each probe that has been passed, in the order the probes
+were first passed*/
+inline std::vector<ProbeStats> collect() {
+
+    std::vector<ProbeStats> stats;
+#ifdef UTILITRON_PROFILE
+    detail::Registry& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::size_t count = r.names.size() + (r.overflowed > 0 ? 1 : 0);
+    for (std::size_t i = 0; i < count; ++i) {
+
+        ProbeStats probe;
+        probe.name = i < r.names.size() ? r.names[i] :
+            "(overflow of " + std::to_string(r.overflowed) + " probes)";
+        probe.calls = r.retiredCalls[i];
+        probe.cycles = r.retiredCycles[i];
+        for (std::size_t t = 0; t < r.threads.size(); ++t) {
+
+            probe.calls +=
+                r.threads[t]->calls[i].load(std::memory_order_relaxed);
+            probe.cycles +=
+                r.threads[t]->cycles[i].load(std::memory_order_relaxed);
+        }
+        stats.push_back(probe);
+    }
+#endif
+
+    return stats;
+}
+
+/**Sets every counter back to 0. Calls made by other threads while the
+counters are being reset may be lost*/
+inline void reset() {
+
+#ifdef UTILITRON_PROFILE
+    detail::Registry& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::fill(r.retiredCalls, r.retiredCalls + detail::MAX_PROBES, 0ULL);
+    std::fill(r.retiredCycles, r.retiredCycles + detail::MAX_PROBES, 0ULL);
+    for (std::size_t t = 0; t < r.threads.size(); ++t) {
+
+        for (std::size_t i = 0; i < detail::MAX_PROBES; ++i) {
+
+            r.threads[t]->calls[i].store(0, std::memory_order_relaxed);
+            r.threads[t]->cycles[i].store(0, std::memory_order_relaxed);
+        }
+    }
+#endif
+}
+
+/**Writes a table of the probe totals, busiest first
+@param output the stream to write the report to*/
+inline void report(std::ostream& output) {
+
+#ifdef UTILITRON_PROFILE
+    std::vector<ProbeStats> stats = collect();
+
+    //busiest first, by time when it is measured and by calls otherwise
+    std::stable_sort(stats.begin(), stats.end(),
+        [](const ProbeStats& a, const ProbeStats& b) {
+
+            return a.cycles != b.cycles ?
+                a.cycles > b.cycles : a.calls > b.calls;
+        });
+
+    output << std::left << std::setw(40) << "probe" << std::right <<
+        std::setw(16) << "calls" << std::setw(20) << "cycles" <<
+        std::setw(14) << "cycles/call" << std::endl;
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+
+        const ProbeStats& probe = stats[i];
+        output << std::left << std::setw(40) << probe.name << std::right <<
+            std::setw(16) << probe.calls << std::setw(20) << probe.cycles <<
+            std::setw(14) << (probe.calls > 0 ?
+                probe.cycles / probe.calls : 0ULL) << std::endl;
+    }
+#else
+    output << "profiling is disabled, define UTILITRON_PROFILE to enable it" <<
+        std::endl;
+#endif
+}
+
+} } //util //profile
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef UTILITRON_RANDOMUTIL_H_
+#   define UTILITRON_RANDOMUTIL_H_
+
+#include <cstdint>
+
+namespace util {
+
+/*****************************************************************************\
+| Seedable pseudo random number generation. Generators are identified by a    |
+| seed and a stream number: generators with the same seed and stream produce  |
+| the same sequence on every platform, and different streams of one seed are  |
+| uncorrelated, so each thread or each chunk of a parallel job can draw from  |
+| its own stream and still give results that do not depend on how the work is |
+| scheduled.                                                                  |
+\*****************************************************************************/
+namespace random {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Advances a SplitMix64 generator, which is used to expand seeds
+@param state the state of the generator
+@return the next output of the generator*/
+inline std::uint64_t splitMix64(std::uint64_t& state) {
+
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+/**Expands a seed and a stream number into the state of a xoshiro128 generator
+@param seed the seed
+@param stream the stream number
+@param state returns the four words of the state, never all zero*/
+inline void seedState(
+        std::uint64_t seed, std::uint64_t stream, std::uint32_t* state) {
+
+    //hash the stream first so that neighbouring streams start far apart
+    std::uint64_t s = stream;
+    s = seed ^ splitMix64(s);
+    std::uint64_t a = splitMix64(s);
+    std::uint64_t b = splitMix64(s);
+    state[0] = static_cast<std::uint32_t>(a);
+    state[1] = static_cast<std::uint32_t>(a >> 32);
+    state[2] = static_cast<std::uint32_t>(b);
+    state[3] = static_cast<std::uint32_t>(b >> 32);
+    if ((state[0] | state[1] | state[2] | state[3]) == 0) {
+
+        state[0] = 1;
+    }
+}
+
+/**@return x rotated left by k bits*/
+inline std::uint32_t rotateLeft(std::uint32_t x, unsigned k) {
+
+    return (x << k) | (x >> (32 - k));
+}
+
+/**Advances a xoshiro128++ generator
+@param s the four words of the state of the generator
+@return the next output of the generator*/
+inline std::uint32_t xoshiro128(std::uint32_t* s) {
+
+    std::uint32_t result = rotateLeft(s[0] + s[3], 7) + s[0];
+    std::uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotateLeft(s[3], 11);
+
+    return result;
+}
+
+/**@return a float in [0, 1) made from the top 24 bits of a random word*/
+inline float unitFloat(std::uint32_t bits) {
+
+    return static_cast<float>(static_cast<std::int32_t>(bits >> 8)) *
+        (1.0f / 16777216.0f);
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/****************************************************************************\
+| A xoshiro128++ generator: 128 bits of state, a period of 2^128 - 1, and 32 |
+| bit outputs of good quality in every bit. One generator must not be shared |
+| between threads, give each thread its own stream instead.                  |
+\****************************************************************************/
+class Xoshiro128 {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new generator
+    @param seed the seed of the generator
+    @param stream the stream of the seed to draw from*/
+    inline explicit Xoshiro128(
+            std::uint64_t seed, std::uint64_t stream = 0) {
+
+        detail::seedState(seed, stream, mState);
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the next 32 random bits*/
+    inline std::uint32_t next() {
+
+        return detail::xoshiro128(mState);
+    }
+
+    /**@return a uniformly distributed float in [0, 1)*/
+    inline float uniform() {
+
+        return detail::unitFloat(next());
+    }
+
+    /**@return a uniformly distributed float in [lower, upper)
+    @param lower the smallest value that can be returned
+    @param upper the bound the values are below*/
+    inline float uniform(float lower, float upper) {
+
+        return lower + (upper - lower) * uniform();
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the state of the generator
+    std::uint32_t mState[4];
+};
+
+} } //util //random
+
+#endif
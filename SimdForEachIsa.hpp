@@ -0,0 +1,76 @@
+//no include guard: this file is included once by every kernel header
+
+/*****************************************************************************\
+| Compiles a file of kernel bodies once for each instruction set. Define      |
+| UTIL_SIMD_KERNELS as the path of the kernel file (relative to this file)    |
+| and include this file inside the namespace the kernels should live in. Each |
+| copy of the kernels is placed in a namespace named after its instruction    |
+| set (scalar, sse2, sse41, avx2, and avx512) where Pack is the pack type of  |
+| that instruction set. The kernel file must not include any headers itself.  |
+| Kernels are then called through UTIL_SIMD_DISPATCH.                         |
+\*****************************************************************************/
+
+#ifndef UTIL_SIMD_KERNELS
+#   error "UTIL_SIMD_KERNELS must be defined before including SimdForEachIsa"
+#endif
+
+namespace scalar {
+
+typedef util::simd::PackScalar Pack;
+
+#include UTIL_SIMD_KERNELS
+
+} //scalar
+
+#ifdef UTIL_SIMD_X86
+
+UTIL_SIMD_BEGIN_TARGET(UTIL_SIMD_TARGET_SSE2)
+namespace sse2 {
+
+typedef util::simd::PackSse2 Pack;
+
+#include UTIL_SIMD_KERNELS
+
+} //sse2
+UTIL_SIMD_END_TARGET
+
+UTIL_SIMD_BEGIN_TARGET(UTIL_SIMD_TARGET_SSE41)
+namespace sse41 {
+
+typedef util::simd::PackSse41 Pack;
+
+#include UTIL_SIMD_KERNELS
+
+} //sse41
+UTIL_SIMD_END_TARGET
+
+UTIL_SIMD_BEGIN_TARGET(UTIL_SIMD_TARGET_AVX2)
+namespace avx2 {
+
+typedef util::simd::PackAvx2 Pack;
+
+#include UTIL_SIMD_KERNELS
+
+} //avx2
+UTIL_SIMD_END_TARGET
+
+UTIL_SIMD_BEGIN_TARGET(UTIL_SIMD_TARGET_AVX512)
+namespace avx512 {
+
+typedef util::simd::PackAvx512 Pack;
+
+#include UTIL_SIMD_KERNELS
+
+} //avx512
+UTIL_SIMD_END_TARGET
+
+#else
+
+namespace sse2 = scalar;
+namespace sse41 = scalar;
+namespace avx2 = scalar;
+namespace avx512 = scalar;
+
+#endif
+
+#undef UTIL_SIMD_KERNELS
@@ -0,0 +1,1392 @@
+#ifndef UTILITRON_SIMDUTIL_H_
+#   define UTILITRON_SIMDUTIL_H_
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#   define UTIL_SIMD_X86
+#   include <immintrin.h>
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif
+
+//------------------------------------------------------------------------------
+//                                TARGET REGIONS
+//------------------------------------------------------------------------------
+// Functions defined between UTIL_SIMD_BEGIN_TARGET and UTIL_SIMD_END_TARGET are
+// compiled for the given instruction set regardless of the compiler flags. MSVC
+// allows intrinsics everywhere so the regions are empty there.
+
+#define UTIL_SIMD_PRAGMA(x) _Pragma(#x)
+
+#if defined(__clang__)
+#   define UTIL_SIMD_BEGIN_TARGET(t) UTIL_SIMD_PRAGMA(clang attribute push( \
+        __attribute__((target(t))), apply_to = function))
+#   define UTIL_SIMD_END_TARGET UTIL_SIMD_PRAGMA(clang attribute pop)
+#elif defined(__GNUC__)
+//GCC 12 raises false uninitialised warnings inside its own AVX-512 intrinsics
+#   define UTIL_SIMD_BEGIN_TARGET(t) \
+        UTIL_SIMD_PRAGMA(GCC push_options) UTIL_SIMD_PRAGMA(GCC target(t)) \
+        UTIL_SIMD_PRAGMA(GCC diagnostic push) \
+        UTIL_SIMD_PRAGMA(GCC diagnostic ignored "-Wmaybe-uninitialized") \
+        UTIL_SIMD_PRAGMA(GCC diagnostic ignored "-Wuninitialized")
+#   define UTIL_SIMD_END_TARGET \
+        UTIL_SIMD_PRAGMA(GCC diagnostic pop) UTIL_SIMD_PRAGMA(GCC pop_options)
+#else
+#   define UTIL_SIMD_BEGIN_TARGET(t)
+#   define UTIL_SIMD_END_TARGET
+#endif
+
+#define UTIL_SIMD_TARGET_SSE2   "sse2"
+#define UTIL_SIMD_TARGET_SSE41  "sse2,ssse3,sse4.1"
+#define UTIL_SIMD_TARGET_AVX2   "sse2,ssse3,sse4.1,avx,avx2,fma"
+#define UTIL_SIMD_TARGET_AVX512 \
+    "sse2,ssse3,sse4.1,avx,avx2,fma,avx512f,avx512dq,avx512bw,avx512vl"
+
+/**Selects the variant of a kernel compiled by SimdForEachIsa.hpp for the active
+instruction set
+@param ns the namespace SimdForEachIsa.hpp was included in
+@param fn the name of the kernel*/
+#define UTIL_SIMD_DISPATCH(ns, fn) \
+    util::simd::select(&ns::scalar::fn, &ns::sse2::fn, &ns::sse41::fn, \
+        &ns::avx2::fn, &ns::avx512::fn)
+
+namespace util {
+
+/*****************************************************************************\
+| Runtime CPU feature detection and SIMD kernel dispatch. Kernels are         |
+| compiled once for each supported instruction set (see SimdForEachIsa.hpp)   |
+| and the variant that matches the running CPU is selected the first time any |
+| kernel is called. The selection can be overridden with forceIsa() or by     |
+| setting the UTILITRON_SIMD_ISA environment variable to scalar, sse2, sse41, |
+| avx2, or avx512.                                                            |
+\*****************************************************************************/
+namespace simd {
+
+//------------------------------------------------------------------------------
+//                                  ENUMERATORS
+//------------------------------------------------------------------------------
+
+/**The instruction sets kernels are compiled for, ordered from least to most
+capable*/
+enum Isa {
+
+    ISA_SCALAR = 0,
+    ISA_SSE2,
+    ISA_SSE41,
+    ISA_AVX2,
+    ISA_AVX512,
+    ISA_COUNT
+};
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/***************************************************************************\
+| The instruction set extensions supported by the running CPU and operating |
+| system.                                                                   |
+\***************************************************************************/
+struct CpuFeatures {
+
+    //!SSE2 is supported
+    bool sse2;
+    //!SSE4.1 is supported
+    bool sse41;
+    //!AVX is supported and the OS saves the ymm registers
+    bool avx;
+    //!AVX2 is supported
+    bool avx2;
+    //!fused multiply-add is supported
+    bool fma;
+    //!BMI2 (pdep/pext) is supported
+    bool bmi2;
+    //!AVX-512 F, DQ, BW, and VL are supported and the OS saves the zmm
+    //!registers
+    bool avx512;
+};
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+#ifdef UTIL_SIMD_X86
+
+/**Executes the cpuid instruction
+@param leaf the cpuid leaf to query
+@param subleaf the cpuid sub-leaf to query
+@param regs returns eax, ebx, ecx, and edx*/
+inline void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+
+#   if defined(_MSC_VER)
+
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (unsigned i = 0; i < 4; ++i) {
+
+        regs[i] = static_cast<unsigned>(r[i]);
+    }
+#   else
+
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]);
+#   endif
+}
+
+/**@return the extended control register that lists the register states the
+operating system saves on context switches*/
+inline unsigned long long xgetbv() {
+
+#   if defined(_MSC_VER)
+
+    return _xgetbv(0);
+#   else
+
+    unsigned eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#   endif
+}
+
+#endif
+
+/**@return the features of the running CPU*/
+inline CpuFeatures queryCpuFeatures() {
+
+    CpuFeatures features;
+    std::memset(&features, 0, sizeof(features));
+
+#ifdef UTIL_SIMD_X86
+
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    unsigned maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+
+        return features;
+    }
+
+    cpuid(1, 0, regs);
+    features.sse2  = (regs[3] & (1u << 26)) != 0;
+    features.sse41 = (regs[2] & (1u << 19)) != 0;
+
+    //the wide registers are only usable if the OS saves them
+    bool osxsave = (regs[2] & (1u << 27)) != 0;
+    unsigned long long xcr0 = osxsave ? xgetbv() : 0;
+    bool ymmSaved = (xcr0 & 0x6) == 0x6;
+    bool zmmSaved = (xcr0 & 0xE6) == 0xE6;
+
+    features.avx = ymmSaved && (regs[2] & (1u << 28)) != 0;
+    features.fma = features.avx && (regs[2] & (1u << 12)) != 0;
+
+    if (maxLeaf >= 7) {
+
+        cpuid(7, 0, regs);
+        features.avx2 = features.avx && (regs[1] & (1u << 5)) != 0;
+        features.bmi2 = (regs[1] & (1u << 8)) != 0;
+
+        const unsigned avx512Bits =
+            (1u << 16) | // F
+            (1u << 17) | // DQ
+            (1u << 30) | // BW
+            (1u << 31);  // VL
+        features.avx512 = zmmSaved && features.avx2 && features.fma &&
+            (regs[1] & avx512Bits) == avx512Bits;
+    }
+#endif
+
+    return features;
+}
+
+/**@return the instruction set named by the given string, or ISA_COUNT if the
+string does not name an instruction set*/
+inline Isa parseIsa(const char* name) {
+
+    static const char* const names[ISA_COUNT] =
+        { "scalar", "sse2", "sse41", "avx2", "avx512" };
+
+    for (int i = 0; i < ISA_COUNT; ++i) {
+
+        if (std::strcmp(name, names[i]) == 0) {
+
+            return static_cast<Isa>(i);
+        }
+    }
+
+    return ISA_COUNT;
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return the instruction set extensions supported by the running CPU. The
+CPU is only queried the first time this is called*/
+inline const CpuFeatures& cpuFeatures() {
+
+    static const CpuFeatures features = detail::queryCpuFeatures();
+
+    return features;
+}
+
+/**@return the most capable instruction set the running CPU supports*/
+inline Isa detectIsa() {
+
+    const CpuFeatures& features = cpuFeatures();
+
+    //AVX2 kernels are also compiled with FMA, every AVX2 CPU in practice has
+    //both but check anyway
+    if (features.avx512) {
+
+        return ISA_AVX512;
+    }
+    if (features.avx2 && features.fma) {
+
+        return ISA_AVX2;
+    }
+    if (features.sse41) {
+
+        return ISA_SSE41;
+    }
+    if (features.sse2) {
+
+        return ISA_SSE2;
+    }
+
+    return ISA_SCALAR;
+}
+
+/**@return the name of the given instruction set*/
+inline const char* isaName(Isa isa) {
+
+    switch (isa) {
+
+        case ISA_SCALAR: {
+
+            return "scalar";
+        }
+        case ISA_SSE2: {
+
+            return "sse2";
+        }
+        case ISA_SSE41: {
+
+            return "sse41";
+        }
+        case ISA_AVX2: {
+
+            return "avx2";
+        }
+        case ISA_AVX512: {
+
+            return "avx512";
+        }
+        default: {
+
+            return "unknown";
+        }
+    }
+}
+
+namespace detail {
+
+/**@return the instruction set to use when no override has been forced: the
+UTILITRON_SIMD_ISA environment variable if it is set, otherwise the most
+capable instruction set the CPU supports*/
+inline Isa defaultIsa() {
+
+    Isa detected = detectIsa();
+
+    const char* env = std::getenv("UTILITRON_SIMD_ISA");
+    if (env) {
+
+        Isa requested = parseIsa(env);
+        if (requested < detected) {
+
+            return requested;
+        }
+    }
+
+    return detected;
+}
+
+/**@return the storage of the selected instruction set*/
+inline std::atomic<int>& selectedIsa() {
+
+    static std::atomic<int> isa(defaultIsa());
+
+    return isa;
+}
+
+} //detail
+
+/**@return the instruction set kernels are currently dispatched to*/
+inline Isa activeIsa() {
+
+    return static_cast<Isa>(
+        detail::selectedIsa().load(std::memory_order_relaxed));
+}
+
+/**Forces kernels to be dispatched to the given instruction set, this is
+intended for testing and benchmarking the individual variants. The
+instruction set is clamped to the most capable one the CPU supports
+@param isa the instruction set to dispatch to
+@return the instruction set that is now active*/
+inline Isa forceIsa(Isa isa) {
+
+    Isa detected = detectIsa();
+    if (isa > detected) {
+
+        isa = detected;
+    }
+    detail::selectedIsa().store(isa, std::memory_order_relaxed);
+
+    return isa;
+}
+
+/**Removes any override applied by forceIsa() so that kernels are dispatched to
+the default instruction set again*/
+inline void resetIsa() {
+
+    detail::selectedIsa().store(
+        detail::defaultIsa(), std::memory_order_relaxed);
+}
+
+/**Selects the variant of a kernel for the active instruction set
+@param scalar the portable variant
+@param sse2 the SSE2 variant
+@param sse41 the SSE4.1 variant
+@param avx2 the AVX2 variant
+@param avx512 the AVX-512 variant
+@return the variant to call*/
+template<typename Kernel>
+inline Kernel select(
+        Kernel scalar,
+        Kernel sse2,
+        Kernel sse41,
+        Kernel avx2,
+        Kernel avx512) {
+
+    switch (activeIsa()) {
+
+        case ISA_AVX512: {
+
+            return avx512;
+        }
+        case ISA_AVX2: {
+
+            return avx2;
+        }
+        case ISA_SSE41: {
+
+            return sse41;
+        }
+        case ISA_SSE2: {
+
+            return sse2;
+        }
+        default: {
+
+            return scalar;
+        }
+    }
+}
+
+/**@return the index of the lowest set bit of a non-zero mask, such as the
+byte mask bits of a block*/
+inline unsigned lowestSetBit(std::uint64_t bits) {
+
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+
+    return static_cast<unsigned>(index);
+#else
+    unsigned index = 0;
+    while (!(bits & 1u)) {
+
+        bits >>= 1;
+        ++index;
+    }
+
+    return index;
+#endif
+}
+
+/**@return the number of set bits of a mask*/
+inline unsigned countSetBits(std::uint64_t bits) {
+
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_popcountll(bits));
+#else
+    bits -= (bits >> 1) & 0x5555555555555555ull;
+    bits = (bits & 0x3333333333333333ull) +
+        ((bits >> 2) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+
+    return static_cast<unsigned>((bits * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+//------------------------------------------------------------------------------
+//                                     PACKS
+//------------------------------------------------------------------------------
+// A pack wraps the widest float register of an instruction set behind a common
+// interface so that a kernel body can be written once and compiled for every
+// instruction set. Masks are the result of comparisons, combined with maskAnd()
+// and consumed by select(). fmadd() rounds once where FUSED is true and rounds
+// the product and then the sum otherwise. Blocks are the same register seen as
+// BLOCK_BYTES bytes for text and other byte data, blockEqual() gives a mask of
+// the matching bytes and blockMaskBits() turns it into one bit per byte with
+// the first byte in the lowest bit. Byte comparisons and arithmetic are
+// unsigned and wrap, except blockSubSaturate() which stops at zero.
+
+/**************************************************************************\
+| A single float, used by the portable kernels and the scalar tails of the |
+| wider kernels.                                                           |
+\**************************************************************************/
+struct PackScalar {
+
+    typedef float Type;
+    typedef bool Mask;
+
+    static const unsigned WIDTH = 1;
+    static const bool FUSED = false;
+
+    static inline Type zero() { return 0.0f; }
+    static inline Type set(float v) { return v; }
+    static inline Type load(const float* p) { return *p; }
+    static inline void store(float* p, Type v) { *p = v; }
+
+    static inline Type add(Type a, Type b) { return a + b; }
+    static inline Type sub(Type a, Type b) { return a - b; }
+    static inline Type mul(Type a, Type b) { return a * b; }
+    static inline Type div(Type a, Type b) { return a / b; }
+    static inline Type fmadd(Type a, Type b, Type c) { return a * b + c; }
+    static inline Type sqrt(Type v) { return std::sqrt(v); }
+    static inline Type abs(Type v) { return std::fabs(v); }
+    static inline Type floor(Type v) { return std::floor(v); }
+    static inline Type min(Type a, Type b) { return b < a ? b : a; }
+    static inline Type max(Type a, Type b) { return a < b ? b : a; }
+
+    static inline Mask cmpLt(Type a, Type b) { return a < b; }
+    static inline Mask cmpLe(Type a, Type b) { return a <= b; }
+    static inline Type select(Mask m, Type a, Type b) { return m ? a : b; }
+    static inline Mask maskAnd(Mask a, Mask b) { return a && b; }
+    static inline unsigned maskBits(Mask m) { return m ? 1u : 0u; }
+
+    static inline float hsum(Type v) { return v; }
+    static inline float hmin(Type v) { return v; }
+    static inline float hmax(Type v) { return v; }
+
+    typedef std::uint64_t Block;
+    typedef std::uint64_t BlockMask;
+
+    static const unsigned BLOCK_BYTES = 8;
+
+    static inline Block setBlock(unsigned char v) {
+
+        return 0x0101010101010101ull * v;
+    }
+    static inline Block loadBlock(const unsigned char* p) {
+
+        Block b;
+        std::memcpy(&b, p, sizeof(b));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        b = __builtin_bswap64(b);
+#endif
+
+        return b;
+    }
+    static inline BlockMask blockEqual(Block a, Block b) {
+
+        //the high bit of each byte that is zero after the xor
+        const Block low = 0x7F7F7F7F7F7F7F7Full;
+        Block x = a ^ b;
+
+        return ~(((x & low) + low) | x | low);
+    }
+    static inline BlockMask blockMaskAnd(BlockMask a, BlockMask b) {
+
+        return a & b;
+    }
+    static inline BlockMask blockMaskOr(BlockMask a, BlockMask b) {
+
+        return a | b;
+    }
+    static inline std::uint64_t blockMaskBits(BlockMask m) {
+
+        //gathers the high bit of each byte into the top byte
+        return ((m >> 7) * 0x0102040810204080ull) >> 56;
+    }
+
+    static inline void storeBlock(unsigned char* p, Block v) {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        v = __builtin_bswap64(v);
+#endif
+        std::memcpy(p, &v, sizeof(v));
+    }
+    static inline Block blockAnd(Block a, Block b) { return a & b; }
+    static inline Block blockOr(Block a, Block b) { return a | b; }
+    static inline Block blockXor(Block a, Block b) { return a ^ b; }
+    static inline Block blockSub(Block a, Block b) {
+
+        //subtracts the low 7 bits without borrowing across bytes, then fixes
+        //the high bits
+        const Block high = 0x8080808080808080ull;
+
+        return ((a | high) - (b & ~high)) ^ ((a ^ ~b) & high);
+    }
+    static inline Block blockHighNibbles(Block v) {
+
+        return (v >> 4) & 0x0F0F0F0F0F0F0F0Full;
+    }
+    static inline BlockMask blockAtMost(Block a, Block b) {
+
+        //the high bit compares the low 7 bits, unless the high bits differ
+        const Block high = 0x8080808080808080ull;
+        Block low = (b | high) - (a & ~high);
+
+        return ((b & ~a) | (~(a ^ b) & low)) & high;
+    }
+    static inline Block blockSubSaturate(Block a, Block b) {
+
+        //keeps the difference of the bytes where b is at most a
+        return blockSub(a, b) & ((blockAtMost(b, a) >> 7) * 0xFF);
+    }
+    static inline Block blockSelect(BlockMask m, Block a, Block b) {
+
+        Block whole = (m >> 7) * 0xFF;
+
+        return (a & whole) | (b & ~whole);
+    }
+    static inline bool blockAny(Block v) { return v != 0; }
+    static inline std::uint64_t blockHighBits(Block v) {
+
+        return blockMaskBits(v & 0x8080808080808080ull);
+    }
+
+    /**Replaces each byte, which must be less than 16, with that entry of a
+    16 byte table*/
+    static inline Block blockLookup(const unsigned char* table, Block v) {
+
+        Block r = 0;
+        for (unsigned i = 0; i < 64; i += 8) {
+
+            r |= static_cast<Block>(table[(v >> i) & 0x0F]) << i;
+        }
+
+        return r;
+    }
+
+    /**Shifts bytes from the end of the previous block into the front of the
+    current one, so byte i holds the byte K before it in the data*/
+    template<unsigned K>
+    static inline Block blockPrevious(Block current, Block previous) {
+
+        return (current << (8 * K)) | (previous >> (64 - 8 * K));
+    }
+
+    /**Loads WIDTH bytes as floats*/
+    static inline Type loadBytes(const unsigned char* p) { return *p; }
+
+    /**Stores each lane rounded to the nearest integer as a byte, saturating
+    at 0 and 255*/
+    static inline void storeBytes(unsigned char* p, Type v) {
+
+        long i = std::lrint(v);
+        *p = static_cast<unsigned char>(i < 0 ? 0 : (i > 255 ? 255 : i));
+    }
+
+    /**Loads the components of WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void loadInterleaved(const float* p, Type* c) {
+
+        for (unsigned i = 0; i < N; ++i) {
+
+            c[i] = p[i];
+        }
+    }
+
+    /**Stores components as WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void storeInterleaved(float* p, const Type* c) {
+
+        for (unsigned i = 0; i < N; ++i) {
+
+            p[i] = c[i];
+        }
+    }
+    /**Loads the components of the WIDTH N component vectors of the array at
+    the given indices*/
+    template<unsigned N>
+    static inline void gatherInterleaved(
+            const float* base, const unsigned* indices, Type* c) {
+
+        for (unsigned i = 0; i < N; ++i) {
+
+            c[i] = base[indices[0] * N + i];
+        }
+    }
+};
+
+#ifdef UTIL_SIMD_X86
+
+UTIL_SIMD_BEGIN_TARGET(UTIL_SIMD_TARGET_SSE2)
+
+/*********************************\
+| Four floats in an SSE register. |
+\*********************************/
+struct PackSse2 {
+
+    typedef __m128 Type;
+    typedef __m128 Mask;
+
+    static const unsigned WIDTH = 4;
+    static const bool FUSED = false;
+
+    static inline Type zero() { return _mm_setzero_ps(); }
+    static inline Type set(float v) { return _mm_set1_ps(v); }
+    static inline Type load(const float* p) { return _mm_loadu_ps(p); }
+    static inline void store(float* p, Type v) { _mm_storeu_ps(p, v); }
+
+    static inline Type add(Type a, Type b) { return _mm_add_ps(a, b); }
+    static inline Type sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+    static inline Type mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+    static inline Type div(Type a, Type b) { return _mm_div_ps(a, b); }
+    static inline Type fmadd(Type a, Type b, Type c) {
+
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+    static inline Type sqrt(Type v) { return _mm_sqrt_ps(v); }
+    static inline Type abs(Type v) {
+
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    }
+    static inline Type floor(Type v) {
+
+        //truncate then step down for negative fractions, values too large to
+        //convert are already whole numbers
+        Type t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+        t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.0f)));
+
+        return select(_mm_cmplt_ps(abs(v), _mm_set1_ps(8388608.0f)), t, v);
+    }
+    static inline Type min(Type a, Type b) { return _mm_min_ps(a, b); }
+    static inline Type max(Type a, Type b) { return _mm_max_ps(a, b); }
+
+    static inline Mask cmpLt(Type a, Type b) { return _mm_cmplt_ps(a, b); }
+    static inline Mask cmpLe(Type a, Type b) { return _mm_cmple_ps(a, b); }
+    static inline Type select(Mask m, Type a, Type b) {
+
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+    static inline Mask maskAnd(Mask a, Mask b) { return _mm_and_ps(a, b); }
+    static inline unsigned maskBits(Mask m) {
+
+        return static_cast<unsigned>(_mm_movemask_ps(m));
+    }
+
+    static inline float hsum(Type v) {
+
+        Type s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+
+        return _mm_cvtss_f32(s);
+    }
+    static inline float hmin(Type v) {
+
+        Type s = _mm_min_ps(v, _mm_movehl_ps(v, v));
+        s = _mm_min_ss(s, _mm_shuffle_ps(s, s, 1));
+
+        return _mm_cvtss_f32(s);
+    }
+    static inline float hmax(Type v) {
+
+        Type s = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        s = _mm_max_ss(s, _mm_shuffle_ps(s, s, 1));
+
+        return _mm_cvtss_f32(s);
+    }
+
+    typedef __m128i Block;
+    typedef __m128i BlockMask;
+
+    static const unsigned BLOCK_BYTES = 16;
+
+    static inline Block setBlock(unsigned char v) {
+
+        return _mm_set1_epi8(static_cast<char>(v));
+    }
+    static inline Block loadBlock(const unsigned char* p) {
+
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    static inline BlockMask blockEqual(Block a, Block b) {
+
+        return _mm_cmpeq_epi8(a, b);
+    }
+    static inline BlockMask blockMaskAnd(BlockMask a, BlockMask b) {
+
+        return _mm_and_si128(a, b);
+    }
+    static inline BlockMask blockMaskOr(BlockMask a, BlockMask b) {
+
+        return _mm_or_si128(a, b);
+    }
+    static inline std::uint64_t blockMaskBits(BlockMask m) {
+
+        return static_cast<unsigned>(_mm_movemask_epi8(m));
+    }
+
+    static inline void storeBlock(unsigned char* p, Block v) {
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+    static inline Block blockAnd(Block a, Block b) {
+
+        return _mm_and_si128(a, b);
+    }
+    static inline Block blockOr(Block a, Block b) { return _mm_or_si128(a, b); }
+    static inline Block blockXor(Block a, Block b) {
+
+        return _mm_xor_si128(a, b);
+    }
+    static inline Block blockSub(Block a, Block b) {
+
+        return _mm_sub_epi8(a, b);
+    }
+    static inline Block blockSubSaturate(Block a, Block b) {
+
+        return _mm_subs_epu8(a, b);
+    }
+    static inline Block blockHighNibbles(Block v) {
+
+        return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+    }
+    static inline BlockMask blockAtMost(Block a, Block b) {
+
+        return _mm_cmpeq_epi8(_mm_min_epu8(a, b), a);
+    }
+    static inline Block blockSelect(BlockMask m, Block a, Block b) {
+
+        return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+    }
+    static inline bool blockAny(Block v) {
+
+        return _mm_movemask_epi8(
+            _mm_cmpeq_epi8(v, _mm_setzero_si128())) != 0xFFFF;
+    }
+    static inline std::uint64_t blockHighBits(Block v) {
+
+        return static_cast<unsigned>(_mm_movemask_epi8(v));
+    }
+
+    /**Replaces each byte, which must be less than 16, with that entry of a
+    16 byte table. SSE2 has no byte shuffle so this goes through memory*/
+    static inline Block blockLookup(const unsigned char* table, Block v) {
+
+        unsigned char bytes[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), v);
+        for (unsigned i = 0; i < 16; ++i) {
+
+            bytes[i] = table[bytes[i]];
+        }
+
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    }
+
+    /**Shifts bytes from the end of the previous block into the front of the
+    current one, so byte i holds the byte K before it in the data*/
+    template<unsigned K>
+    static inline Block blockPrevious(Block current, Block previous) {
+
+        return _mm_or_si128(
+            _mm_slli_si128(current, K), _mm_srli_si128(previous, 16 - K));
+    }
+
+    /**Loads WIDTH bytes as floats*/
+    static inline Type loadBytes(const unsigned char* p) {
+
+        int bytes;
+        std::memcpy(&bytes, p, sizeof(bytes));
+        __m128i zero = _mm_setzero_si128();
+        __m128i i = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+
+        return _mm_cvtepi32_ps(_mm_unpacklo_epi16(i, zero));
+    }
+
+    /**Stores each lane rounded to the nearest integer as a byte, saturating
+    at 0 and 255*/
+    static inline void storeBytes(unsigned char* p, Type v) {
+
+        __m128i i = _mm_cvtps_epi32(v);
+        i = _mm_packs_epi32(i, i);
+        int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(i, i));
+        std::memcpy(p, &bytes, sizeof(bytes));
+    }
+
+    /**Loads the components of WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void loadInterleaved(const float* p, Type* c) {
+
+        for (unsigned i = 0; i < N; ++i) {
+
+            c[i] = _mm_setr_ps(p[i], p[N + i], p[2 * N + i], p[3 * N + i]);
+        }
+    }
+
+    /**Stores components as WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void storeInterleaved(float* p, const Type* c) {
+
+        float t[N][WIDTH];
+        for (unsigned i = 0; i < N; ++i) {
+
+            _mm_storeu_ps(t[i], c[i]);
+        }
+        for (unsigned j = 0; j < WIDTH; ++j) {
+
+            for (unsigned i = 0; i < N; ++i) {
+
+                p[j * N + i] = t[i][j];
+            }
+        }
+    }
+
+    /**Loads the components of the WIDTH N component vectors of the array at
+    the given indices*/
+    template<unsigned N>
+    static inline void gatherInterleaved(
+            const float* base, const unsigned* indices, Type* c) {
+
+        for (unsigned i = 0; i < N; ++i) {
+
+            c[i] = _mm_setr_ps(
+                base[indices[0] * N + i], base[indices[1] * N + i],
+                base[indices[2] * N + i], base[indices[3] * N + i]);
+        }
+    }
+};
+
+UTIL_SIMD_END_TARGET
+
+UTIL_SIMD_BEGIN_TARGET(UTIL_SIMD_TARGET_SSE41)
+
+/*******************************************************\
+| Four floats in an SSE register using SSE4.1 blending. |
+\*******************************************************/
+struct PackSse41 : public PackSse2 {
+
+    static inline Type select(Mask m, Type a, Type b) {
+
+        return _mm_blendv_ps(b, a, m);
+    }
+    static inline Type floor(Type v) { return _mm_floor_ps(v); }
+
+    static inline Block blockSelect(BlockMask m, Block a, Block b) {
+
+        return _mm_blendv_epi8(b, a, m);
+    }
+    static inline bool blockAny(Block v) { return !_mm_testz_si128(v, v); }
+
+    /**Replaces each byte, which must be less than 16, with that entry of a
+    16 byte table*/
+    static inline Block blockLookup(const unsigned char* table, Block v) {
+
+        return _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)), v);
+    }
+
+    /**Shifts bytes from the end of the previous block into the front of the
+    current one, so byte i holds the byte K before it in the data*/
+    template<unsigned K>
+    static inline Block blockPrevious(Block current, Block previous) {
+
+        return _mm_alignr_epi8(current, previous, 16 - K);
+    }
+
+    /**Loads the components of WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void loadInterleaved(const float* p, Type* c) {
+
+        for (unsigned i = 0; i < N; ++i) {
+
+            Type v = _mm_load_ss(p + i);
+            v = _mm_insert_ps(v, _mm_load_ss(p + N + i), 0x10);
+            v = _mm_insert_ps(v, _mm_load_ss(p + 2 * N + i), 0x20);
+            c[i] = _mm_insert_ps(v, _mm_load_ss(p + 3 * N + i), 0x30);
+        }
+    }
+};
+
+UTIL_SIMD_END_TARGET
+
+UTIL_SIMD_BEGIN_TARGET(UTIL_SIMD_TARGET_AVX2)
+
+/***********************************\
+| Eight floats in an AVX2 register. |
+\***********************************/
+struct PackAvx2 {
+
+    typedef __m256 Type;
+    typedef __m256 Mask;
+
+    static const unsigned WIDTH = 8;
+    static const bool FUSED = true;
+
+    static inline Type zero() { return _mm256_setzero_ps(); }
+    static inline Type set(float v) { return _mm256_set1_ps(v); }
+    static inline Type load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void store(float* p, Type v) { _mm256_storeu_ps(p, v); }
+
+    static inline Type add(Type a, Type b) { return _mm256_add_ps(a, b); }
+    static inline Type sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+    static inline Type mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+    static inline Type div(Type a, Type b) { return _mm256_div_ps(a, b); }
+    static inline Type fmadd(Type a, Type b, Type c) {
+
+        return _mm256_fmadd_ps(a, b, c);
+    }
+    static inline Type sqrt(Type v) { return _mm256_sqrt_ps(v); }
+    static inline Type abs(Type v) {
+
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+    }
+    static inline Type floor(Type v) { return _mm256_floor_ps(v); }
+    static inline Type min(Type a, Type b) { return _mm256_min_ps(a, b); }
+    static inline Type max(Type a, Type b) { return _mm256_max_ps(a, b); }
+
+    static inline Mask cmpLt(Type a, Type b) {
+
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    static inline Mask cmpLe(Type a, Type b) {
+
+        return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+    }
+    static inline Type select(Mask m, Type a, Type b) {
+
+        return _mm256_blendv_ps(b, a, m);
+    }
+    static inline Mask maskAnd(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+    static inline unsigned maskBits(Mask m) {
+
+        return static_cast<unsigned>(_mm256_movemask_ps(m));
+    }
+
+    static inline float hsum(Type v) {
+
+        return PackSse2::hsum(_mm_add_ps(
+            _mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+    static inline float hmin(Type v) {
+
+        return PackSse2::hmin(_mm_min_ps(
+            _mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+    static inline float hmax(Type v) {
+
+        return PackSse2::hmax(_mm_max_ps(
+            _mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+
+    typedef __m256i Block;
+    typedef __m256i BlockMask;
+
+    static const unsigned BLOCK_BYTES = 32;
+
+    static inline Block setBlock(unsigned char v) {
+
+        return _mm256_set1_epi8(static_cast<char>(v));
+    }
+    static inline Block loadBlock(const unsigned char* p) {
+
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    static inline BlockMask blockEqual(Block a, Block b) {
+
+        return _mm256_cmpeq_epi8(a, b);
+    }
+    static inline BlockMask blockMaskAnd(BlockMask a, BlockMask b) {
+
+        return _mm256_and_si256(a, b);
+    }
+    static inline BlockMask blockMaskOr(BlockMask a, BlockMask b) {
+
+        return _mm256_or_si256(a, b);
+    }
+    static inline std::uint64_t blockMaskBits(BlockMask m) {
+
+        return static_cast<unsigned>(_mm256_movemask_epi8(m));
+    }
+
+    static inline void storeBlock(unsigned char* p, Block v) {
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+    static inline Block blockAnd(Block a, Block b) {
+
+        return _mm256_and_si256(a, b);
+    }
+    static inline Block blockOr(Block a, Block b) {
+
+        return _mm256_or_si256(a, b);
+    }
+    static inline Block blockXor(Block a, Block b) {
+
+        return _mm256_xor_si256(a, b);
+    }
+    static inline Block blockSub(Block a, Block b) {
+
+        return _mm256_sub_epi8(a, b);
+    }
+    static inline Block blockSubSaturate(Block a, Block b) {
+
+        return _mm256_subs_epu8(a, b);
+    }
+    static inline Block blockHighNibbles(Block v) {
+
+        return _mm256_and_si256(
+            _mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+    }
+    static inline BlockMask blockAtMost(Block a, Block b) {
+
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(a, b), a);
+    }
+    static inline Block blockSelect(BlockMask m, Block a, Block b) {
+
+        return _mm256_blendv_epi8(b, a, m);
+    }
+    static inline bool blockAny(Block v) { return !_mm256_testz_si256(v, v); }
+    static inline std::uint64_t blockHighBits(Block v) {
+
+        return static_cast<unsigned>(_mm256_movemask_epi8(v));
+    }
+
+    /**Replaces each byte, which must be less than 16, with that entry of a
+    16 byte table*/
+    static inline Block blockLookup(const unsigned char* table, Block v) {
+
+        return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table))), v);
+    }
+
+    /**Shifts bytes from the end of the previous block into the front of the
+    current one, so byte i holds the byte K before it in the data*/
+    template<unsigned K>
+    static inline Block blockPrevious(Block current, Block previous) {
+
+        return _mm256_alignr_epi8(current,
+            _mm256_permute2x128_si256(previous, current, 0x21), 16 - K);
+    }
+
+    /**Loads WIDTH bytes as floats*/
+    static inline Type loadBytes(const unsigned char* p) {
+
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+
+        return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+    }
+
+    /**Stores each lane rounded to the nearest integer as a byte, saturating
+    at 0 and 255*/
+    static inline void storeBytes(unsigned char* p, Type v) {
+
+        __m256i i = _mm256_cvtps_epi32(v);
+        __m128i words = _mm_packs_epi32(
+            _mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p),
+            _mm_packus_epi16(words, words));
+    }
+
+    /**Loads the components of WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void loadInterleaved(const float* p, Type* c) {
+
+        const __m256i index = _mm256_mullo_epi32(
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(N));
+        for (unsigned i = 0; i < N; ++i) {
+
+            c[i] = _mm256_i32gather_ps(p + i, index, 4);
+        }
+    }
+
+    /**Stores components as WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void storeInterleaved(float* p, const Type* c) {
+
+        float t[N][WIDTH];
+        for (unsigned i = 0; i < N; ++i) {
+
+            _mm256_storeu_ps(t[i], c[i]);
+        }
+        for (unsigned j = 0; j < WIDTH; ++j) {
+
+            for (unsigned i = 0; i < N; ++i) {
+
+                p[j * N + i] = t[i][j];
+            }
+        }
+    }
+
+    /**Loads the components of the WIDTH N component vectors of the array at
+    the given indices, the indices multiplied by N must fit in an int*/
+    template<unsigned N>
+    static inline void gatherInterleaved(
+            const float* base, const unsigned* indices, Type* c) {
+
+        const __m256i index = _mm256_mullo_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)),
+            _mm256_set1_epi32(N));
+        for (unsigned i = 0; i < N; ++i) {
+
+            c[i] = _mm256_i32gather_ps(base + i, index, 4);
+        }
+    }
+};
+
+UTIL_SIMD_END_TARGET
+
+UTIL_SIMD_BEGIN_TARGET(UTIL_SIMD_TARGET_AVX512)
+
+/****************************************\
+| Sixteen floats in an AVX-512 register. |
+\****************************************/
+struct PackAvx512 {
+
+    typedef __m512 Type;
+    typedef __mmask16 Mask;
+
+    static const unsigned WIDTH = 16;
+    static const bool FUSED = true;
+
+    static inline Type zero() { return _mm512_setzero_ps(); }
+    static inline Type set(float v) { return _mm512_set1_ps(v); }
+    static inline Type load(const float* p) { return _mm512_loadu_ps(p); }
+    static inline void store(float* p, Type v) { _mm512_storeu_ps(p, v); }
+
+    static inline Type add(Type a, Type b) { return _mm512_add_ps(a, b); }
+    static inline Type sub(Type a, Type b) { return _mm512_sub_ps(a, b); }
+    static inline Type mul(Type a, Type b) { return _mm512_mul_ps(a, b); }
+    static inline Type div(Type a, Type b) { return _mm512_div_ps(a, b); }
+    static inline Type fmadd(Type a, Type b, Type c) {
+
+        return _mm512_fmadd_ps(a, b, c);
+    }
+    static inline Type sqrt(Type v) { return _mm512_sqrt_ps(v); }
+    static inline Type abs(Type v) { return _mm512_abs_ps(v); }
+    static inline Type floor(Type v) { return _mm512_floor_ps(v); }
+    static inline Type min(Type a, Type b) { return _mm512_min_ps(a, b); }
+    static inline Type max(Type a, Type b) { return _mm512_max_ps(a, b); }
+
+    static inline Mask cmpLt(Type a, Type b) {
+
+        return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+    }
+    static inline Mask cmpLe(Type a, Type b) {
+
+        return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ);
+    }
+    static inline Type select(Mask m, Type a, Type b) {
+
+        return _mm512_mask_blend_ps(m, b, a);
+    }
+    static inline Mask maskAnd(Mask a, Mask b) {
+
+        return static_cast<Mask>(a & b);
+    }
+    static inline unsigned maskBits(Mask m) {
+
+        return static_cast<unsigned>(m);
+    }
+
+    static inline float hsum(Type v) { return _mm512_reduce_add_ps(v); }
+    static inline float hmin(Type v) { return _mm512_reduce_min_ps(v); }
+    static inline float hmax(Type v) { return _mm512_reduce_max_ps(v); }
+
+    typedef __m512i Block;
+    typedef __mmask64 BlockMask;
+
+    static const unsigned BLOCK_BYTES = 64;
+
+    static inline Block setBlock(unsigned char v) {
+
+        return _mm512_set1_epi8(static_cast<char>(v));
+    }
+    static inline Block loadBlock(const unsigned char* p) {
+
+        return _mm512_loadu_si512(p);
+    }
+    static inline BlockMask blockEqual(Block a, Block b) {
+
+        return _mm512_cmpeq_epi8_mask(a, b);
+    }
+    static inline BlockMask blockMaskAnd(BlockMask a, BlockMask b) {
+
+        return static_cast<BlockMask>(a & b);
+    }
+    static inline BlockMask blockMaskOr(BlockMask a, BlockMask b) {
+
+        return static_cast<BlockMask>(a | b);
+    }
+    static inline std::uint64_t blockMaskBits(BlockMask m) {
+
+        return static_cast<std::uint64_t>(m);
+    }
+
+    static inline void storeBlock(unsigned char* p, Block v) {
+
+        _mm512_storeu_si512(p, v);
+    }
+    static inline Block blockAnd(Block a, Block b) {
+
+        return _mm512_and_si512(a, b);
+    }
+    static inline Block blockOr(Block a, Block b) {
+
+        return _mm512_or_si512(a, b);
+    }
+    static inline Block blockXor(Block a, Block b) {
+
+        return _mm512_xor_si512(a, b);
+    }
+    static inline Block blockSub(Block a, Block b) {
+
+        return _mm512_sub_epi8(a, b);
+    }
+    static inline Block blockSubSaturate(Block a, Block b) {
+
+        return _mm512_subs_epu8(a, b);
+    }
+    static inline Block blockHighNibbles(Block v) {
+
+        return _mm512_and_si512(
+            _mm512_srli_epi16(v, 4), _mm512_set1_epi8(0x0F));
+    }
+    static inline BlockMask blockAtMost(Block a, Block b) {
+
+        return _mm512_cmple_epu8_mask(a, b);
+    }
+    static inline Block blockSelect(BlockMask m, Block a, Block b) {
+
+        return _mm512_mask_blend_epi8(m, b, a);
+    }
+    static inline bool blockAny(Block v) {
+
+        return _mm512_test_epi8_mask(v, v) != 0;
+    }
+    static inline std::uint64_t blockHighBits(Block v) {
+
+        return static_cast<std::uint64_t>(_mm512_movepi8_mask(v));
+    }
+
+    /**Replaces each byte, which must be less than 16, with that entry of a
+    16 byte table*/
+    static inline Block blockLookup(const unsigned char* table, Block v) {
+
+        return _mm512_shuffle_epi8(_mm512_broadcast_i32x4(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table))), v);
+    }
+
+    /**Shifts bytes from the end of the previous block into the front of the
+    current one, so byte i holds the byte K before it in the data*/
+    template<unsigned K>
+    static inline Block blockPrevious(Block current, Block previous) {
+
+        return _mm512_alignr_epi8(current,
+            _mm512_alignr_epi64(current, previous, 6), 16 - K);
+    }
+
+    /**Loads WIDTH bytes as floats*/
+    static inline Type loadBytes(const unsigned char* p) {
+
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+        return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(bytes));
+    }
+
+    /**Stores each lane rounded to the nearest integer as a byte, saturating
+    at 0 and 255*/
+    static inline void storeBytes(unsigned char* p, Type v) {
+
+        __m512i i = _mm512_max_epi32(
+            _mm512_cvtps_epi32(v), _mm512_setzero_si512());
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(p), _mm512_cvtusepi32_epi8(i));
+    }
+
+    /**Loads the components of WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void loadInterleaved(const float* p, Type* c) {
+
+        const __m512i index = _mm512_mullo_epi32(
+            _mm512_setr_epi32(
+                0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+            _mm512_set1_epi32(N));
+        for (unsigned i = 0; i < N; ++i) {
+
+            c[i] = _mm512_i32gather_ps(index, p + i, 4);
+        }
+    }
+
+    /**Stores components as WIDTH interleaved N component vectors*/
+    template<unsigned N>
+    static inline void storeInterleaved(float* p, const Type* c) {
+
+        const __m512i index = _mm512_mullo_epi32(
+            _mm512_setr_epi32(
+                0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+            _mm512_set1_epi32(N));
+        for (unsigned i = 0; i < N; ++i) {
+
+            _mm512_i32scatter_ps(p + i, index, c[i], 4);
+        }
+    }
+    /**Loads the components of the WIDTH N component vectors of the array at
+    the given indices, the indices multiplied by N must fit in an int*/
+    template<unsigned N>
+    static inline void gatherInterleaved(
+            const float* base, const unsigned* indices, Type* c) {
+
+        const __m512i index = _mm512_mullo_epi32(
+            _mm512_loadu_si512(indices), _mm512_set1_epi32(N));
+        for (unsigned i = 0; i < N; ++i) {
+
+            c[i] = _mm512_i32gather_ps(index, base + i, 4);
+        }
+    }
+};
+
+UTIL_SIMD_END_TARGET
+
+#else
+
+//packs wider than a float are only available on x86, the other instruction
+//sets fall back to the portable kernels
+typedef PackScalar PackSse2;
+typedef PackScalar PackSse41;
+typedef PackScalar PackAvx2;
+typedef PackScalar PackAvx512;
+
+#endif
+
+} } //util //simd
+
+#endif
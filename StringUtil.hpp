@@ -4,6 +4,10 @@
 #include <iostream>
 #include <sstream>
 
+#include "MemoryUtil.hpp"
+#include "ProfileUtil.hpp"
+#include "str/StringUtf8.hpp"
+
 
 namespace util {
 
@@ -22,6 +26,9 @@ namespace str {
 @return a new string made from the concatenation*/
 inline std::string concatenate(std::string strings[], unsigned n) {
 
+    UTIL_PROFILE_PROBE("str::concatenate");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
     std::stringstream ss;
 
     //add the strings
@@ -38,6 +45,9 @@ inline std::string concatenate(std::string strings[], unsigned n) {
 @param b the string to concatenate on to the front of the other string*/
 inline void concatenateFront(std::string& a, const std::string& b) {
 
+    UTIL_PROFILE_PROBE("str::concatenateFront");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
     //create a new string stream
     std::stringstream ss;
     //add the strings to it
@@ -52,6 +62,9 @@ inline void concatenateFront(std::string& a, const std::string& b) {
 @param b the string to concatenate on to the end of the other string**/
 inline void concatenateBack(std::string& a, const std::string& b) {
 
+    UTIL_PROFILE_PROBE("str::concatenateBack");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
     //create a new string stream
     std::stringstream ss;
     //add the strings to it
@@ -67,6 +80,9 @@ inline void concatenateBack(std::string& a, const std::string& b) {
 @return the generated string*/
 inline std::string generateRepeat(const std::string& str, unsigned n) {
 
+    UTIL_PROFILE_PROBE("str::generateRepeat");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
     //create a new string stream
     std::stringstream ss;
     for (unsigned i = 0; i < n; ++i) {
@@ -77,44 +93,81 @@ inline std::string generateRepeat(const std::string& str, unsigned n) {
     return ss.str();
 }
 
+/**Pads the front of a string with a character until it occupies a given
+number of columns, measured by displayWidth() so that UTF-8 is padded by
+what is seen rather than by its bytes
+@param str the string to pad
+@param charNum the number of columns the string should occupy
+@param fill the character to pad with, which should be one column wide*/
+inline void padFront(std::string& str, unsigned charNum, char fill = ' ') {
+
+    UTIL_PROFILE_PROBE("str::padFront");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::size_t width = displayWidth(str);
+    if (width < charNum) {
+
+        str.insert(0, charNum - width, fill);
+    }
+}
+
+/**Pads the back of a string with a character until it occupies a given
+number of columns, measured by displayWidth() so that UTF-8 is padded by
+what is seen rather than by its bytes
+@param str the string to pad
+@param charNum the number of columns the string should occupy
+@param fill the character to pad with, which should be one column wide*/
+inline void padBack(std::string& str, unsigned charNum, char fill = ' ') {
+
+    UTIL_PROFILE_PROBE("str::padBack");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::size_t width = displayWidth(str);
+    if (width < charNum) {
+
+        str.append(charNum - width, fill);
+    }
+}
+
 //TODO: centre a string on multiple lines
-/**Centres a string so that it occupies a given number of characters. If the
-string is longer than the given number of characters it is split into
-multiple lines
+/**Centres a string so that it occupies a given number of columns, measured by
+displayWidth() so that UTF-8 is centred by what is seen rather than by its
+bytes. If the string is wider than the given number of columns it is split
+into multiple lines
 #WARNING This will not trim white-space from the initial string so any
 proceeding or trailing white-space will be considered part of the string
 to centre.
 #WARNING If the string initially occupies multiple lines each line of the
 string will be centered to occupy the given number of characters.
 @param str the string to centre
-@param charNum the number of characters the string should occupy
+@param charNum the number of columns the string should occupy
 @return the number of lines the string now occupies*/
 inline unsigned centre(std::string& str, unsigned charNum) {
 
-    //TODO: check for new lines (windows too)
-
-    //check the length of the string
-    if (str.length() < charNum) {
+    UTIL_PROFILE_PROBE("str::centre");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
 
-        //find the number of characters to add
-        int addLength = charNum - str.length();
-
-        //generate the spaces to add
-        std::string whiteSpace = generateRepeat(" ", addLength / 2);
+    //TODO: check for new lines (windows too)
 
-        //add the white space to the string
-        concatenateFront(str, whiteSpace);
-        concatenateBack(str, whiteSpace);
+    //check the width of the string
+    std::size_t width = displayWidth(str);
+    if (width < charNum) {
 
-        //if odd add an extra space to the end
-        if (addLength % 2) {
+        //find the number of columns to add, if odd the extra space goes on
+        //the end
+        std::size_t addLength = charNum - width;
 
-            concatenateBack(str, " ");
-        }
+        //build the centred string in one allocation
+        std::string centred;
+        centred.reserve(str.size() + addLength);
+        centred.append(addLength / 2, ' ');
+        centred.append(str);
+        centred.append(addLength - addLength / 2, ' ');
+        str.swap(centred);
 
         return 1;
     }
-    else if (str.length() > charNum) {
+    else if (width > charNum) {
 
         //TODO:
     }
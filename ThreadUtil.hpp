@@ -0,0 +1,308 @@
+#ifndef UTILITRON_THREADUTIL_H_
+#   define UTILITRON_THREADUTIL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MacroUtil.hpp"
+
+namespace util {
+
+/**************************************************************************\
+| Utilities for running work across threads. A process wide pool of worker |
+| threads is started on first use and shared by every parallel kernel so   |
+| threads are never created per call.                                      |
+\**************************************************************************/
+namespace thread {
+
+//------------------------------------------------------------------------------
+//                                  ENUMERATORS
+//------------------------------------------------------------------------------
+
+/**How a bulk function that offers a choice spreads its work*/
+enum Execution {
+
+    //!run on the calling thread only
+    EXECUTE_SERIAL,
+    //!split large inputs across the default thread pool
+    EXECUTE_PARALLEL
+};
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/*****************************************************************************\
+| A fixed set of worker threads that run submitted tasks in submission order. |
+\*****************************************************************************/
+class ThreadPool {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new thread pool and starts its workers
+    @param threads the number of worker threads, may be 0 in which case
+    parallel work runs on the calling thread only*/
+    inline explicit ThreadPool(unsigned threads) :
+        mStopping(false) {
+
+        for (unsigned i = 0; i < threads; ++i) {
+
+            mWorkers.push_back(std::thread(&ThreadPool::work, this));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //                                 DESTRUCTOR
+    //--------------------------------------------------------------------------
+
+    /**Destroys this pool once the tasks already submitted have run*/
+    inline ~ThreadPool() {
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mWake.notify_all();
+
+        for (std::size_t i = 0; i < mWorkers.size(); ++i) {
+
+            mWorkers[i].join();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the number of worker threads in the pool*/
+    inline unsigned size() const {
+
+        return static_cast<unsigned>(mWorkers.size());
+    }
+
+    /**Queues a task to be run by a worker thread
+    @param task the task to run*/
+    inline void submit(const std::function<void()>& task) {
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.push_back(task);
+        }
+        mWake.notify_one();
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the worker threads
+    std::vector<std::thread> mWorkers;
+    //the tasks waiting to be run
+    std::deque<std::function<void()> > mTasks;
+    //guards the tasks and the stopping flag
+    std::mutex mMutex;
+    //signals the workers when there is a task or the pool is stopping
+    std::condition_variable mWake;
+    //whether the pool is being destroyed
+    bool mStopping;
+
+    //--------------------------------------------------------------------------
+    //                          PRIVATE MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+
+    /**The loop run by each worker thread*/
+    inline void work() {
+
+        for (;;) {
+
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                while (!mStopping && mTasks.empty()) {
+
+                    mWake.wait(lock);
+                }
+                if (mTasks.empty()) {
+
+                    return;
+                }
+
+                task = mTasks.front();
+                mTasks.pop_front();
+            }
+
+            task();
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return the process wide thread pool, it has one worker fewer than the
+number of hardware threads since the thread that starts parallel work also
+takes part in it*/
+inline ThreadPool& defaultPool() {
+
+    static ThreadPool pool(std::thread::hardware_concurrency() > 1 ?
+        std::thread::hardware_concurrency() - 1 : 0);
+
+    return pool;
+}
+
+namespace detail {
+
+/**The progress of a parallelFor() shared between the threads running it*/
+struct ParallelForState {
+
+    //the next chunk to run
+    std::atomic<std::size_t> next;
+    //the number of chunks that have finished
+    std::size_t finished;
+    //the first exception a chunk threw
+    std::exception_ptr error;
+    //guards finished and error
+    std::mutex mutex;
+    //signalled when the last chunk finishes
+    std::condition_variable done;
+};
+
+} //detail
+
+/**Runs a function over the range [0, count) split into fixed size chunks,
+spreading the chunks across the default thread pool and the calling thread.
+The chunk boundaries depend only on count and chunkSize, never on the number
+of threads, so kernels that combine per-chunk results in chunk order produce
+the same result on any machine. Returns once every chunk has run and rethrows
+the first exception a chunk threw
+@param count the size of the range
+@param chunkSize the size of each chunk
+@param function called as function(begin, end, chunk) for each chunk*/
+template<typename Function>
+inline void parallelFor(
+        std::size_t count, std::size_t chunkSize, Function function) {
+
+    if (chunkSize == 0) {
+
+        chunkSize = 1;
+    }
+    std::size_t chunks = (count + chunkSize - 1) / chunkSize;
+
+    ThreadPool& pool = defaultPool();
+    if (chunks <= 1 || pool.size() == 0) {
+
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+            std::size_t begin = chunk * chunkSize;
+            std::size_t end = begin + chunkSize < count ?
+                begin + chunkSize : count;
+            function(begin, end, chunk);
+        }
+
+        return;
+    }
+
+    std::shared_ptr<detail::ParallelForState> state(
+        new detail::ParallelForState());
+    state->next = 0;
+    state->finished = 0;
+
+    //every participating thread pulls chunks until none are left
+    std::function<void()> run = [state, chunks, chunkSize, count, function]() {
+
+        for (;;) {
+
+            std::size_t chunk = state->next.fetch_add(1);
+            if (chunk >= chunks) {
+
+                return;
+            }
+
+            std::size_t begin = chunk * chunkSize;
+            std::size_t end = begin + chunkSize < count ?
+                begin + chunkSize : count;
+            try {
+
+                function(begin, end, chunk);
+            }
+            catch (...) {
+
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) {
+
+                    state->error = std::current_exception();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (++state->finished == chunks) {
+
+                state->done.notify_all();
+            }
+        }
+    };
+
+    std::size_t helpers = chunks - 1 < pool.size() ? chunks - 1 : pool.size();
+    for (std::size_t i = 0; i < helpers; ++i) {
+
+        pool.submit(run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (state->finished < chunks) {
+
+        state->done.wait(lock);
+    }
+    if (state->error) {
+
+        std::rethrow_exception(state->error);
+    }
+}
+
+/**Runs a function over the range [0, count), either in one call on the calling
+thread or in chunks spread by parallelFor()
+@param execution whether to split the range across the thread pool
+@param count the size of the range
+@param chunkSize the size of each chunk when running in parallel
+@param function called as function(begin, end) for each chunk*/
+template<typename Function>
+inline void execute(
+        Execution execution,
+        std::size_t count,
+        std::size_t chunkSize,
+        Function function) {
+
+    if (execution == EXECUTE_SERIAL || count <= chunkSize) {
+
+        function(static_cast<std::size_t>(0), count);
+
+        return;
+    }
+
+    parallelFor(count, chunkSize,
+        [&](std::size_t begin, std::size_t end, std::size_t) {
+
+            function(begin, end);
+        });
+}
+
+} } //util //thread
+
+#endif
@@ -6,6 +6,9 @@
 #include <sstream>
 
 #include "exceptions/ArrayException.hpp"
+#include "MathUtil.hpp"
+#include "MemoryUtil.hpp"
+#include "ProfileUtil.hpp"
 
 namespace util {
 
@@ -44,26 +47,29 @@ public:
     //                                 VARIABLES
     //--------------------------------------------------------------------------
 
-    //------------------------POSITION COMPONENT ACCESS-------------------------
+    //-----------------------------COMPONENT ACCESS-----------------------------
 
-    //!x position access component
-    float x;
-    //!y position access component
-    float y;
+    // the colour and measurement components are aliases of the position
+    // components so that the vector packs down to its float components
 
-    //-------------------------COLOUR COMPONENT ACCESS--------------------------
+    union {
 
-    //!red colour access component (alias of x)
-    float& r;
-    //!green colour access component (alias of y)
-    float& g;
+        //!x position access component
+        float x;
+        //!red colour access component (alias of x)
+        float r;
+        //!width measurement access component (alias of x)
+        float width;
+    };
+    union {
 
-    //-----------------------MEASUREMENT COMPONENT ACCESS-----------------------
-
-    //!width measurement access component (alias of x)
-    float& width;
-    //!height measurement access component (alias of y)
-    float& height;
+        //!y position access component
+        float y;
+        //!green colour access component (alias of y)
+        float g;
+        //!height measurement access component (alias of y)
+        float height;
+    };
 
     //--------------------------------------------------------------------------
     //                                CONSTRUCTORS
@@ -73,11 +79,7 @@ public:
     initialised as zero*/
     inline Vector2() :
         x(0),
-        y(0),
-        r(x),
-        g(y),
-        width(x),
-        height(y) {
+        y(0) {
     }
 
     /**Creates a new two dimensional vector with the given values
@@ -85,11 +87,7 @@ public:
     @param p_y the y value of the vector*/
     inline Vector2(float p_x, float p_y) :
         x(p_x),
-        y(p_y),
-        r(x),
-        g(y),
-        width(x),
-        height(y) {
+        y(p_y) {
     }
 
     /**Creates a new two dimensional vector by the copying the values from
@@ -97,11 +95,7 @@ public:
     @param v2 the 2d vector copy from*/
     inline Vector2(const Vector2& v2) :
         x(v2.x),
-        y(v2.y),
-        r(x),
-        g(y),
-        width(x),
-        height(y) {
+        y(v2.y) {
     }
 
     //--------------------------------------------------------------------------
@@ -134,12 +128,16 @@ public:
     /**@return if this vector and the other given vector are equal*/
     inline bool operator ==(const Vector2& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator ==");
+
         return x == other.x && y == other.y;
     }
 
     /**@return if this vector and the other given vector are not equal*/
     inline bool operator !=(const Vector2& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator !=");
+
         return !((*this) == other);
     }
 
@@ -198,6 +196,8 @@ public:
     /**@return a copy of the vector which has been negated*/
     inline Vector2 operator -() const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator -");
+
         return Vector2(-x, -y);
     }
 
@@ -209,6 +209,8 @@ public:
     @return the result of the addition*/
     inline Vector2 operator +(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator +");
+
         return Vector2(x + scalar, y + scalar);
     }
 
@@ -216,6 +218,8 @@ public:
     @param scalar the scalar to add*/
     inline void operator +=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator +=");
+
         x += scalar;
         y += scalar;
     }
@@ -226,6 +230,8 @@ public:
     @return the result of the addition*/
     inline Vector2 operator +(const Vector2& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator +");
+
         return Vector2(x + other.x, y + other.y);
     }
 
@@ -233,6 +239,8 @@ public:
     @param other the vector to add to this*/
     inline void operator +=(const Vector2& other) {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator +=");
+
         x += other.x;
         y += other.y;
     }
@@ -245,6 +253,8 @@ public:
     @return the result of the subtraction*/
     inline Vector2 operator -(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator -");
+
         return Vector2(x - scalar, y - scalar);
     }
 
@@ -252,6 +262,8 @@ public:
     @param scalar the scalar to subtract from the components*/
     inline void operator -=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator -=");
+
         x -= scalar;
         y -= scalar;
     }
@@ -262,6 +274,8 @@ public:
     @return the result of the subtraction*/
     inline Vector2 operator -(const Vector2& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator -");
+
         return Vector2(x - other.x, y - other.y);
     }
 
@@ -269,6 +283,8 @@ public:
     @param other the vector to subtract from this*/
     inline void operator -=(const Vector2& other) {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator -=");
+
         x -= other.x;
         y -= other.y;
     }
@@ -281,6 +297,8 @@ public:
     @return the result of the multiplication*/
     inline Vector2 operator *(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator *");
+
         return Vector2(x * scalar, y * scalar);
     }
 
@@ -288,6 +306,8 @@ public:
     @param scalar the scalar to multiply the components by*/
     inline void operator *=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator *=");
+
         x *= scalar;
         y *= scalar;
     }
@@ -300,6 +320,8 @@ public:
     @return the result of the division*/
     inline Vector2 operator /(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator /");
+
         return Vector2(x / scalar, y / scalar);
     }
 
@@ -307,6 +329,8 @@ public:
     @param scalar the scalar to divide the components by*/
     inline void operator /=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::operator /=");
+
         x /= scalar;
         y /= scalar;
     }
@@ -360,6 +384,9 @@ public:
     /**@return the vector in string format*/
     inline std::string toString() const {
 
+        UTIL_PROFILE_PROBE("vec::Vector2::toString");
+        UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_VECTOR_FORMAT);
+
         std::stringstream ss;
         ss << "[ " << x << ", " << y << "]";
 
@@ -396,32 +423,38 @@ public:
     //                                 VARIABLES
     //--------------------------------------------------------------------------
 
-    //------------------------POSITION COMPONENT ACCESS-------------------------
-
-    //!x position access component
-    float x;
-    //!y position access component
-    float y;
-    //!z position access component
-    float z;
-
-    //-------------------------COLOUR COMPONENT ACCESS--------------------------
-
-    //!red colour access component (alias of x)
-    float& r;
-    //!green colour access component (alias of y)
-    float& g;
-    //!blue colour access component (alias of z)
-    float& b;
-
-    //-----------------------MEASUREMENT COMPONENT ACCESS-----------------------
-
-    //!width measurement access component (alias of x)
-    float& width;
-    //!height measurement access component (alias of x)
-    float& height;
-    //!depth measurement access component (alias of x)
-    float& depth;
+    //-----------------------------COMPONENT ACCESS-----------------------------
+
+    // the colour and measurement components are aliases of the position
+    // components so that the vector packs down to its float components
+
+    union {
+
+        //!x position access component
+        float x;
+        //!red colour access component (alias of x)
+        float r;
+        //!width measurement access component (alias of x)
+        float width;
+    };
+    union {
+
+        //!y position access component
+        float y;
+        //!green colour access component (alias of y)
+        float g;
+        //!height measurement access component (alias of y)
+        float height;
+    };
+    union {
+
+        //!z position access component
+        float z;
+        //!blue colour access component (alias of z)
+        float b;
+        //!depth measurement access component (alias of z)
+        float depth;
+    };
 
     //--------------------------------------------------------------------------
     //                                CONSTRUCTORS
@@ -432,13 +465,7 @@ public:
     inline Vector3() :
         x(0),
         y(0),
-        z(0),
-        r(x),
-        g(y),
-        b(z),
-        width(x),
-        height(y),
-        depth(z) {
+        z(0) {
     }
 
     /**Creates a new three dimensional vector with the given values
@@ -448,13 +475,7 @@ public:
     inline Vector3(float p_x, float p_y, float p_z) :
         x(p_x),
         y(p_y),
-        z(p_z),
-        r(x),
-        g(y),
-        b(z),
-        width(x),
-        height(y),
-        depth(z) {
+        z(p_z) {
     }
 
     /**Creates a new three dimensional vector by the copying the values from
@@ -463,13 +484,7 @@ public:
     inline Vector3(const Vector3& v3) :
         x(v3.x),
         y(v3.y),
-        z(v3.z),
-        r(x),
-        g(y),
-        b(z),
-        width(x),
-        height(y),
-        depth(z) {
+        z(v3.z) {
     }
 
     /**Creates a new three dimensional vector by copying the x and y components
@@ -479,13 +494,7 @@ public:
     inline Vector3(const Vector2& v2, float p_z) :
         x(v2.x),
         y(v2.y),
-        z(p_z),
-        r(x),
-        g(y),
-        b(z),
-        width(x),
-        height(y),
-        depth(z) {
+        z(p_z) {
     }
 
     /**Creates a new three dimensional from the given x value and copying
@@ -495,13 +504,7 @@ public:
     inline Vector3(float p_x, const Vector2& v2) :
         x(p_x),
         y(v2.x),
-        z(v2.y),
-        r(x),
-        g(y),
-        b(z),
-        width(x),
-        height(y),
-        depth(z) {
+        z(v2.y) {
     }
 
     //--------------------------------------------------------------------------
@@ -535,12 +538,16 @@ public:
     /**@return if this vector and the other given vector are equal*/
     inline bool operator ==(const Vector3& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator ==");
+
         return x == other.x && y == other.y && z == other.z;
     }
 
     /**@return if this vector and the other given vector are not equal*/
     inline bool operator !=(const Vector3& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator !=");
+
         return !((*this) == other);
     }
 
@@ -607,6 +614,8 @@ public:
     /**@return a copy of the vector which has been negated*/
     inline Vector3 operator -() const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator -");
+
         return Vector3(-x, -y, -z);
     }
 
@@ -618,6 +627,8 @@ public:
     @return the result of the addition*/
     inline Vector3 operator +(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator +");
+
         return Vector3(x + scalar, y + scalar, z + scalar);
     }
 
@@ -625,6 +636,8 @@ public:
     @param scalar the scalar to add*/
     inline void operator +=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator +=");
+
         x += scalar;
         y += scalar;
         z += scalar;
@@ -636,6 +649,8 @@ public:
     @return the result of the addition*/
     inline Vector3 operator +(const Vector3& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator +");
+
         return Vector3(x + other.x, y + other.y, z + other.z);
     }
 
@@ -643,6 +658,8 @@ public:
     @param other the vector to add to this*/
     inline void operator +=(const Vector3& other) {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator +=");
+
         x += other.x;
         y += other.y;
         z += other.z;
@@ -656,6 +673,8 @@ public:
     @return the result of the subtraction*/
     inline Vector3 operator -(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator -");
+
         return Vector3(x - scalar, y - scalar, z - scalar);
     }
 
@@ -663,6 +682,8 @@ public:
     @param scalar the scalar to subtract from the components*/
     inline void operator -=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator -=");
+
         x -= scalar;
         y -= scalar;
         z -= scalar;
@@ -674,6 +695,8 @@ public:
     @return the result of the subtraction*/
     inline Vector3 operator -(const Vector3& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator -");
+
         return Vector3(x - other.x, y - other.y, z - other.z);
     }
 
@@ -681,6 +704,8 @@ public:
     @param other the vector to subtract from this*/
     inline void operator -=(const Vector3& other) {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator -=");
+
         x -= other.x;
         y -= other.y;
         z -= other.z;
@@ -694,6 +719,8 @@ public:
     @return the result of the multiplication*/
     inline Vector3 operator *(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator *");
+
         return Vector3(x * scalar, y * scalar, z * scalar);
     }
 
@@ -701,6 +728,8 @@ public:
     @param scalar the scalar to multiply the components by*/
     inline void operator *=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator *=");
+
         x *= scalar;
         y *= scalar;
         z *= scalar;
@@ -714,6 +743,8 @@ public:
     @return the result of the division*/
     inline Vector3 operator /(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator /");
+
         return Vector3(x / scalar, y / scalar, z / scalar);
     }
 
@@ -721,6 +752,8 @@ public:
     @param scalar the scalar to divide the components by*/
     inline void operator /=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::operator /=");
+
         x /= scalar;
         y /= scalar;
         z /= scalar;
@@ -841,6 +874,9 @@ public:
     /**@return the vector in string format*/
     inline std::string toString() const {
 
+        UTIL_PROFILE_PROBE("vec::Vector3::toString");
+        UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_VECTOR_FORMAT);
+
         std::stringstream ss;
         ss << "[ " << x << ", " << y << ", " << z << "]";
 
@@ -876,36 +912,45 @@ public:
     //                                 VARIABLES
     //--------------------------------------------------------------------------
 
-    //------------------------POSITION COMPONENT ACCESS-------------------------
-
-    //!x position access component
-    float x;
-    //!y position access component
-    float y;
-    //!z position access component
-    float z;
-    //!w position access component
-    float w;
-
-    //-------------------------COLOUR COMPONENT ACCESS--------------------------
-
-    //!red colour access component (alias of x)
-    float& r;
-    //!green colour access component (alias of y)
-    float& g;
-    //!blue colour access component (alias of z)
-    float& b;
-    //!alpha colour access component (alias of w)
-    float& a;
-
-    //-----------------------MEASUREMENT COMPONENT ACCESS-----------------------
-
-    //!width measurement access component (alias of x)
-    float& width;
-    //!height measurement access component (alias of x)
-    float& height;
-    //!depth measurement access component (alias of x)
-    float& depth;
+    //-----------------------------COMPONENT ACCESS-----------------------------
+
+    // the colour and measurement components are aliases of the position
+    // components so that the vector packs down to its float components
+
+    union {
+
+        //!x position access component
+        float x;
+        //!red colour access component (alias of x)
+        float r;
+        //!width measurement access component (alias of x)
+        float width;
+    };
+    union {
+
+        //!y position access component
+        float y;
+        //!green colour access component (alias of y)
+        float g;
+        //!height measurement access component (alias of y)
+        float height;
+    };
+    union {
+
+        //!z position access component
+        float z;
+        //!blue colour access component (alias of z)
+        float b;
+        //!depth measurement access component (alias of z)
+        float depth;
+    };
+    union {
+
+        //!w position access component
+        float w;
+        //!alpha colour access component (alias of w)
+        float a;
+    };
 
     //--------------------------------------------------------------------------
     //                                CONSTRUCTORS
@@ -917,14 +962,7 @@ public:
         x(0),
         y(0),
         z(0),
-        w(0),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(0) {
     }
 
     /**Creates a new four dimensional vector with the given values
@@ -936,14 +974,7 @@ public:
         x(p_x),
         y(p_y),
         z(p_z),
-        w(p_w),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(p_w) {
     }
 
     /**Creates a new four dimensional vector by the copying the values from
@@ -953,14 +984,7 @@ public:
         x(v4.x),
         y(v4.y),
         z(v4.z),
-        w(v4.w),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(v4.w) {
     }
 
     /**Creates a new four dimensional vector by setting the x and y components
@@ -973,14 +997,7 @@ public:
         x(v2.x),
         y(v2.y),
         z(p_z),
-        w(p_w),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(p_w) {
     }
 
     /**Creates a new four dimensional vector by setting the y and z components
@@ -993,14 +1010,7 @@ public:
         x(p_x),
         y(v2.x),
         z(v2.y),
-        w(p_w),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(p_w) {
     }
 
     /**Creates a new four dimensional vector by setting the z and w components
@@ -1013,14 +1023,7 @@ public:
         x(p_x),
         y(p_y),
         z(v2.x),
-        w(v2.y),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(v2.y) {
     }
 
     /**Creates a new four dimensional vector by setting the x and y components
@@ -1032,14 +1035,7 @@ public:
         x(firstV2.x),
         y(firstV2.y),
         z(secondV2.x),
-        w(secondV2.y),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(secondV2.y) {
     }
 
     /**Creates a new four dimensional vector by setting the x, y, and z
@@ -1051,14 +1047,7 @@ public:
         x(v3.x),
         y(v3.y),
         z(v3.z),
-        w(p_w),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(p_w) {
     }
 
     /**Creates a new four dimensional vector by setting the y, x, and w
@@ -1070,14 +1059,7 @@ public:
         x(p_x),
         y(v3.x),
         z(v3.y),
-        w(v3.z),
-        r(x),
-        g(y),
-        b(z),
-        a(w),
-        width(x),
-        height(y),
-        depth(z) {
+        w(v3.z) {
     }
 
     //--------------------------------------------------------------------------
@@ -1112,12 +1094,16 @@ public:
     /**@return if this vector and the other given vector are equal*/
     inline bool operator ==(const Vector4& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator ==");
+
         return x == other.x && y == other.y && z == other.z && w == other.w;
     }
 
     /**@return if this vector and the other given vector are not equal*/
     inline bool operator !=(const Vector4& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator !=");
+
         return !((*this) == other);
     }
 
@@ -1192,6 +1178,8 @@ public:
     /**@return a copy of the vector which has been negated*/
     inline Vector4 operator -() const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator -");
+
         return Vector4(-x, -y, -z, -w);
     }
 
@@ -1203,6 +1191,8 @@ public:
     @return the result of the addition*/
     inline Vector4 operator +(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator +");
+
         return Vector4(x + scalar, y + scalar, z + scalar, w + scalar);
     }
 
@@ -1210,6 +1200,8 @@ public:
     @param scalar the scalar to add*/
     inline void operator +=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator +=");
+
         x += scalar;
         y += scalar;
         z += scalar;
@@ -1222,6 +1214,8 @@ public:
     @return the result of the addition*/
     inline Vector4 operator +(const Vector4& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator +");
+
         return Vector4(x + other.x, y + other.y, z + other.z, w + other.w);
     }
 
@@ -1229,6 +1223,8 @@ public:
     @param other the vector to add to this*/
     inline void operator +=(const Vector4& other) {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator +=");
+
         x += other.x;
         y += other.y;
         z += other.z;
@@ -1243,6 +1239,8 @@ public:
     @return the result of the subtraction*/
     inline Vector4 operator -(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator -");
+
         return Vector4(x - scalar, y - scalar, z - scalar, w - scalar);
     }
 
@@ -1250,6 +1248,8 @@ public:
     @param scalar the scalar to subtract from the components*/
     inline void operator -=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator -=");
+
         x -= scalar;
         y -= scalar;
         z -= scalar;
@@ -1262,6 +1262,8 @@ public:
     @return the result of the subtraction*/
     inline Vector4 operator -(const Vector4& other) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator -");
+
         return Vector4(x - other.x, y - other.y, z - other.z, w - other.w);
     }
 
@@ -1269,6 +1271,8 @@ public:
     @param other the vector to subtract from this*/
     inline void operator -=(const Vector4& other) {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator -=");
+
         x -= other.x;
         y -= other.y;
         z -= other.z;
@@ -1283,6 +1287,8 @@ public:
     @return the result of the multiplication*/
     inline Vector4 operator *(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator *");
+
         return Vector4(x * scalar, y * scalar, z * scalar, w * scalar);
     }
 
@@ -1290,6 +1296,8 @@ public:
     @param scalar the scalar to multiply the components by*/
     inline void operator *=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator *=");
+
         x *= scalar;
         y *= scalar;
         z *= scalar;
@@ -1304,6 +1312,8 @@ public:
     @return the result of the division*/
     inline Vector4 operator /(float scalar) const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator /");
+
         return Vector4(x / scalar, y / scalar, z / scalar, w / scalar);
     }
 
@@ -1311,6 +1321,8 @@ public:
     @param scalar the scalar to divide the components by*/
     inline void operator /=(float scalar) {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::operator /=");
+
         x /= scalar;
         y /= scalar;
         z /= scalar;
@@ -1660,6 +1672,9 @@ public:
     /**@return the vector in string format*/
     inline std::string toString() const {
 
+        UTIL_PROFILE_PROBE("vec::Vector4::toString");
+        UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_VECTOR_FORMAT);
+
         std::stringstream ss;
         ss << "[ " << x << ", " << y << ", " << z <<  ", " << w << "]";
 
@@ -1667,16 +1682,61 @@ public:
     }
 };
 
+//the bulk functions read arrays of vectors as packed arrays of floats
+static_assert(sizeof(Vector2) == 2 * sizeof(float),
+    "Vector2 must be two packed floats");
+static_assert(sizeof(Vector3) == 3 * sizeof(float),
+    "Vector3 must be three packed floats");
+static_assert(sizeof(Vector4) == 4 * sizeof(float),
+    "Vector4 must be four packed floats");
+
 //------------------------------------------------------------------------------
 //                             VECTOR MATH FUNCTIONS
 //------------------------------------------------------------------------------
 
+/**Computes the dot product of the two given vectors
+@param a the first vector
+@param b the second vector
+@return the result of dot product*/
+inline float dot(const Vector2& a, const Vector2& b) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector2)");
+
+    return util::math::multiplyAdd(a.x, b.x, a.y * b.y);
+}
+
+/**Computes the dot product of the two given vectors
+@param a the first vector
+@param b the second vector
+@return the result of dot product*/
+inline float dot(const Vector3& a, const Vector3& b) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector3)");
+
+    return util::math::multiplyAdd(a.x, b.x,
+        util::math::multiplyAdd(a.y, b.y, a.z * b.z));
+}
+
+/**Computes the dot product of the two given vectors
+@param a the first vector
+@param b the second vector
+@return the result of dot product*/
+inline float dot(const Vector4& a, const Vector4& b) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector4)");
+
+    return util::math::multiplyAdd(a.x, b.x, util::math::multiplyAdd(a.y, b.y,
+        util::math::multiplyAdd(a.z, b.z, a.w * b.w)));
+}
+
 /**Computes the magnitude of the given vector
 @param v the vector to compute the magnitude
 @return the magnitude*/
 inline float magnitude(const Vector2& v) {
 
-    return sqrt((v.x * v.x) + (v.y * v.y));
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector2)");
+
+    return sqrt(dot(v, v));
 }
 
 /**Computes the magnitude of the given vector
@@ -1684,7 +1744,9 @@ inline float magnitude(const Vector2& v) {
 @return the magnitude*/
 inline float magnitude(const Vector3& v) {
 
-    return sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector3)");
+
+    return sqrt(dot(v, v));
 }
 
 /**Computes the magnitude of the given vector
@@ -1692,7 +1754,9 @@ inline float magnitude(const Vector3& v) {
 @return the magnitude*/
 inline float magnitude(const Vector4& v) {
 
-    return sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z) + (v.w + v.w));
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector4)");
+
+    return sqrt(dot(v, v));
 }
 
 /**Computes a normalised version of the given vector
@@ -1700,6 +1764,8 @@ inline float magnitude(const Vector4& v) {
 @return the normalised vector*/
 inline Vector2 normalise(const Vector2& v) {
 
+    UTIL_PROFILE_PROBE("vec::normalise(Vector2)");
+
     float mag = magnitude(v);
 
     return Vector2(v.x / mag, v.y / mag);
@@ -1710,6 +1776,8 @@ inline Vector2 normalise(const Vector2& v) {
 @return the normalised vector*/
 inline Vector3 normalise(const Vector3& v) {
 
+    UTIL_PROFILE_PROBE("vec::normalise(Vector3)");
+
     float mag = magnitude(v);
 
     return Vector3(v.x / mag, v.y / mag, v.z / mag);
@@ -1720,48 +1788,26 @@ inline Vector3 normalise(const Vector3& v) {
 @return the normalised vector*/
 inline Vector4 normalise(const Vector4& v) {
 
+    UTIL_PROFILE_PROBE("vec::normalise(Vector4)");
+
     float mag = magnitude(v);
 
     return Vector4(v.x / mag, v.y / mag, v.z / mag, v.w / mag);
 }
 
-/**Computes the dot product of the two given vectors
-@param a the first vector
-@param b the second vector
-@return the result of dot product*/
-inline float dot(const Vector2& a, const Vector2& b) {
-
-    return (a.x * b.x) + (a.y * b.y);
-}
-
-/**Computes the dot product of the two given vectors
-@param a the first vector
-@param b the second vector
-@return the result of dot product*/
-inline float dot(const Vector3& a, const Vector3& b) {
-
-    return (a.x * b.x) + (a.y * b.y) * (a.z * b.z);
-}
-
-/**Computes the dot product of the two given vectors
-@param a the first vector
-@param b the second vector
-@return the result of dot product*/
-inline float dot(const Vector4& a, const Vector4& b) {
-
-    return (a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w);
-}
-
 /**Computes the cross product of the two given vectors
 @param a the first vector
 @param b the second vector
 @return the result of cross product*/
 inline Vector3 cross(const Vector3& a, const Vector3& b) {
 
-    //the cross product values
-    float cx = (a.y * b.z) - (a.z * b.y);
-    float cy = (a.x * b.z) - (a.z * b.x);
-    float cz = (a.x * b.y) - (a.y * b.x);
+    UTIL_PROFILE_PROBE("vec::cross(Vector3)");
+
+    //the cross product values, with each product rounded on its own so that
+    //cross(a, a) is zero and cross(b, a) is -cross(a, b)
+    float cx = util::math::differenceOfProducts(a.y, b.z, a.z, b.y);
+    float cy = util::math::differenceOfProducts(a.z, b.x, a.x, b.z);
+    float cz = util::math::differenceOfProducts(a.x, b.y, a.y, b.x);
 
     return Vector3(cx, cy, cz);
 }
@@ -1772,7 +1818,9 @@ inline Vector3 cross(const Vector3& a, const Vector3& b) {
 @return the distance between the vectors*/
 inline float distance(const Vector2& a, const Vector2& b) {
 
-    return sqrt(pow(a.x - b.x, 2.0f) + pow(a.y - b.y, 2.0f));
+    UTIL_PROFILE_PROBE("vec::distance(Vector2)");
+
+    return magnitude(a - b);
 }
 
 /**@Calculates the distance between the two vectors
@@ -1781,8 +1829,9 @@ inline float distance(const Vector2& a, const Vector2& b) {
 @return the distance between the vectors*/
 inline float distance(const Vector3& a, const Vector3& b) {
 
-    return sqrt(pow(a.x - b.x, 2.0f) + pow(a.y - b.y, 2.0f) +
-        pow(a.z - b.z, 2.0f));
+    UTIL_PROFILE_PROBE("vec::distance(Vector3)");
+
+    return magnitude(a - b);
 }
 
 /**@Calculates the distance between the two vectors
@@ -1791,8 +1840,9 @@ inline float distance(const Vector3& a, const Vector3& b) {
 @return the distance between the vectors*/
 inline float distance(const Vector4& a, const Vector4& b) {
 
-    return sqrt(pow(a.x - b.x, 2.0f) + pow(a.y - b.y, 2.0f) +
-        pow(a.z - b.z, 2.0f) + pow(a.w - b.w, 2.0f));
+    UTIL_PROFILE_PROBE("vec::distance(Vector4)");
+
+    return magnitude(a - b);
 }
 
 /**@return the angle between the two vectors
@@ -1801,6 +1851,8 @@ inline float distance(const Vector4& a, const Vector4& b) {
 @return the angle between the vectors*/
 inline float angleBetween(const Vector2& a, const Vector2& b) {
 
+    UTIL_PROFILE_PROBE("vec::angleBetween(Vector2)");
+
     return (-1.0f * atan2(a.y - b.y, a.x - b.x));
 }
 
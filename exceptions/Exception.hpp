@@ -5,6 +5,8 @@
 #include <iostream>
 #include <sstream>
 
+#include "../MemoryUtil.hpp"
+
 namespace util {
 
 /***********************************************************************\
@@ -35,6 +37,8 @@ public:
     /*!@return the error message of the exception*/
     const char* what() const throw() {
 
+        UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_EXCEPTION);
+
         std::string message = info();
 
         //create a char array for the message
@@ -74,6 +78,8 @@ private:
     /*!@return the exception name joint with the error message*/
     std::string info() const {
 
+        UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_EXCEPTION);
+
         std::stringstream ss;
         ss << name() << ": " << mErrorMessage;
 
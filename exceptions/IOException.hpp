@@ -0,0 +1,45 @@
+#ifndef UTILITRON_EXCEPTIONS_IOEXCEPTION_H_
+#   define UTILITRON_EXCEPTIONS_IOEXCEPTION_H_
+
+#include "Exception.hpp"
+
+namespace util { namespace ex {
+
+/********************************************\
+| Abstract base class for all IO exceptions. |
+|                                            |
+| @author David Saxon                        |
+\********************************************/
+class IOException : public Exception {
+};
+
+/*****************************************************************************\
+| Warns that reading from or writing to a stream failed or that a stream held |
+| malformed data.                                                             |
+|                                                                             |
+| @author David Saxon                                                         |
+\*****************************************************************************/
+class StreamException : public IOException {
+public:
+
+    //CONSTRUCTOR
+    /*!Creates a new stream exception
+    @message the error message*/
+    StreamException(const std::string& message) {
+
+        mErrorMessage = message;
+    }
+
+private:
+
+    //PRIVATE MEMBER FUNCTIONS
+    /*!@override*/
+    std::string name() const {
+
+        return "STREAM EXCEPTION";
+    }
+};
+
+} } //util //ex
+
+#endif
@@ -0,0 +1,1123 @@
+#ifndef UTILITRON_STR_STRINGCONVERT_H_
+#   define UTILITRON_STR_STRINGCONVERT_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "../ProfileUtil.hpp"
+
+namespace util { namespace str {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of 32 bit limbs of a BigInteger, enough for the exact comparison
+//!of any decimal string with the halfway point between two doubles
+static const unsigned BIG_LIMBS = 128;
+//!the number of significant digits of a decimal string that are kept exactly,
+//!more than any halfway point between two doubles has, so later digits only
+//!matter for whether they are all zero
+static const unsigned PARSE_DIGITS = 800;
+//!the number of significant digits that fit in a std::uint64_t
+static const unsigned UINT64_DIGITS = 19;
+//!the greatest magnitude of an exponent that is parsed exactly
+static const int PARSE_EXPONENT = 100000;
+
+//!the pairs of decimal digits from 00 to 99
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+//!the powers of ten that are exact in a std::uint32_t
+static const std::uint32_t POW10_32[] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u,
+    100000000u, 1000000000u };
+
+//!the powers of ten that are exact in a double
+static const double POW10_DOUBLE[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+//!the greatest power of ten that is exact in a double
+static const int POW10_DOUBLE_MAX = 22;
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/**The layout of a binary floating point type and the limits of its decimal
+strings*/
+template<typename Float>
+struct FloatTraits;
+
+template<>
+struct FloatTraits<float> {
+
+    typedef std::uint32_t Bits;
+
+    //!the number of explicit bits of the significand
+    static const unsigned MANTISSA_BITS = 23;
+    //!the bias of the exponent field
+    static const int EXPONENT_BIAS = 127;
+    //!the greatest number of significant digits a shortest string has
+    static const int SHORTEST_DIGITS = 9;
+    //!the greatest number of digits parsed on the fast path
+    static const unsigned FAST_DIGITS = 7;
+    //!the greatest magnitude of the exponent on the fast path
+    static const int FAST_EXPONENT = 10;
+    //!decimal strings whose first digit is at or below this power of ten
+    //!round to zero
+    static const int ZERO_EXPONENT = -47;
+    //!decimal strings whose first digit is at or above this power of ten
+    //!round to infinity
+    static const int INFINITY_EXPONENT = 39;
+    //!the greatest number of characters a float is written with
+    static const std::size_t MAX_CHARS = 15;
+};
+
+template<>
+struct FloatTraits<double> {
+
+    typedef std::uint64_t Bits;
+
+    static const unsigned MANTISSA_BITS = 52;
+    static const int EXPONENT_BIAS = 1023;
+    static const int SHORTEST_DIGITS = 17;
+    static const unsigned FAST_DIGITS = 15;
+    static const int FAST_EXPONENT = POW10_DOUBLE_MAX;
+    static const int ZERO_EXPONENT = -325;
+    static const int INFINITY_EXPONENT = 309;
+    static const std::size_t MAX_CHARS = 24;
+};
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/*****************************************************************************\
+| An unsigned integer of up to BIG_LIMBS 32 bit limbs held on the stack, with |
+| just the operations the exact float conversions need. Copies only copy the  |
+| limbs in use, so small values stay cheap.                                   |
+\*****************************************************************************/
+class BigInteger {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new big integer
+    @param value the initial value*/
+    inline explicit BigInteger(std::uint64_t value = 0) :
+        mSize(0) {
+
+        while (value != 0) {
+
+            mLimbs[mSize++] = static_cast<std::uint32_t>(value);
+            value >>= 32;
+        }
+    }
+
+    /**Creates a copy of a big integer*/
+    inline BigInteger(const BigInteger& other) :
+        mSize(other.mSize) {
+
+        std::memcpy(mLimbs, other.mLimbs, mSize * sizeof(std::uint32_t));
+    }
+
+    //--------------------------------------------------------------------------
+    //                                 OPERATORS
+    //--------------------------------------------------------------------------
+
+    /**Copies another big integer*/
+    inline BigInteger& operator =(const BigInteger& other) {
+
+        mSize = other.mSize;
+        std::memcpy(mLimbs, other.mLimbs, mSize * sizeof(std::uint32_t));
+
+        return *this;
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**Multiplies by a small factor and adds a small value*/
+    inline void multiplyAdd(std::uint32_t factor, std::uint32_t addend = 0) {
+
+        std::uint64_t carry = addend;
+        for (unsigned i = 0; i < mSize; ++i) {
+
+            std::uint64_t p =
+                static_cast<std::uint64_t>(mLimbs[i]) * factor + carry;
+            mLimbs[i] = static_cast<std::uint32_t>(p);
+            carry = p >> 32;
+        }
+        if (carry != 0) {
+
+            mLimbs[mSize++] = static_cast<std::uint32_t>(carry);
+        }
+    }
+
+    /**Multiplies by a power of ten*/
+    inline void multiplyPow10(unsigned exponent) {
+
+        for (; exponent >= 9; exponent -= 9) {
+
+            multiplyAdd(POW10_32[9]);
+        }
+        if (exponent > 0) {
+
+            multiplyAdd(POW10_32[exponent]);
+        }
+    }
+
+    /**Multiplies by a power of two*/
+    inline void shiftLeft(unsigned bits) {
+
+        if (mSize == 0) {
+
+            return;
+        }
+
+        unsigned words = bits / 32;
+        unsigned shift = bits % 32;
+        if (shift != 0) {
+
+            std::uint32_t top = mLimbs[mSize - 1] >> (32 - shift);
+            for (unsigned i = mSize - 1; i > 0; --i) {
+
+                mLimbs[i] = (mLimbs[i] << shift) |
+                    (mLimbs[i - 1] >> (32 - shift));
+            }
+            mLimbs[0] <<= shift;
+            if (top != 0) {
+
+                mLimbs[mSize++] = top;
+            }
+        }
+        if (words != 0) {
+
+            std::memmove(mLimbs + words, mLimbs,
+                mSize * sizeof(std::uint32_t));
+            std::memset(mLimbs, 0, words * sizeof(std::uint32_t));
+            mSize += words;
+        }
+    }
+
+    /**Adds another big integer*/
+    inline void add(const BigInteger& other) {
+
+        std::uint64_t carry = 0;
+        unsigned size = mSize > other.mSize ? mSize : other.mSize;
+        for (unsigned i = 0; i < size; ++i) {
+
+            std::uint64_t sum = carry +
+                (i < mSize ? mLimbs[i] : 0u) +
+                (i < other.mSize ? other.mLimbs[i] : 0u);
+            mLimbs[i] = static_cast<std::uint32_t>(sum);
+            carry = sum >> 32;
+        }
+        mSize = size;
+        if (carry != 0) {
+
+            mLimbs[mSize++] = static_cast<std::uint32_t>(carry);
+        }
+    }
+
+    /**Subtracts another big integer that is not larger than this one*/
+    inline void subtract(const BigInteger& other) {
+
+        std::int64_t borrow = 0;
+        for (unsigned i = 0; i < mSize; ++i) {
+
+            std::int64_t difference = static_cast<std::int64_t>(mLimbs[i]) -
+                (i < other.mSize ? other.mLimbs[i] : 0u) - borrow;
+            borrow = difference < 0 ? 1 : 0;
+            mLimbs[i] = static_cast<std::uint32_t>(difference);
+        }
+        while (mSize > 0 && mLimbs[mSize - 1] == 0) {
+
+            --mSize;
+        }
+    }
+
+    /**Replaces this integer with its remainder after dividing by another
+    that is more than a tenth of it. The quotient is estimated from the top
+    limbs, which is never too large and is exact or one too small when the top
+    limb of the divisor has its high bits set
+    @return the quotient, which is less than ten*/
+    inline unsigned divideSmall(const BigInteger& divisor) {
+
+        unsigned n = divisor.mSize;
+        std::uint64_t top = mSize > n ?
+            (static_cast<std::uint64_t>(mLimbs[n]) << 32) | mLimbs[n - 1] :
+            (mSize == n ? mLimbs[n - 1] : 0);
+        unsigned quotient = static_cast<unsigned>(
+            top / (static_cast<std::uint64_t>(divisor.mLimbs[n - 1]) + 1));
+
+        if (quotient != 0) {
+
+            //subtracts quotient * divisor in one pass
+            std::uint64_t carry = 0;
+            std::int64_t borrow = 0;
+            for (unsigned i = 0; i < mSize; ++i) {
+
+                std::uint64_t product = carry;
+                if (i < n) {
+
+                    product += static_cast<std::uint64_t>(divisor.mLimbs[i]) *
+                        quotient;
+                }
+                carry = product >> 32;
+                std::int64_t difference = static_cast<std::int64_t>(mLimbs[i]) -
+                    static_cast<std::uint32_t>(product) - borrow;
+                borrow = difference < 0 ? 1 : 0;
+                mLimbs[i] = static_cast<std::uint32_t>(difference);
+            }
+            while (mSize > 0 && mLimbs[mSize - 1] == 0) {
+
+                --mSize;
+            }
+        }
+        while (compare(*this, divisor) >= 0) {
+
+            subtract(divisor);
+            ++quotient;
+        }
+
+        return quotient;
+    }
+
+    /**@return the number of bits below and including the highest set bit*/
+    inline unsigned bitLength() const {
+
+        if (mSize == 0) {
+
+            return 0;
+        }
+
+        unsigned length = (mSize - 1) * 32;
+        for (std::uint32_t top = mLimbs[mSize - 1]; top != 0; top >>= 1) {
+
+            ++length;
+        }
+
+        return length;
+    }
+
+    /**@return -1, 0, or 1 as a is less than, equal to, or greater than b*/
+    inline static int compare(const BigInteger& a, const BigInteger& b) {
+
+        if (a.mSize != b.mSize) {
+
+            return a.mSize < b.mSize ? -1 : 1;
+        }
+        for (unsigned i = a.mSize; i > 0; --i) {
+
+            if (a.mLimbs[i - 1] != b.mLimbs[i - 1]) {
+
+                return a.mLimbs[i - 1] < b.mLimbs[i - 1] ? -1 : 1;
+            }
+        }
+
+        return 0;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the limbs from least to most significant
+    std::uint32_t mLimbs[BIG_LIMBS];
+    //the number of limbs in use, the top one is never zero
+    unsigned mSize;
+};
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Writes the decimal digits of an unsigned integer
+@return the number of characters written*/
+template<typename Unsigned>
+inline std::size_t formatUnsigned(Unsigned value, char* buffer) {
+
+    std::size_t length = 1;
+    for (Unsigned v = value; v >= 10; v /= 10) {
+
+        ++length;
+    }
+
+    //two digits at a time from the back
+    char* p = buffer + length;
+    while (value >= 100) {
+
+        unsigned pair = static_cast<unsigned>(value % 100) * 2;
+        value /= 100;
+        *--p = DIGIT_PAIRS[pair + 1];
+        *--p = DIGIT_PAIRS[pair];
+    }
+    if (value >= 10) {
+
+        unsigned pair = static_cast<unsigned>(value) * 2;
+        *--p = DIGIT_PAIRS[pair + 1];
+        *--p = DIGIT_PAIRS[pair];
+    }
+    else {
+
+        *--p = static_cast<char>('0' + value);
+    }
+
+    return length;
+}
+
+/**Writes an integer
+@return the number of characters written*/
+template<typename Integer>
+inline std::size_t formatInteger(Integer value, char* buffer) {
+
+    typedef typename std::make_unsigned<Integer>::type Unsigned;
+
+    if (value < 0) {
+
+        *buffer = '-';
+
+        //negated as unsigned, which small types are promoted out of
+        Unsigned magnitude = static_cast<Unsigned>(
+            static_cast<Unsigned>(0) - static_cast<Unsigned>(value));
+
+        return 1 + formatUnsigned(magnitude, buffer + 1);
+    }
+
+    return formatUnsigned(static_cast<Unsigned>(value), buffer);
+}
+
+/**Parses an integer
+@return the end of the integer, or first if there is none or it does not fit
+in the type*/
+template<typename Integer>
+inline const char* parseInteger(
+        const char* first, const char* last, Integer& value) {
+
+    typedef typename std::make_unsigned<Integer>::type Unsigned;
+
+    const char* p = first;
+    bool negative = false;
+    if (p != last && (*p == '-' || *p == '+')) {
+
+        negative = *p == '-';
+        ++p;
+    }
+    if (negative && !std::numeric_limits<Integer>::is_signed) {
+
+        return first;
+    }
+
+    //the greatest magnitude, one more for negative signed integers
+    Unsigned limit = static_cast<Unsigned>(
+        std::numeric_limits<Integer>::max());
+    if (negative) {
+
+        limit += 1;
+    }
+
+    const char* digits = p;
+    Unsigned magnitude = 0;
+    for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+
+        unsigned digit = static_cast<unsigned>(*p - '0');
+        if (magnitude > (limit - digit) / 10) {
+
+            return first;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    if (p == digits) {
+
+        return first;
+    }
+
+    value = negative ?
+        static_cast<Integer>(static_cast<Unsigned>(0) - magnitude) :
+        static_cast<Integer>(magnitude);
+
+    return p;
+}
+
+/**Splits a finite non-negative float into an integer significand and a power
+of two
+@param bits the bits of the float
+@param significand returns the significand including the hidden bit
+@param exponent returns the power of two*/
+template<typename Float>
+inline void decompose(
+        typename FloatTraits<Float>::Bits bits,
+        typename FloatTraits<Float>::Bits& significand,
+        int& exponent) {
+
+    typedef FloatTraits<Float> Traits;
+    typedef typename Traits::Bits Bits;
+
+    const Bits hidden = static_cast<Bits>(1) << Traits::MANTISSA_BITS;
+    int biased = static_cast<int>(bits >> Traits::MANTISSA_BITS);
+    significand = bits & (hidden - 1);
+    if (biased == 0) {
+
+        exponent = 1 - Traits::EXPONENT_BIAS -
+            static_cast<int>(Traits::MANTISSA_BITS);
+    }
+    else {
+
+        significand |= hidden;
+        exponent = biased - Traits::EXPONENT_BIAS -
+            static_cast<int>(Traits::MANTISSA_BITS);
+    }
+}
+
+/**Finds the shortest digits that read back as a positive finite float, with
+the free-format algorithm of R. G. Burger and R. K. Dybvig, "Printing
+Floating-Point Numbers Quickly and Accurately", 1996, on exact big integers
+@param digits returns the digits as characters
+@param point returns the power of ten of the position after the first digit,
+so the value is 0.digits * 10^point
+@return the number of digits*/
+template<typename Float>
+inline int shortestDigits(Float value, char* digits, int& point) {
+
+    typedef FloatTraits<Float> Traits;
+    typedef typename Traits::Bits Bits;
+
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(Float));
+    Bits f;
+    int e;
+    decompose<Float>(bits, f, e);
+
+    //integers that are exact need no search, their own digits are the
+    //shortest once trailing zeros are dropped
+    if (e <= 0 && e > -static_cast<int>(Traits::MANTISSA_BITS) - 1 &&
+        (f & ((static_cast<Bits>(1) << -e) - 1)) == 0) {
+
+        char integer[24];
+        int length = static_cast<int>(formatUnsigned(f >> -e, integer));
+        point = length;
+        while (length > 1 && integer[length - 1] == '0') {
+
+            --length;
+        }
+        std::memcpy(digits, integer, length);
+
+        return length;
+    }
+
+    //the value is r / s, and the gaps to its neighbours are plus / s and
+    //minus / s, the lower gap is halved at the bottom of a binade
+    const Bits hidden = static_cast<Bits>(1) << Traits::MANTISSA_BITS;
+    const int minimum = 1 - Traits::EXPONENT_BIAS -
+        static_cast<int>(Traits::MANTISSA_BITS);
+    bool unequal = f == hidden && e > minimum;
+    bool even = (f & 1) == 0;
+    BigInteger r(f);
+    BigInteger s(1);
+    BigInteger plus(1);
+    BigInteger minus(1);
+    r.shiftLeft(unequal ? 2 : 1);
+    s.shiftLeft(unequal ? 2 : 1);
+    if (e >= 0) {
+
+        r.shiftLeft(e);
+        plus.shiftLeft(unequal ? e + 1 : e);
+        minus.shiftLeft(e);
+    }
+    else {
+
+        s.shiftLeft(-e);
+        if (unequal) {
+
+            plus.shiftLeft(1);
+        }
+    }
+
+    //scale by an estimate of the power of ten that is never too large, then
+    //correct it if it is one too small
+    int k = static_cast<int>(std::ceil(
+        std::log10(static_cast<double>(value)) - 1e-10));
+    if (k >= 0) {
+
+        s.multiplyPow10(k);
+    }
+    else {
+
+        r.multiplyPow10(-k);
+        plus.multiplyPow10(-k);
+        minus.multiplyPow10(-k);
+    }
+    BigInteger high(r);
+    high.add(plus);
+    int c = BigInteger::compare(high, s);
+    if (c > 0 || (c == 0 && even)) {
+
+        s.multiplyAdd(10);
+        ++k;
+    }
+    point = k;
+
+    //shifting every term alike leaves the digits unchanged and makes the top
+    //limb of s large, so each digit is found from one estimate
+    unsigned normalize = (32 - s.bitLength() % 32) % 32;
+    if (normalize > 4) {
+
+        normalize -= 4;
+        r.shiftLeft(normalize);
+        s.shiftLeft(normalize);
+        plus.shiftLeft(normalize);
+        minus.shiftLeft(normalize);
+    }
+
+    int length = 0;
+    for (;;) {
+
+        r.multiplyAdd(10);
+        plus.multiplyAdd(10);
+        minus.multiplyAdd(10);
+        unsigned digit = r.divideSmall(s);
+
+        //whether the digits so far are within the lower or upper gap
+        c = BigInteger::compare(r, minus);
+        bool low = c < 0 || (c == 0 && even);
+        high = r;
+        high.add(plus);
+        c = BigInteger::compare(high, s);
+        bool up = c > 0 || (c == 0 && even);
+
+        if (low && up) {
+
+            //either way reads back, so take the nearer, or the even digit
+            BigInteger twice(r);
+            twice.shiftLeft(1);
+            c = BigInteger::compare(twice, s);
+            up = c > 0 || (c == 0 && (digit & 1) != 0);
+        }
+        else if (!low && !up) {
+
+            digits[length++] = static_cast<char>('0' + digit);
+            continue;
+        }
+        digits[length++] = static_cast<char>('0' + digit + (up ? 1 : 0));
+
+        return length;
+    }
+}
+
+/**Writes a float
+@return the number of characters written*/
+template<typename Float>
+inline std::size_t formatFloat(Float value, char* buffer) {
+
+    typedef FloatTraits<Float> Traits;
+
+    char* p = buffer;
+    if (value != value) {
+
+        std::memcpy(p, "nan", 3);
+
+        return 3;
+    }
+    if (std::signbit(value)) {
+
+        *p++ = '-';
+        value = -value;
+    }
+    if (value == std::numeric_limits<Float>::infinity()) {
+
+        std::memcpy(p, "inf", 3);
+
+        return p - buffer + 3;
+    }
+    if (value == 0) {
+
+        *p++ = '0';
+
+        return p - buffer;
+    }
+
+    char digits[Traits::SHORTEST_DIGITS + 1];
+    int point;
+    int length = shortestDigits(value, digits, point);
+
+    //positional notation for the powers of ten of the first digit from -4 up
+    //to the shortest digits of the type, like printf's %g
+    int exponent = point - 1;
+    if (exponent >= -4 && exponent < Traits::SHORTEST_DIGITS) {
+
+        if (point <= 0) {
+
+            *p++ = '0';
+            *p++ = '.';
+            for (int i = point; i < 0; ++i) {
+
+                *p++ = '0';
+            }
+            std::memcpy(p, digits, length);
+
+            return p - buffer + length;
+        }
+        for (int i = 0; i < point || i < length; ++i) {
+
+            if (i == point) {
+
+                *p++ = '.';
+            }
+            *p++ = i < length ? digits[i] : '0';
+        }
+
+        return p - buffer;
+    }
+
+    *p++ = digits[0];
+    if (length > 1) {
+
+        *p++ = '.';
+        std::memcpy(p, digits + 1, length - 1);
+        p += length - 1;
+    }
+    *p++ = 'e';
+
+    return p - buffer + formatInteger(exponent, p);
+}
+
+/**@return the sign of the difference between digits * 10^exponent, plus a
+little more if sticky is set, and halfway * 2^power*/
+inline int compareDecimal(
+        const BigInteger& digits,
+        int exponent,
+        bool sticky,
+        std::uint64_t halfway,
+        int power) {
+
+    BigInteger left(digits);
+    BigInteger right(halfway);
+    if (exponent > 0) {
+
+        left.multiplyPow10(exponent);
+    }
+    else {
+
+        right.multiplyPow10(-exponent);
+    }
+    if (power > 0) {
+
+        right.shiftLeft(power);
+    }
+    else {
+
+        left.shiftLeft(-power);
+    }
+
+    int c = BigInteger::compare(left, right);
+
+    return c == 0 && sticky ? 1 : c;
+}
+
+/**Matches a word without regard to case
+@return the end of the word, or p if it does not match*/
+inline const char* matchWord(
+        const char* p, const char* last, const char* word) {
+
+    const char* q = p;
+    for (; *word != '\0'; ++word, ++q) {
+
+        if (q == last || (*q | 0x20) != *word) {
+
+            return p;
+        }
+    }
+
+    return q;
+}
+
+/**Parses a float, correctly rounded to the nearest with ties to even. Short
+strings are converted with one exactly rounded double operation (W. D.
+Clinger, "How to Read Floating Point Numbers Accurately", 1990), others from
+an estimate that is corrected by comparing the string with the halfway points
+on either side of it as exact big integers
+@return the end of the float, or first if there is none*/
+template<typename Float>
+inline const char* parseFloat(
+        const char* first, const char* last, Float& value) {
+
+    typedef FloatTraits<Float> Traits;
+    typedef typename Traits::Bits Bits;
+
+    const char* p = first;
+    bool negative = false;
+    if (p != last && (*p == '-' || *p == '+')) {
+
+        negative = *p == '-';
+        ++p;
+    }
+    const Float sign = negative ? static_cast<Float>(-1) : 1;
+
+    const char* word = matchWord(p, last, "inf");
+    if (word != p) {
+
+        const char* longer = matchWord(word, last, "inity");
+        value = sign * std::numeric_limits<Float>::infinity();
+
+        return longer;
+    }
+    word = matchWord(p, last, "nan");
+    if (word != p) {
+
+        value = std::numeric_limits<Float>::quiet_NaN();
+
+        return word;
+    }
+
+    //the significant digits, the first 19 of them as an integer too, and
+    //the power of ten of the last digit kept
+    char digits[PARSE_DIGITS];
+    unsigned count = 0;
+    std::uint64_t leading = 0;
+    int exponent = 0;
+    bool sticky = false;
+    bool any = false;
+    bool point = false;
+    for (; p != last; ++p) {
+
+        if (*p == '.' && !point) {
+
+            point = true;
+            continue;
+        }
+        if (*p < '0' || *p > '9') {
+
+            break;
+        }
+        any = true;
+
+        if (count == 0 && *p == '0') {
+
+            exponent -= point ? 1 : 0;
+        }
+        else if (count < PARSE_DIGITS) {
+
+            if (count < UINT64_DIGITS) {
+
+                leading = leading * 10 + static_cast<unsigned>(*p - '0');
+            }
+            digits[count++] = *p;
+            exponent -= point ? 1 : 0;
+        }
+        else {
+
+            sticky = sticky || *p != '0';
+            exponent += point ? 0 : 1;
+        }
+    }
+    if (!any) {
+
+        return first;
+    }
+
+    if (p != last && (*p == 'e' || *p == 'E')) {
+
+        //the exponent is only part of the number if it has digits
+        int power = 0;
+        const char* end = parseInteger(p + 1, last, power);
+        if (end == p + 1) {
+
+            //too many digits for an int, parsed by hand and clamped
+            const char* q = p + 1;
+            bool down = q != last && *q == '-';
+            q += q != last && (*q == '-' || *q == '+') ? 1 : 0;
+            for (end = q; end != last && *end >= '0' && *end <= '9'; ++end) {
+            }
+            power = end == q ? 0 :
+                (down ? -PARSE_EXPONENT : PARSE_EXPONENT);
+            end = end == q ? p : end;
+        }
+        power = power > PARSE_EXPONENT ? PARSE_EXPONENT :
+            (power < -PARSE_EXPONENT ? -PARSE_EXPONENT : power);
+        exponent += power;
+        p = end;
+    }
+
+    //the power of ten of the first digit decides zero and infinity
+    int first10 = exponent + static_cast<int>(count) - 1;
+    if (count == 0 || first10 <= Traits::ZERO_EXPONENT) {
+
+        value = sign * static_cast<Float>(0);
+
+        return p;
+    }
+    if (first10 >= Traits::INFINITY_EXPONENT) {
+
+        value = sign * std::numeric_limits<Float>::infinity();
+
+        return p;
+    }
+
+    //the fast path, where the digits and the power of ten are exact and one
+    //rounding gives the result
+    int magnitude = exponent < 0 ? -exponent : exponent;
+    if (count <= Traits::FAST_DIGITS && !sticky &&
+        magnitude <= Traits::FAST_EXPONENT) {
+
+        double x = static_cast<double>(leading);
+        x = exponent < 0 ? x / POW10_DOUBLE[magnitude] :
+            x * POW10_DOUBLE[magnitude];
+        value = sign * static_cast<Float>(x);
+
+        return p;
+    }
+
+    //an estimate within a few units in the last place, scaled a step at a
+    //time so it neither overflows nor underflows before the end
+    int scale = exponent + static_cast<int>(count) -
+        static_cast<int>(count < UINT64_DIGITS ? count : UINT64_DIGITS);
+    double estimate = static_cast<double>(leading);
+    while (scale != 0) {
+
+        int step = scale < 0 ? -scale : scale;
+        step = step < POW10_DOUBLE_MAX ? step : POW10_DOUBLE_MAX;
+        estimate = scale < 0 ?
+            estimate / POW10_DOUBLE[step] : estimate * POW10_DOUBLE[step];
+        scale += scale < 0 ? step : -step;
+    }
+    if (estimate > std::numeric_limits<Float>::max()) {
+
+        estimate = std::numeric_limits<Float>::max();
+    }
+    Float approximate = static_cast<Float>(estimate);
+
+    BigInteger exact;
+    for (unsigned i = 0; i < count; ++i) {
+
+        exact.multiplyAdd(10, static_cast<std::uint32_t>(digits[i] - '0'));
+    }
+
+    //step to a neighbour while the string is past a halfway point, the bits
+    //of non-negative floats count up in the same order as their values
+    const Bits hidden = static_cast<Bits>(1) << Traits::MANTISSA_BITS;
+    const int minimum = 1 - Traits::EXPONENT_BIAS -
+        static_cast<int>(Traits::MANTISSA_BITS);
+    Bits infinity;
+    Float inf = std::numeric_limits<Float>::infinity();
+    std::memcpy(&infinity, &inf, sizeof(Float));
+    Bits bits;
+    std::memcpy(&bits, &approximate, sizeof(Float));
+    for (;;) {
+
+        Bits f;
+        int e;
+        decompose<Float>(bits, f, e);
+
+        int c = compareDecimal(exact, exponent, sticky, f * 2 + 1, e - 1);
+        if (c > 0 || (c == 0 && (f & 1) != 0)) {
+
+            if (++bits == infinity) {
+
+                break;
+            }
+            continue;
+        }
+        if (f == 0) {
+
+            break;
+        }
+        c = f == hidden && e > minimum ?
+            compareDecimal(exact, exponent, sticky, f * 4 - 1, e - 2) :
+            compareDecimal(exact, exponent, sticky, f * 2 - 1, e - 1);
+        if (c < 0 || (c == 0 && (f & 1) != 0)) {
+
+            --bits;
+            continue;
+        }
+        break;
+    }
+
+    std::memcpy(&value, &bits, sizeof(Float));
+    value *= sign;
+
+    return p;
+}
+
+/**Converts one type of number to and from strings*/
+template<
+        typename Number,
+        bool INTEGER = std::numeric_limits<Number>::is_integer>
+struct Converter;
+
+template<typename Integer>
+struct Converter<Integer, true> {
+
+    static const std::size_t MAX_CHARS =
+        std::numeric_limits<Integer>::digits10 + 2;
+
+    static inline std::size_t format(Integer value, char* buffer) {
+
+        return formatInteger(value, buffer);
+    }
+
+    static inline const char* parse(
+            const char* first, const char* last, Integer& value) {
+
+        return parseInteger(first, last, value);
+    }
+};
+
+template<typename Float>
+struct Converter<Float, false> {
+
+    static const std::size_t MAX_CHARS = FloatTraits<Float>::MAX_CHARS;
+
+    static inline std::size_t format(Float value, char* buffer) {
+
+        return formatFloat(value, buffer);
+    }
+
+    static inline const char* parse(
+            const char* first, const char* last, Float& value) {
+
+        return parseFloat(first, last, value);
+    }
+};
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+// These convert integers, floats and doubles to and from decimal strings in
+// buffers the caller owns, without streams, locales or allocation. Floats are
+// written with the fewest significant digits that read back as the same value,
+// in positional notation when the first digit is between 10^-4 and the
+// largest number of digits the type needs, and as d.ddde-x otherwise, which
+// the standard library and these functions read back exactly. Infinities are
+// written as inf and -inf and NaNs as nan. The strings are not terminated.
+
+/**@return the greatest number of characters toChars() writes for a number of
+the given type*/
+template<typename Number>
+inline std::size_t maxChars() {
+
+    return detail::Converter<Number>::MAX_CHARS;
+}
+
+/**Writes a number as a decimal string, for floats with the fewest digits that
+read back as the same value
+@param value the integer, float or double to write
+@param buffer the buffer to write to, it must hold maxChars<Number>()
+characters
+@return the number of characters written*/
+template<typename Number>
+inline std::size_t toChars(Number value, char* buffer) {
+
+    UTIL_PROFILE_PROBE("str::toChars");
+
+    return detail::Converter<Number>::format(value, buffer);
+}
+
+/**Reads a number from the start of a decimal string. Integers are an
+optional sign and digits. Floats also have an optional fraction and
+exponent, or are inf, infinity or nan in any case. Floats are correctly
+rounded and those too large for the type are read as infinity
+@param first the start of the string
+@param last the end of the string
+@param value returns the number, it is unchanged if there is none
+@return the end of the number, or first if the string does not start with a
+number or an integer is too large for the type*/
+template<typename Number>
+inline const char* fromChars(
+        const char* first, const char* last, Number& value) {
+
+    UTIL_PROFILE_PROBE("str::fromChars");
+
+    return detail::Converter<Number>::parse(first, last, value);
+}
+
+/**Writes an array of numbers as decimal strings with a separator between each
+@param values the integers, floats or doubles to write
+@param n the number of values
+@param buffer the buffer to write to, it must hold n * (maxChars<Number>() +
+1) characters
+@param separator the character to put between each pair of numbers
+@return the number of characters written*/
+template<typename Number>
+inline std::size_t toChars(
+        const Number* values,
+        std::size_t n,
+        char* buffer,
+        char separator = ' ') {
+
+    UTIL_PROFILE_PROBE("str::toChars[]");
+
+    char* p = buffer;
+    for (std::size_t i = 0; i < n; ++i) {
+
+        if (i > 0) {
+
+            *p++ = separator;
+        }
+        p += detail::Converter<Number>::format(values[i], p);
+    }
+
+    return p - buffer;
+}
+
+/**Reads an array of numbers from a string, skipping any separating
+characters before each
+@param first the start of the string
+@param last the end of the string
+@param values returns the numbers
+@param n the greatest number of values to read
+@param separators the characters that may separate the numbers, terminated
+by a null character
+@return the number of values read, which is less than n if the string ends
+or holds something other than a number or a separator first*/
+template<typename Number>
+inline std::size_t fromChars(
+        const char* first,
+        const char* last,
+        Number* values,
+        std::size_t n,
+        const char* separators = " \t\n\r,;") {
+
+    UTIL_PROFILE_PROBE("str::fromChars[]");
+
+    std::size_t count = 0;
+    const char* p = first;
+    while (count < n) {
+
+        while (p != last && *p != '\0' && std::strchr(separators, *p)) {
+
+            ++p;
+        }
+        const char* end =
+            detail::Converter<Number>::parse(p, last, values[count]);
+        if (end == p) {
+
+            break;
+        }
+        p = end;
+        ++count;
+    }
+
+    return count;
+}
+
+} } //util //str
+
+#endif
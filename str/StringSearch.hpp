@@ -0,0 +1,645 @@
+#ifndef UTILITRON_STR_STRINGSEARCH_H_
+#   define UTILITRON_STR_STRINGSEARCH_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../MemoryUtil.hpp"
+#include "../ProfileUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+
+namespace util { namespace str {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of bytes of text each thread searches at a time in parallel mode
+static const std::size_t SEARCH_CHUNK = 1 << 20;
+//!the number of matches the find kernel reports per call
+static const std::size_t MATCH_BUFFER = 256;
+//!the number of blocks in a row without candidates after which the find
+//!kernel skips ahead with std::memchr(), in dense text the call costs more
+//!than it skips
+static const std::size_t SEARCH_SKIP_AFTER = 4;
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/**The matches found in one chunk of a parallel search*/
+struct ChunkMatches {
+
+    //!the first position a match in the chunk may start at, which is past the
+    //!end of any match that runs in from the chunks before
+    std::size_t begin;
+    //!the number of matches in the chunks before
+    std::size_t before;
+    //!the number of matches
+    std::size_t count;
+    //!the position past the end of the last match, or the start of the chunk
+    //!if there are none
+    std::size_t next;
+    //!the positions of the matches, if they are wanted
+    std::vector<std::size_t> positions;
+};
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return the bytes of a string*/
+inline const unsigned char* bytesOf(const std::string& str) {
+
+    return reinterpret_cast<const unsigned char*>(str.data());
+}
+
+/**@return a rough rank of how common a byte is in text, lower is rarer. Spaces
+and lower case letters are the most common, then the rest of printable ASCII
+and line breaks, then the bytes of other encodings, then control bytes*/
+inline unsigned byteFrequency(unsigned char byte) {
+
+    if (byte == ' ' || (byte >= 'a' && byte <= 'z')) {
+
+        return 3;
+    }
+    if ((byte > ' ' && byte < 0x7F) || byte == '\n' || byte == '\t') {
+
+        return 2;
+    }
+
+    return byte >= 0x80 ? 1 : 0;
+}
+
+/**@return the position in a pattern of m bytes, at least 1, of the byte that
+is likely to be rarest in text, the first of those that are equally rare*/
+inline std::size_t rarestByte(const unsigned char* pattern, std::size_t m) {
+
+    std::size_t rarest = 0;
+    for (std::size_t i = 1; i < m; ++i) {
+
+        if (byteFrequency(pattern[i]) < byteFrequency(pattern[rarest])) {
+
+            rarest = i;
+        }
+    }
+
+    return rarest;
+}
+
+#define UTIL_SIMD_KERNELS "str/detail/StringSearch.inl"
+#include "../SimdForEachIsa.hpp"
+
+typedef std::size_t (*FindKernel)(const unsigned char*, std::size_t,
+    const unsigned char*, std::size_t, std::size_t*, std::size_t);
+
+/**Finds the non-overlapping matches of a pattern that start in [begin, end),
+taking each as early as possible from begin
+@param kernel the find kernel
+@param text the text to search
+@param n the length of the whole text, matches may run past end up to here
+@param pattern the pattern to find
+@param m the length of the pattern, at least 1
+@param begin the first position a match may start at
+@param end the position matches must start before
+@param visit called with the position of each match in order
+@return the position past the end of the last match, or begin if there are
+none*/
+template<typename Visitor>
+inline std::size_t scanMatches(
+        FindKernel kernel,
+        const unsigned char* text,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        std::size_t begin,
+        std::size_t end,
+        Visitor visit) {
+
+    std::size_t limit = n - end > m - 1 ? end + m - 1 : n;
+    std::size_t p = begin;
+    std::size_t buffer[MATCH_BUFFER];
+    while (p < end && limit - p >= m) {
+
+        std::size_t found =
+            kernel(text + p, limit - p, pattern, m, buffer, MATCH_BUFFER);
+        for (std::size_t i = 0; i < found; ++i) {
+
+            visit(p + buffer[i]);
+        }
+        if (found > 0) {
+
+            p += buffer[found - 1] + m;
+        }
+        //a partly filled buffer means the kernel reached the end
+        if (found < MATCH_BUFFER) {
+
+            break;
+        }
+    }
+
+    return p;
+}
+
+/**Finds the first match of a pattern at or after a position
+@return the position of the match, or std::string::npos if there is none*/
+inline std::size_t findFirst(
+        const unsigned char* text,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        std::size_t from,
+        util::thread::Execution execution) {
+
+    if (from > n || m > n - from) {
+
+        return std::string::npos;
+    }
+    if (m == 0) {
+
+        return from;
+    }
+
+    FindKernel kernel = UTIL_SIMD_DISPATCH(detail, findBytes);
+    std::size_t length = n - from;
+    if (execution == util::thread::EXECUTE_SERIAL || length <= SEARCH_CHUNK) {
+
+        std::size_t found;
+
+        return kernel(text + from, length, pattern, m, &found, 1) == 0 ?
+            std::string::npos : from + found;
+    }
+
+    //chunks are taken in order, so those after the earliest chunk with a
+    //match can be skipped
+    std::size_t chunks = (length + SEARCH_CHUNK - 1) / SEARCH_CHUNK;
+    std::vector<std::size_t> found(chunks, std::string::npos);
+    std::atomic<std::size_t> earliest(chunks);
+    util::thread::parallelFor(length, SEARCH_CHUNK,
+        [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+            if (chunk > earliest.load(std::memory_order_relaxed)) {
+
+                return;
+            }
+            //the chunk's matches start before its end but may run past it
+            std::size_t start = from + begin;
+            std::size_t limit = n - (from + end) > m - 1 ?
+                from + end + m - 1 : n;
+            std::size_t position;
+            if (kernel(text + start, limit - start, pattern, m, &position, 1)) {
+
+                found[chunk] = start + position;
+                std::size_t current = earliest.load();
+                while (chunk < current &&
+                       !earliest.compare_exchange_weak(current, chunk)) {
+                }
+            }
+        });
+
+    std::size_t first = earliest.load();
+
+    return first < chunks ? found[first] : std::string::npos;
+}
+
+/**Finds the non-overlapping matches of a pattern at or after a position in
+chunks of SEARCH_CHUNK bytes across the thread pool
+@param keep whether to keep the positions of the matches of each chunk
+@param matches returns the matches of each chunk
+@return the number of matches*/
+inline std::size_t scanChunks(
+        FindKernel kernel,
+        const unsigned char* text,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        std::size_t from,
+        bool keep,
+        std::vector<ChunkMatches>& matches) {
+
+    std::size_t length = n - from;
+    std::size_t chunks = (length + SEARCH_CHUNK - 1) / SEARCH_CHUNK;
+    matches.resize(chunks);
+    //finds the matches in one chunk from a given start
+    auto scanChunk = [&](std::size_t chunk, std::size_t begin) {
+
+        ChunkMatches& chunkMatches = matches[chunk];
+        std::size_t end = from + (chunk + 1) * SEARCH_CHUNK;
+        chunkMatches.begin = begin;
+        chunkMatches.count = 0;
+        chunkMatches.positions.clear();
+        chunkMatches.next = scanMatches(kernel, text, n, pattern, m, begin,
+            end < n ? end : n,
+            [&](std::size_t position) {
+
+                ++chunkMatches.count;
+                if (keep) {
+
+                    chunkMatches.positions.push_back(position);
+                }
+            });
+    };
+    util::thread::parallelFor(length, SEARCH_CHUNK,
+        [&](std::size_t begin, std::size_t, std::size_t chunk) {
+
+            scanChunk(chunk, from + begin);
+        });
+
+    //a match that runs into the next chunk moves where that chunk's matches
+    //may start, so such a chunk is scanned again from the end of the match
+    std::size_t count = 0;
+    std::size_t next = from;
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+        if (next > from + chunk * SEARCH_CHUNK) {
+
+            scanChunk(chunk, next);
+        }
+        matches[chunk].before = count;
+        count += matches[chunk].count;
+        next = matches[chunk].next > next ? matches[chunk].next : next;
+    }
+
+    return count;
+}
+
+/**Finds the non-overlapping matches of a pattern at or after a position
+@param positions returns the positions of the matches if it is not null
+@return the number of matches*/
+inline std::size_t findMatches(
+        const unsigned char* text,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        std::size_t from,
+        util::thread::Execution execution,
+        std::vector<std::size_t>* positions) {
+
+    if (m == 0 || from > n || m > n - from) {
+
+        return 0;
+    }
+
+    FindKernel kernel = UTIL_SIMD_DISPATCH(detail, findBytes);
+    std::size_t length = n - from;
+    if (execution == util::thread::EXECUTE_SERIAL || length <= SEARCH_CHUNK) {
+
+        std::size_t count = 0;
+        scanMatches(kernel, text, n, pattern, m, from, n,
+            [&](std::size_t position) {
+
+                ++count;
+                if (positions) {
+
+                    positions->push_back(position);
+                }
+            });
+
+        return count;
+    }
+
+    std::vector<ChunkMatches> matches;
+    std::size_t count = scanChunks(
+        kernel, text, n, pattern, m, from, positions != nullptr, matches);
+
+    if (positions) {
+
+        positions->reserve(positions->size() + count);
+        for (std::size_t chunk = 0; chunk < matches.size(); ++chunk) {
+
+            positions->insert(positions->end(),
+                matches[chunk].positions.begin(),
+                matches[chunk].positions.end());
+        }
+    }
+
+    return count;
+}
+
+/**@return the length of a text once every match is replaced*/
+inline std::size_t replacedLength(
+        std::size_t n, std::size_t m, std::size_t r, std::size_t count) {
+
+    return n - count * m + count * r;
+}
+
+/**Copies the part of a text from begin up to stop with the matches of a
+pattern that start in [begin, end) replaced, taking each as early as
+possible from begin
+@param out where the copy of the text at begin goes*/
+inline void replaceRange(
+        FindKernel kernel,
+        const unsigned char* text,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        const unsigned char* replacement,
+        std::size_t r,
+        std::size_t begin,
+        std::size_t end,
+        std::size_t stop,
+        unsigned char* out) {
+
+    std::size_t copied = begin;
+    scanMatches(kernel, text, n, pattern, m, begin, end,
+        [&](std::size_t position) {
+
+            std::memcpy(out, text + copied, position - copied);
+            out += position - copied;
+            std::memcpy(out, replacement, r);
+            out += r;
+            copied = position + m;
+        });
+    std::memcpy(out, text + copied, stop - copied);
+}
+
+/**Counts the matches of a pattern that a replacement will replace, in
+parallel mode by chunks
+@param matches returns the matches of each chunk in parallel mode, and is left
+empty when the text is searched as a whole
+@return the number of matches*/
+inline std::size_t countReplacements(
+        const unsigned char* text,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        util::thread::Execution execution,
+        std::vector<ChunkMatches>& matches) {
+
+    if (m == 0 || m > n) {
+
+        return 0;
+    }
+    if (execution == util::thread::EXECUTE_SERIAL || n <= SEARCH_CHUNK) {
+
+        return findMatches(text, n, pattern, m, 0, execution, nullptr);
+    }
+
+    return scanChunks(UTIL_SIMD_DISPATCH(detail, findBytes), text, n, pattern,
+        m, 0, false, matches);
+}
+
+/**Copies a text with the matches counted by countReplacements() replaced,
+of which there must be at least one. The text is searched again rather than
+keeping the positions of the matches, in parallel mode each chunk is written
+where the matches before it put it
+@param matches the chunk matches from countReplacements()
+@param out the buffer to write to, it must hold replacedLength() bytes*/
+inline void replaceMatches(
+        const unsigned char* text,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        const unsigned char* replacement,
+        std::size_t r,
+        const std::vector<ChunkMatches>& matches,
+        unsigned char* out) {
+
+    FindKernel kernel = UTIL_SIMD_DISPATCH(detail, findBytes);
+    if (matches.empty()) {
+
+        replaceRange(kernel, text, n, pattern, m, replacement, r, 0, n, n, out);
+
+        return;
+    }
+
+    //each chunk copies the text up to where the next chunk's matches begin
+    std::size_t chunks = matches.size();
+    util::thread::parallelFor(chunks, 1,
+        [&](std::size_t, std::size_t, std::size_t chunk) {
+
+            std::size_t before = matches[chunk].before;
+            std::size_t begin = matches[chunk].begin;
+            std::size_t end = (chunk + 1) * SEARCH_CHUNK;
+            std::size_t stop = chunk + 1 < chunks ?
+                matches[chunk + 1].begin : n;
+            replaceRange(kernel, text, n, pattern, m, replacement, r, begin,
+                end < n ? end : n, stop, out + (begin - before * m) +
+                before * r);
+        });
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+// These search ASCII, UTF-8, or any other byte strings using the widest
+// instruction set the CPU supports, and across the thread pool when given
+// EXECUTE_PARALLEL and more than a chunk of text. Matches are non-overlapping
+// and taken from the front, as std::string::find() would step through them,
+// and the results are the same in either mode.
+
+/**Finds the first occurrence of a pattern in a byte string
+@param data the bytes to search
+@param n the number of bytes
+@param pattern the bytes to find
+@param m the number of bytes in the pattern
+@param from the position to start searching at
+@param execution whether to split large inputs across the thread pool
+@return the position of the first match, or std::string::npos if there is
+none. An empty pattern matches at from if it is no more than n*/
+inline std::size_t find(
+        const unsigned char* data,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        std::size_t from = 0,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::find");
+
+    return detail::findFirst(data, n, pattern, m, from, execution);
+}
+
+/**Finds the first occurrence of a pattern in a string
+@param str the string to search
+@param pattern the string to find
+@param from the position to start searching at
+@param execution whether to split large strings across the thread pool
+@return the position of the first match, or std::string::npos if there is
+none. An empty pattern matches at from if it is within the string*/
+inline std::size_t find(
+        const std::string& str,
+        const std::string& pattern,
+        std::size_t from = 0,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::find");
+
+    return detail::findFirst(detail::bytesOf(str), str.size(),
+        detail::bytesOf(pattern), pattern.size(), from, execution);
+}
+
+/**Counts the non-overlapping occurrences of a pattern in a byte string
+@param data the bytes to search
+@param n the number of bytes
+@param pattern the bytes to find
+@param m the number of bytes in the pattern, an empty pattern is never
+counted
+@param execution whether to split large inputs across the thread pool
+@return the number of matches*/
+inline std::size_t count(
+        const unsigned char* data,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::count");
+
+    return detail::findMatches(data, n, pattern, m, 0, execution, nullptr);
+}
+
+/**Counts the non-overlapping occurrences of a pattern in a string
+@param str the string to search
+@param pattern the string to find, an empty pattern is never counted
+@param execution whether to split large strings across the thread pool
+@return the number of matches*/
+inline std::size_t count(
+        const std::string& str,
+        const std::string& pattern,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::count");
+
+    return detail::findMatches(detail::bytesOf(str), str.size(),
+        detail::bytesOf(pattern), pattern.size(), 0, execution, nullptr);
+}
+
+/**Finds the non-overlapping occurrences of a pattern in a byte string
+@param data the bytes to search
+@param n the number of bytes
+@param pattern the bytes to find
+@param m the number of bytes in the pattern, an empty pattern is never found
+@param execution whether to split large inputs across the thread pool
+@return the positions of the matches in order*/
+inline std::vector<std::size_t> findAll(
+        const unsigned char* data,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::findAll");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::vector<std::size_t> positions;
+    detail::findMatches(data, n, pattern, m, 0, execution, &positions);
+
+    return positions;
+}
+
+/**Finds the non-overlapping occurrences of a pattern in a string
+@param str the string to search
+@param pattern the string to find, an empty pattern is never found
+@param execution whether to split large strings across the thread pool
+@return the positions of the matches in order*/
+inline std::vector<std::size_t> findAll(
+        const std::string& str,
+        const std::string& pattern,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::findAll");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::vector<std::size_t> positions;
+    detail::findMatches(detail::bytesOf(str), str.size(),
+        detail::bytesOf(pattern), pattern.size(), 0, execution, &positions);
+
+    return positions;
+}
+
+/**Replaces every non-overlapping occurrence of a pattern in a byte string.
+The matches are counted in a first pass so the result is allocated once at
+its final size, and written in a second pass, without holding the positions
+of the matches or growing with each replacement
+@param data the bytes to search
+@param n the number of bytes
+@param pattern the bytes to replace, an empty pattern replaces nothing
+@param m the number of bytes in the pattern
+@param replacement the bytes to put in place of each match
+@param r the number of bytes in the replacement
+@param execution whether to split large inputs across the thread pool
+@return a copy of the bytes with the matches replaced*/
+inline std::vector<unsigned char> replaceAll(
+        const unsigned char* data,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        const unsigned char* replacement,
+        std::size_t r,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::replaceAll");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::vector<detail::ChunkMatches> matches;
+    std::size_t count =
+        detail::countReplacements(data, n, pattern, m, execution, matches);
+    if (count == 0) {
+
+        return std::vector<unsigned char>(data, data + n);
+    }
+
+    std::vector<unsigned char> replaced(
+        detail::replacedLength(n, m, r, count));
+    if (!replaced.empty()) {
+
+        detail::replaceMatches(data, n, pattern, m, replacement, r, matches,
+            &replaced[0]);
+    }
+
+    return replaced;
+}
+
+/**Replaces every non-overlapping occurrence of a pattern in a string. The
+matches are counted in a first pass so the result is allocated once at its
+final size, and written in a second pass, without holding the positions of
+the matches or growing with each replacement
+@param str the string to search
+@param pattern the string to replace, an empty pattern replaces nothing
+@param replacement the string to put in place of each match
+@param execution whether to split large strings across the thread pool
+@return a copy of the string with the matches replaced*/
+inline std::string replaceAll(
+        const std::string& str,
+        const std::string& pattern,
+        const std::string& replacement,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::replaceAll");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::vector<detail::ChunkMatches> matches;
+    std::size_t count = detail::countReplacements(detail::bytesOf(str),
+        str.size(), detail::bytesOf(pattern), pattern.size(), execution,
+        matches);
+    if (count == 0) {
+
+        return str;
+    }
+
+    std::string replaced(detail::replacedLength(str.size(), pattern.size(),
+        replacement.size(), count), '\0');
+    if (!replaced.empty()) {
+
+        detail::replaceMatches(detail::bytesOf(str), str.size(),
+            detail::bytesOf(pattern), pattern.size(),
+            detail::bytesOf(replacement), replacement.size(), matches,
+            reinterpret_cast<unsigned char*>(&replaced[0]));
+    }
+
+    return replaced;
+}
+
+} } //util //str
+
+#endif
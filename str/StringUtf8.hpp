@@ -0,0 +1,806 @@
+#ifndef UTILITRON_STR_STRINGUTF8_H_
+#   define UTILITRON_STR_STRINGUTF8_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../MemoryUtil.hpp"
+#include "../ProfileUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+
+namespace util { namespace str {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of bytes of text each thread measures at a time in parallel mode
+static const std::size_t UTF8_CHUNK = 1 << 20;
+
+//the errors a pair of adjacent bytes can show, each of the validation tables
+//gives the errors a pair may have going by one nibble of it and a pair is
+//invalid if all three agree on one
+static const unsigned char UTF8_TOO_SHORT = 1 << 0;
+static const unsigned char UTF8_TOO_LONG = 1 << 1;
+static const unsigned char UTF8_OVERLONG_3 = 1 << 2;
+static const unsigned char UTF8_TOO_LARGE = 1 << 3;
+static const unsigned char UTF8_SURROGATE = 1 << 4;
+static const unsigned char UTF8_OVERLONG_2 = 1 << 5;
+static const unsigned char UTF8_TOO_LARGE_1000 = 1 << 6;
+static const unsigned char UTF8_OVERLONG_4 = 1 << 6;
+//a continuation after a continuation, which is only an error if the byte
+//before them is not a lead of three or four bytes
+static const unsigned char UTF8_TWO_CONTS = 1 << 7;
+static const unsigned char UTF8_CARRY =
+    UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS;
+
+//!the errors by the high nibble of the first byte of a pair
+static const unsigned char UTF8_FIRST_HIGH[16] = {
+    //ascii
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+    //continuations
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+    //leads of two, three, and four bytes
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+    UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+};
+//!the errors by the low nibble of the first byte of a pair
+static const unsigned char UTF8_FIRST_LOW[16] = {
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+    UTF8_CARRY | UTF8_OVERLONG_2,
+    UTF8_CARRY,
+    UTF8_CARRY,
+    UTF8_CARRY | UTF8_TOO_LARGE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+};
+//!the errors by the high nibble of the second byte of a pair
+static const unsigned char UTF8_SECOND_HIGH[16] = {
+    //ascii
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+    //continuations 0x80 to 0x8F, 0x90 to 0x9F, and 0xA0 to 0xBF
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+        UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 |
+        UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE |
+        UTF8_TOO_LARGE,
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE |
+        UTF8_TOO_LARGE,
+    //leads
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+};
+//!the greatest byte at each of the last positions of a block that does not
+//!start a sequence running past the block, a block loads the last
+//!BLOCK_BYTES of these
+static const unsigned char UTF8_INCOMPLETE_LIMIT[64] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+
+//flags of the width lookup tables, a byte's flags are those its high and low
+//nibbles agree on
+//!ascii and continuations, which are counted apart
+static const unsigned char WIDTH_PLAIN = 1 << 0;
+//!leads of two bytes starting with 0xC whose codepoints are all one column
+static const unsigned char WIDTH_NARROW_C = 1 << 1;
+//!leads of two bytes starting with 0xD whose codepoints are all one column
+static const unsigned char WIDTH_NARROW_D = 1 << 2;
+//!leads of three bytes whose codepoints are all two columns
+static const unsigned char WIDTH_WIDE = 1 << 3;
+
+//!the width flags by the high nibble of a byte
+static const unsigned char WIDTH_HIGH[16] = {
+    WIDTH_PLAIN, WIDTH_PLAIN, WIDTH_PLAIN, WIDTH_PLAIN,
+    WIDTH_PLAIN, WIDTH_PLAIN, WIDTH_PLAIN, WIDTH_PLAIN,
+    WIDTH_PLAIN, WIDTH_PLAIN, WIDTH_PLAIN, WIDTH_PLAIN,
+    WIDTH_NARROW_C, WIDTH_NARROW_D, WIDTH_WIDE, 0
+};
+//!the width flags by the low nibble of a byte: 0xC3 to 0xCB are U+00C0 to
+//!U+02FF, 0xCE to 0xD5 less 0xD2 are Greek, Cyrillic, and Armenian, 0xDA and
+//!0xDF are blocks of Arabic and N'Ko without marks, 0xE4 to 0xE9 are CJK
+//!ideographs, and 0xEB and 0xEC are Hangul syllables
+static const unsigned char WIDTH_LOW[16] = {
+    WIDTH_PLAIN | WIDTH_NARROW_D,
+    WIDTH_PLAIN | WIDTH_NARROW_D,
+    WIDTH_PLAIN,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_NARROW_D,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_NARROW_D | WIDTH_WIDE,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_NARROW_D | WIDTH_WIDE,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_WIDE,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_WIDE,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_WIDE,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_WIDE,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_NARROW_D,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_WIDE,
+    WIDTH_PLAIN | WIDTH_WIDE,
+    WIDTH_PLAIN,
+    WIDTH_PLAIN | WIDTH_NARROW_C,
+    WIDTH_PLAIN | WIDTH_NARROW_C | WIDTH_NARROW_D
+};
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/**An inclusive range of codepoints*/
+struct CodepointRange {
+
+    //!the first codepoint in the range
+    std::uint32_t first;
+    //!the last codepoint in the range
+    std::uint32_t last;
+};
+
+//!the combining marks, joiners, and other format characters that take no
+//!columns of their own, sorted
+static const CodepointRange ZERO_WIDTH[] = {
+    {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x05BF, 0x05BF},
+    {0x05C1, 0x05C2}, {0x05C4, 0x05C5}, {0x05C7, 0x05C7}, {0x0610, 0x061A},
+    {0x061C, 0x061C}, {0x064B, 0x065F}, {0x0670, 0x0670}, {0x06D6, 0x06DC},
+    {0x06DF, 0x06E4}, {0x06E7, 0x06E8}, {0x06EA, 0x06ED}, {0x0711, 0x0711},
+    {0x0730, 0x074A}, {0x07A6, 0x07B0}, {0x0900, 0x0902}, {0x093A, 0x093A},
+    {0x093C, 0x093C}, {0x0941, 0x0948}, {0x094D, 0x094D}, {0x0951, 0x0957},
+    {0x0962, 0x0963}, {0x0981, 0x0981}, {0x09BC, 0x09BC}, {0x09C1, 0x09C4},
+    {0x09CD, 0x09CD}, {0x09E2, 0x09E3}, {0x0E31, 0x0E31}, {0x0E34, 0x0E3A},
+    {0x0E47, 0x0E4E}, {0x0EB1, 0x0EB1}, {0x0EB4, 0x0EBC}, {0x0EC8, 0x0ECD},
+    {0x1160, 0x11FF}, {0x1AB0, 0x1AFF}, {0x1DC0, 0x1DFF}, {0x200B, 0x200F},
+    {0x202A, 0x202E}, {0x2060, 0x2064}, {0x20D0, 0x20FF}, {0x302A, 0x302D},
+    {0x3099, 0x309A}, {0xFE00, 0xFE0F}, {0xFE20, 0xFE2F}, {0xFEFF, 0xFEFF},
+    {0x1F3FB, 0x1F3FF}, {0xE0001, 0xE0001}, {0xE0020, 0xE007F},
+    {0xE0100, 0xE01EF}
+};
+//!the East Asian wide and full-width characters and the emoji that take two
+//!columns, sorted
+static const CodepointRange WIDE[] = {
+    {0x1100, 0x115F}, {0x2329, 0x232A}, {0x2E80, 0x303E}, {0x3040, 0xA4CF},
+    {0xAC00, 0xD7A3}, {0xF900, 0xFAFF}, {0xFE10, 0xFE19}, {0xFE30, 0xFE6F},
+    {0xFF00, 0xFF60}, {0xFFE0, 0xFFE6}, {0x1F300, 0x1F64F},
+    {0x1F900, 0x1F9FF}, {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD}
+};
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return whether a codepoint is in one of a sorted array of ranges*/
+template<std::size_t N>
+inline bool inRanges(
+        std::uint32_t codepoint, const CodepointRange (&ranges)[N]) {
+
+    if (codepoint < ranges[0].first || codepoint > ranges[N - 1].last) {
+
+        return false;
+    }
+
+    std::size_t low = 0;
+    std::size_t high = N;
+    while (low < high) {
+
+        std::size_t middle = (low + high) / 2;
+        if (codepoint < ranges[middle].first) {
+
+            high = middle;
+        }
+        else if (codepoint > ranges[middle].last) {
+
+            low = middle + 1;
+        }
+        else {
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**@return whether a byte continues a sequence rather than starting one*/
+inline bool isContinuation(unsigned char byte) {
+
+    return (byte & 0xC0) == 0x80;
+}
+
+/**Decodes the sequence at the front of some UTF-8
+@param text the bytes to decode
+@param n the number of bytes, at least 1
+@param codepoint returns the codepoint if the sequence is valid
+@return the length of the sequence, or 0 if it is not valid UTF-8: a stray
+continuation, an overlong encoding, a surrogate, a codepoint above U+10FFFF,
+or a sequence cut short*/
+inline std::size_t decodeUtf8(
+        const unsigned char* text, std::size_t n, std::uint32_t& codepoint) {
+
+    unsigned char lead = text[0];
+    if (lead < 0x80) {
+
+        codepoint = lead;
+
+        return 1;
+    }
+
+    std::size_t length;
+    //the range of the second byte, which is narrower than a plain
+    //continuation after the leads that could otherwise encode overlongs,
+    //surrogates, or codepoints that are too large
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+
+        length = 2;
+        codepoint = lead & 0x1F;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF) {
+
+        length = 3;
+        codepoint = lead & 0x0F;
+        low = lead == 0xE0 ? 0xA0 : 0x80;
+        high = lead == 0xED ? 0x9F : 0xBF;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4) {
+
+        length = 4;
+        codepoint = lead & 0x07;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF;
+    }
+    else {
+
+        return 0;
+    }
+
+    if (n < length || text[1] < low || text[1] > high) {
+
+        return 0;
+    }
+    codepoint = (codepoint << 6) | (text[1] & 0x3F);
+    for (std::size_t i = 2; i < length; ++i) {
+
+        if (!isContinuation(text[i])) {
+
+            return 0;
+        }
+        codepoint = (codepoint << 6) | (text[i] & 0x3F);
+    }
+
+    return length;
+}
+
+/**@return the position of the first sequence at or after begin that is not
+valid UTF-8, or n if there is none. begin must be the start of a sequence*/
+inline std::size_t scanUtf8(
+        const unsigned char* text, std::size_t begin, std::size_t n) {
+
+    std::size_t i = begin;
+    while (i < n) {
+
+        if (text[i] < 0x80) {
+
+            ++i;
+
+            continue;
+        }
+        std::uint32_t codepoint;
+        std::size_t length = decodeUtf8(text + i, n - i, codepoint);
+        if (length == 0) {
+
+            return i;
+        }
+        i += length;
+    }
+
+    return n;
+}
+
+/**@return the number of columns a codepoint takes*/
+inline unsigned widthOfCodepoint(std::uint32_t codepoint) {
+
+    //control characters do not advance by a fixed number of columns
+    if (codepoint < 0x20 || (codepoint >= 0x7F && codepoint <= 0x9F)) {
+
+        return 0;
+    }
+    if (codepoint < 0x0300) {
+
+        return 1;
+    }
+    //the bulk of Chinese, Japanese, and Korean text, which has no zero width
+    //characters
+    if ((codepoint >= 0x4E00 && codepoint <= 0x9FFF) ||
+        (codepoint >= 0xAC00 && codepoint <= 0xD7A3)) {
+
+        return 2;
+    }
+    if (inRanges(codepoint, ZERO_WIDTH)) {
+
+        return 0;
+    }
+
+    return inRanges(codepoint, WIDE) ? 2 : 1;
+}
+
+/**Measures the sequence at the front of some UTF-8, a byte that does not
+start a valid sequence is taken as one replacement character
+@param text the bytes to measure
+@param n the number of bytes, at least 1
+@param width has the number of columns of the sequence added to it
+@return the number of bytes the sequence takes*/
+inline std::size_t measureSequence(
+        const unsigned char* text, std::size_t n, std::size_t& width) {
+
+    std::uint32_t codepoint;
+    std::size_t length = decodeUtf8(text, n, codepoint);
+    if (length == 0) {
+
+        ++width;
+
+        return 1;
+    }
+    width += widthOfCodepoint(codepoint);
+
+    return length;
+}
+
+/**Measures the sequences of some UTF-8 that start in [begin, end), the last
+of which may run past end
+@param text the bytes to measure
+@param n the number of bytes
+@param width has the number of columns of the sequences added to it
+@return the position after the last sequence*/
+inline std::size_t measureSequences(
+        const unsigned char* text,
+        std::size_t n,
+        std::size_t begin,
+        std::size_t end,
+        std::size_t& width) {
+
+    std::size_t i = begin;
+    while (i < end) {
+
+        if (text[i] < 0x80) {
+
+            width += text[i] >= 0x20 && text[i] != 0x7F;
+            ++i;
+        }
+        else {
+
+            i += measureSequence(text + i, n - i, width);
+        }
+    }
+
+    return i;
+}
+
+/**@return whether a byte is an ASCII letter of the given case*/
+template<bool UPPER>
+inline bool isAsciiLetter(unsigned char byte) {
+
+    return static_cast<unsigned char>(byte - (UPPER ? 'A' : 'a')) <= 25;
+}
+
+/**@return whether a byte is a space, tab, line feed, vertical tab, form feed,
+or carriage return*/
+inline bool isWhitespaceByte(unsigned char byte) {
+
+    return byte == ' ' || static_cast<unsigned char>(byte - '\t') <= 4;
+}
+
+#define UTIL_SIMD_KERNELS "str/detail/StringUtf8.inl"
+#include "../SimdForEachIsa.hpp"
+
+typedef void (*CaseKernel)(const unsigned char*, unsigned char*, std::size_t);
+
+/**@return the first position at or after a chunk boundary that no valid
+sequence runs across, so that chunks split there can be measured apart*/
+inline std::size_t sequenceStart(
+        const unsigned char* text, std::size_t n, std::size_t position) {
+
+    //a valid sequence has at most three continuations, after which the
+    //position is invalid wherever the chunk starts
+    std::size_t limit = position + 3 < n ? position + 3 : n;
+    while (position < limit && isContinuation(text[position])) {
+
+        ++position;
+    }
+
+    return position;
+}
+
+/**@return the number of chunks forEachSequenceChunk() splits n bytes into*/
+inline std::size_t sequenceChunks(
+        std::size_t n, util::thread::Execution execution) {
+
+    return execution == util::thread::EXECUTE_SERIAL || n <= UTF8_CHUNK ?
+        1 : (n + UTF8_CHUNK - 1) / UTF8_CHUNK;
+}
+
+/**Runs a function over some UTF-8 split into sequenceChunks() chunks whose
+boundaries, other than the start of the text, are moved forward by
+sequenceStart()
+@param function called as function(chunk, begin, end) for each chunk*/
+template<typename Function>
+inline void forEachSequenceChunk(
+        const unsigned char* text,
+        std::size_t n,
+        util::thread::Execution execution,
+        Function function) {
+
+    if (sequenceChunks(n, execution) == 1) {
+
+        function(static_cast<std::size_t>(0), static_cast<std::size_t>(0), n);
+
+        return;
+    }
+
+    util::thread::parallelFor(n, UTF8_CHUNK,
+        [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+            //no chunk comes before the first, so it keeps any stray
+            //continuations at the front of the text
+            function(chunk, begin == 0 ? 0 : sequenceStart(text, n, begin),
+                sequenceStart(text, n, end));
+        });
+}
+
+/**Converts the case of the ASCII letters of a byte string, across the thread
+pool in parallel mode. in and out may be the same*/
+inline void convertCase(
+        CaseKernel kernel,
+        const unsigned char* in,
+        unsigned char* out,
+        std::size_t n,
+        util::thread::Execution execution) {
+
+    util::thread::execute(execution, n, UTF8_CHUNK,
+        [&](std::size_t begin, std::size_t end) {
+
+            kernel(in + begin, out + begin, end - begin);
+        });
+}
+
+/**@return the bytes of a string*/
+inline const unsigned char* utf8Bytes(const std::string& str) {
+
+    return reinterpret_cast<const unsigned char*>(str.data());
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+// These work through UTF-8 a block of bytes at a time using the widest
+// instruction set the CPU supports, taking runs of ASCII at full speed, and
+// the bulk functions split large inputs across the thread pool when given
+// EXECUTE_PARALLEL. The results are the same in either mode. Case conversion
+// and white-space only consider ASCII, which leaves the bytes of multi-byte
+// sequences untouched, so they are safe to use on any UTF-8.
+
+/**Finds the first byte of some UTF-8 that does not start a valid sequence.
+Overlong encodings, surrogates, codepoints above U+10FFFF, stray
+continuation bytes, and sequences that are cut short are all invalid
+@param data the bytes to check
+@param n the number of bytes
+@param execution whether to split large inputs across the thread pool
+@return the position of the first invalid sequence, or std::string::npos if
+the bytes are valid UTF-8*/
+inline std::size_t findInvalidUtf8(
+        const unsigned char* data,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::findInvalidUtf8");
+
+    std::size_t (*kernel)(const unsigned char*, std::size_t) =
+        UTIL_SIMD_DISPATCH(detail, validateUtf8);
+
+    //the first chunk with an invalid sequence has the earliest one
+    std::vector<std::size_t> invalid(detail::sequenceChunks(n, execution));
+    detail::forEachSequenceChunk(data, n, execution,
+        [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+
+            std::size_t position = kernel(data + begin, end - begin);
+            invalid[chunk] =
+                position == end - begin ? std::string::npos : begin + position;
+        });
+    for (std::size_t chunk = 0; chunk < invalid.size(); ++chunk) {
+
+        if (invalid[chunk] != std::string::npos) {
+
+            return invalid[chunk];
+        }
+    }
+
+    return std::string::npos;
+}
+
+/**Finds the first byte of a string that does not start a valid UTF-8
+sequence
+@param str the string to check
+@param execution whether to split large strings across the thread pool
+@return the position of the first invalid sequence, or std::string::npos if
+the string is valid UTF-8*/
+inline std::size_t findInvalidUtf8(
+        const std::string& str,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    return findInvalidUtf8(detail::utf8Bytes(str), str.size(), execution);
+}
+
+/**@return whether some bytes are valid UTF-8, see findInvalidUtf8()*/
+inline bool isValidUtf8(
+        const unsigned char* data,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    return findInvalidUtf8(data, n, execution) == std::string::npos;
+}
+
+/**@return whether a string is valid UTF-8, see findInvalidUtf8()*/
+inline bool isValidUtf8(
+        const std::string& str,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    return findInvalidUtf8(str, execution) == std::string::npos;
+}
+
+/**Counts the codepoints of some UTF-8, that is the bytes that are not
+continuation bytes. This is exact for valid UTF-8 and counts each stray
+continuation of invalid UTF-8 as part of the codepoint before it
+@param data the bytes to count
+@param n the number of bytes
+@param execution whether to split large inputs across the thread pool
+@return the number of codepoints*/
+inline std::size_t countCodepoints(
+        const unsigned char* data,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::countCodepoints");
+
+    std::size_t (*kernel)(const unsigned char*, std::size_t) =
+        UTIL_SIMD_DISPATCH(detail, countContinuations);
+
+    std::vector<std::size_t> continuations(
+        detail::sequenceChunks(n, execution));
+    util::thread::execute(execution, n, detail::UTF8_CHUNK,
+        [&](std::size_t begin, std::size_t end) {
+
+            continuations[begin / detail::UTF8_CHUNK] =
+                kernel(data + begin, end - begin);
+        });
+
+    std::size_t count = n;
+    for (std::size_t chunk = 0; chunk < continuations.size(); ++chunk) {
+
+        count -= continuations[chunk];
+    }
+
+    return count;
+}
+
+/**Counts the codepoints of a UTF-8 string, see countCodepoints()
+@param str the string to count
+@param execution whether to split large strings across the thread pool
+@return the number of codepoints*/
+inline std::size_t countCodepoints(
+        const std::string& str,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    return countCodepoints(detail::utf8Bytes(str), str.size(), execution);
+}
+
+/**@return the number of columns a codepoint takes in a terminal or other
+fixed-width text: 2 for East Asian wide and full-width characters and emoji,
+0 for control characters, combining marks, and other format characters, and
+1 otherwise*/
+inline unsigned codepointWidth(std::uint32_t codepoint) {
+
+    return detail::widthOfCodepoint(codepoint);
+}
+
+/**Measures the number of columns some UTF-8 takes in a terminal or other
+fixed-width text, the sum of the codepointWidth() of its codepoints. Each
+byte that does not start a valid sequence is taken as a replacement
+character one column wide
+@param data the bytes to measure
+@param n the number of bytes
+@param execution whether to split large inputs across the thread pool
+@return the display width*/
+inline std::size_t displayWidth(
+        const unsigned char* data,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::displayWidth");
+
+    std::size_t (*kernel)(const unsigned char*, std::size_t) =
+        UTIL_SIMD_DISPATCH(detail, displayWidthOf);
+
+    std::vector<std::size_t> widths(detail::sequenceChunks(n, execution));
+    detail::forEachSequenceChunk(data, n, execution,
+        [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+
+            widths[chunk] = kernel(data + begin, end - begin);
+        });
+
+    std::size_t width = 0;
+    for (std::size_t chunk = 0; chunk < widths.size(); ++chunk) {
+
+        width += widths[chunk];
+    }
+
+    return width;
+}
+
+/**Measures the number of columns a UTF-8 string takes, see displayWidth()
+@param str the string to measure
+@param execution whether to split large strings across the thread pool
+@return the display width*/
+inline std::size_t displayWidth(
+        const std::string& str,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    return displayWidth(detail::utf8Bytes(str), str.size(), execution);
+}
+
+/**Converts the ASCII letters of a byte string to upper case in place
+@param data the bytes to convert
+@param n the number of bytes
+@param execution whether to split large inputs across the thread pool*/
+inline void toUpperAscii(
+        unsigned char* data,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::toUpperAscii");
+
+    detail::convertCase(UTIL_SIMD_DISPATCH(detail, changeCase<true>),
+        data, data, n, execution);
+}
+
+/**@return a copy of a string with its ASCII letters in upper case*/
+inline std::string toUpperAscii(
+        const std::string& str,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::toUpperAscii");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::string upper(str.size(), '\0');
+    if (!str.empty()) {
+
+        detail::convertCase(UTIL_SIMD_DISPATCH(detail, changeCase<true>),
+            detail::utf8Bytes(str), reinterpret_cast<unsigned char*>(&upper[0]),
+            str.size(), execution);
+    }
+
+    return upper;
+}
+
+/**Converts the ASCII letters of a byte string to lower case in place
+@param data the bytes to convert
+@param n the number of bytes
+@param execution whether to split large inputs across the thread pool*/
+inline void toLowerAscii(
+        unsigned char* data,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::toLowerAscii");
+
+    detail::convertCase(UTIL_SIMD_DISPATCH(detail, changeCase<false>),
+        data, data, n, execution);
+}
+
+/**@return a copy of a string with its ASCII letters in lower case*/
+inline std::string toLowerAscii(
+        const std::string& str,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("str::toLowerAscii");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::string lower(str.size(), '\0');
+    if (!str.empty()) {
+
+        detail::convertCase(UTIL_SIMD_DISPATCH(detail, changeCase<false>),
+            detail::utf8Bytes(str), reinterpret_cast<unsigned char*>(&lower[0]),
+            str.size(), execution);
+    }
+
+    return lower;
+}
+
+/**Finds the first white-space byte of a byte string: a space, tab, line
+feed, vertical tab, form feed, or carriage return
+@param data the bytes to search
+@param n the number of bytes
+@param from the position to start searching at
+@return the position of the white-space, or std::string::npos if there is
+none*/
+inline std::size_t findWhitespace(
+        const unsigned char* data, std::size_t n, std::size_t from = 0) {
+
+    UTIL_PROFILE_PROBE("str::findWhitespace");
+
+    if (from >= n) {
+
+        return std::string::npos;
+    }
+    std::size_t position = UTIL_SIMD_DISPATCH(detail, whitespaceSpan<false>)(
+        data + from, n - from);
+
+    return position == n - from ? std::string::npos : from + position;
+}
+
+/**@return the position of the first white-space character of a string at or
+after from, or std::string::npos if there is none, see findWhitespace()*/
+inline std::size_t findWhitespace(
+        const std::string& str, std::size_t from = 0) {
+
+    return findWhitespace(detail::utf8Bytes(str), str.size(), from);
+}
+
+/**Finds the first byte of a byte string that is not white-space
+@param data the bytes to search
+@param n the number of bytes
+@param from the position to start searching at
+@return the position of the byte, or std::string::npos if the rest of the
+bytes are all white-space*/
+inline std::size_t findNonWhitespace(
+        const unsigned char* data, std::size_t n, std::size_t from = 0) {
+
+    UTIL_PROFILE_PROBE("str::findNonWhitespace");
+
+    if (from >= n) {
+
+        return std::string::npos;
+    }
+    std::size_t position = UTIL_SIMD_DISPATCH(detail, whitespaceSpan<true>)(
+        data + from, n - from);
+
+    return position == n - from ? std::string::npos : from + position;
+}
+
+/**@return the position of the first character of a string at or after from
+that is not white-space, or std::string::npos if there is none*/
+inline std::size_t findNonWhitespace(
+        const std::string& str, std::size_t from = 0) {
+
+    return findNonWhitespace(detail::utf8Bytes(str), str.size(), from);
+}
+
+/**@return whether a string is empty or only white-space*/
+inline bool isBlank(const std::string& str) {
+
+    return findNonWhitespace(str) == std::string::npos;
+}
+
+} } //util //str
+
+#endif
@@ -0,0 +1,407 @@
+#ifndef UTILITRON_STR_STRINGVIEW_H_
+#   define UTILITRON_STR_STRINGVIEW_H_
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../MemoryUtil.hpp"
+#include "../ProfileUtil.hpp"
+
+//std::string_view is C++17, so these functions are only declared when
+//compiling for C++17 or later
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#   include <string_view>
+#   define UTIL_STR_STRING_VIEW
+#endif
+
+#ifdef UTIL_STR_STRING_VIEW
+
+namespace util { namespace str {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the characters trim() and tokenize() treat as white-space by default
+static const std::string_view WHITESPACE = " \t\n\v\f\r";
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/****************************************************************************\
+| The tokens of a string, found lazily as the range is iterated so that huge |
+| inputs are never split up front. Each token is a view into the original    |
+| string, which must outlive the range and its iterators. Ranges are made by |
+| split(), which keeps the empty tokens between adjacent delimiters, and by  |
+| tokenize(), which splits at any of a set of characters and skips empty     |
+| tokens.                                                                    |
+\****************************************************************************/
+class TokenRange {
+public:
+
+    /**A forward iterator over the tokens of a range*/
+    class iterator {
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::string_view value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::string_view* pointer;
+        typedef const std::string_view& reference;
+
+        //----------------------------------------------------------------------
+        //                             CONSTRUCTORS
+        //----------------------------------------------------------------------
+
+        /**Creates an iterator past the last token of any range*/
+        inline iterator() :
+            mAnyOf(false),
+            mNext(std::string_view::npos),
+            mEnd(true) {
+        }
+
+        /**Creates an iterator at the first token of a range, the iterator
+        does not refer to the range so it may outlive it
+        @param range the range to iterate*/
+        inline explicit iterator(const TokenRange& range) :
+            mText(range.mText),
+            mDelimiter(range.mDelimiter),
+            mAnyOf(range.mAnyOf),
+            mNext(0),
+            mEnd(false) {
+
+            advance();
+        }
+
+        //----------------------------------------------------------------------
+        //                              OPERATORS
+        //----------------------------------------------------------------------
+
+        /**@return the current token*/
+        inline reference operator *() const {
+
+            return mToken;
+        }
+
+        /**@return a pointer to the current token*/
+        inline pointer operator ->() const {
+
+            return &mToken;
+        }
+
+        /**Moves to the next token
+        @return this iterator*/
+        inline iterator& operator ++() {
+
+            advance();
+
+            return *this;
+        }
+
+        /**Moves to the next token
+        @return a copy of this iterator from before it moved*/
+        inline iterator operator ++(int) {
+
+            iterator previous(*this);
+            advance();
+
+            return previous;
+        }
+
+        /**@return whether two iterators are at the same token of the same
+        range, or are both past the end*/
+        inline bool operator ==(const iterator& other) const {
+
+            //iterators past the end are equal whatever their range
+            if (mEnd || other.mEnd) {
+
+                return mEnd == other.mEnd;
+            }
+
+            return mToken.data() == other.mToken.data();
+        }
+
+        /**@return whether two iterators are at different tokens*/
+        inline bool operator !=(const iterator& other) const {
+
+            return !(*this == other);
+        }
+
+    private:
+
+        //----------------------------------------------------------------------
+        //                              VARIABLES
+        //----------------------------------------------------------------------
+
+        //the string being split
+        std::string_view mText;
+        //the delimiter or the set of delimiting characters
+        std::string_view mDelimiter;
+        //whether mDelimiter is a set of characters
+        bool mAnyOf;
+        //the current token
+        std::string_view mToken;
+        //the position in the text the next token starts from, or npos once
+        //the last token has been found
+        std::size_t mNext;
+        //whether the iterator is past the last token
+        bool mEnd;
+
+        //----------------------------------------------------------------------
+        //                       PRIVATE MEMBER FUNCTIONS
+        //----------------------------------------------------------------------
+
+        /**Moves to the next token, or past the end if there are none*/
+        inline void advance() {
+
+            if (mNext == std::string_view::npos) {
+
+                mEnd = true;
+
+                return;
+            }
+
+            if (mAnyOf) {
+
+                std::size_t begin = mText.find_first_not_of(mDelimiter, mNext);
+                if (begin == std::string_view::npos) {
+
+                    mEnd = true;
+
+                    return;
+                }
+                std::size_t end = mText.find_first_of(mDelimiter, begin);
+                mToken = mText.substr(begin, end - begin);
+                mNext = end;
+
+                return;
+            }
+
+            //an empty delimiter does not split the text at all
+            std::size_t end = mDelimiter.empty() ?
+                std::string_view::npos :
+                (mDelimiter.size() == 1 ?
+                    mText.find(mDelimiter[0], mNext) :
+                    mText.find(mDelimiter, mNext));
+            mToken = mText.substr(mNext, end - mNext);
+            mNext = end == std::string_view::npos ?
+                end : end + mDelimiter.size();
+        }
+    };
+
+    typedef iterator const_iterator;
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new range over the tokens of a string
+    @param text the string to split
+    @param delimiter the delimiter between tokens, or the set of characters
+    that delimit tokens if anyOf is true
+    @param anyOf whether to split at any of the characters of delimiter and
+    skip empty tokens*/
+    inline TokenRange(
+            std::string_view text,
+            std::string_view delimiter,
+            bool anyOf)
+        :
+        mText(text),
+        mDelimiter(delimiter),
+        mAnyOf(anyOf) {
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return an iterator at the first token*/
+    inline iterator begin() const {
+
+        return iterator(*this);
+    }
+
+    /**@return an iterator past the last token*/
+    inline iterator end() const {
+
+        return iterator();
+    }
+
+    /**@return whether there are no tokens*/
+    inline bool empty() const {
+
+        return begin() == end();
+    }
+
+    /**@return the number of tokens, found without storing them*/
+    inline std::size_t size() const {
+
+        std::size_t count = 0;
+        for (iterator i = begin(); i != end(); ++i) {
+
+            ++count;
+        }
+
+        return count;
+    }
+
+    /**@return the tokens as a vector of views, allocated once*/
+    inline std::vector<std::string_view> toVector() const {
+
+        UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+        std::vector<std::string_view> tokens;
+        tokens.reserve(size());
+        tokens.assign(begin(), end());
+
+        return tokens;
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the string being split
+    std::string_view mText;
+    //the delimiter or the set of delimiting characters
+    std::string_view mDelimiter;
+    //whether mDelimiter is a set of characters
+    bool mAnyOf;
+};
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+// These work on views so that neither the input nor the results are copied.
+// The views they return point into the string they were given, which must
+// outlive them.
+
+/**Removes white-space from the front of a string
+@param str the string to trim
+@param characters the characters to remove
+@return a view of str without the leading characters*/
+inline std::string_view trimFront(
+        std::string_view str, std::string_view characters = WHITESPACE) {
+
+    UTIL_PROFILE_PROBE("str::trimFront");
+
+    std::size_t begin = str.find_first_not_of(characters);
+
+    return begin == std::string_view::npos ?
+        str.substr(str.size()) : str.substr(begin);
+}
+
+/**Removes white-space from the back of a string
+@param str the string to trim
+@param characters the characters to remove
+@return a view of str without the trailing characters*/
+inline std::string_view trimBack(
+        std::string_view str, std::string_view characters = WHITESPACE) {
+
+    UTIL_PROFILE_PROBE("str::trimBack");
+
+    std::size_t last = str.find_last_not_of(characters);
+
+    return last == std::string_view::npos ?
+        str.substr(0, 0) : str.substr(0, last + 1);
+}
+
+/**Removes white-space from both ends of a string
+@param str the string to trim
+@param characters the characters to remove
+@return a view of str without the leading and trailing characters*/
+inline std::string_view trim(
+        std::string_view str, std::string_view characters = WHITESPACE) {
+
+    UTIL_PROFILE_PROBE("str::trim");
+
+    return trimBack(trimFront(str, characters), characters);
+}
+
+/**Splits a string at each occurrence of a delimiter. Adjacent delimiters and
+delimiters at either end give empty tokens, so a string with n delimiters
+always has n + 1 tokens
+@param str the string to split
+@param delimiter the string between tokens, if it is empty the whole string
+is one token
+@return a lazy range over the tokens*/
+inline TokenRange split(std::string_view str, std::string_view delimiter) {
+
+    UTIL_PROFILE_PROBE("str::split");
+
+    return TokenRange(str, delimiter, false);
+}
+
+/**Splits a string into the non-empty runs of characters between any of a set
+of delimiting characters, for example the words of a line
+@param str the string to split
+@param delimiters the characters that separate tokens
+@return a lazy range over the tokens*/
+inline TokenRange tokenize(
+        std::string_view str, std::string_view delimiters = WHITESPACE) {
+
+    UTIL_PROFILE_PROBE("str::tokenize");
+
+    return TokenRange(str, delimiters, true);
+}
+
+/**Joins strings with a separator between each, measuring them first so the
+result is allocated once
+@param begin an iterator at the first string, of any type convertible to
+std::string_view
+@param end an iterator past the last string
+@param separator the string to put between each pair of strings
+@return the joined string*/
+template<typename Iterator>
+inline std::string join(
+        Iterator begin, Iterator end, std::string_view separator) {
+
+    UTIL_PROFILE_PROBE("str::join");
+    UTIL_ALLOCATION_SCOPE(util::mem::ALLOCATION_STRING);
+
+    std::size_t length = 0;
+    std::size_t count = 0;
+    for (Iterator i = begin; i != end; ++i, ++count) {
+
+        length += std::string_view(*i).size();
+    }
+    if (count > 1) {
+
+        length += separator.size() * (count - 1);
+    }
+
+    std::string joined;
+    joined.reserve(length);
+    for (Iterator i = begin; i != end; ++i) {
+
+        if (i != begin) {
+
+            joined.append(separator);
+        }
+        joined.append(std::string_view(*i));
+    }
+
+    return joined;
+}
+
+/**Joins strings with a separator between each, measuring them first so the
+result is allocated once
+@param strings a range of strings, such as a container or a TokenRange
+@param separator the string to put between each pair of strings
+@return the joined string*/
+template<typename Range>
+inline std::string join(const Range& strings, std::string_view separator) {
+
+    return join(std::begin(strings), std::end(strings), separator);
+}
+
+} } //util //str
+
+#endif
+
+#endif
@@ -0,0 +1,114 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**Finds the non-overlapping occurrences of a pattern of m bytes in n bytes of
+text, m is at least 1. Each block of positions is screened by comparing its
+bytes with the first and last bytes of the pattern at once, and only the
+positions that pass both are compared in full. After a few blocks in a row
+with no candidates, std::memchr() skips ahead to the next occurrence of the
+byte of the pattern that is likely to be rarest, so sparse text is passed over
+at the speed of the C library
+@param out returns the positions of the matches
+@param capacity the greatest number of matches to find, at least 1
+@return the number of matches, if it is less than capacity there are no more
+in the text*/
+inline std::size_t findBytes(
+        const unsigned char* text,
+        std::size_t n,
+        const unsigned char* pattern,
+        std::size_t m,
+        std::size_t* out,
+        std::size_t capacity) {
+
+    if (m > n) {
+
+        return 0;
+    }
+
+    const std::size_t last = m - 1;
+    //the bytes between the first and last that are left to compare
+    const std::size_t middle = m > 2 ? m - 2 : 0;
+    const Pack::Block first = Pack::setBlock(pattern[0]);
+    const Pack::Block final = Pack::setBlock(pattern[last]);
+    const std::size_t rare = rarestByte(pattern, m);
+
+    std::size_t found = 0;
+    std::size_t i = 0;
+    //the number of blocks in a row without candidates
+    std::size_t empty = 0;
+    while (i + last + Pack::BLOCK_BYTES <= n) {
+
+        Pack::BlockMask match = Pack::blockMaskAnd(
+            Pack::blockEqual(Pack::loadBlock(text + i), first),
+            Pack::blockEqual(Pack::loadBlock(text + i + last), final));
+
+        std::uint64_t bits = Pack::blockMaskBits(match);
+        if (bits == 0) {
+
+            std::size_t next = i + Pack::BLOCK_BYTES;
+            if (++empty < SEARCH_SKIP_AFTER) {
+
+                i = next;
+
+                continue;
+            }
+            //move to the next position the rare byte lines up with, if any
+            empty = 0;
+            const void* skip = std::memchr(
+                text + next + rare, pattern[rare], n - last - next);
+            if (skip == nullptr) {
+
+                return found;
+            }
+            i = static_cast<const unsigned char*>(skip) - text - rare;
+
+            continue;
+        }
+
+        empty = 0;
+        std::size_t step = Pack::BLOCK_BYTES;
+        for (; bits != 0; bits &= bits - 1) {
+
+            std::size_t candidate = i + util::simd::lowestSetBit(bits);
+            if (middle == 0 || std::memcmp(
+                    text + candidate + 1, pattern + 1, middle) == 0) {
+
+                out[found++] = candidate;
+                if (found == capacity) {
+
+                    return found;
+                }
+                //matches may not overlap, so the next block starts after
+                //this one
+                step = candidate + m - i;
+                break;
+            }
+        }
+        i += step;
+    }
+
+    //the positions too close to the end for a whole block
+    while (i + last < n) {
+
+        if (text[i] == pattern[0] && text[i + last] == pattern[last] &&
+            (middle == 0 ||
+             std::memcmp(text + i + 1, pattern + 1, middle) == 0)) {
+
+            out[found++] = i;
+            if (found == capacity) {
+
+                return found;
+            }
+            i += m;
+        }
+        else {
+
+            ++i;
+        }
+    }
+
+    return found;
+}
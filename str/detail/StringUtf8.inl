@@ -0,0 +1,256 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**Finds the first invalid sequence of n bytes of UTF-8. Each block is checked
+at once by looking up the errors each pair of adjacent bytes may show by the
+nibbles of the pair and keeping those all three lookups agree on, then
+checking that the leads of three and four bytes are followed by enough
+continuations. Blocks of ASCII only need checking for a sequence cut short
+by the block before. The first block with an error, and the bytes after the
+last whole block, are finished a sequence at a time
+@return the position of the first invalid sequence, or n if there is none*/
+inline std::size_t validateUtf8(const unsigned char* text, std::size_t n) {
+
+    const Pack::Block lowNibbles = Pack::setBlock(0x0F);
+    const Pack::Block highBit = Pack::setBlock(0x80);
+    //leads of three or four bytes are left with the high bit set
+    const Pack::Block thirdLead = Pack::setBlock(0xE0 - 0x80);
+    const Pack::Block fourthLead = Pack::setBlock(0xF0 - 0x80);
+    const Pack::Block limit = Pack::loadBlock(
+        UTF8_INCOMPLETE_LIMIT + sizeof(UTF8_INCOMPLETE_LIMIT) -
+        Pack::BLOCK_BYTES);
+
+    Pack::Block previous = Pack::setBlock(0);
+    Pack::Block incomplete = Pack::setBlock(0);
+    std::size_t i = 0;
+    for (; i + Pack::BLOCK_BYTES <= n; i += Pack::BLOCK_BYTES) {
+
+        Pack::Block input = Pack::loadBlock(text + i);
+        Pack::Block error = incomplete;
+        if (Pack::blockHighBits(input) != 0) {
+
+            Pack::Block prev1 = Pack::blockPrevious<1>(input, previous);
+            Pack::Block pairs = Pack::blockAnd(
+                Pack::blockAnd(
+                    Pack::blockLookup(
+                        UTF8_FIRST_HIGH, Pack::blockHighNibbles(prev1)),
+                    Pack::blockLookup(
+                        UTF8_FIRST_LOW, Pack::blockAnd(prev1, lowNibbles))),
+                Pack::blockLookup(
+                    UTF8_SECOND_HIGH, Pack::blockHighNibbles(input)));
+            //the bytes two after a lead of three or more and three after a
+            //lead of four must be continuations, which is where two
+            //continuations in a row are allowed
+            Pack::Block continues = Pack::blockAnd(
+                Pack::blockOr(
+                    Pack::blockSubSaturate(
+                        Pack::blockPrevious<2>(input, previous), thirdLead),
+                    Pack::blockSubSaturate(
+                        Pack::blockPrevious<3>(input, previous), fourthLead)),
+                highBit);
+            error = Pack::blockXor(continues, pairs);
+        }
+        if (Pack::blockAny(error)) {
+
+            break;
+        }
+        incomplete = Pack::blockSubSaturate(input, limit);
+        previous = input;
+    }
+
+    //restart from the sequence that runs into the unchecked bytes, if any
+    std::size_t start = i;
+    for (std::size_t k = 1; k <= 3 && k <= i; ++k) {
+
+        if (!isContinuation(text[i - k])) {
+
+            start = i - k;
+            break;
+        }
+    }
+
+    return scanUtf8(text, start, n);
+}
+
+/**@return the number of continuation bytes in n bytes*/
+inline std::size_t countContinuations(
+        const unsigned char* text, std::size_t n) {
+
+    //continuations are the bytes 0x80 to 0xBF
+    const Pack::Block offset = Pack::setBlock(0x80);
+    const Pack::Block range = Pack::setBlock(0x3F);
+
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i + Pack::BLOCK_BYTES <= n; i += Pack::BLOCK_BYTES) {
+
+        Pack::Block input = Pack::loadBlock(text + i);
+        count += util::simd::countSetBits(Pack::blockMaskBits(
+            Pack::blockAtMost(Pack::blockSub(input, offset), range)));
+    }
+    for (; i < n; ++i) {
+
+        count += isContinuation(text[i]);
+    }
+
+    return count;
+}
+
+/**Measures the display width of n bytes of valid UTF-8 that start at the
+start of a sequence. Blocks of ASCII are one column a byte less their
+control characters. In other blocks each byte is looked up by its nibbles,
+and if every lead is of a range of codepoints that are all one or all two
+columns wide the block is counted at once, otherwise the sequences starting
+in the block are measured one at a time
+@return the number of columns*/
+inline std::size_t validWidthOf(const unsigned char* text, std::size_t n) {
+
+    const Pack::Block zero = Pack::setBlock(0);
+    const Pack::Block lowNibbles = Pack::setBlock(0x0F);
+    const Pack::Block lastControl = Pack::setBlock(0x1F);
+    const Pack::Block deleteControl = Pack::setBlock(0x7F);
+    const Pack::Block continuation = Pack::setBlock(0x80);
+    const Pack::Block continuations = Pack::setBlock(0x3F);
+    const Pack::Block wide = Pack::setBlock(WIDTH_WIDE);
+
+    std::size_t width = 0;
+    std::size_t i = 0;
+    for (; i + Pack::BLOCK_BYTES <= n; i += Pack::BLOCK_BYTES) {
+
+        Pack::Block input = Pack::loadBlock(text + i);
+        std::size_t controls = util::simd::countSetBits(
+            Pack::blockMaskBits(Pack::blockMaskOr(
+                Pack::blockAtMost(input, lastControl),
+                Pack::blockEqual(input, deleteControl))));
+        if (Pack::blockHighBits(input) == 0) {
+
+            width += Pack::BLOCK_BYTES - controls;
+
+            continue;
+        }
+
+        Pack::Block flags = Pack::blockAnd(
+            Pack::blockLookup(WIDTH_HIGH, Pack::blockHighNibbles(input)),
+            Pack::blockLookup(WIDTH_LOW, Pack::blockAnd(input, lowNibbles)));
+        if (Pack::blockMaskBits(Pack::blockEqual(flags, zero)) == 0) {
+
+            //a column for each codepoint and another for each wide one
+            width += Pack::BLOCK_BYTES - controls - util::simd::countSetBits(
+                Pack::blockMaskBits(Pack::blockAtMost(
+                    Pack::blockSub(input, continuation), continuations)));
+            width += util::simd::countSetBits(Pack::blockMaskBits(
+                Pack::blockEqual(Pack::blockAnd(flags, wide), wide)));
+        }
+        else {
+
+            //the continuations at the front belong to the block before
+            std::size_t start = i;
+            std::size_t end = i + Pack::BLOCK_BYTES;
+            while (start < end && isContinuation(text[start])) {
+
+                ++start;
+            }
+            measureSequences(text, n, start, end, width);
+        }
+    }
+
+    std::size_t start = i;
+    while (start < n && isContinuation(text[start])) {
+
+        ++start;
+    }
+    measureSequences(text, n, start, n, width);
+
+    return width;
+}
+
+/**Measures the display width of n bytes of UTF-8, each stretch of valid
+UTF-8 found by validateUtf8() is measured by validWidthOf() and each invalid
+byte between them is one column
+@return the number of columns*/
+inline std::size_t displayWidthOf(const unsigned char* text, std::size_t n) {
+
+    std::size_t width = 0;
+    std::size_t i = 0;
+    for (;;) {
+
+        std::size_t valid = i + validateUtf8(text + i, n - i);
+        width += validWidthOf(text + i, valid - i);
+        if (valid == n) {
+
+            return width;
+        }
+        ++width;
+        i = valid + 1;
+    }
+}
+
+/**Converts the ASCII letters of n bytes to upper or lower case, the bytes of
+each block that are letters of the other case have their case bit flipped.
+in and out may be the same*/
+template<bool UPPER>
+inline void changeCase(
+        const unsigned char* in, unsigned char* out, std::size_t n) {
+
+    const Pack::Block first = Pack::setBlock(UPPER ? 'a' : 'A');
+    const Pack::Block letters = Pack::setBlock('z' - 'a');
+    const Pack::Block caseBit = Pack::setBlock(0x20);
+
+    std::size_t i = 0;
+    for (; i + Pack::BLOCK_BYTES <= n; i += Pack::BLOCK_BYTES) {
+
+        Pack::Block input = Pack::loadBlock(in + i);
+        Pack::storeBlock(out + i, Pack::blockSelect(
+            Pack::blockAtMost(Pack::blockSub(input, first), letters),
+            Pack::blockXor(input, caseBit),
+            input));
+    }
+    for (; i < n; ++i) {
+
+        out[i] = isAsciiLetter<!UPPER>(in[i]) ?
+            static_cast<unsigned char>(in[i] ^ 0x20) : in[i];
+    }
+}
+
+/**Finds the end of the run of white-space, or of bytes that are not
+white-space, at the front of n bytes
+@return the position of the first byte that is not in the run, or n*/
+template<bool WHITESPACE>
+inline std::size_t whitespaceSpan(const unsigned char* text, std::size_t n) {
+
+    //tab, line feed, vertical tab, form feed, and carriage return are
+    //consecutive
+    const Pack::Block tab = Pack::setBlock('\t');
+    const Pack::Block controls = Pack::setBlock('\r' - '\t');
+    const Pack::Block space = Pack::setBlock(' ');
+    const std::uint64_t all = ~0ull >> (64 - Pack::BLOCK_BYTES);
+
+    std::size_t i = 0;
+    for (; i + Pack::BLOCK_BYTES <= n; i += Pack::BLOCK_BYTES) {
+
+        Pack::Block input = Pack::loadBlock(text + i);
+        std::uint64_t bits = Pack::blockMaskBits(Pack::blockMaskOr(
+            Pack::blockAtMost(Pack::blockSub(input, tab), controls),
+            Pack::blockEqual(input, space)));
+        if (WHITESPACE) {
+
+            bits = ~bits & all;
+        }
+        if (bits != 0) {
+
+            return i + util::simd::lowestSetBit(bits);
+        }
+    }
+    for (; i < n; ++i) {
+
+        if (isWhitespaceByte(text[i]) != WHITESPACE) {
+
+            return i;
+        }
+    }
+
+    return n;
+}
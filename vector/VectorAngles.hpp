@@ -0,0 +1,124 @@
+#ifndef UTILITRON_VECTOR_VECTORANGLES_H_
+#   define UTILITRON_VECTOR_VECTORANGLES_H_
+
+#include <cmath>
+#include <cstddef>
+
+#include "../MathUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../Vector.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorAngles.inl"
+#include "../SimdForEachIsa.hpp"
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                ANGLE FUNCTIONS
+//------------------------------------------------------------------------------
+// These use the fast trigonometric approximations of util::math, the precision
+// tier trades accuracy for speed (see util::math::TrigPrecision).
+
+/**Approximates the angle between the two vectors, this is the fast version of
+angleBetween()
+@param a the first vector
+@param b the second vector
+@return the angle between the vectors*/
+template<util::math::TrigPrecision P>
+inline float fastAngleBetween(const Vector2& a, const Vector2& b) {
+
+    UTIL_PROFILE_PROBE("vec::fastAngleBetween(Vector2)");
+
+    return -util::math::fastAtan2<P>(a.y - b.y, a.x - b.x);
+}
+
+/**Rotates the given vector anticlockwise
+@param v the vector to rotate
+@param angle the angle to rotate by in radians
+@return the rotated vector*/
+template<util::math::TrigPrecision P>
+inline Vector2 rotate(const Vector2& v, float angle) {
+
+    UTIL_PROFILE_PROBE("vec::rotate(Vector2)");
+
+    float s;
+    float c;
+    util::math::fastSincos<P>(angle, s, c);
+
+    return Vector2((v.x * c) - (v.y * s), (v.x * s) + (v.y * c));
+}
+
+//------------------------------------------------------------------------------
+//                             BULK ANGLE FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Approximates the angle between each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the angles between the vectors
+@param n the number of vectors*/
+template<util::math::TrigPrecision P>
+inline void angleBetween(
+        const Vector2* a, const Vector2* b, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::angleBetween(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, angleBetween<P>)(&a->x, &b->x, out, n);
+}
+
+/**Creates the unit vector pointing in each direction
+@param angles the array of directions in radians
+@param out returns the unit vectors
+@param n the number of directions*/
+template<util::math::TrigPrecision P>
+inline void direction(const float* angles, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::direction(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, direction<P>)(angles, &out->x, n);
+}
+
+/**Rotates each vector anticlockwise by the angle at the same index
+@param v the array of vectors
+@param angles the array of angles to rotate by in radians
+@param out returns the rotated vectors, may be the same as v
+@param n the number of vectors*/
+template<util::math::TrigPrecision P>
+inline void rotate(
+        const Vector2* v, const float* angles, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::rotate(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, rotate<P>)(&v->x, angles, &out->x, n);
+}
+
+/**Rotates each vector anticlockwise by the same angle. The sine and cosine are
+only computed once so this uses the standard functions
+@param v the array of vectors
+@param angle the angle to rotate by in radians
+@param out returns the rotated vectors, may be the same as v
+@param n the number of vectors*/
+inline void rotate(
+        const Vector2* v, float angle, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::rotate(Vector2[])");
+
+    float s = std::sin(angle);
+    float c = std::cos(angle);
+
+    for (std::size_t i = 0; i < n; ++i) {
+
+        float x = v[i].x;
+        float y = v[i].y;
+        out[i].x = (x * c) - (y * s);
+        out[i].y = (x * s) + (y * c);
+    }
+}
+
+} } //util //vec
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef UTILITRON_VECTOR_VECTORARRAY_H_
+#   define UTILITRON_VECTOR_VECTORARRAY_H_
+
+#include <vector>
+
+#include "../MemoryUtil.hpp"
+#include "../Vector.hpp"
+
+namespace util { namespace vec {
+
+//------------------------------------------------------------------------------
+//                                  ARRAY TYPES
+//------------------------------------------------------------------------------
+// Containers for the bulk vector functions. The plain arrays start on a SIMD
+// aligned boundary, the arena arrays allocate from a util::mem::Arena (the
+// arena of the thread that constructed them by default, which is the only
+// thread they may then grow or be freed on) and are freed in bulk when it is
+// reset.
+
+//!an array of 2d vectors aligned for SIMD
+typedef std::vector<Vector2, util::mem::AlignedAllocator<Vector2> >
+    Vector2Array;
+//!an array of 3d vectors aligned for SIMD
+typedef std::vector<Vector3, util::mem::AlignedAllocator<Vector3> >
+    Vector3Array;
+//!an array of 4d vectors aligned for SIMD
+typedef std::vector<Vector4, util::mem::AlignedAllocator<Vector4> >
+    Vector4Array;
+
+//!an array of 2d vectors allocated from an arena
+typedef std::vector<Vector2, util::mem::ArenaAllocator<Vector2> >
+    ArenaVector2Array;
+//!an array of 3d vectors allocated from an arena
+typedef std::vector<Vector3, util::mem::ArenaAllocator<Vector3> >
+    ArenaVector3Array;
+//!an array of 4d vectors allocated from an arena
+typedef std::vector<Vector4, util::mem::ArenaAllocator<Vector4> >
+    ArenaVector4Array;
+
+} } //util //vec
+
+#endif
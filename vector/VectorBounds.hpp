@@ -0,0 +1,430 @@
+#ifndef UTILITRON_VECTOR_VECTORBOUNDS_H_
+#   define UTILITRON_VECTOR_VECTORBOUNDS_H_
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+
+namespace util { namespace vec {
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/***********************************************************************\
+| A two dimensional axis aligned bounding box. An empty box has a lower |
+| corner of +infinity and an upper corner of -infinity.                 |
+\***********************************************************************/
+struct BoundingBox2 {
+
+    //!the corner with the smallest components
+    Vector2 lower;
+    //!the corner with the largest components
+    Vector2 upper;
+};
+
+/*************************************************************************\
+| A three dimensional axis aligned bounding box. An empty box has a lower |
+| corner of +infinity and an upper corner of -infinity.                   |
+\*************************************************************************/
+struct BoundingBox3 {
+
+    //!the corner with the smallest components
+    Vector3 lower;
+    //!the corner with the largest components
+    Vector3 upper;
+};
+
+/************************************\
+| A two dimensional bounding circle. |
+\************************************/
+struct BoundingCircle {
+
+    //!the centre of the circle
+    Vector2 centre;
+    //!the radius of the circle
+    float radius;
+};
+
+/**************************************\
+| A three dimensional bounding sphere. |
+\**************************************/
+struct BoundingSphere {
+
+    //!the centre of the sphere
+    Vector3 centre;
+    //!the radius of the sphere
+    float radius;
+};
+
+namespace detail {
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorBounds.inl"
+#include "../SimdForEachIsa.hpp"
+
+//!the number of vectors each thread bounds at a time, arrays no larger than
+//!this are always bounded on the calling thread
+static const std::size_t BOUNDS_CHUNK = 1 << 18;
+
+/**Computes the bounding box of n N component vectors, across the thread pool
+for large arrays if execution is parallel*/
+template<unsigned N>
+inline void bounds(
+        const float* v,
+        std::size_t n,
+        float* lower,
+        float* upper,
+        util::thread::Execution execution) {
+
+    void (*kernel)(const float*, std::size_t, float*, float*) =
+        UTIL_SIMD_DISPATCH(detail, minMax<N>);
+
+    if (execution == util::thread::EXECUTE_SERIAL || n <= BOUNDS_CHUNK) {
+
+        kernel(v, n, lower, upper);
+
+        return;
+    }
+
+    //bound each chunk then combine the chunk boxes
+    std::size_t chunks = (n + BOUNDS_CHUNK - 1) / BOUNDS_CHUNK;
+    std::vector<float> partial(chunks * 2 * N);
+    util::thread::parallelFor(n, BOUNDS_CHUNK,
+        [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+            kernel(v + begin * N, end - begin,
+                &partial[chunk * 2 * N], &partial[chunk * 2 * N + N]);
+        });
+
+    for (unsigned c = 0; c < N; ++c) {
+
+        lower[c] = std::numeric_limits<float>::infinity();
+        upper[c] = -std::numeric_limits<float>::infinity();
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+            float l = partial[chunk * 2 * N + c];
+            float u = partial[chunk * 2 * N + N + c];
+            lower[c] = l < lower[c] ? l : lower[c];
+            upper[c] = u > upper[c] ? u : upper[c];
+        }
+    }
+}
+
+/**Computes the bounding box of the N component vectors at the given indices,
+across the thread pool for long index lists if execution is parallel*/
+template<unsigned N>
+inline void boundsIndexed(
+        const float* v,
+        const unsigned* indices,
+        std::size_t count,
+        float* lower,
+        float* upper,
+        util::thread::Execution execution) {
+
+    void (*kernel)(const float*, const unsigned*, std::size_t, float*, float*) =
+        UTIL_SIMD_DISPATCH(detail, minMaxIndexed<N>);
+
+    if (execution == util::thread::EXECUTE_SERIAL || count <= BOUNDS_CHUNK) {
+
+        kernel(v, indices, count, lower, upper);
+
+        return;
+    }
+
+    std::size_t chunks = (count + BOUNDS_CHUNK - 1) / BOUNDS_CHUNK;
+    std::vector<float> partial(chunks * 2 * N);
+    util::thread::parallelFor(count, BOUNDS_CHUNK,
+        [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+            kernel(v, indices + begin, end - begin,
+                &partial[chunk * 2 * N], &partial[chunk * 2 * N + N]);
+        });
+
+    for (unsigned c = 0; c < N; ++c) {
+
+        lower[c] = std::numeric_limits<float>::infinity();
+        upper[c] = -std::numeric_limits<float>::infinity();
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+            float l = partial[chunk * 2 * N + c];
+            float u = partial[chunk * 2 * N + N + c];
+            lower[c] = l < lower[c] ? l : lower[c];
+            upper[c] = u > upper[c] ? u : upper[c];
+        }
+    }
+}
+
+/**@return the greatest squared distance of n N component vectors from the
+given point, across the thread pool for large arrays if execution is parallel*/
+template<unsigned N>
+inline float radiusSquared(
+        const float* v,
+        std::size_t n,
+        const float* point,
+        util::thread::Execution execution) {
+
+    float (*kernel)(const float*, std::size_t, const float*) =
+        UTIL_SIMD_DISPATCH(detail, maxDistanceSquared<N>);
+
+    if (execution == util::thread::EXECUTE_SERIAL || n <= BOUNDS_CHUNK) {
+
+        return kernel(v, n, point);
+    }
+
+    std::vector<float> partial((n + BOUNDS_CHUNK - 1) / BOUNDS_CHUNK);
+    util::thread::parallelFor(n, BOUNDS_CHUNK,
+        [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+            partial[chunk] = kernel(v + begin * N, end - begin, point);
+        });
+
+    float result = 0.0f;
+    for (std::size_t chunk = 0; chunk < partial.size(); ++chunk) {
+
+        result = partial[chunk] > result ? partial[chunk] : result;
+    }
+
+    return result;
+}
+
+/**@return the greatest squared distance of the N component vectors at the
+given indices from the given point, across the thread pool for long index lists
+if execution is parallel*/
+template<unsigned N>
+inline float radiusSquaredIndexed(
+        const float* v,
+        const unsigned* indices,
+        std::size_t count,
+        const float* point,
+        util::thread::Execution execution) {
+
+    float (*kernel)(const float*, const unsigned*, std::size_t, const float*) =
+        UTIL_SIMD_DISPATCH(detail, maxDistanceSquaredIndexed<N>);
+
+    if (execution == util::thread::EXECUTE_SERIAL || count <= BOUNDS_CHUNK) {
+
+        return kernel(v, indices, count, point);
+    }
+
+    std::vector<float> partial((count + BOUNDS_CHUNK - 1) / BOUNDS_CHUNK);
+    util::thread::parallelFor(count, BOUNDS_CHUNK,
+        [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+            partial[chunk] =
+                kernel(v, indices + begin, end - begin, point);
+        });
+
+    float result = 0.0f;
+    for (std::size_t chunk = 0; chunk < partial.size(); ++chunk) {
+
+        result = partial[chunk] > result ? partial[chunk] : result;
+    }
+
+    return result;
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                               BOUNDS FUNCTIONS
+//------------------------------------------------------------------------------
+// These find the bounds of an array of vectors in one SIMD pass, and can split
+// the work of very large arrays across the thread pool. Each also has a form
+// that only bounds the vectors at the indices of an index list.
+
+/**Computes the axis aligned bounding box of the given vectors
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the bounding box, which is empty if n is 0*/
+inline BoundingBox2 boundingBox(
+        const Vector2* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::boundingBox(Vector2[])");
+
+    BoundingBox2 box;
+    detail::bounds<2>(&v->x, n, &box.lower.x, &box.upper.x, execution);
+
+    return box;
+}
+
+/**Computes the axis aligned bounding box of the given vectors
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the bounding box, which is empty if n is 0*/
+inline BoundingBox3 boundingBox(
+        const Vector3* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::boundingBox(Vector3[])");
+
+    BoundingBox3 box;
+    detail::bounds<3>(&v->x, n, &box.lower.x, &box.upper.x, execution);
+
+    return box;
+}
+
+/**Computes the axis aligned bounding box of a subset of the given vectors
+@param v the array of vectors
+@param indices the indices of the vectors to bound
+@param count the number of indices
+@param execution whether to split long index lists across the thread pool
+@return the bounding box, which is empty if count is 0*/
+inline BoundingBox2 boundingBox(
+        const Vector2* v,
+        const unsigned* indices,
+        std::size_t count,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::boundingBox(Vector2[])");
+
+    BoundingBox2 box;
+    detail::boundsIndexed<2>(
+        &v->x, indices, count, &box.lower.x, &box.upper.x, execution);
+
+    return box;
+}
+
+/**Computes the axis aligned bounding box of a subset of the given vectors
+@param v the array of vectors
+@param indices the indices of the vectors to bound
+@param count the number of indices
+@param execution whether to split long index lists across the thread pool
+@return the bounding box, which is empty if count is 0*/
+inline BoundingBox3 boundingBox(
+        const Vector3* v,
+        const unsigned* indices,
+        std::size_t count,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::boundingBox(Vector3[])");
+
+    BoundingBox3 box;
+    detail::boundsIndexed<3>(
+        &v->x, indices, count, &box.lower.x, &box.upper.x, execution);
+
+    return box;
+}
+
+/**Computes a bounding circle of the given vectors. The circle is centred on
+the centre of the bounding box, which takes a second pass over the vectors to
+find the radius, so it is not the smallest enclosing circle
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the bounding circle, which has a radius of 0 if n is 0*/
+inline BoundingCircle boundingCircle(
+        const Vector2* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::boundingCircle(Vector2[])");
+
+    BoundingCircle circle;
+    circle.radius = 0.0f;
+    if (n > 0) {
+
+        BoundingBox2 box = boundingBox(v, n, execution);
+        circle.centre = (box.lower + box.upper) * 0.5f;
+        circle.radius = sqrt(detail::radiusSquared<2>(&v->x, n,
+            &circle.centre.x, execution));
+    }
+
+    return circle;
+}
+
+/**Computes a bounding sphere of the given vectors. The sphere is centred on
+the centre of the bounding box, which takes a second pass over the vectors to
+find the radius, so it is not the smallest enclosing sphere
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the bounding sphere, which has a radius of 0 if n is 0*/
+inline BoundingSphere boundingSphere(
+        const Vector3* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::boundingSphere(Vector3[])");
+
+    BoundingSphere sphere;
+    sphere.radius = 0.0f;
+    if (n > 0) {
+
+        BoundingBox3 box = boundingBox(v, n, execution);
+        sphere.centre = (box.lower + box.upper) * 0.5f;
+        sphere.radius = sqrt(detail::radiusSquared<3>(&v->x, n,
+            &sphere.centre.x, execution));
+    }
+
+    return sphere;
+}
+
+/**Computes a bounding circle of a subset of the given vectors, see
+boundingCircle()
+@param v the array of vectors
+@param indices the indices of the vectors to bound
+@param count the number of indices
+@param execution whether to split long index lists across the thread pool
+@return the bounding circle, which has a radius of 0 if count is 0*/
+inline BoundingCircle boundingCircle(
+        const Vector2* v,
+        const unsigned* indices,
+        std::size_t count,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::boundingCircle(Vector2[])");
+
+    BoundingCircle circle;
+    circle.radius = 0.0f;
+    if (count > 0) {
+
+        BoundingBox2 box = boundingBox(v, indices, count, execution);
+        circle.centre = (box.lower + box.upper) * 0.5f;
+        circle.radius = sqrt(detail::radiusSquaredIndexed<2>(
+            &v->x, indices, count, &circle.centre.x, execution));
+    }
+
+    return circle;
+}
+
+/**Computes a bounding sphere of a subset of the given vectors, see
+boundingSphere()
+@param v the array of vectors
+@param indices the indices of the vectors to bound
+@param count the number of indices
+@param execution whether to split long index lists across the thread pool
+@return the bounding sphere, which has a radius of 0 if count is 0*/
+inline BoundingSphere boundingSphere(
+        const Vector3* v,
+        const unsigned* indices,
+        std::size_t count,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::boundingSphere(Vector3[])");
+
+    BoundingSphere sphere;
+    sphere.radius = 0.0f;
+    if (count > 0) {
+
+        BoundingBox3 box = boundingBox(v, indices, count, execution);
+        sphere.centre = (box.lower + box.upper) * 0.5f;
+        sphere.radius = sqrt(detail::radiusSquaredIndexed<3>(
+            &v->x, indices, count, &sphere.centre.x, execution));
+    }
+
+    return sphere;
+}
+
+} } //util //vec
+
+#endif
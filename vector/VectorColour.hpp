@@ -0,0 +1,306 @@
+#ifndef UTILITRON_VECTOR_VECTORCOLOUR_H_
+#   define UTILITRON_VECTOR_VECTORCOLOUR_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+
+namespace util { namespace vec {
+
+//------------------------------------------------------------------------------
+//                                  ENUMERATORS
+//------------------------------------------------------------------------------
+
+/**The order of the channels of a packed 8-bit colour*/
+enum ChannelOrder {
+
+    //!red, green, blue, alpha
+    CHANNELS_RGBA,
+    //!blue, green, red, alpha
+    CHANNELS_BGRA
+};
+
+/**How the colour channels of a packed 8-bit colour are encoded, alpha is
+always linear*/
+enum ColourEncoding {
+
+    //!the channels are stored linearly
+    ENCODING_LINEAR,
+    //!the channels are stored with the sRGB transfer function
+    ENCODING_SRGB
+};
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//the Rec. 709 weights of the linear channels in the luminance of a colour
+static const float LUMINANCE_RED = 0.2126f;
+static const float LUMINANCE_GREEN = 0.7152f;
+static const float LUMINANCE_BLUE = 0.0722f;
+
+//the ends of the linear segments of the sRGB transfer function, before and
+//after encoding
+static const float SRGB_LINEAR_LIMIT = 0.0031308f;
+static const float SRGB_ENCODED_LIMIT = 0.04045f;
+
+//a minimax fit of the curved segment of sRGB encoding against the fourth root
+//of the linear value, within 2e-6 of the exact encoding
+static const unsigned SRGB_ENCODE_TERMS = 7;
+static const float SRGB_ENCODE[SRGB_ENCODE_TERMS] = {
+    -0.0595466087f, 0.139604136f, 1.36592105f, -0.852957453f, 0.65718829f,
+    -0.318415992f, 0.0682079792f
+};
+
+//a minimax fit of v^0.4 against sqrt(v) for the curved segment of sRGB
+//decoding, within a relative error of 2e-5 of the exact decoding
+static const unsigned SRGB_DECODE_TERMS = 6;
+static const float SRGB_DECODE[SRGB_DECODE_TERMS] = {
+    0.0366033577f, 1.32845856f, -0.774411062f, 0.712760979f, -0.399693121f,
+    0.0962877061f
+};
+
+//!the operations applied channel by channel by the colour kernel
+enum ColourOperation {
+
+    COLOUR_TO_LINEAR,
+    COLOUR_TO_SRGB,
+    COLOUR_PREMULTIPLY,
+    COLOUR_UNPREMULTIPLY
+};
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorColour.inl"
+#include "../SimdForEachIsa.hpp"
+
+//!the number of colours each thread converts at a time in parallel mode
+static const std::size_t COLOUR_CHUNK = 1 << 14;
+
+/**Applies a colour operation to an array of colours*/
+template<unsigned OPERATION>
+inline void colour(
+        const Vector4* in,
+        Vector4* out,
+        std::size_t n,
+        util::thread::Execution execution) {
+
+    void (*kernel)(const float*, float*, std::size_t) =
+        UTIL_SIMD_DISPATCH(detail, colour<OPERATION>);
+    util::thread::execute(execution, n, COLOUR_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&in[begin].x, &out[begin].x, end - begin);
+        });
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                               COLOUR FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Decodes an sRGB encoded colour channel
+@param s the encoded channel, from 0 to 1
+@return the linear channel*/
+inline float srgbToLinear(float s) {
+
+    UTIL_PROFILE_PROBE("vec::srgbToLinear(float)");
+
+    if (s <= detail::SRGB_ENCODED_LIMIT) {
+
+        return s / 12.92f;
+    }
+
+    return std::pow((s + 0.055f) / 1.055f, 2.4f);
+}
+
+/**Encodes a linear colour channel with the sRGB transfer function
+@param x the linear channel, from 0 to 1
+@return the encoded channel*/
+inline float linearToSrgb(float x) {
+
+    UTIL_PROFILE_PROBE("vec::linearToSrgb(float)");
+
+    if (x <= detail::SRGB_LINEAR_LIMIT) {
+
+        return x * 12.92f;
+    }
+
+    return 1.055f * std::pow(x, 1.0f / 2.4f) - 0.055f;
+}
+
+/**Computes the Rec. 709 luminance of a linear colour
+@param colour the linear colour, alpha is ignored
+@return the luminance of the colour*/
+inline float luminance(const Vector4& colour) {
+
+    UTIL_PROFILE_PROBE("vec::luminance(Vector4)");
+
+    return colour.r * detail::LUMINANCE_RED +
+        colour.g * detail::LUMINANCE_GREEN + colour.b * detail::LUMINANCE_BLUE;
+}
+
+//------------------------------------------------------------------------------
+//                            BULK COLOUR FUNCTIONS
+//------------------------------------------------------------------------------
+// These convert whole arrays of RGBA colours using the widest instruction set
+// the CPU supports, and across the thread pool when given EXECUTE_PARALLEL.
+// The sRGB conversions use polynomial fits of the transfer function, which are
+// far closer to the exact curve than 8-bit channels can resolve, and clamp the
+// channels to [0, 1]. Alpha is never encoded. The output array may be the same
+// as the input array.
+
+/**Decodes the colour channels of an array of sRGB encoded colours
+@param in the array of encoded colours
+@param out returns the linear colours
+@param n the number of colours
+@param execution whether to split large arrays across the thread pool*/
+inline void srgbToLinear(
+        const Vector4* in,
+        Vector4* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::srgbToLinear(Vector4[])");
+
+    detail::colour<detail::COLOUR_TO_LINEAR>(in, out, n, execution);
+}
+
+/**Encodes the colour channels of an array of linear colours with the sRGB
+transfer function
+@param in the array of linear colours
+@param out returns the encoded colours
+@param n the number of colours
+@param execution whether to split large arrays across the thread pool*/
+inline void linearToSrgb(
+        const Vector4* in,
+        Vector4* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::linearToSrgb(Vector4[])");
+
+    detail::colour<detail::COLOUR_TO_SRGB>(in, out, n, execution);
+}
+
+/**Multiplies the colour channels of an array of colours by their alpha
+@param in the array of straight colours
+@param out returns the premultiplied colours
+@param n the number of colours
+@param execution whether to split large arrays across the thread pool*/
+inline void premultiply(
+        const Vector4* in,
+        Vector4* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::premultiply(Vector4[])");
+
+    detail::colour<detail::COLOUR_PREMULTIPLY>(in, out, n, execution);
+}
+
+/**Divides the colour channels of an array of premultiplied colours by their
+alpha, colours with an alpha of 0 become transparent black
+@param in the array of premultiplied colours
+@param out returns the straight colours
+@param n the number of colours
+@param execution whether to split large arrays across the thread pool*/
+inline void unpremultiply(
+        const Vector4* in,
+        Vector4* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::unpremultiply(Vector4[])");
+
+    detail::colour<detail::COLOUR_UNPREMULTIPLY>(in, out, n, execution);
+}
+
+/**Computes the Rec. 709 luminance of an array of linear colours
+@param in the array of linear colours
+@param out returns the luminance of each colour
+@param n the number of colours
+@param execution whether to split large arrays across the thread pool*/
+inline void luminance(
+        const Vector4* in,
+        float* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::luminance(Vector4[])");
+
+    void (*kernel)(const float*, float*, std::size_t) =
+        UTIL_SIMD_DISPATCH(detail, luminance);
+    util::thread::execute(execution, n, detail::COLOUR_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&in[begin].x, out + begin, end - begin);
+        });
+}
+
+/**Packs an array of float colours into 8-bit channels, four bytes a colour.
+The channels are clamped to [0, 1] and rounded to the nearest byte
+@param in the array of linear colours
+@param out returns the packed colours, 4 * n bytes
+@param n the number of colours
+@param order the order of the packed channels
+@param encoding how to encode the packed colour channels
+@param execution whether to split large arrays across the thread pool*/
+inline void packColours(
+        const Vector4* in,
+        unsigned char* out,
+        std::size_t n,
+        ChannelOrder order = CHANNELS_RGBA,
+        ColourEncoding encoding = ENCODING_LINEAR,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::packColours(Vector4[])");
+
+    void (*kernel)(const float*, unsigned char*, std::size_t, bool, bool) =
+        UTIL_SIMD_DISPATCH(detail, packColours);
+    bool bgra = order == CHANNELS_BGRA;
+    bool srgb = encoding == ENCODING_SRGB;
+    util::thread::execute(execution, n, detail::COLOUR_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&in[begin].x, out + begin * 4, end - begin, bgra, srgb);
+        });
+}
+
+/**Unpacks an array of colours with 8-bit channels, four bytes a colour, into
+float colours
+@param in the packed colours, 4 * n bytes
+@param out returns the linear colours
+@param n the number of colours
+@param order the order of the packed channels
+@param encoding how the packed colour channels are encoded
+@param execution whether to split large arrays across the thread pool*/
+inline void unpackColours(
+        const unsigned char* in,
+        Vector4* out,
+        std::size_t n,
+        ChannelOrder order = CHANNELS_RGBA,
+        ColourEncoding encoding = ENCODING_LINEAR,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::unpackColours(Vector4[])");
+
+    void (*kernel)(const unsigned char*, float*, std::size_t, bool, bool) =
+        UTIL_SIMD_DISPATCH(detail, unpackColours);
+    bool bgra = order == CHANNELS_BGRA;
+    bool srgb = encoding == ENCODING_SRGB;
+    util::thread::execute(execution, n, detail::COLOUR_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(in + begin * 4, &out[begin].x, end - begin, bgra, srgb);
+        });
+}
+
+} } //util //vec
+
+#endif
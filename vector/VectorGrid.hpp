@@ -0,0 +1,486 @@
+#ifndef UTILITRON_VECTOR_VECTORGRID_H_
+#   define UTILITRON_VECTOR_VECTORGRID_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "../MemoryUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                  GRID LAYOUT
+//------------------------------------------------------------------------------
+
+//!grids are stored as square tiles of 2^GRID_TILE_SHIFT elements a side
+static const unsigned GRID_TILE_SHIFT = 3;
+static const unsigned GRID_TILE_SIZE = 1 << GRID_TILE_SHIFT;
+static const unsigned GRID_TILE_ELEMENTS = GRID_TILE_SIZE * GRID_TILE_SIZE;
+
+/**The dimensions of a tiled grid*/
+struct GridLayout {
+
+    //the width of the grid in elements
+    unsigned width;
+    //the height of the grid in elements
+    unsigned height;
+    //the number of tiles in each row of tiles
+    unsigned tilesPerRow;
+};
+
+/**@return the index in the tiled storage of the element at x, y. Tiles are
+stored a row of tiles at a time and the elements of each tile row by row*/
+inline unsigned gridOffset(const GridLayout& layout, unsigned x, unsigned y) {
+
+    unsigned tile = (y >> GRID_TILE_SHIFT) * layout.tilesPerRow +
+        (x >> GRID_TILE_SHIFT);
+
+    return tile * GRID_TILE_ELEMENTS +
+        ((y & (GRID_TILE_SIZE - 1)) << GRID_TILE_SHIFT) +
+        (x & (GRID_TILE_SIZE - 1));
+}
+
+/**Finds the four elements and weights to bilinearly sample a grid at the
+given coordinate, which is clamped to the grid
+@param layout the dimensions of the grid, which must not be empty
+@param x the x coordinate to sample at
+@param y the y coordinate to sample at
+@param i00 returns the index of the element at the lower x and y
+@param i10 returns the index of the element at the higher x and lower y
+@param i01 returns the index of the element at the lower x and higher y
+@param i11 returns the index of the element at the higher x and y
+@param fx returns the weight of the higher x elements
+@param fy returns the weight of the higher y elements*/
+inline void locateTexel(
+        const GridLayout& layout,
+        float x,
+        float y,
+        unsigned& i00,
+        unsigned& i10,
+        unsigned& i01,
+        unsigned& i11,
+        float& fx,
+        float& fy) {
+
+    //also sends NaN to the edge
+    float maxX = static_cast<float>(layout.width - 1);
+    float maxY = static_cast<float>(layout.height - 1);
+    x = x > 0.0f ? (x < maxX ? x : maxX) : 0.0f;
+    y = y > 0.0f ? (y < maxY ? y : maxY) : 0.0f;
+
+    unsigned x0 = static_cast<unsigned>(x);
+    unsigned y0 = static_cast<unsigned>(y);
+    unsigned x1 = x0 + 1 < layout.width ? x0 + 1 : x0;
+    unsigned y1 = y0 + 1 < layout.height ? y0 + 1 : y0;
+    fx = x - static_cast<float>(x0);
+    fy = y - static_cast<float>(y0);
+
+    i00 = gridOffset(layout, x0, y0);
+    i10 = gridOffset(layout, x1, y0);
+    i01 = gridOffset(layout, x0, y1);
+    i11 = gridOffset(layout, x1, y1);
+}
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorGrid.inl"
+#include "../SimdForEachIsa.hpp"
+
+//!the number of samples each thread takes at a time in parallel mode
+static const std::size_t GRID_SAMPLE_CHUNK = 1 << 14;
+
+} //detail
+
+/***************************************************************************\
+| A two dimensional grid of vectors, such as an image, a vector field or a  |
+| height map. The grid is stored as square tiles of TILE_SIZE by TILE_SIZE  |
+| elements rather than row by row, so neighbouring elements in either       |
+| direction are usually in the same few cache lines. Use the fill, blit and |
+| copy functions rather than per element access to move blocks of elements. |
+\***************************************************************************/
+template<typename VectorType>
+class VectorGrid {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //!the width and height of the tiles in elements
+    static const unsigned TILE_SIZE = detail::GRID_TILE_SIZE;
+    //!the number of float components of each element
+    static const unsigned COMPONENTS = sizeof(VectorType) / sizeof(float);
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new grid
+    @param width the width of the grid in elements
+    @param height the height of the grid in elements
+    @param value the value to fill the grid with*/
+    inline VectorGrid(
+            unsigned width,
+            unsigned height,
+            const VectorType& value = VectorType()) {
+
+        mLayout.width = width;
+        mLayout.height = height;
+        mLayout.tilesPerRow = (width + TILE_SIZE - 1) / TILE_SIZE;
+
+        std::size_t tileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+        mData.resize(mLayout.tilesPerRow * tileRows *
+            detail::GRID_TILE_ELEMENTS);
+        fill(value);
+    }
+
+    //--------------------------------------------------------------------------
+    //                                 OPERATORS
+    //--------------------------------------------------------------------------
+
+    /**@return the element at the given position, which is not bounds checked
+    @param x the column of the element
+    @param y the row of the element*/
+    inline VectorType& operator ()(unsigned x, unsigned y) {
+
+        return mData[detail::gridOffset(mLayout, x, y)];
+    }
+
+    /**@return the element at the given position, which is not bounds checked
+    @param x the column of the element
+    @param y the row of the element*/
+    inline const VectorType& operator ()(unsigned x, unsigned y) const {
+
+        return mData[detail::gridOffset(mLayout, x, y)];
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the width of the grid in elements*/
+    inline unsigned width() const {
+
+        return mLayout.width;
+    }
+
+    /**@return the height of the grid in elements*/
+    inline unsigned height() const {
+
+        return mLayout.height;
+    }
+
+    /**Sets every element of the grid
+    @param value the value to set the elements to*/
+    inline void fill(const VectorType& value) {
+
+        UTIL_PROFILE_PROBE("vec::VectorGrid::fill");
+
+        if (mData.empty()) {
+
+            return;
+        }
+        UTIL_SIMD_DISPATCH(detail, fill<COMPONENTS>)(
+            &mData.data()->x, &value.x, mData.size());
+    }
+
+    /**Sets the elements of a rectangle of the grid, the rectangle is clipped
+    to the grid
+    @param x the left column of the rectangle
+    @param y the top row of the rectangle
+    @param width the width of the rectangle
+    @param height the height of the rectangle
+    @param value the value to set the elements to*/
+    inline void fill(
+            unsigned x,
+            unsigned y,
+            unsigned width,
+            unsigned height,
+            const VectorType& value) {
+
+        UTIL_PROFILE_PROBE("vec::VectorGrid::fill");
+
+        void (*kernel)(float*, const float*, std::size_t) =
+            UTIL_SIMD_DISPATCH(detail, fill<COMPONENTS>);
+
+        clip(x, y, width, height, mLayout);
+        for (unsigned row = y; row < y + height; ++row) {
+
+            //each run ends at the edge of a tile
+            for (unsigned column = x; column < x + width;) {
+
+                unsigned run = std::min(x + width, tileEnd(column)) - column;
+                kernel(&mData[detail::gridOffset(mLayout, column, row)].x,
+                    &value.x, run);
+                column += run;
+            }
+        }
+    }
+
+    /**Copies a rectangle of another grid into this grid, the rectangle is
+    clipped to both grids. The source may be this grid if the rectangles do not
+    overlap
+    @param source the grid to copy from
+    @param sourceX the left column of the rectangle in the source
+    @param sourceY the top row of the rectangle in the source
+    @param width the width of the rectangle
+    @param height the height of the rectangle
+    @param x the column to copy the left of the rectangle to
+    @param y the row to copy the top of the rectangle to*/
+    inline void blit(
+            const VectorGrid& source,
+            unsigned sourceX,
+            unsigned sourceY,
+            unsigned width,
+            unsigned height,
+            unsigned x,
+            unsigned y) {
+
+        UTIL_PROFILE_PROBE("vec::VectorGrid::blit");
+
+        clip(sourceX, sourceY, width, height, source.mLayout);
+        clip(x, y, width, height, mLayout);
+        for (unsigned row = 0; row < height; ++row) {
+
+            //each run ends at the edge of a tile in either grid
+            for (unsigned column = 0; column < width;) {
+
+                unsigned run = std::min(width - column, std::min(
+                    tileEnd(sourceX + column) - sourceX - column,
+                    tileEnd(x + column) - x - column));
+                std::memcpy(
+                    &(*this)(x + column, y + row).x,
+                    &source(sourceX + column, sourceY + row).x,
+                    run * sizeof(VectorType));
+                column += run;
+            }
+        }
+    }
+
+    /**Copies the grid out to a row by row array
+    @param rows returns the elements of the grid, width * height elements with
+    the element at x, y at index y * width + x*/
+    inline void copyToRows(VectorType* rows) const {
+
+        UTIL_PROFILE_PROBE("vec::VectorGrid::copyToRows");
+
+        for (unsigned row = 0; row < mLayout.height; ++row) {
+
+            for (unsigned column = 0; column < mLayout.width;) {
+
+                unsigned run =
+                    std::min(mLayout.width, tileEnd(column)) - column;
+                std::memcpy(&rows[row * mLayout.width + column].x,
+                    &(*this)(column, row).x, run * sizeof(VectorType));
+                column += run;
+            }
+        }
+    }
+
+    /**Sets the grid from a row by row array
+    @param rows the elements to set, width * height elements with the element
+    at x, y at index y * width + x*/
+    inline void copyFromRows(const VectorType* rows) {
+
+        UTIL_PROFILE_PROBE("vec::VectorGrid::copyFromRows");
+
+        for (unsigned row = 0; row < mLayout.height; ++row) {
+
+            for (unsigned column = 0; column < mLayout.width;) {
+
+                unsigned run =
+                    std::min(mLayout.width, tileEnd(column)) - column;
+                std::memcpy(&(*this)(column, row).x,
+                    &rows[row * mLayout.width + column].x,
+                    run * sizeof(VectorType));
+                column += run;
+            }
+        }
+    }
+
+    /**Bilinearly samples the grid. Element x, y lies at coordinate x, y and
+    coordinates outside the grid are clamped to its edges
+    @param x the x coordinate to sample at
+    @param y the y coordinate to sample at
+    @return the sampled value, or the zero vector if the grid is empty*/
+    inline VectorType sample(float x, float y) const {
+
+        UTIL_PROFILE_PROBE("vec::VectorGrid::sample");
+
+        //an empty grid has no edge to clamp to
+        if (mData.empty()) {
+
+            return VectorType();
+        }
+
+        unsigned i00;
+        unsigned i10;
+        unsigned i01;
+        unsigned i11;
+        float fx;
+        float fy;
+        detail::locateTexel(mLayout, x, y, i00, i10, i01, i11, fx, fy);
+
+        VectorType top = mData[i00] + (mData[i10] - mData[i00]) * fx;
+        VectorType bottom = mData[i01] + (mData[i11] - mData[i01]) * fx;
+
+        return top + (bottom - top) * fy;
+    }
+
+    /**Bilinearly samples the grid at an array of coordinates, see sample()
+    @param coordinates the coordinates to sample at
+    @param out returns the sampled values, which are the zero vector if the
+    grid is empty
+    @param n the number of coordinates
+    @param execution whether to split large arrays across the thread pool*/
+    inline void sample(
+            const Vector2* coordinates,
+            VectorType* out,
+            std::size_t n,
+            util::thread::Execution execution =
+                util::thread::EXECUTE_SERIAL) const {
+
+        UTIL_PROFILE_PROBE("vec::VectorGrid::sample(Vector2[])");
+
+        if (mData.empty()) {
+
+            std::fill(out, out + n, VectorType());
+
+            return;
+        }
+
+        void (*kernel)(const float*, const detail::GridLayout&, const float*,
+            float*, std::size_t) =
+            UTIL_SIMD_DISPATCH(detail, bilinear<COMPONENTS>);
+        const float* data = &mData.data()->x;
+        const detail::GridLayout& layout = mLayout;
+        util::thread::execute(execution, n, detail::GRID_SAMPLE_CHUNK,
+            [=, &layout](std::size_t begin, std::size_t end) {
+
+                kernel(data, layout, &coordinates[begin].x, &out[begin].x,
+                    end - begin);
+            });
+    }
+
+    /**Sets this grid to a bilinearly resampled copy of another grid, stretching
+    the source to the dimensions of this grid. There is no filtering so
+    shrinking by more than half skips source elements
+    @param source the grid to resample, which must not be this grid. If it is
+    empty this grid is filled with the zero vector
+    @param execution whether to split large grids across the thread pool*/
+    inline void resample(
+            const VectorGrid& source,
+            util::thread::Execution execution =
+                util::thread::EXECUTE_SERIAL) {
+
+        UTIL_PROFILE_PROBE("vec::VectorGrid::resample");
+
+        if (source.mData.empty()) {
+
+            fill(VectorType());
+
+            return;
+        }
+
+        void (*kernel)(const float*, const detail::GridLayout&, const float*,
+            float*, std::size_t) =
+            UTIL_SIMD_DISPATCH(detail, bilinear<COMPONENTS>);
+
+        //the centres of the elements of both grids line up
+        float scaleX = static_cast<float>(source.mLayout.width) /
+            static_cast<float>(mLayout.width);
+        float scaleY = static_cast<float>(source.mLayout.height) /
+            static_cast<float>(mLayout.height);
+
+        //each tile is sampled whole, including any padding past the edges
+        const float* data = &source.mData.data()->x;
+        const detail::GridLayout& layout = source.mLayout;
+        VectorType* tiles = mData.data();
+        unsigned tilesPerRow = mLayout.tilesPerRow;
+        util::thread::execute(execution,
+            mData.size() / detail::GRID_TILE_ELEMENTS, 16,
+            [=, &layout](std::size_t begin, std::size_t end) {
+
+                Vector2 coordinates[detail::GRID_TILE_ELEMENTS];
+                for (std::size_t tile = begin; tile < end; ++tile) {
+
+                    unsigned left = static_cast<unsigned>(
+                        tile % tilesPerRow) * TILE_SIZE;
+                    unsigned top = static_cast<unsigned>(
+                        tile / tilesPerRow) * TILE_SIZE;
+                    for (unsigned i = 0; i < detail::GRID_TILE_ELEMENTS; ++i) {
+
+                        float x = static_cast<float>(left + i % TILE_SIZE);
+                        float y = static_cast<float>(top + i / TILE_SIZE);
+                        coordinates[i].x = (x + 0.5f) * scaleX - 0.5f;
+                        coordinates[i].y = (y + 0.5f) * scaleY - 0.5f;
+                    }
+                    kernel(data, layout, &coordinates->x,
+                        &tiles[tile * detail::GRID_TILE_ELEMENTS].x,
+                        detail::GRID_TILE_ELEMENTS);
+                }
+            });
+    }
+
+    /**@return the tiled storage of the grid, see detail::gridOffset()*/
+    inline const VectorType* data() const {
+
+        return mData.data();
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the dimensions of the grid
+    detail::GridLayout mLayout;
+    //the tiles of the grid
+    std::vector<VectorType, util::mem::AlignedAllocator<VectorType> > mData;
+
+    //--------------------------------------------------------------------------
+    //                          PRIVATE MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the column after the last column of the tile holding the given
+    column*/
+    static inline unsigned tileEnd(unsigned column) {
+
+        return (column | (TILE_SIZE - 1)) + 1;
+    }
+
+    /**Clips a rectangle to a grid*/
+    static inline void clip(
+            unsigned& x,
+            unsigned& y,
+            unsigned& width,
+            unsigned& height,
+            const detail::GridLayout& layout) {
+
+        x = std::min(x, layout.width);
+        y = std::min(y, layout.height);
+        width = std::min(width, layout.width - x);
+        height = std::min(height, layout.height - y);
+    }
+};
+
+//------------------------------------------------------------------------------
+//                                  GRID TYPES
+//------------------------------------------------------------------------------
+
+//!a grid of 2d vectors
+typedef VectorGrid<Vector2> Vector2Grid;
+//!a grid of 3d vectors
+typedef VectorGrid<Vector3> Vector3Grid;
+//!a grid of 4d vectors
+typedef VectorGrid<Vector4> Vector4Grid;
+
+} } //util //vec
+
+#endif
@@ -0,0 +1,699 @@
+#ifndef UTILITRON_VECTOR_VECTORHASH_H_
+#   define UTILITRON_VECTOR_VECTORHASH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../MemoryUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+namespace util { namespace vec {
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/**********************************************************************\
+| The integer coordinates of a cell of a uniform grid, see gridCell(). |
+\**********************************************************************/
+template<unsigned N>
+struct GridCell {
+
+    //!the index of the cell along each axis
+    int index[N];
+
+    /**@return whether this is the same cell as the other*/
+    inline bool operator ==(const GridCell& other) const {
+
+        for (unsigned i = 0; i < N; ++i) {
+
+            if (index[i] != other.index[i]) {
+
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**@return whether this is not the same cell as the other*/
+    inline bool operator !=(const GridCell& other) const {
+
+        return !(*this == other);
+    }
+};
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of slots of a spatial hash map whose tags are probed at once
+static const unsigned HASH_GROUP = 16;
+//!the tag of an empty slot, the tags of full slots are 7 bits of the hash
+static const unsigned char HASH_EMPTY = 0x80;
+//!the number of keys the bulk map functions hash and prefetch ahead of probing
+static const std::size_t HASH_BATCH = 32;
+//!the number of keys each thread looks up at a time in parallel mode
+static const std::size_t HASH_CHUNK = 1 << 14;
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Mixes a 32 bit word into a running hash*/
+inline std::uint64_t mixHash(std::uint64_t hash, std::uint32_t word) {
+
+    return (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+}
+
+/**Finishes a running hash so that every bit of it depends on every input bit
+(the MurmurHash3 finaliser)*/
+inline std::uint64_t finishHash(std::uint64_t hash) {
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+
+    return hash ^ (hash >> 33);
+}
+
+/**@return the bits of a float, with -0 given the bits of 0 since they compare
+equal*/
+inline std::uint32_t floatBits(float v) {
+
+    std::uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+
+    return bits == 0x80000000u ? 0u : bits;
+}
+
+/**@return the hash of the N floats at v*/
+template<unsigned N>
+inline std::uint64_t hashFloats(const float* v) {
+
+    std::uint64_t hash = N;
+    for (unsigned i = 0; i < N; ++i) {
+
+        hash = mixHash(hash, floatBits(v[i]));
+    }
+
+    return finishHash(hash);
+}
+
+/**@return the hash of a grid cell*/
+template<unsigned N>
+inline std::uint64_t hashCell(const GridCell<N>& cell) {
+
+    std::uint64_t hash = N;
+    for (unsigned i = 0; i < N; ++i) {
+
+        hash = mixHash(hash, static_cast<std::uint32_t>(cell.index[i]));
+    }
+
+    return finishHash(hash);
+}
+
+/**@return the cell of the N floats at v on a grid with the given inverse cell
+size, coordinates outside the range of int are clamped to it and NaN is given
+the lowest cell*/
+template<unsigned N>
+inline GridCell<N> cellOf(const float* v, float inverseCellSize) {
+
+    //the largest floats below 2^31 and at or above -2^31
+    const float lowest = -2147483648.0f;
+    const float highest = 2147483520.0f;
+
+    GridCell<N> cell;
+    for (unsigned i = 0; i < N; ++i) {
+
+        float f = std::floor(v[i] * inverseCellSize);
+        f = f >= lowest ? (f <= highest ? f : highest) : lowest;
+        cell.index[i] = static_cast<int>(f);
+    }
+
+    return cell;
+}
+
+/**@return bit i set for each of the HASH_GROUP tags at group that equals the
+given tag. SSE2 compares the whole group at once and is part of every x86-64
+CPU, so this needs no runtime dispatch*/
+inline unsigned matchTags(const unsigned char* group, unsigned char tag) {
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    __m128i tags = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+
+    return static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(tags, _mm_set1_epi8(static_cast<char>(tag)))));
+#else
+    unsigned bits = 0;
+    for (unsigned i = 0; i < HASH_GROUP; ++i) {
+
+        bits |= static_cast<unsigned>(group[i] == tag) << i;
+    }
+
+    return bits;
+#endif
+}
+
+/**Hints that the memory at the given address will be read soon*/
+inline void prefetch(const void* address) {
+
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#elif defined(UTIL_SIMD_X86)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void) address;
+#endif
+}
+
+/**@return the number of cells to make room for part way through adding an
+array of vectors to a map, which may share far fewer cells than there are
+vectors: the cells so far plus those the rest of the vectors would add at the
+rate new cells have been found so far
+@param size the number of cells in the map
+@param added the number of cells the vectors so far have added
+@param done the number of vectors added so far
+@param rest the number of vectors still to add*/
+inline std::size_t expectedCells(
+        std::size_t size,
+        std::size_t added,
+        std::size_t done,
+        std::size_t rest) {
+
+    if (done == 0) {
+
+        return size;
+    }
+
+    return size + static_cast<std::size_t>(static_cast<double>(rest) *
+        static_cast<double>(added) / static_cast<double>(done));
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return a hash of the exact value of a vector, vectors that compare equal
+have the same hash
+@param v the vector to hash*/
+inline std::size_t hash(const Vector2& v) {
+
+    UTIL_PROFILE_PROBE("vec::hash(Vector2)");
+
+    return static_cast<std::size_t>(detail::hashFloats<2>(&v.x));
+}
+
+/**@return a hash of the exact value of a vector, vectors that compare equal
+have the same hash
+@param v the vector to hash*/
+inline std::size_t hash(const Vector3& v) {
+
+    UTIL_PROFILE_PROBE("vec::hash(Vector3)");
+
+    return static_cast<std::size_t>(detail::hashFloats<3>(&v.x));
+}
+
+/**@return a hash of the exact value of a vector, vectors that compare equal
+have the same hash
+@param v the vector to hash*/
+inline std::size_t hash(const Vector4& v) {
+
+    UTIL_PROFILE_PROBE("vec::hash(Vector4)");
+
+    return static_cast<std::size_t>(detail::hashFloats<4>(&v.x));
+}
+
+/**@return a hash of a grid cell
+@param cell the cell to hash*/
+template<unsigned N>
+inline std::size_t hash(const GridCell<N>& cell) {
+
+    UTIL_PROFILE_PROBE("vec::hash(GridCell)");
+
+    return static_cast<std::size_t>(detail::hashCell(cell));
+}
+
+/**@return the cell of a uniform grid that a vector falls in, cell i along an
+axis holds the components from i * cellSize up to (i + 1) * cellSize
+@param v the vector
+@param cellSize the width of the cells of the grid*/
+inline GridCell<2> gridCell(const Vector2& v, float cellSize) {
+
+    UTIL_PROFILE_PROBE("vec::gridCell(Vector2)");
+
+    return detail::cellOf<2>(&v.x, 1.0f / cellSize);
+}
+
+/**@return the cell of a uniform grid that a vector falls in, cell i along an
+axis holds the components from i * cellSize up to (i + 1) * cellSize
+@param v the vector
+@param cellSize the width of the cells of the grid*/
+inline GridCell<3> gridCell(const Vector3& v, float cellSize) {
+
+    UTIL_PROFILE_PROBE("vec::gridCell(Vector3)");
+
+    return detail::cellOf<3>(&v.x, 1.0f / cellSize);
+}
+
+/**@return the cell of a uniform grid that a vector falls in, cell i along an
+axis holds the components from i * cellSize up to (i + 1) * cellSize
+@param v the vector
+@param cellSize the width of the cells of the grid*/
+inline GridCell<4> gridCell(const Vector4& v, float cellSize) {
+
+    UTIL_PROFILE_PROBE("vec::gridCell(Vector4)");
+
+    return detail::cellOf<4>(&v.x, 1.0f / cellSize);
+}
+
+/**@return a hash of the grid cell a vector falls in, vectors in the same cell
+have the same hash
+@param v the vector to hash
+@param cellSize the width of the cells of the grid*/
+template<typename VectorType>
+inline std::size_t gridHash(const VectorType& v, float cellSize) {
+
+    UTIL_PROFILE_PROBE("vec::gridHash");
+
+    return hash(gridCell(v, cellSize));
+}
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/****************************************************************************\
+| A function object hashing vectors and grid cells with hash(), for use with |
+| the standard unordered containers.                                         |
+\****************************************************************************/
+struct VectorHash {
+
+    template<typename T>
+    inline std::size_t operator ()(const T& v) const {
+
+        return hash(v);
+    }
+};
+
+/****************************************************************************\
+| A hash map from the cells of a uniform grid to values, looked up by any    |
+| vector in the cell. Cells, values and one byte tags are stored in flat     |
+| arrays with open addressing: a key is probed for by comparing its tag with |
+| a group of HASH_GROUP tags at once using SIMD, and the group of a key is   |
+| only left when the group is full. Entries cannot be removed individually.  |
+| Inserting may move the values, so pointers returned by find() only last    |
+| until the next insert.                                                     |
+\****************************************************************************/
+template<typename VectorType, typename Value>
+class SpatialHashMap {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //!the number of float components of the keys
+    static const unsigned COMPONENTS = sizeof(VectorType) / sizeof(float);
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new empty map
+    @param cellSize the width of the cells of the grid
+    @param capacity the number of cells to make room for*/
+    inline explicit SpatialHashMap(float cellSize, std::size_t capacity = 0) :
+        mCellSize(cellSize),
+        mInverseCellSize(1.0f / cellSize),
+        mSize(0) {
+
+        allocate(groupsFor(capacity));
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the number of cells in the map*/
+    inline std::size_t size() const {
+
+        return mSize;
+    }
+
+    /**@return the width of the cells of the grid*/
+    inline float cellSize() const {
+
+        return mCellSize;
+    }
+
+    /**@return the cell of the map's grid that a vector falls in*/
+    inline GridCell<COMPONENTS> cell(const VectorType& v) const {
+
+        return detail::cellOf<COMPONENTS>(&v.x, mInverseCellSize);
+    }
+
+    /**Makes room for the given number of cells without rehashing
+    @param capacity the number of cells to make room for*/
+    inline void reserve(std::size_t capacity) {
+
+        UTIL_PROFILE_PROBE("vec::SpatialHashMap::reserve");
+
+        std::size_t groups = groupsFor(capacity);
+        if (groups > mTags.size() / detail::HASH_GROUP) {
+
+            rehash(groups);
+        }
+    }
+
+    /**Removes every cell from the map, keeping its storage*/
+    inline void clear() {
+
+        std::fill(mTags.begin(), mTags.end(), detail::HASH_EMPTY);
+        mSize = 0;
+    }
+
+    /**@return the value of the cell a vector falls in, or null if the cell is
+    not in the map
+    @param v the vector to look up*/
+    inline Value* find(const VectorType& v) {
+
+        return find(cell(v));
+    }
+
+    /**@return the value of the cell a vector falls in, or null if the cell is
+    not in the map
+    @param v the vector to look up*/
+    inline const Value* find(const VectorType& v) const {
+
+        return find(cell(v));
+    }
+
+    /**@return the value of a cell, or null if the cell is not in the map,
+    neighbouring cells can be found by offsetting the indices of cell()
+    @param key the cell to look up*/
+    inline Value* find(const GridCell<COMPONENTS>& key) {
+
+        std::size_t slot = locate(key, detail::hashCell(key));
+
+        return slot == NOT_FOUND ? 0 : &mValues[slot];
+    }
+
+    /**@return the value of a cell, or null if the cell is not in the map,
+    neighbouring cells can be found by offsetting the indices of cell()
+    @param key the cell to look up*/
+    inline const Value* find(const GridCell<COMPONENTS>& key) const {
+
+        std::size_t slot = locate(key, detail::hashCell(key));
+
+        return slot == NOT_FOUND ? 0 : &mValues[slot];
+    }
+
+    /**Adds the cell a vector falls in with the given value, unless the cell is
+    already in the map
+    @param v a vector in the cell
+    @param value the value of the cell
+    @return whether the cell was added*/
+    inline bool insert(const VectorType& v, const Value& value) {
+
+        return insert(cell(v), value);
+    }
+
+    /**Adds a cell with the given value, unless the cell is already in the map
+    @param key the cell
+    @param value the value of the cell
+    @return whether the cell was added*/
+    inline bool insert(const GridCell<COMPONENTS>& key, const Value& value) {
+
+        std::size_t slot;
+
+        return insertHashed(key, detail::hashCell(key), value, slot);
+    }
+
+    /**Adds the cells an array of vectors fall in, each cell with the value of
+    the first vector to fall in it, and returns the value each vector's cell
+    ends up with. Giving each vector its index as its value therefore gives
+    every vector the index of the first vector in its cell
+    @param v the vectors
+    @param values the value of each vector
+    @param n the number of vectors
+    @param stored returns the value of each vector's cell after the insert,
+    may be null*/
+    inline void insert(
+            const VectorType* v,
+            const Value* values,
+            std::size_t n,
+            Value* stored) {
+
+        UTIL_PROFILE_PROBE("vec::SpatialHashMap::insert(Vector[])");
+
+        std::size_t initialSize = mSize;
+        GridCell<COMPONENTS> keys[detail::HASH_BATCH];
+        std::uint64_t hashes[detail::HASH_BATCH];
+        for (std::size_t begin = 0; begin < n; begin += detail::HASH_BATCH) {
+
+            std::size_t count = n - begin < detail::HASH_BATCH ?
+                n - begin : detail::HASH_BATCH;
+
+            //only grow when the batch might not fit, room for all of it keeps
+            //the groups prefetched for it in place
+            if (groupsFor(mSize + count) > mTags.size() / detail::HASH_GROUP) {
+
+                std::size_t expected = detail::expectedCells(
+                    mSize, mSize - initialSize, begin, n - begin);
+                reserve(expected > mSize + count ? expected : mSize + count);
+            }
+            hashBatch(v + begin, count, keys, hashes);
+
+            for (std::size_t i = 0; i < count; ++i) {
+
+                std::size_t slot;
+                insertHashed(keys[i], hashes[i], values[begin + i], slot);
+                if (stored) {
+
+                    stored[begin + i] = mValues[slot];
+                }
+            }
+        }
+    }
+
+    /**Looks up the cells an array of vectors fall in
+    @param v the vectors to look up
+    @param n the number of vectors
+    @param out returns the value of each vector's cell
+    @param missing the value returned for vectors whose cell is not in the map
+    @param execution whether to split large arrays across the thread pool*/
+    inline void find(
+            const VectorType* v,
+            std::size_t n,
+            Value* out,
+            const Value& missing,
+            util::thread::Execution execution =
+                util::thread::EXECUTE_SERIAL) const {
+
+        UTIL_PROFILE_PROBE("vec::SpatialHashMap::find(Vector[])");
+
+        util::thread::execute(execution, n, detail::HASH_CHUNK,
+            [&](std::size_t first, std::size_t last) {
+
+                GridCell<COMPONENTS> keys[detail::HASH_BATCH];
+                std::uint64_t hashes[detail::HASH_BATCH];
+                for (std::size_t begin = first; begin < last;
+                        begin += detail::HASH_BATCH) {
+
+                    std::size_t count = last - begin < detail::HASH_BATCH ?
+                        last - begin : detail::HASH_BATCH;
+                    hashBatch(v + begin, count, keys, hashes);
+
+                    for (std::size_t i = 0; i < count; ++i) {
+
+                        std::size_t slot = locate(keys[i], hashes[i]);
+                        out[begin + i] =
+                            slot == NOT_FOUND ? missing : mValues[slot];
+                    }
+                }
+            });
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the slot returned when a cell is not found
+    static const std::size_t NOT_FOUND = ~static_cast<std::size_t>(0);
+
+    //the width of the cells and its inverse
+    float mCellSize;
+    float mInverseCellSize;
+    //the number of cells in the map
+    std::size_t mSize;
+    //the tag of each slot, HASH_EMPTY or the low 7 bits of the cell's hash
+    std::vector<unsigned char, util::mem::AlignedAllocator<unsigned char> >
+        mTags;
+    //the cell and the value of each slot
+    std::vector<GridCell<COMPONENTS> > mCells;
+    std::vector<Value> mValues;
+
+    //--------------------------------------------------------------------------
+    //                          PRIVATE MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the number of groups, a power of two, that hold the given number
+    of cells at most 7/8 full*/
+    static inline std::size_t groupsFor(std::size_t capacity) {
+
+        std::size_t groups = 1;
+        while (groups * detail::HASH_GROUP * 7 / 8 < capacity) {
+
+            groups *= 2;
+        }
+
+        return groups;
+    }
+
+    /**Replaces the storage with the given number of empty groups*/
+    inline void allocate(std::size_t groups) {
+
+        mTags.assign(groups * detail::HASH_GROUP, detail::HASH_EMPTY);
+        mCells.resize(groups * detail::HASH_GROUP);
+        mValues.resize(groups * detail::HASH_GROUP);
+    }
+
+    /**Moves every cell into a new set of groups*/
+    inline void rehash(std::size_t groups) {
+
+        std::vector<unsigned char, util::mem::AlignedAllocator<unsigned char> >
+            tags;
+        std::vector<GridCell<COMPONENTS> > cells;
+        std::vector<Value> values;
+        tags.swap(mTags);
+        cells.swap(mCells);
+        values.swap(mValues);
+
+        allocate(groups);
+        mSize = 0;
+        for (std::size_t i = 0; i < tags.size(); ++i) {
+
+            if (tags[i] != detail::HASH_EMPTY) {
+
+                std::size_t slot;
+                insertHashed(cells[i], detail::hashCell(cells[i]), values[i],
+                    slot);
+            }
+        }
+    }
+
+    /**Finds the cells and hashes of a batch of vectors and prefetches the
+    first group each will probe*/
+    inline void hashBatch(
+            const VectorType* v,
+            std::size_t count,
+            GridCell<COMPONENTS>* keys,
+            std::uint64_t* hashes) const {
+
+        std::size_t mask = mTags.size() / detail::HASH_GROUP - 1;
+        for (std::size_t i = 0; i < count; ++i) {
+
+            keys[i] = detail::cellOf<COMPONENTS>(&v[i].x, mInverseCellSize);
+            hashes[i] = detail::hashCell(keys[i]);
+            detail::prefetch(
+                &mTags[((hashes[i] >> 7) & mask) * detail::HASH_GROUP]);
+        }
+    }
+
+    /**@return the slot of a cell or NOT_FOUND. The low 7 bits of the hash are
+    the tag and the rest choose the first group, the groups are then visited
+    with steps of 1, 2, 3... which covers every group*/
+    inline std::size_t locate(
+            const GridCell<COMPONENTS>& key, std::uint64_t hash) const {
+
+        std::size_t mask = mTags.size() / detail::HASH_GROUP - 1;
+        std::size_t group = static_cast<std::size_t>(hash >> 7) & mask;
+        unsigned char tag = static_cast<unsigned char>(hash & 0x7F);
+        for (std::size_t step = 1;; ++step) {
+
+            const unsigned char* tags = &mTags[group * detail::HASH_GROUP];
+            for (unsigned match = detail::matchTags(tags, tag); match != 0;
+                    match &= match - 1) {
+
+                std::size_t slot = group * detail::HASH_GROUP +
+                    util::simd::lowestSetBit(match);
+                if (mCells[slot] == key) {
+
+                    return slot;
+                }
+            }
+            if (detail::matchTags(tags, detail::HASH_EMPTY) != 0) {
+
+                return NOT_FOUND;
+            }
+            group = (group + step) & mask;
+        }
+    }
+
+    /**Adds a cell with its hash unless it is in the map already
+    @param slot returns the slot of the cell
+    @return whether the cell was added*/
+    inline bool insertHashed(
+            const GridCell<COMPONENTS>& key,
+            std::uint64_t hash,
+            const Value& value,
+            std::size_t& slot) {
+
+        slot = locate(key, hash);
+        if (slot != NOT_FOUND) {
+
+            return false;
+        }
+
+        if ((mSize + 1) * 8 > mTags.size() * 7) {
+
+            rehash(mTags.size() / detail::HASH_GROUP * 2);
+        }
+
+        //the cell goes in the first empty slot of its probe sequence
+        std::size_t mask = mTags.size() / detail::HASH_GROUP - 1;
+        std::size_t group = static_cast<std::size_t>(hash >> 7) & mask;
+        for (std::size_t step = 1;; ++step) {
+
+            unsigned empty = detail::matchTags(
+                &mTags[group * detail::HASH_GROUP], detail::HASH_EMPTY);
+            if (empty != 0) {
+
+                slot = group * detail::HASH_GROUP +
+                    util::simd::lowestSetBit(empty);
+                break;
+            }
+            group = (group + step) & mask;
+        }
+
+        mTags[slot] = static_cast<unsigned char>(hash & 0x7F);
+        mCells[slot] = key;
+        mValues[slot] = value;
+        ++mSize;
+
+        return true;
+    }
+};
+
+} } //util //vec
+
+#endif
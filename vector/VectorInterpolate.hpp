@@ -0,0 +1,465 @@
+#ifndef UTILITRON_VECTOR_VECTORINTERPOLATE_H_
+#   define UTILITRON_VECTOR_VECTORINTERPOLATE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "../MathUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+#include "VectorAngles.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+//the interpolation kernels use the trig evaluators of VectorAngles.inl
+#define UTIL_SIMD_KERNELS "vector/detail/VectorInterpolate.inl"
+#include "../SimdForEachIsa.hpp"
+
+//!the number of interpolations each thread runs at a time in parallel mode
+static const std::size_t INTERPOLATE_CHUNK = 1 << 14;
+
+/**@return a unit vector perpendicular to a unit vector, made from its two
+largest components so that it is never close to zero*/
+inline Vector3 perpendicular(const Vector3& v) {
+
+    Vector3 p = std::fabs(v.x) > std::fabs(v.z) ?
+        Vector3(-v.y, v.x, 0.0f) : Vector3(0.0f, -v.z, v.y);
+
+    return p / magnitude(p);
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                INTERPOLATION
+//------------------------------------------------------------------------------
+
+/**Linearly interpolates between two values
+@param a the value at t = 0
+@param b the value at t = 1
+@param t the interpolation parameter
+@return the interpolated value*/
+template<typename VectorType>
+inline VectorType lerp(const VectorType& a, const VectorType& b, float t) {
+
+    UTIL_PROFILE_PROBE("vec::lerp");
+
+    return a + (b - a) * t;
+}
+
+/**Linearly interpolates between two unit vectors and normalises the result,
+which is cheaper than slerp() but does not move at a constant angular speed
+@param a the unit vector at t = 0
+@param b the unit vector at t = 1
+@param t the interpolation parameter
+@return the interpolated unit vector*/
+inline Vector3 nlerp(const Vector3& a, const Vector3& b, float t) {
+
+    UTIL_PROFILE_PROBE("vec::nlerp(Vector3)");
+
+    return normalise(lerp(a, b, t));
+}
+
+/**Spherically interpolates between two unit vectors, moving along the great
+circle between them at a constant angular speed. Nearly opposite vectors have
+no single great circle between them, so they are interpolated through a unit
+vector perpendicular to a, reached at t = 0.5
+@param a the unit vector at t = 0
+@param b the unit vector at t = 1
+@param t the interpolation parameter
+@return the interpolated unit vector*/
+inline Vector3 slerp(const Vector3& a, const Vector3& b, float t) {
+
+    UTIL_PROFILE_PROBE("vec::slerp(Vector3)");
+
+    float sine = magnitude(cross(a, b));
+    if (sine < 1.0e-4f) {
+
+        //nearly parallel vectors fall back to normalised linear
+        //interpolation, which would pass through zero between opposite ones
+        if (!(dot(a, b) < 0.0f)) {
+
+            return nlerp(a, b, t);
+        }
+
+        Vector3 middle = detail::perpendicular(a);
+
+        return t < 0.5f ? slerp(a, middle, t * 2.0f) :
+            slerp(middle, b, t * 2.0f - 1.0f);
+    }
+
+    float angle = std::atan2(sine, dot(a, b));
+
+    return (a * std::sin((1.0f - t) * angle) + b * std::sin(t * angle)) /
+        sine;
+}
+
+/**Evaluates a segment of a uniform Catmull-Rom spline, which passes through
+its keys
+@param p0 the key before the segment
+@param p1 the key at the start of the segment
+@param p2 the key at the end of the segment
+@param p3 the key after the segment
+@param t the parameter along the segment, from 0 to 1
+@return the point on the spline*/
+template<typename VectorType>
+inline VectorType catmullRom(
+        const VectorType& p0,
+        const VectorType& p1,
+        const VectorType& p2,
+        const VectorType& p3,
+        float t) {
+
+    UTIL_PROFILE_PROBE("vec::catmullRom");
+
+    VectorType b = p2 - p0;
+    VectorType c = p0 * 2.0f + p2 * 4.0f - p1 * 5.0f - p3;
+    VectorType d = (p1 - p2) * 3.0f + p3 - p0;
+
+    return (((d * t + c) * t + b) * t + p1 * 2.0f) * 0.5f;
+}
+
+/**Evaluates a cubic Bezier curve
+@param p0 the start of the curve
+@param p1 the first control point
+@param p2 the second control point
+@param p3 the end of the curve
+@param t the parameter along the curve, from 0 to 1
+@return the point on the curve*/
+template<typename VectorType>
+inline VectorType bezier(
+        const VectorType& p0,
+        const VectorType& p1,
+        const VectorType& p2,
+        const VectorType& p3,
+        float t) {
+
+    UTIL_PROFILE_PROBE("vec::bezier");
+
+    float u = 1.0f - t;
+
+    return p0 * (u * u * u) + p1 * (3.0f * u * u * t) +
+        p2 * (3.0f * u * t * t) + p3 * (t * t * t);
+}
+
+//------------------------------------------------------------------------------
+//                             BULK INTERPOLATION
+//------------------------------------------------------------------------------
+// These interpolate whole arrays using the widest instruction set the CPU
+// supports, and across the thread pool when given EXECUTE_PARALLEL. The spline
+// functions sample a track of keys or control points at an array of parameters:
+// a track of k Catmull-Rom keys is parameterised from 0 to k - 1 and a track of
+// 3s + 1 Bezier control points (s curves sharing end points) from 0 to s, with
+// key i or curve i starting at parameter i. Parameters outside the track are
+// clamped to it. The bulk slerp uses util::math::TRIG_PRECISE approximations.
+
+//-----------------------------------VECTOR2------------------------------------
+
+/**out[i] = lerp(a[i], b[i], t[i])
+@param a the array of vectors at t = 0
+@param b the array of vectors at t = 1
+@param t the array of interpolation parameters
+@param out returns the interpolated vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool*/
+inline void lerp(
+        const Vector2* a,
+        const Vector2* b,
+        const float* t,
+        Vector2* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::lerp(Vector2[])");
+
+    void (*kernel)(const float*, const float*, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, lerp<2>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&a[begin].x, &b[begin].x, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+/**Samples a uniform Catmull-Rom spline through a track of keys
+@param keys the keys of the track
+@param keyCount the number of keys, at least 1
+@param t the parameters to sample the track at, from 0 to keyCount - 1
+@param out returns the points on the spline
+@param n the number of parameters
+@param execution whether to split large arrays across the thread pool*/
+inline void catmullRom(
+        const Vector2* keys,
+        std::size_t keyCount,
+        const float* t,
+        Vector2* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::catmullRom(Vector2[])");
+
+    void (*kernel)(const float*, std::size_t, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, catmullRom<2>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&keys->x, keyCount, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+/**Samples a track of cubic Bezier curves that share their end points
+@param controls the control points of the track, 3s + 1 for s curves
+@param controlCount the number of control points, at least 1
+@param t the parameters to sample the track at, from 0 to s
+@param out returns the points on the curves
+@param n the number of parameters
+@param execution whether to split large arrays across the thread pool*/
+inline void bezier(
+        const Vector2* controls,
+        std::size_t controlCount,
+        const float* t,
+        Vector2* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::bezier(Vector2[])");
+
+    void (*kernel)(const float*, std::size_t, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, bezier<2>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&controls->x, controlCount, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+//-----------------------------------VECTOR3------------------------------------
+
+/**out[i] = lerp(a[i], b[i], t[i])
+@param a the array of vectors at t = 0
+@param b the array of vectors at t = 1
+@param t the array of interpolation parameters
+@param out returns the interpolated vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool*/
+inline void lerp(
+        const Vector3* a,
+        const Vector3* b,
+        const float* t,
+        Vector3* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::lerp(Vector3[])");
+
+    void (*kernel)(const float*, const float*, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, lerp<3>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&a[begin].x, &b[begin].x, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+/**Samples a uniform Catmull-Rom spline through a track of keys
+@param keys the keys of the track
+@param keyCount the number of keys, at least 1
+@param t the parameters to sample the track at, from 0 to keyCount - 1
+@param out returns the points on the spline
+@param n the number of parameters
+@param execution whether to split large arrays across the thread pool*/
+inline void catmullRom(
+        const Vector3* keys,
+        std::size_t keyCount,
+        const float* t,
+        Vector3* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::catmullRom(Vector3[])");
+
+    void (*kernel)(const float*, std::size_t, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, catmullRom<3>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&keys->x, keyCount, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+/**Samples a track of cubic Bezier curves that share their end points
+@param controls the control points of the track, 3s + 1 for s curves
+@param controlCount the number of control points, at least 1
+@param t the parameters to sample the track at, from 0 to s
+@param out returns the points on the curves
+@param n the number of parameters
+@param execution whether to split large arrays across the thread pool*/
+inline void bezier(
+        const Vector3* controls,
+        std::size_t controlCount,
+        const float* t,
+        Vector3* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::bezier(Vector3[])");
+
+    void (*kernel)(const float*, std::size_t, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, bezier<3>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&controls->x, controlCount, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+/**out[i] = nlerp(a[i], b[i], t[i])
+@param a the array of unit vectors at t = 0
+@param b the array of unit vectors at t = 1
+@param t the array of interpolation parameters
+@param out returns the interpolated unit vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool*/
+inline void nlerp(
+        const Vector3* a,
+        const Vector3* b,
+        const float* t,
+        Vector3* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::nlerp(Vector3[])");
+
+    void (*kernel)(const float*, const float*, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, interpolateUnit<false>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&a[begin].x, &b[begin].x, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+/**out[i] = slerp(a[i], b[i], t[i])
+@param a the array of unit vectors at t = 0
+@param b the array of unit vectors at t = 1
+@param t the array of interpolation parameters
+@param out returns the interpolated unit vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool*/
+inline void slerp(
+        const Vector3* a,
+        const Vector3* b,
+        const float* t,
+        Vector3* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::slerp(Vector3[])");
+
+    void (*kernel)(const float*, const float*, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, interpolateUnit<true>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&a[begin].x, &b[begin].x, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+//-----------------------------------VECTOR4------------------------------------
+
+/**out[i] = lerp(a[i], b[i], t[i])
+@param a the array of vectors at t = 0
+@param b the array of vectors at t = 1
+@param t the array of interpolation parameters
+@param out returns the interpolated vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool*/
+inline void lerp(
+        const Vector4* a,
+        const Vector4* b,
+        const float* t,
+        Vector4* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::lerp(Vector4[])");
+
+    void (*kernel)(const float*, const float*, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, lerp<4>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&a[begin].x, &b[begin].x, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+/**Samples a uniform Catmull-Rom spline through a track of keys
+@param keys the keys of the track
+@param keyCount the number of keys, at least 1
+@param t the parameters to sample the track at, from 0 to keyCount - 1
+@param out returns the points on the spline
+@param n the number of parameters
+@param execution whether to split large arrays across the thread pool*/
+inline void catmullRom(
+        const Vector4* keys,
+        std::size_t keyCount,
+        const float* t,
+        Vector4* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::catmullRom(Vector4[])");
+
+    void (*kernel)(const float*, std::size_t, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, catmullRom<4>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&keys->x, keyCount, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+/**Samples a track of cubic Bezier curves that share their end points
+@param controls the control points of the track, 3s + 1 for s curves
+@param controlCount the number of control points, at least 1
+@param t the parameters to sample the track at, from 0 to s
+@param out returns the points on the curves
+@param n the number of parameters
+@param execution whether to split large arrays across the thread pool*/
+inline void bezier(
+        const Vector4* controls,
+        std::size_t controlCount,
+        const float* t,
+        Vector4* out,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::bezier(Vector4[])");
+
+    void (*kernel)(const float*, std::size_t, const float*, float*,
+        std::size_t) = UTIL_SIMD_DISPATCH(detail, bezier<4>);
+    util::thread::execute(execution, n, detail::INTERPOLATE_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&controls->x, controlCount, t + begin, &out[begin].x,
+                end - begin);
+        });
+}
+
+} } //util //vec
+
+#endif
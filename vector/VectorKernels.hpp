@@ -0,0 +1,545 @@
+#ifndef UTILITRON_VECTOR_VECTORKERNELS_H_
+#   define UTILITRON_VECTOR_VECTORKERNELS_H_
+
+#include <cmath>
+#include <cstddef>
+
+#include "../SimdUtil.hpp"
+#include "../Vector.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorKernels.inl"
+#include "../SimdForEachIsa.hpp"
+
+/**@return the components of the given vector array as a flat float array*/
+template<typename VectorType>
+inline const float* components(const VectorType* v) {
+
+    return &v->x;
+}
+
+/**@return the components of the given vector array as a flat float array*/
+template<typename VectorType>
+inline float* components(VectorType* v) {
+
+    return &v->x;
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                             BULK VECTOR FUNCTIONS
+//------------------------------------------------------------------------------
+// These apply the vector operators and vector math functions to whole arrays of
+// vectors using the widest instruction set the CPU supports (see SimdUtil.hpp).
+// The output array may be the same as an input array but must not otherwise
+// overlap one.
+
+//-----------------------------------VECTOR2------------------------------------
+
+/**Adds each vector of b to the vector at the same index of a
+@param a the first array of vectors
+@param b the array of vectors to add
+@param out returns the results of the additions
+@param n the number of vectors*/
+inline void add(
+        const Vector2* a, const Vector2* b, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::add(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, add)(detail::components(a),
+        detail::components(b), detail::components(out), n * 2);
+}
+
+/**Adds the given scalar to the components of each vector
+@param v the array of vectors
+@param scalar the scalar to add
+@param out returns the results of the additions
+@param n the number of vectors*/
+inline void add(const Vector2* v, float scalar, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::add(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, addScalar)(
+        detail::components(v), scalar, detail::components(out), n * 2);
+}
+
+/**Subtracts each vector of b from the vector at the same index of a
+@param a the first array of vectors
+@param b the array of vectors to subtract
+@param out returns the results of the subtractions
+@param n the number of vectors*/
+inline void subtract(
+        const Vector2* a, const Vector2* b, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::subtract(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, subtract)(detail::components(a),
+        detail::components(b), detail::components(out), n * 2);
+}
+
+/**Subtracts the given scalar from the components of each vector
+@param v the array of vectors
+@param scalar the scalar to subtract
+@param out returns the results of the subtractions
+@param n the number of vectors*/
+inline void subtract(
+        const Vector2* v, float scalar, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::subtract(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, addScalar)(
+        detail::components(v), -scalar, detail::components(out), n * 2);
+}
+
+/**Multiplies the components of each vector by the given scalar
+@param v the array of vectors
+@param scalar the scalar to multiply by
+@param out returns the results of the multiplications
+@param n the number of vectors*/
+inline void multiply(
+        const Vector2* v, float scalar, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::multiply(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, multiplyScalar)(
+        detail::components(v), scalar, detail::components(out), n * 2);
+}
+
+/**Divides the components of each vector by the given scalar
+@param v the array of vectors
+@param scalar the scalar to divide by
+@param out returns the results of the divisions
+@param n the number of vectors*/
+inline void divide(
+        const Vector2* v, float scalar, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::divide(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, divideScalar)(
+        detail::components(v), scalar, detail::components(out), n * 2);
+}
+
+/**Negates each vector
+@param v the array of vectors
+@param out returns the negated vectors
+@param n the number of vectors*/
+inline void negate(const Vector2* v, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::negate(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, multiplyScalar)(
+        detail::components(v), -1.0f, detail::components(out), n * 2);
+}
+
+/**Computes the dot product of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the dot products
+@param n the number of vectors*/
+inline void dot(const Vector2* a, const Vector2* b, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, dot<2>)(
+        detail::components(a), detail::components(b), out, n);
+}
+
+/**Computes the magnitude of each vector
+@param v the array of vectors
+@param out returns the magnitudes
+@param n the number of vectors*/
+inline void magnitude(const Vector2* v, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, magnitude<2>)(
+        detail::components(v), out, n);
+}
+
+/**Normalises each vector
+@param v the array of vectors
+@param out returns the normalised vectors
+@param n the number of vectors*/
+inline void normalise(const Vector2* v, Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::normalise(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, normalise<2>)(
+        detail::components(v), detail::components(out), n);
+}
+
+/**Calculates the distance between each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the distances
+@param n the number of vectors*/
+inline void distance(
+        const Vector2* a, const Vector2* b, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, distance<2>)(
+        detail::components(a), detail::components(b), out, n);
+}
+
+/**Transforms each vector as a point in the xy plane (with an implicit z of 0
+and w of 1) by the given matrix. Only the x and y rows of the matrix are used
+@param v the array of vectors
+@param matrix the row-major 4x4 matrix to transform by
+@param out returns the transformed vectors
+@param n the number of vectors*/
+inline void transform(
+        const Vector2* v, const float matrix[16], Vector2* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::transform(Vector2[])");
+
+    UTIL_SIMD_DISPATCH(detail, transform<2>)(
+        detail::components(v), matrix, detail::components(out), n);
+}
+
+//-----------------------------------VECTOR3------------------------------------
+
+/**Adds each vector of b to the vector at the same index of a
+@param a the first array of vectors
+@param b the array of vectors to add
+@param out returns the results of the additions
+@param n the number of vectors*/
+inline void add(
+        const Vector3* a, const Vector3* b, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::add(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, add)(detail::components(a),
+        detail::components(b), detail::components(out), n * 3);
+}
+
+/**Adds the given scalar to the components of each vector
+@param v the array of vectors
+@param scalar the scalar to add
+@param out returns the results of the additions
+@param n the number of vectors*/
+inline void add(const Vector3* v, float scalar, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::add(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, addScalar)(
+        detail::components(v), scalar, detail::components(out), n * 3);
+}
+
+/**Subtracts each vector of b from the vector at the same index of a
+@param a the first array of vectors
+@param b the array of vectors to subtract
+@param out returns the results of the subtractions
+@param n the number of vectors*/
+inline void subtract(
+        const Vector3* a, const Vector3* b, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::subtract(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, subtract)(detail::components(a),
+        detail::components(b), detail::components(out), n * 3);
+}
+
+/**Subtracts the given scalar from the components of each vector
+@param v the array of vectors
+@param scalar the scalar to subtract
+@param out returns the results of the subtractions
+@param n the number of vectors*/
+inline void subtract(
+        const Vector3* v, float scalar, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::subtract(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, addScalar)(
+        detail::components(v), -scalar, detail::components(out), n * 3);
+}
+
+/**Multiplies the components of each vector by the given scalar
+@param v the array of vectors
+@param scalar the scalar to multiply by
+@param out returns the results of the multiplications
+@param n the number of vectors*/
+inline void multiply(
+        const Vector3* v, float scalar, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::multiply(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, multiplyScalar)(
+        detail::components(v), scalar, detail::components(out), n * 3);
+}
+
+/**Divides the components of each vector by the given scalar
+@param v the array of vectors
+@param scalar the scalar to divide by
+@param out returns the results of the divisions
+@param n the number of vectors*/
+inline void divide(
+        const Vector3* v, float scalar, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::divide(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, divideScalar)(
+        detail::components(v), scalar, detail::components(out), n * 3);
+}
+
+/**Negates each vector
+@param v the array of vectors
+@param out returns the negated vectors
+@param n the number of vectors*/
+inline void negate(const Vector3* v, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::negate(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, multiplyScalar)(
+        detail::components(v), -1.0f, detail::components(out), n * 3);
+}
+
+/**Computes the dot product of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the dot products
+@param n the number of vectors*/
+inline void dot(const Vector3* a, const Vector3* b, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, dot<3>)(
+        detail::components(a), detail::components(b), out, n);
+}
+
+/**Computes the magnitude of each vector
+@param v the array of vectors
+@param out returns the magnitudes
+@param n the number of vectors*/
+inline void magnitude(const Vector3* v, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, magnitude<3>)(
+        detail::components(v), out, n);
+}
+
+/**Normalises each vector
+@param v the array of vectors
+@param out returns the normalised vectors
+@param n the number of vectors*/
+inline void normalise(const Vector3* v, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::normalise(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, normalise<3>)(
+        detail::components(v), detail::components(out), n);
+}
+
+/**Calculates the distance between each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the distances
+@param n the number of vectors*/
+inline void distance(
+        const Vector3* a, const Vector3* b, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, distance<3>)(
+        detail::components(a), detail::components(b), out, n);
+}
+
+/**Computes the cross product of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the cross products
+@param n the number of vectors*/
+inline void cross(
+        const Vector3* a, const Vector3* b, Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::cross(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, cross)(detail::components(a),
+        detail::components(b), detail::components(out), n);
+}
+
+/**Transforms each vector as a point (with an implicit w of 1) by the given
+matrix. The w row of the matrix is ignored
+@param v the array of vectors
+@param matrix the row-major 4x4 matrix to transform by
+@param out returns the transformed vectors
+@param n the number of vectors*/
+inline void transform(
+        const Vector3* v, const float matrix[16], Vector3* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::transform(Vector3[])");
+
+    UTIL_SIMD_DISPATCH(detail, transform<3>)(
+        detail::components(v), matrix, detail::components(out), n);
+}
+
+//-----------------------------------VECTOR4------------------------------------
+
+/**Adds each vector of b to the vector at the same index of a
+@param a the first array of vectors
+@param b the array of vectors to add
+@param out returns the results of the additions
+@param n the number of vectors*/
+inline void add(
+        const Vector4* a, const Vector4* b, Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::add(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, add)(detail::components(a),
+        detail::components(b), detail::components(out), n * 4);
+}
+
+/**Adds the given scalar to the components of each vector
+@param v the array of vectors
+@param scalar the scalar to add
+@param out returns the results of the additions
+@param n the number of vectors*/
+inline void add(const Vector4* v, float scalar, Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::add(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, addScalar)(
+        detail::components(v), scalar, detail::components(out), n * 4);
+}
+
+/**Subtracts each vector of b from the vector at the same index of a
+@param a the first array of vectors
+@param b the array of vectors to subtract
+@param out returns the results of the subtractions
+@param n the number of vectors*/
+inline void subtract(
+        const Vector4* a, const Vector4* b, Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::subtract(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, subtract)(detail::components(a),
+        detail::components(b), detail::components(out), n * 4);
+}
+
+/**Subtracts the given scalar from the components of each vector
+@param v the array of vectors
+@param scalar the scalar to subtract
+@param out returns the results of the subtractions
+@param n the number of vectors*/
+inline void subtract(
+        const Vector4* v, float scalar, Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::subtract(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, addScalar)(
+        detail::components(v), -scalar, detail::components(out), n * 4);
+}
+
+/**Multiplies the components of each vector by the given scalar
+@param v the array of vectors
+@param scalar the scalar to multiply by
+@param out returns the results of the multiplications
+@param n the number of vectors*/
+inline void multiply(
+        const Vector4* v, float scalar, Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::multiply(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, multiplyScalar)(
+        detail::components(v), scalar, detail::components(out), n * 4);
+}
+
+/**Divides the components of each vector by the given scalar
+@param v the array of vectors
+@param scalar the scalar to divide by
+@param out returns the results of the divisions
+@param n the number of vectors*/
+inline void divide(
+        const Vector4* v, float scalar, Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::divide(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, divideScalar)(
+        detail::components(v), scalar, detail::components(out), n * 4);
+}
+
+/**Negates each vector
+@param v the array of vectors
+@param out returns the negated vectors
+@param n the number of vectors*/
+inline void negate(const Vector4* v, Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::negate(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, multiplyScalar)(
+        detail::components(v), -1.0f, detail::components(out), n * 4);
+}
+
+/**Computes the dot product of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the dot products
+@param n the number of vectors*/
+inline void dot(const Vector4* a, const Vector4* b, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, dot<4>)(
+        detail::components(a), detail::components(b), out, n);
+}
+
+/**Computes the magnitude of each vector
+@param v the array of vectors
+@param out returns the magnitudes
+@param n the number of vectors*/
+inline void magnitude(const Vector4* v, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, magnitude<4>)(
+        detail::components(v), out, n);
+}
+
+/**Normalises each vector
+@param v the array of vectors
+@param out returns the normalised vectors
+@param n the number of vectors*/
+inline void normalise(const Vector4* v, Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::normalise(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, normalise<4>)(
+        detail::components(v), detail::components(out), n);
+}
+
+/**Calculates the distance between each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the distances
+@param n the number of vectors*/
+inline void distance(
+        const Vector4* a, const Vector4* b, float* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, distance<4>)(
+        detail::components(a), detail::components(b), out, n);
+}
+
+/**Transforms each vector by the given matrix
+@param v the array of vectors
+@param matrix the row-major 4x4 matrix to transform by
+@param out returns the transformed vectors
+@param n the number of vectors*/
+inline void transform(
+        const Vector4* v, const float matrix[16], Vector4* out, std::size_t n) {
+
+    UTIL_PROFILE_PROBE("vec::transform(Vector4[])");
+
+    UTIL_SIMD_DISPATCH(detail, transform<4>)(
+        detail::components(v), matrix, detail::components(out), n);
+}
+
+} } //util //vec
+
+#endif
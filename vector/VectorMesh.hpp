@@ -0,0 +1,368 @@
+#ifndef UTILITRON_VECTOR_VECTORMESH_H_
+#   define UTILITRON_VECTOR_VECTORMESH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "../MathUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+#include "VectorAngles.hpp"
+
+namespace util { namespace vec {
+
+//------------------------------------------------------------------------------
+//                                  ENUMERATORS
+//------------------------------------------------------------------------------
+
+/**How the normals of the triangles around a vertex are weighted in its
+vertex normal*/
+enum NormalWeighting {
+
+    //!by the area of each triangle, which is the cheapest
+    WEIGHT_AREA,
+    //!by the angle of each triangle at the vertex, which does not depend on
+    //!how the faces around the vertex are split into triangles
+    WEIGHT_ANGLE
+};
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of triangles or vertices each thread processes at a time in
+//!parallel mode
+static const std::size_t MESH_CHUNK = 1 << 14;
+//!the sine of the angle between the edges of a triangle below which it is
+//!taken to have no area, as its normal would be mostly rounding error
+static const float MESH_SLIVER_SINE = 1.0e-6f;
+
+//the angle weights use the atan2 evaluator of VectorAngles.inl
+#define UTIL_SIMD_KERNELS "vector/detail/VectorMesh.inl"
+#include "../SimdForEachIsa.hpp"
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return a vector scaled to unit length, or the zero vector if it has no
+length*/
+inline Vector3 unitOrZero(const Vector3& v) {
+
+    float length = magnitude(v);
+
+    return length > 0.0f ? v / length : Vector3();
+}
+
+/**Finds the unit normals of triangles, and the weights of their corners in
+the vertex normals if weights is not null*/
+inline void meshTriangles(
+        const Vector3* positions,
+        const unsigned* indices,
+        std::size_t triangles,
+        Vector3* normals,
+        float* weights,
+        NormalWeighting weighting,
+        util::thread::Execution execution) {
+
+    void (*kernel)(const float*, const unsigned*, std::size_t, float*, float*) =
+        weighting == WEIGHT_ANGLE ?
+            UTIL_SIMD_DISPATCH(detail, triangleNormals<true>) :
+            UTIL_SIMD_DISPATCH(detail, triangleNormals<false>);
+
+    util::thread::execute(execution, triangles, MESH_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&positions->x, indices + begin * 3, end - begin,
+                &normals[begin].x, weights ? weights + begin * 3 : nullptr);
+        });
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/*****************************************************************************\
+| The triangles around each vertex of an indexed triangle mesh, as the        |
+| corners (triangle * 3 + corner) that refer to each vertex. Vertex normals   |
+| and tangents are gathered by each vertex from its own corners, so vertices  |
+| can be split between threads without locks and the sums are always taken in |
+| the same order. The adjacency only depends on the index buffer, so a        |
+| deforming mesh can build it once and reuse it every frame.                  |
+\*****************************************************************************/
+class MeshAdjacency {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Finds the corners around each vertex of a mesh
+    @param indices the index buffer, three vertex indices per triangle
+    @param triangles the number of triangles
+    @param vertices the number of vertices*/
+    inline MeshAdjacency(
+            const unsigned* indices,
+            std::size_t triangles,
+            std::size_t vertices)
+        :
+        mOffsets(vertices + 1, 0),
+        mCorners(triangles * 3) {
+
+        UTIL_PROFILE_PROBE("vec::MeshAdjacency::MeshAdjacency");
+
+        //a counting sort of the corners by vertex
+        for (std::size_t i = 0; i < triangles * 3; ++i) {
+
+            ++mOffsets[indices[i] + 1];
+        }
+        for (std::size_t v = 0; v < vertices; ++v) {
+
+            mOffsets[v + 1] += mOffsets[v];
+        }
+        std::vector<std::size_t> next(mOffsets.begin(), mOffsets.end() - 1);
+        for (std::size_t i = 0; i < triangles * 3; ++i) {
+
+            mCorners[next[indices[i]]++] = static_cast<unsigned>(i);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the number of vertices*/
+    inline std::size_t vertices() const {
+
+        return mOffsets.size() - 1;
+    }
+
+    /**@return the first corner that refers to a vertex, in ascending order*/
+    inline const unsigned* begin(std::size_t vertex) const {
+
+        return mCorners.data() + mOffsets[vertex];
+    }
+
+    /**@return the end of the corners that refer to a vertex*/
+    inline const unsigned* end(std::size_t vertex) const {
+
+        return mCorners.data() + mOffsets[vertex + 1];
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the first entry of mCorners of each vertex, and the total at the end
+    std::vector<std::size_t> mOffsets;
+    //the corners grouped by vertex
+    std::vector<unsigned> mCorners;
+};
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+// These work on indexed triangle meshes: an array of vertex positions and an
+// index buffer of three vertex indices per triangle, with counter-clockwise
+// triangles facing the viewer. Triangles without area, including slivers
+// whose edges are parallel to within rounding, have a zero normal and
+// vertices without any triangles with area get a zero normal and tangent.
+
+/**Computes the unit normal of each triangle of a mesh, a register of
+triangles at a time
+@param positions the positions of the vertices
+@param indices the index buffer
+@param triangles the number of triangles
+@param normals returns the normal of each triangle
+@param execution whether to split large meshes across the thread pool*/
+inline void faceNormals(
+        const Vector3* positions,
+        const unsigned* indices,
+        std::size_t triangles,
+        Vector3* normals,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::faceNormals(Vector3[])");
+
+    detail::meshTriangles(positions, indices, triangles, normals, nullptr,
+        WEIGHT_AREA, execution);
+}
+
+/**Computes the unit normal of each vertex of a mesh from the normals of the
+triangles around it. The triangle normals are found in bulk, then each vertex
+sums the normals of its own triangles, so the vertices are split across the
+thread pool without locks and the result does not depend on the execution
+mode
+@param positions the positions of the vertices
+@param indices the index buffer
+@param triangles the number of triangles
+@param adjacency the adjacency of the mesh
+@param normals returns the normal of each vertex
+@param weighting how the triangle normals are weighted
+@param execution whether to split large meshes across the thread pool*/
+inline void vertexNormals(
+        const Vector3* positions,
+        const unsigned* indices,
+        std::size_t triangles,
+        const MeshAdjacency& adjacency,
+        Vector3* normals,
+        NormalWeighting weighting = WEIGHT_AREA,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::vertexNormals(Vector3[])");
+
+    std::vector<Vector3> faces(triangles);
+    std::vector<float> weights(triangles * 3);
+    detail::meshTriangles(positions, indices, triangles, faces.data(),
+        weights.data(), weighting, execution);
+
+    util::thread::execute(execution, adjacency.vertices(), detail::MESH_CHUNK,
+        [&](std::size_t begin, std::size_t end) {
+
+            for (std::size_t v = begin; v < end; ++v) {
+
+                Vector3 sum;
+                for (const unsigned* c = adjacency.begin(v);
+                     c != adjacency.end(v); ++c) {
+
+                    sum += faces[*c / 3] * weights[*c];
+                }
+                normals[v] = detail::unitOrZero(sum);
+            }
+        });
+}
+
+/**Computes the unit normal of each vertex of a mesh from the normals of the
+triangles around it, building the adjacency of the mesh first
+@param positions the positions of the vertices
+@param vertices the number of vertices
+@param indices the index buffer
+@param triangles the number of triangles
+@param normals returns the normal of each vertex
+@param weighting how the triangle normals are weighted
+@param execution whether to split large meshes across the thread pool*/
+inline void vertexNormals(
+        const Vector3* positions,
+        std::size_t vertices,
+        const unsigned* indices,
+        std::size_t triangles,
+        Vector3* normals,
+        NormalWeighting weighting = WEIGHT_AREA,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::vertexNormals(Vector3[])");
+
+    MeshAdjacency adjacency(indices, triangles, vertices);
+    vertexNormals(positions, indices, triangles, adjacency, normals, weighting,
+        execution);
+}
+
+/**Computes the tangent of each vertex of a mesh from its texture coordinates,
+with the method of E. Lengyel, "Computing Tangent Space Basis Vectors for an
+Arbitrary Mesh", 2001. The directions of increasing u and v across each
+triangle are summed by each vertex as in vertexNormals(), and the u direction
+is made perpendicular to the vertex normal
+@param positions the positions of the vertices
+@param uvs the texture coordinates of the vertices
+@param normals the unit normals of the vertices
+@param indices the index buffer
+@param triangles the number of triangles
+@param adjacency the adjacency of the mesh
+@param tangents returns the unit tangent of each vertex in x, y, and z, and
+in w the sign that gives the bitangent as cross(normal, tangent) * w
+@param execution whether to split large meshes across the thread pool*/
+inline void vertexTangents(
+        const Vector3* positions,
+        const Vector2* uvs,
+        const Vector3* normals,
+        const unsigned* indices,
+        std::size_t triangles,
+        const MeshAdjacency& adjacency,
+        Vector4* tangents,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::vertexTangents(Vector3[])");
+
+    //the u and v directions of each triangle
+    std::vector<Vector3> directions(triangles * 2);
+    util::thread::execute(execution, triangles, detail::MESH_CHUNK,
+        [&](std::size_t begin, std::size_t end) {
+
+            for (std::size_t t = begin; t < end; ++t) {
+
+                const unsigned* corner = indices + t * 3;
+                Vector3 e1 = positions[corner[1]] - positions[corner[0]];
+                Vector3 e2 = positions[corner[2]] - positions[corner[0]];
+                Vector2 d1 = uvs[corner[1]] - uvs[corner[0]];
+                Vector2 d2 = uvs[corner[2]] - uvs[corner[0]];
+
+                float determinant = d1.x * d2.y - d2.x * d1.y;
+                float r = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+                directions[t * 2] = (e1 * d2.y - e2 * d1.y) * r;
+                directions[t * 2 + 1] = (e2 * d1.x - e1 * d2.x) * r;
+            }
+        });
+
+    util::thread::execute(execution, adjacency.vertices(), detail::MESH_CHUNK,
+        [&](std::size_t begin, std::size_t end) {
+
+            for (std::size_t v = begin; v < end; ++v) {
+
+                Vector3 u;
+                Vector3 w;
+                for (const unsigned* c = adjacency.begin(v);
+                     c != adjacency.end(v); ++c) {
+
+                    u += directions[*c / 3 * 2];
+                    w += directions[*c / 3 * 2 + 1];
+                }
+
+                //Gram-Schmidt against the normal
+                const Vector3& n = normals[v];
+                Vector3 t = detail::unitOrZero(u - n * dot(n, u));
+                float handedness = dot(cross(n, t), w) < 0.0f ? -1.0f : 1.0f;
+                tangents[v] = Vector4(t.x, t.y, t.z, handedness);
+            }
+        });
+}
+
+/**Computes the tangent of each vertex of a mesh from its texture
+coordinates, building the adjacency of the mesh first
+@param positions the positions of the vertices
+@param uvs the texture coordinates of the vertices
+@param normals the unit normals of the vertices
+@param vertices the number of vertices
+@param indices the index buffer
+@param triangles the number of triangles
+@param tangents returns the unit tangent of each vertex and the sign of its
+bitangent
+@param execution whether to split large meshes across the thread pool*/
+inline void vertexTangents(
+        const Vector3* positions,
+        const Vector2* uvs,
+        const Vector3* normals,
+        std::size_t vertices,
+        const unsigned* indices,
+        std::size_t triangles,
+        Vector4* tangents,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::vertexTangents(Vector3[])");
+
+    MeshAdjacency adjacency(indices, triangles, vertices);
+    vertexTangents(positions, uvs, normals, indices, triangles, adjacency,
+        tangents, execution);
+}
+
+} } //util //vec
+
+#endif
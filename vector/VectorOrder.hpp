@@ -0,0 +1,572 @@
+#ifndef UTILITRON_VECTOR_VECTORORDER_H_
+#   define UTILITRON_VECTOR_VECTORORDER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+#include "VectorBounds.hpp"
+
+//pdep is only available to 64-bit code
+#if defined(UTIL_SIMD_X86) && (defined(__x86_64__) || defined(_M_X64))
+#   define UTIL_ORDER_BMI2
+#endif
+
+namespace util { namespace vec {
+
+//------------------------------------------------------------------------------
+//                                  ENUMERATORS
+//------------------------------------------------------------------------------
+
+/**The space filling curves points can be ordered along*/
+enum SpatialOrder {
+
+    //!the Morton or Z-order curve, which interleaves the bits of the grid
+    //!coordinates and is the cheapest to compute
+    ORDER_MORTON,
+    //!the Hilbert curve, whose neighbouring codes are always neighbouring grid
+    //!cells so it keeps slightly more locality
+    ORDER_HILBERT
+};
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of bits in a code, each of the N axes gets ORDER_BITS / N of them
+static const unsigned ORDER_BITS = 64;
+//!the number of vectors each thread encodes at a time in parallel mode
+static const std::size_t ORDER_CHUNK = 1 << 16;
+//!the number of bits of the code sorted by each pass of the radix sort
+static const unsigned RADIX_BITS = 8;
+//!the number of buckets of each pass of the radix sort
+static const std::size_t RADIX_BUCKETS = 1 << RADIX_BITS;
+//!the number of elements each thread counts and scatters in each pass of a
+//!parallel radix sort
+static const std::size_t RADIX_CHUNK = 1 << 16;
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Finds the grid cell of an N component vector, vectors outside the grid are
+clamped to its edge and NaN components fall in the first cell
+@param v the vector
+@param lower the lower corner of the grid
+@param scale the number of grid cells per unit along each axis
+@param q returns the cell coordinates*/
+template<unsigned N>
+inline void quantiseOrder(
+        const float* v,
+        const double* lower,
+        const double* scale,
+        std::uint32_t* q) {
+
+    const unsigned bits = ORDER_BITS / N;
+    const double top = static_cast<double>((1ULL << bits) - 1);
+    for (unsigned k = 0; k < N; ++k) {
+
+        double x = (static_cast<double>(v[k]) - lower[k]) * scale[k];
+        q[k] = x > 0.0 ?
+            static_cast<std::uint32_t>(x < top ? x : top) : 0;
+    }
+}
+
+/**Transforms the N coordinates of a grid cell in place so that interleaving
+their BITS bits, most significant first and the first coordinate first, gives
+the index of the cell along the Hilbert curve. This is the AxestoTranspose
+transform of J. Skilling, "Programming the Hilbert curve", 2004*/
+template<unsigned N, unsigned BITS>
+inline void hilbertTranspose(std::uint32_t* x) {
+
+    const std::uint32_t top = 1u << (BITS - 1);
+
+    //inverse undo
+    for (std::uint32_t q = top; q > 1; q >>= 1) {
+
+        std::uint32_t p = q - 1;
+        for (unsigned i = 0; i < N; ++i) {
+
+            if (x[i] & q) {
+
+                x[0] ^= p;
+            }
+            else {
+
+                std::uint32_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+
+    //Gray encode
+    for (unsigned i = 1; i < N; ++i) {
+
+        x[i] ^= x[i - 1];
+    }
+    std::uint32_t t = 0;
+    for (std::uint32_t q = top; q > 1; q >>= 1) {
+
+        if (x[N - 1] & q) {
+
+            t ^= q - 1;
+        }
+    }
+    for (unsigned i = 0; i < N; ++i) {
+
+        x[i] ^= t;
+    }
+}
+
+namespace portable {
+
+#define UTIL_ORDER_PDEP 0
+#include "detail/VectorOrder.inl"
+#undef UTIL_ORDER_PDEP
+
+} //portable
+
+#ifdef UTIL_ORDER_BMI2
+
+UTIL_SIMD_BEGIN_TARGET("bmi,bmi2")
+namespace bmi2 {
+
+#define UTIL_ORDER_PDEP 1
+#include "detail/VectorOrder.inl"
+#undef UTIL_ORDER_PDEP
+
+} //bmi2
+UTIL_SIMD_END_TARGET
+
+#else
+
+namespace bmi2 = portable;
+
+#endif
+
+/**The type of the encoding loops*/
+typedef void (*OrderEncoder)(
+    const float*, std::size_t, const double*, const double*, std::uint64_t*);
+
+/**Finds the grid of a box, which has 2^(ORDER_BITS / N) cells along each
+axis. Axes the box is flat or empty along only have the first cell*/
+template<unsigned N>
+inline void orderGrid(
+        const float* boxLower,
+        const float* boxUpper,
+        double* lower,
+        double* scale) {
+
+    const double cells = static_cast<double>(1ULL << (ORDER_BITS / N));
+    for (unsigned k = 0; k < N; ++k) {
+
+        double extent = static_cast<double>(boxUpper[k]) - boxLower[k];
+        lower[k] = boxLower[k];
+        scale[k] = extent > 0.0 && std::isfinite(extent) ?
+            cells / extent : 0.0;
+    }
+}
+
+/**Encodes n N component vectors relative to a box, with pdep on CPUs that
+support BMI2 unless kernels are forced below AVX2*/
+template<unsigned N, bool HILBERT>
+inline void encodeCodes(
+        const float* v,
+        std::size_t n,
+        const float* boxLower,
+        const float* boxUpper,
+        std::uint64_t* codes,
+        util::thread::Execution execution) {
+
+    double lower[N];
+    double scale[N];
+    orderGrid<N>(boxLower, boxUpper, lower, scale);
+
+    bool pdep = util::simd::cpuFeatures().bmi2 &&
+        util::simd::activeIsa() >= util::simd::ISA_AVX2;
+    OrderEncoder encoder = pdep ?
+        &bmi2::encodeOrder<N, HILBERT> : &portable::encodeOrder<N, HILBERT>;
+
+    util::thread::execute(execution, n, ORDER_CHUNK,
+        [&](std::size_t begin, std::size_t end) {
+
+            encoder(v + begin * N, end - begin, lower, scale, codes + begin);
+        });
+}
+
+/**Encodes a single N component vector relative to a box*/
+template<unsigned N, bool HILBERT>
+inline std::uint64_t encodeCode(
+        const float* v, const float* boxLower, const float* boxUpper) {
+
+    double lower[N];
+    double scale[N];
+    orderGrid<N>(boxLower, boxUpper, lower, scale);
+
+    std::uint64_t code;
+    portable::encodeOrder<N, HILBERT>(v, 1, lower, scale, &code);
+
+    return code;
+}
+
+/**Runs one stage of a radix sort pass over each chunk of n elements, the
+whole array is one chunk in serial mode*/
+template<typename Function>
+inline void radixChunks(
+        std::size_t n,
+        std::size_t chunks,
+        Function function) {
+
+    if (chunks == 1) {
+
+        function(static_cast<std::size_t>(0), n, static_cast<std::size_t>(0));
+
+        return;
+    }
+    util::thread::parallelFor(n, RADIX_CHUNK, function);
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                 SPATIAL CODES
+//------------------------------------------------------------------------------
+// These map points onto a grid spanning a bounding box, 2^32 cells along each
+// axis in 2d and 2^21 in 3d, and return the position of their cell along a
+// space filling curve as a 64-bit code. Points that are close together tend to
+// have close codes, so sorting by code lays points out in memory in spatial
+// order. Points outside the box are clamped to its edge. The bulk forms use the
+// BMI2 pdep instruction to interleave bits when the CPU supports it.
+
+/**@return the Morton code of a point on the grid of a bounding box
+@param v the point
+@param box the box the grid spans*/
+inline std::uint64_t mortonCode(const Vector2& v, const BoundingBox2& box) {
+
+    UTIL_PROFILE_PROBE("vec::mortonCode(Vector2)");
+
+    return detail::encodeCode<2, false>(&v.x, &box.lower.x, &box.upper.x);
+}
+
+/**@return the Morton code of a point on the grid of a bounding box
+@param v the point
+@param box the box the grid spans*/
+inline std::uint64_t mortonCode(const Vector3& v, const BoundingBox3& box) {
+
+    UTIL_PROFILE_PROBE("vec::mortonCode(Vector3)");
+
+    return detail::encodeCode<3, false>(&v.x, &box.lower.x, &box.upper.x);
+}
+
+/**@return the Hilbert code of a point on the grid of a bounding box
+@param v the point
+@param box the box the grid spans*/
+inline std::uint64_t hilbertCode(const Vector2& v, const BoundingBox2& box) {
+
+    UTIL_PROFILE_PROBE("vec::hilbertCode(Vector2)");
+
+    return detail::encodeCode<2, true>(&v.x, &box.lower.x, &box.upper.x);
+}
+
+/**@return the Hilbert code of a point on the grid of a bounding box
+@param v the point
+@param box the box the grid spans*/
+inline std::uint64_t hilbertCode(const Vector3& v, const BoundingBox3& box) {
+
+    UTIL_PROFILE_PROBE("vec::hilbertCode(Vector3)");
+
+    return detail::encodeCode<3, true>(&v.x, &box.lower.x, &box.upper.x);
+}
+
+/**Computes the Morton codes of an array of points
+@param v the points
+@param n the number of points
+@param box the box the grid spans
+@param codes returns the code of each point
+@param execution whether to split large arrays across the thread pool*/
+inline void mortonCodes(
+        const Vector2* v,
+        std::size_t n,
+        const BoundingBox2& box,
+        std::uint64_t* codes,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::mortonCodes(Vector2[])");
+
+    detail::encodeCodes<2, false>(
+        &v->x, n, &box.lower.x, &box.upper.x, codes, execution);
+}
+
+/**Computes the Morton codes of an array of points
+@param v the points
+@param n the number of points
+@param box the box the grid spans
+@param codes returns the code of each point
+@param execution whether to split large arrays across the thread pool*/
+inline void mortonCodes(
+        const Vector3* v,
+        std::size_t n,
+        const BoundingBox3& box,
+        std::uint64_t* codes,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::mortonCodes(Vector3[])");
+
+    detail::encodeCodes<3, false>(
+        &v->x, n, &box.lower.x, &box.upper.x, codes, execution);
+}
+
+/**Computes the Hilbert codes of an array of points
+@param v the points
+@param n the number of points
+@param box the box the grid spans
+@param codes returns the code of each point
+@param execution whether to split large arrays across the thread pool*/
+inline void hilbertCodes(
+        const Vector2* v,
+        std::size_t n,
+        const BoundingBox2& box,
+        std::uint64_t* codes,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::hilbertCodes(Vector2[])");
+
+    detail::encodeCodes<2, true>(
+        &v->x, n, &box.lower.x, &box.upper.x, codes, execution);
+}
+
+/**Computes the Hilbert codes of an array of points
+@param v the points
+@param n the number of points
+@param box the box the grid spans
+@param codes returns the code of each point
+@param execution whether to split large arrays across the thread pool*/
+inline void hilbertCodes(
+        const Vector3* v,
+        std::size_t n,
+        const BoundingBox3& box,
+        std::uint64_t* codes,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::hilbertCodes(Vector3[])");
+
+    detail::encodeCodes<3, true>(
+        &v->x, n, &box.lower.x, &box.upper.x, codes, execution);
+}
+
+//------------------------------------------------------------------------------
+//                                    SORTING
+//------------------------------------------------------------------------------
+
+/**Sorts an array of codes into ascending order with a least significant digit
+radix sort, carrying an array of values along with them. The sort is stable
+and skips the digits every code shares, so codes from a small grid or a small
+region of a large one need fewer passes. In parallel mode each pass counts
+and scatters fixed size chunks across the thread pool, with the same result
+as the serial sort
+@param codes the codes to sort
+@param values the values to reorder with the codes, such as the vectors the
+codes were computed from or their indices
+@param n the number of codes and values
+@param execution whether to split large arrays across the thread pool*/
+template<typename Value>
+inline void radixSort(
+        std::uint64_t* codes,
+        Value* values,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::radixSort");
+
+    const std::size_t buckets = detail::RADIX_BUCKETS;
+    std::size_t chunks = execution == util::thread::EXECUTE_PARALLEL ?
+        (n + detail::RADIX_CHUNK - 1) / detail::RADIX_CHUNK : 1;
+    if (n < 2) {
+
+        return;
+    }
+
+    //the bits that differ between codes, the digits without any are skipped
+    std::vector<std::uint64_t> varying(chunks * 2);
+    detail::radixChunks(n, chunks,
+        [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+            std::uint64_t all = ~0ULL;
+            std::uint64_t any = 0;
+            for (std::size_t i = begin; i < end; ++i) {
+
+                all &= codes[i];
+                any |= codes[i];
+            }
+            varying[chunk * 2] = all;
+            varying[chunk * 2 + 1] = any;
+        });
+    std::uint64_t all = ~0ULL;
+    std::uint64_t any = 0;
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+        all &= varying[chunk * 2];
+        any |= varying[chunk * 2 + 1];
+    }
+    std::uint64_t differ = all ^ any;
+
+    std::vector<std::uint64_t> codeBuffer;
+    std::vector<Value> valueBuffer;
+    std::vector<std::size_t> offsets(chunks * buckets);
+    std::uint64_t* fromCodes = codes;
+    Value* fromValues = values;
+    for (unsigned shift = 0; shift < 64; shift += detail::RADIX_BITS) {
+
+        if (((differ >> shift) & (buckets - 1)) == 0) {
+
+            continue;
+        }
+        if (codeBuffer.empty()) {
+
+            codeBuffer.resize(n);
+            valueBuffer.resize(n);
+        }
+        std::uint64_t* toCodes =
+            fromCodes == codes ? codeBuffer.data() : codes;
+        Value* toValues = fromValues == values ? valueBuffer.data() : values;
+
+        //count the digits of each chunk
+        detail::radixChunks(n, chunks,
+            [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+                std::size_t* count = &offsets[chunk * buckets];
+                std::fill(count, count + buckets, 0);
+                for (std::size_t i = begin; i < end; ++i) {
+
+                    ++count[(fromCodes[i] >> shift) & (buckets - 1)];
+                }
+            });
+
+        //each chunk writes each digit after the same digit of earlier chunks
+        std::size_t total = 0;
+        for (std::size_t b = 0; b < buckets; ++b) {
+
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+                std::size_t count = offsets[chunk * buckets + b];
+                offsets[chunk * buckets + b] = total;
+                total += count;
+            }
+        }
+
+        detail::radixChunks(n, chunks,
+            [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+                std::size_t* offset = &offsets[chunk * buckets];
+                for (std::size_t i = begin; i < end; ++i) {
+
+                    std::size_t to =
+                        offset[(fromCodes[i] >> shift) & (buckets - 1)]++;
+                    toCodes[to] = fromCodes[i];
+                    toValues[to] = fromValues[i];
+                }
+            });
+
+        fromCodes = toCodes;
+        fromValues = toValues;
+    }
+
+    if (fromCodes != codes) {
+
+        util::thread::execute(execution, n, detail::RADIX_CHUNK,
+            [&](std::size_t begin, std::size_t end) {
+
+                std::copy(fromCodes + begin, fromCodes + end, codes + begin);
+                std::copy(
+                    fromValues + begin, fromValues + end, values + begin);
+            });
+    }
+}
+
+/**Finds the order that sorts an array of codes, leaving the codes untouched
+@param codes the codes
+@param n the number of codes
+@param indices returns the indices of the codes in ascending order of code,
+equal codes keep their order
+@param execution whether to split large arrays across the thread pool*/
+inline void sortIndices(
+        const std::uint64_t* codes,
+        std::size_t n,
+        unsigned* indices,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::sortIndices");
+
+    std::vector<std::uint64_t> sorted(codes, codes + n);
+    for (std::size_t i = 0; i < n; ++i) {
+
+        indices[i] = static_cast<unsigned>(i);
+    }
+    radixSort(sorted.data(), indices, n, execution);
+}
+
+/**Reorders an array of points in place along a space filling curve through
+their bounding box
+@param v the points
+@param n the number of points
+@param order the curve to order the points along
+@param execution whether to split large arrays across the thread pool*/
+inline void spatialSort(
+        Vector2* v,
+        std::size_t n,
+        SpatialOrder order = ORDER_MORTON,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::spatialSort(Vector2[])");
+
+    BoundingBox2 box = boundingBox(v, n, execution);
+    std::vector<std::uint64_t> codes(n);
+    if (order == ORDER_HILBERT) {
+
+        hilbertCodes(v, n, box, codes.data(), execution);
+    }
+    else {
+
+        mortonCodes(v, n, box, codes.data(), execution);
+    }
+    radixSort(codes.data(), v, n, execution);
+}
+
+/**Reorders an array of points in place along a space filling curve through
+their bounding box
+@param v the points
+@param n the number of points
+@param order the curve to order the points along
+@param execution whether to split large arrays across the thread pool*/
+inline void spatialSort(
+        Vector3* v,
+        std::size_t n,
+        SpatialOrder order = ORDER_MORTON,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::spatialSort(Vector3[])");
+
+    BoundingBox3 box = boundingBox(v, n, execution);
+    std::vector<std::uint64_t> codes(n);
+    if (order == ORDER_HILBERT) {
+
+        hilbertCodes(v, n, box, codes.data(), execution);
+    }
+    else {
+
+        mortonCodes(v, n, box, codes.data(), execution);
+    }
+    radixSort(codes.data(), v, n, execution);
+}
+
+} } //util //vec
+
+#endif
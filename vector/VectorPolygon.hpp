@@ -0,0 +1,318 @@
+#ifndef UTILITRON_VECTOR_VECTORPOLYGON_H_
+#   define UTILITRON_VECTOR_VECTORPOLYGON_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "../MathUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorPolygon.inl"
+#include "../SimdForEachIsa.hpp"
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of points each thread finds the hull of in a parallel convex
+//!hull, the hulls of the chunks are then merged
+static const std::size_t HULL_CHUNK = 1 << 16;
+//!the number of points each thread tests against a polygon at a time
+static const std::size_t POLYGON_CHUNK = 1 << 12;
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return twice the signed area of the triangle o, a, b, which is positive if
+the triangle turns counter-clockwise. This is evaluated in double so that
+nearly collinear points are classified consistently*/
+inline double turn(const Vector2& o, const Vector2& a, const Vector2& b) {
+
+    return (static_cast<double>(a.x) - o.x) * (static_cast<double>(b.y) - o.y) -
+        (static_cast<double>(a.y) - o.y) * (static_cast<double>(b.x) - o.x);
+}
+
+/**@return whether a is before b in order of x then y*/
+inline bool hullOrder(const Vector2& a, const Vector2& b) {
+
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+/**Finds the convex hull of points that are already in hull order with
+Andrew's monotone chain
+@param points the sorted points
+@param n the number of points
+@param hull returns the corners of the hull counter-clockwise, starting from
+the first point, and must have room for n + 1 points
+@return the number of corners*/
+inline std::size_t monotoneChain(
+        const Vector2* points, std::size_t n, Vector2* hull) {
+
+    if (n < 3) {
+
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+
+            if (count == 0 || points[i] != hull[count - 1]) {
+
+                hull[count++] = points[i];
+            }
+        }
+
+        return count;
+    }
+
+    //the lower chain left to right then the upper chain right to left, each
+    //dropping the points that do not turn counter-clockwise
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+
+        while (count >= 2 &&
+               turn(hull[count - 2], hull[count - 1], points[i]) <= 0.0) {
+
+            --count;
+        }
+        hull[count++] = points[i];
+    }
+    std::size_t lower = count + 1;
+    for (std::size_t i = n - 1; i-- > 0;) {
+
+        while (count >= lower &&
+               turn(hull[count - 2], hull[count - 1], points[i]) <= 0.0) {
+
+            --count;
+        }
+        hull[count++] = points[i];
+    }
+
+    //the upper chain ends back at the first point, and points that are all
+    //the same leave two copies of it
+    --count;
+    if (count == 2 && hull[0] == hull[1]) {
+
+        count = 1;
+    }
+
+    return count;
+}
+
+/**Finds the convex hull of points in any order
+@param points the points
+@param n the number of points
+@param hull returns the corners of the hull counter-clockwise*/
+inline void sortedHull(
+        const Vector2* points, std::size_t n, std::vector<Vector2>& hull) {
+
+    std::vector<Vector2> sorted(points, points + n);
+    std::sort(sorted.begin(), sorted.end(), hullOrder);
+    hull.resize(n + 1);
+    hull.resize(monotoneChain(sorted.data(), n, hull.data()));
+}
+
+/**The scalar form of the edge test of insidePack(): a ray from the point
+towards +x crosses the edge from a to b if exactly one end is above the point
+and the point is on the left of the edge when it runs upwards*/
+inline bool crossesEdge(const Vector2& p, const Vector2& a, const Vector2& b) {
+
+    float up = (p.y < b.y ? 1.0f : 0.0f) - (p.y < a.y ? 1.0f : 0.0f);
+    float side = util::math::differenceOfProducts(
+        p.x - a.x, b.y - a.y, b.x - a.x, p.y - a.y);
+
+    return up * side < 0.0f;
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+// Polygons are arrays of their vertices in order, the last vertex joins back to
+// the first. Polygons may be in either winding order and need not be convex.
+
+/**Finds the convex hull of an array of points with Andrew's monotone chain.
+In parallel mode the hulls of fixed size chunks of the points are found across
+the thread pool and then merged by finding the hull of their corners
+@param points the points
+@param n the number of points
+@param hull returns the corners of the hull in counter-clockwise order,
+starting from the corner with the smallest x and then y, without collinear
+points along the edges. It must have room for n points
+@param execution whether to split large arrays across the thread pool
+@return the number of corners of the hull, which is 1 if all the points are
+the same and 2 if they are collinear*/
+inline std::size_t convexHull(
+        const Vector2* points,
+        std::size_t n,
+        Vector2* hull,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::convexHull(Vector2[])");
+
+    std::vector<Vector2> merged;
+    if (execution == util::thread::EXECUTE_PARALLEL &&
+        n > detail::HULL_CHUNK) {
+
+        std::size_t chunks = (n + detail::HULL_CHUNK - 1) / detail::HULL_CHUNK;
+        std::vector<std::vector<Vector2> > partial(chunks);
+        util::thread::parallelFor(n, detail::HULL_CHUNK,
+            [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+                detail::sortedHull(points + begin, end - begin, partial[chunk]);
+            });
+
+        //the corners of the whole hull are among the corners of the chunks
+        std::vector<Vector2> corners;
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+            corners.insert(
+                corners.end(), partial[chunk].begin(), partial[chunk].end());
+        }
+        detail::sortedHull(corners.data(), corners.size(), merged);
+    }
+    else {
+
+        detail::sortedHull(points, n, merged);
+    }
+
+    std::copy(merged.begin(), merged.end(), hull);
+
+    return merged.size();
+}
+
+/**@return the signed area of a polygon, which is positive if its vertices
+run counter-clockwise. The sum is taken in double relative to the first vertex
+@param polygon the vertices of the polygon
+@param count the number of vertices*/
+inline float polygonArea(const Vector2* polygon, std::size_t count) {
+
+    UTIL_PROFILE_PROBE("vec::polygonArea(Vector2[])");
+
+    double area = 0.0;
+    for (std::size_t i = 1; i + 1 < count; ++i) {
+
+        area += detail::turn(polygon[0], polygon[i], polygon[i + 1]);
+    }
+
+    return static_cast<float>(area * 0.5);
+}
+
+/**@return the centroid of the area of a simple polygon, or the mean of its
+vertices if it has no area
+@param polygon the vertices of the polygon
+@param count the number of vertices*/
+inline Vector2 polygonCentroid(const Vector2* polygon, std::size_t count) {
+
+    UTIL_PROFILE_PROBE("vec::polygonCentroid(Vector2[])");
+
+    if (count == 0) {
+
+        return Vector2();
+    }
+
+    //the area weighted centroids of the fan of triangles from the first vertex
+    const Vector2& o = polygon[0];
+    double area = 0.0;
+    double x = 0.0;
+    double y = 0.0;
+    for (std::size_t i = 1; i + 1 < count; ++i) {
+
+        double a = detail::turn(o, polygon[i], polygon[i + 1]);
+        area += a;
+        x += a * ((static_cast<double>(polygon[i].x) - o.x) +
+            (static_cast<double>(polygon[i + 1].x) - o.x));
+        y += a * ((static_cast<double>(polygon[i].y) - o.y) +
+            (static_cast<double>(polygon[i + 1].y) - o.y));
+    }
+
+    if (area == 0.0) {
+
+        double mx = 0.0;
+        double my = 0.0;
+        for (std::size_t i = 0; i < count; ++i) {
+
+            mx += polygon[i].x;
+            my += polygon[i].y;
+        }
+
+        return Vector2(
+            static_cast<float>(mx / static_cast<double>(count)),
+            static_cast<float>(my / static_cast<double>(count)));
+    }
+
+    return Vector2(
+        static_cast<float>(o.x + x / (3.0 * area)),
+        static_cast<float>(o.y + y / (3.0 * area)));
+}
+
+/**Tests whether a point is inside a polygon with the even-odd rule. Points on
+the edges may be classified either way
+@param point the point
+@param polygon the vertices of the polygon
+@param count the number of vertices
+@return whether the point is inside*/
+inline bool pointInPolygon(
+        const Vector2& point, const Vector2* polygon, std::size_t count) {
+
+    UTIL_PROFILE_PROBE("vec::pointInPolygon(Vector2)");
+
+    bool inside = false;
+    for (std::size_t i = 0, j = count - 1; i < count; j = i++) {
+
+        if (detail::crossesEdge(point, polygon[j], polygon[i])) {
+
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+/**Tests whether each of an array of points is inside a polygon with the
+even-odd rule, testing a SIMD register of points against each edge at a time.
+Each point is classified exactly as pointInPolygon() classifies it on every
+instruction set, including points on the edges and vertices
+@param points the points
+@param n the number of points
+@param polygon the vertices of the polygon
+@param count the number of vertices
+@param inside returns whether each point is inside
+@param execution whether to split large arrays across the thread pool*/
+inline void pointsInPolygon(
+        const Vector2* points,
+        std::size_t n,
+        const Vector2* polygon,
+        std::size_t count,
+        bool* inside,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::pointsInPolygon(Vector2[])");
+
+    if (count == 0) {
+
+        std::fill(inside, inside + n, false);
+
+        return;
+    }
+
+    void (*kernel)(const float*, std::size_t, const float*, std::size_t,
+        bool*) = UTIL_SIMD_DISPATCH(detail, insidePolygon);
+
+    util::thread::execute(execution, n, detail::POLYGON_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&points[begin].x, end - begin, &polygon->x, count,
+                inside + begin);
+        });
+}
+
+} } //util //vec
+
+#endif
@@ -0,0 +1,900 @@
+#ifndef UTILITRON_VECTOR_VECTORPRECISION_H_
+#   define UTILITRON_VECTOR_VECTORPRECISION_H_
+
+#include <cmath>
+#include <cstddef>
+
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+#include "VectorKernels.hpp"
+#include "VectorReduce.hpp"
+
+namespace util { namespace vec {
+
+//------------------------------------------------------------------------------
+//                                  ENUMERATORS
+//------------------------------------------------------------------------------
+
+/**How the products and sums of a vector function are accumulated*/
+enum Accumulation {
+
+    //!in float with fused multiply-adds where the CPU has them, which is the
+    //!fastest and what the functions without an accumulation use
+    ACCUMULATE_FLOAT,
+    //!in double, where the product of two floats is exact
+    ACCUMULATE_DOUBLE,
+    //!in float with the exact rounding error of each product and sum carried
+    //!alongside, which is as accurate as float with twice the precision and
+    //!still uses SIMD
+    ACCUMULATE_COMPENSATED
+};
+
+namespace detail {
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorPrecision.inl"
+#include "../SimdForEachIsa.hpp"
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return the dot product of two N component vectors in double*/
+template<unsigned N>
+inline double doubleDot(const float* a, const float* b) {
+
+    double sum = 0.0;
+    for (unsigned c = 0; c < N; ++c) {
+
+        sum += static_cast<double>(a[c]) * b[c];
+    }
+
+    return sum;
+}
+
+/**@return the distance between two N component vectors in double*/
+template<unsigned N>
+inline double doubleDistance(const float* a, const float* b) {
+
+    double sum = 0.0;
+    for (unsigned c = 0; c < N; ++c) {
+
+        double d = static_cast<double>(a[c]) - b[c];
+        sum += d * d;
+    }
+
+    return std::sqrt(sum);
+}
+
+/**Computes the cross product of two three component vectors in double*/
+inline void doubleCross(const float* a, const float* b, float* out) {
+
+    for (unsigned j = 0; j < 3; ++j) {
+
+        unsigned k = (j + 1) % 3;
+        unsigned l = (j + 2) % 3;
+        out[j] = static_cast<float>(static_cast<double>(a[k]) * b[l] -
+            static_cast<double>(a[l]) * b[k]);
+    }
+}
+
+/**out[i] = dot(a[i], b[i]) of n N component vectors in double or
+compensated*/
+template<unsigned N>
+inline void preciseDot(
+        const float* a,
+        const float* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_COMPENSATED) {
+
+        UTIL_SIMD_DISPATCH(detail, compensatedDot<N>)(a, b, out, n);
+
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+
+        out[i] = static_cast<float>(doubleDot<N>(a + i * N, b + i * N));
+    }
+}
+
+/**out[i] = magnitude(v[i]) of n N component vectors in double or
+compensated*/
+template<unsigned N>
+inline void preciseMagnitude(
+        const float* v, float* out, std::size_t n, Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_COMPENSATED) {
+
+        UTIL_SIMD_DISPATCH(detail, compensatedMagnitude<N>)(v, out, n);
+
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+
+        out[i] = static_cast<float>(
+            std::sqrt(doubleDot<N>(v + i * N, v + i * N)));
+    }
+}
+
+/**out[i] = distance(a[i], b[i]) of n N component vectors in double or
+compensated*/
+template<unsigned N>
+inline void preciseDistance(
+        const float* a,
+        const float* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_COMPENSATED) {
+
+        UTIL_SIMD_DISPATCH(detail, compensatedDistance<N>)(a, b, out, n);
+
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+
+        out[i] = static_cast<float>(doubleDistance<N>(a + i * N, b + i * N));
+    }
+}
+
+/**out[i] = cross(a[i], b[i]) of n three component vectors in double or
+compensated*/
+inline void preciseCross(
+        const float* a,
+        const float* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_COMPENSATED) {
+
+        UTIL_SIMD_DISPATCH(detail, compensatedCross)(a, b, out, n);
+
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+
+        doubleCross(a + i * 3, b + i * 3, out + i * 3);
+    }
+}
+
+/**@return the sum of dot(a[i], b[i]) over n N component vectors*/
+template<unsigned N>
+inline double innerProduct(
+        const float* a,
+        const float* b,
+        std::size_t n,
+        Accumulation accumulation,
+        util::thread::Execution execution) {
+
+    double (*kernel)(const float*, const float*, std::size_t) =
+        accumulation == ACCUMULATE_COMPENSATED ?
+            UTIL_SIMD_DISPATCH(detail, compensatedProductSum) :
+            UTIL_SIMD_DISPATCH(detail, productSum);
+
+    double total;
+    reduceChunks(n, 1,
+        [=](std::size_t begin, std::size_t end, double* out) {
+
+            if (accumulation == ACCUMULATE_DOUBLE) {
+
+                *out = 0.0;
+                for (std::size_t i = begin; i < end; ++i) {
+
+                    *out += doubleDot<N>(a + i * N, b + i * N);
+                }
+
+                return;
+            }
+            *out = kernel(a + begin * N, b + begin * N, (end - begin) * N);
+        }, &total, execution);
+
+    return total;
+}
+
+/**@return the length of the path through n N component points*/
+template<unsigned N>
+inline double pathLength(
+        const float* points,
+        std::size_t n,
+        Accumulation accumulation,
+        util::thread::Execution execution) {
+
+    if (n < 2) {
+
+        return 0.0;
+    }
+
+    double (*kernel)(const float*, std::size_t) =
+        accumulation == ACCUMULATE_COMPENSATED ?
+            UTIL_SIMD_DISPATCH(detail, compensatedSegmentSum<N>) :
+            UTIL_SIMD_DISPATCH(detail, segmentSum<N>);
+
+    //the reduction is over the segments, segment i runs from point i
+    double total;
+    reduceChunks(n - 1, 1,
+        [=](std::size_t begin, std::size_t end, double* out) {
+
+            if (accumulation == ACCUMULATE_DOUBLE) {
+
+                *out = 0.0;
+                for (std::size_t i = begin; i < end; ++i) {
+
+                    *out += doubleDistance<N>(
+                        points + i * N, points + (i + 1) * N);
+                }
+
+                return;
+            }
+            *out = kernel(points + begin * N, end - begin);
+        }, &total, execution);
+
+    return total;
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+// These are the vector math and bulk vector functions with a choice of how
+// they accumulate. ACCUMULATE_FLOAT gives the same results as the functions
+// without an accumulation. For a single vector the double and compensated
+// modes are about equally accurate, both close to correctly rounded, while
+// the compensated bulk functions run with SIMD and give the same results on
+// every instruction set. The long reductions sum each fixed chunk of vectors
+// in the chosen mode, serially or across the thread pool, and add the chunks
+// in double, like the reductions of VectorReduce.hpp, and return double. Compensation
+// pays off there, where a float sum loses the low bits of every term once the
+// running total has grown large.
+
+//-----------------------------------VECTOR2------------------------------------
+
+/**Computes the dot product of two vectors
+@param a the first vector
+@param b the second vector
+@param accumulation how to accumulate the products
+@return the dot product*/
+inline float dot(
+        const Vector2& a, const Vector2& b, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector2, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = dot(a, b);
+    }
+    else {
+
+        detail::preciseDot<2>(&a.x, &b.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Computes the magnitude of a vector
+@param v the vector
+@param accumulation how to accumulate the squares of the components
+@return the magnitude*/
+inline float magnitude(const Vector2& v, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector2, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = magnitude(v);
+    }
+    else {
+
+        detail::preciseMagnitude<2>(&v.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Calculates the distance between two vectors
+@param a the first vector
+@param b the second vector
+@param accumulation how to accumulate the squared differences
+@return the distance between the vectors*/
+inline float distance(
+        const Vector2& a, const Vector2& b, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector2, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = distance(a, b);
+    }
+    else {
+
+        detail::preciseDistance<2>(&a.x, &b.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Computes the dot product of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the dot products
+@param n the number of vectors
+@param accumulation how to accumulate the products*/
+inline void dot(
+        const Vector2* a,
+        const Vector2* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        dot(a, b, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector2[], Accumulation)");
+
+    detail::preciseDot<2>(&a->x, &b->x, out, n, accumulation);
+}
+
+/**Computes the magnitude of each vector
+@param v the array of vectors
+@param out returns the magnitudes
+@param n the number of vectors
+@param accumulation how to accumulate the squares of the components*/
+inline void magnitude(
+        const Vector2* v,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        magnitude(v, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector2[], Accumulation)");
+
+    detail::preciseMagnitude<2>(&v->x, out, n, accumulation);
+}
+
+/**Calculates the distance between each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the distances
+@param n the number of vectors
+@param accumulation how to accumulate the squared differences*/
+inline void distance(
+        const Vector2* a,
+        const Vector2* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        distance(a, b, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector2[], Accumulation)");
+
+    detail::preciseDistance<2>(&a->x, &b->x, out, n, accumulation);
+}
+
+/**Computes the inner product of two arrays of vectors taken as single long
+vectors, which is the sum of the dot products of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param n the number of vectors
+@param accumulation how to accumulate the products
+@param execution whether to split large arrays across the thread pool
+@return the inner product*/
+inline double innerProduct(
+        const Vector2* a,
+        const Vector2* b,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::innerProduct(Vector2[])");
+
+    return detail::innerProduct<2>(&a->x, &b->x, n, accumulation, execution);
+}
+
+/**Computes the Euclidean norm of an array of vectors taken as a single long
+vector, which is the square root of the sum of their squared magnitudes
+@param v the array of vectors
+@param n the number of vectors
+@param accumulation how to accumulate the squares of the components
+@param execution whether to split large arrays across the thread pool
+@return the norm*/
+inline double norm(
+        const Vector2* v,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::norm(Vector2[])");
+
+    return std::sqrt(detail::innerProduct<2>(
+        &v->x, &v->x, n, accumulation, execution));
+}
+
+/**Computes the length of the path through an array of points, which is the
+sum of the distances between each point and the next
+@param points the array of points
+@param n the number of points
+@param accumulation how to accumulate the distances
+@param execution whether to split large arrays across the thread pool
+@return the length of the path, 0 for fewer than two points*/
+inline double pathLength(
+        const Vector2* points,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::pathLength(Vector2[])");
+
+    return detail::pathLength<2>(&points->x, n, accumulation, execution);
+}
+
+//-----------------------------------VECTOR3------------------------------------
+
+/**Computes the dot product of two vectors
+@param a the first vector
+@param b the second vector
+@param accumulation how to accumulate the products
+@return the dot product*/
+inline float dot(
+        const Vector3& a, const Vector3& b, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector3, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = dot(a, b);
+    }
+    else {
+
+        detail::preciseDot<3>(&a.x, &b.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Computes the magnitude of a vector
+@param v the vector
+@param accumulation how to accumulate the squares of the components
+@return the magnitude*/
+inline float magnitude(const Vector3& v, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector3, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = magnitude(v);
+    }
+    else {
+
+        detail::preciseMagnitude<3>(&v.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Calculates the distance between two vectors
+@param a the first vector
+@param b the second vector
+@param accumulation how to accumulate the squared differences
+@return the distance between the vectors*/
+inline float distance(
+        const Vector3& a, const Vector3& b, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector3, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = distance(a, b);
+    }
+    else {
+
+        detail::preciseDistance<3>(&a.x, &b.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Computes the cross product of two vectors
+@param a the first vector
+@param b the second vector
+@param accumulation how to accumulate the products
+@return the cross product*/
+inline Vector3 cross(
+        const Vector3& a, const Vector3& b, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::cross(Vector3, Accumulation)");
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        return cross(a, b);
+    }
+
+    Vector3 result;
+    detail::preciseCross(&a.x, &b.x, &result.x, 1, accumulation);
+
+    return result;
+}
+
+/**Computes the dot product of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the dot products
+@param n the number of vectors
+@param accumulation how to accumulate the products*/
+inline void dot(
+        const Vector3* a,
+        const Vector3* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        dot(a, b, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector3[], Accumulation)");
+
+    detail::preciseDot<3>(&a->x, &b->x, out, n, accumulation);
+}
+
+/**Computes the magnitude of each vector
+@param v the array of vectors
+@param out returns the magnitudes
+@param n the number of vectors
+@param accumulation how to accumulate the squares of the components*/
+inline void magnitude(
+        const Vector3* v,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        magnitude(v, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector3[], Accumulation)");
+
+    detail::preciseMagnitude<3>(&v->x, out, n, accumulation);
+}
+
+/**Calculates the distance between each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the distances
+@param n the number of vectors
+@param accumulation how to accumulate the squared differences*/
+inline void distance(
+        const Vector3* a,
+        const Vector3* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        distance(a, b, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector3[], Accumulation)");
+
+    detail::preciseDistance<3>(&a->x, &b->x, out, n, accumulation);
+}
+
+/**Computes the cross product of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the cross products
+@param n the number of vectors
+@param accumulation how to accumulate the products*/
+inline void cross(
+        const Vector3* a,
+        const Vector3* b,
+        Vector3* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        cross(a, b, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::cross(Vector3[], Accumulation)");
+
+    detail::preciseCross(&a->x, &b->x, &out->x, n, accumulation);
+}
+
+/**Computes the inner product of two arrays of vectors taken as single long
+vectors, which is the sum of the dot products of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param n the number of vectors
+@param accumulation how to accumulate the products
+@param execution whether to split large arrays across the thread pool
+@return the inner product*/
+inline double innerProduct(
+        const Vector3* a,
+        const Vector3* b,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::innerProduct(Vector3[])");
+
+    return detail::innerProduct<3>(&a->x, &b->x, n, accumulation, execution);
+}
+
+/**Computes the Euclidean norm of an array of vectors taken as a single long
+vector, which is the square root of the sum of their squared magnitudes
+@param v the array of vectors
+@param n the number of vectors
+@param accumulation how to accumulate the squares of the components
+@param execution whether to split large arrays across the thread pool
+@return the norm*/
+inline double norm(
+        const Vector3* v,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::norm(Vector3[])");
+
+    return std::sqrt(detail::innerProduct<3>(
+        &v->x, &v->x, n, accumulation, execution));
+}
+
+/**Computes the length of the path through an array of points, which is the
+sum of the distances between each point and the next
+@param points the array of points
+@param n the number of points
+@param accumulation how to accumulate the distances
+@param execution whether to split large arrays across the thread pool
+@return the length of the path, 0 for fewer than two points*/
+inline double pathLength(
+        const Vector3* points,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::pathLength(Vector3[])");
+
+    return detail::pathLength<3>(&points->x, n, accumulation, execution);
+}
+
+//-----------------------------------VECTOR4------------------------------------
+
+/**Computes the dot product of two vectors
+@param a the first vector
+@param b the second vector
+@param accumulation how to accumulate the products
+@return the dot product*/
+inline float dot(
+        const Vector4& a, const Vector4& b, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector4, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = dot(a, b);
+    }
+    else {
+
+        detail::preciseDot<4>(&a.x, &b.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Computes the magnitude of a vector
+@param v the vector
+@param accumulation how to accumulate the squares of the components
+@return the magnitude*/
+inline float magnitude(const Vector4& v, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector4, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = magnitude(v);
+    }
+    else {
+
+        detail::preciseMagnitude<4>(&v.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Calculates the distance between two vectors
+@param a the first vector
+@param b the second vector
+@param accumulation how to accumulate the squared differences
+@return the distance between the vectors*/
+inline float distance(
+        const Vector4& a, const Vector4& b, Accumulation accumulation) {
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector4, Accumulation)");
+
+    float result;
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        result = distance(a, b);
+    }
+    else {
+
+        detail::preciseDistance<4>(&a.x, &b.x, &result, 1, accumulation);
+    }
+
+    return result;
+}
+
+/**Computes the dot product of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the dot products
+@param n the number of vectors
+@param accumulation how to accumulate the products*/
+inline void dot(
+        const Vector4* a,
+        const Vector4* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        dot(a, b, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::dot(Vector4[], Accumulation)");
+
+    detail::preciseDot<4>(&a->x, &b->x, out, n, accumulation);
+}
+
+/**Computes the magnitude of each vector
+@param v the array of vectors
+@param out returns the magnitudes
+@param n the number of vectors
+@param accumulation how to accumulate the squares of the components*/
+inline void magnitude(
+        const Vector4* v,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        magnitude(v, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::magnitude(Vector4[], Accumulation)");
+
+    detail::preciseMagnitude<4>(&v->x, out, n, accumulation);
+}
+
+/**Calculates the distance between each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param out returns the distances
+@param n the number of vectors
+@param accumulation how to accumulate the squared differences*/
+inline void distance(
+        const Vector4* a,
+        const Vector4* b,
+        float* out,
+        std::size_t n,
+        Accumulation accumulation) {
+
+    if (accumulation == ACCUMULATE_FLOAT) {
+
+        distance(a, b, out, n);
+
+        return;
+    }
+
+    UTIL_PROFILE_PROBE("vec::distance(Vector4[], Accumulation)");
+
+    detail::preciseDistance<4>(&a->x, &b->x, out, n, accumulation);
+}
+
+/**Computes the inner product of two arrays of vectors taken as single long
+vectors, which is the sum of the dot products of each pair of vectors
+@param a the first array of vectors
+@param b the second array of vectors
+@param n the number of vectors
+@param accumulation how to accumulate the products
+@param execution whether to split large arrays across the thread pool
+@return the inner product*/
+inline double innerProduct(
+        const Vector4* a,
+        const Vector4* b,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::innerProduct(Vector4[])");
+
+    return detail::innerProduct<4>(&a->x, &b->x, n, accumulation, execution);
+}
+
+/**Computes the Euclidean norm of an array of vectors taken as a single long
+vector, which is the square root of the sum of their squared magnitudes
+@param v the array of vectors
+@param n the number of vectors
+@param accumulation how to accumulate the squares of the components
+@param execution whether to split large arrays across the thread pool
+@return the norm*/
+inline double norm(
+        const Vector4* v,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::norm(Vector4[])");
+
+    return std::sqrt(detail::innerProduct<4>(
+        &v->x, &v->x, n, accumulation, execution));
+}
+
+/**Computes the length of the path through an array of points, which is the
+sum of the distances between each point and the next
+@param points the array of points
+@param n the number of points
+@param accumulation how to accumulate the distances
+@param execution whether to split large arrays across the thread pool
+@return the length of the path, 0 for fewer than two points*/
+inline double pathLength(
+        const Vector4* points,
+        std::size_t n,
+        Accumulation accumulation = ACCUMULATE_FLOAT,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::pathLength(Vector4[])");
+
+    return detail::pathLength<4>(&points->x, n, accumulation, execution);
+}
+
+} } //util //vec
+
+#endif
@@ -0,0 +1,311 @@
+#ifndef UTILITRON_VECTOR_VECTORRANDOM_H_
+#   define UTILITRON_VECTOR_VECTORRANDOM_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "../MathUtil.hpp"
+#include "../RandomUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+#include "VectorAngles.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+//!the number of generators a bulk fill runs side by side in each chunk
+static const unsigned RANDOM_LANES = 16;
+
+//the samplers use the trig evaluators of VectorAngles.inl
+#define UTIL_SIMD_KERNELS "vector/detail/VectorRandom.inl"
+#include "../SimdForEachIsa.hpp"
+
+//!the number of vectors in each chunk of a bulk fill, chunks are the unit of
+//!work of a parallel fill and are seeded independently
+static const std::size_t RANDOM_CHUNK = 1 << 14;
+
+/**The type of the bulk fill kernels*/
+typedef void (*RandomKernel)(
+    std::uint64_t, std::size_t, const float*, float*, std::size_t);
+
+/**Runs a bulk fill kernel over every chunk of an array of N component
+vectors. The chunks are the same whether or not they run in parallel*/
+template<unsigned N>
+inline void randomChunks(
+        RandomKernel kernel,
+        std::uint64_t seed,
+        const float* params,
+        float* out,
+        std::size_t n,
+        util::thread::Execution execution) {
+
+    auto fill = [=](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+        kernel(seed, chunk, params, out + begin * N, end - begin);
+    };
+
+    if (execution == util::thread::EXECUTE_PARALLEL) {
+
+        util::thread::parallelFor(n, RANDOM_CHUNK, fill);
+
+        return;
+    }
+    for (std::size_t begin = 0; begin < n; begin += RANDOM_CHUNK) {
+
+        fill(begin, std::min(begin + RANDOM_CHUNK, n), begin / RANDOM_CHUNK);
+    }
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                 RANDOM VECTORS
+//------------------------------------------------------------------------------
+// These fill arrays with random vectors using the widest instruction set the
+// CPU supports, and across the thread pool when given EXECUTE_PARALLEL. Each
+// vector depends only on the seed and its index in the array, so the same seed
+// gives the same vectors in serial and parallel mode, on any number of threads,
+// and as the first vectors of a longer fill. The random bits are identical on
+// every instruction set, the vectors made from them may differ in the last bits
+// between instruction sets. Use util::random::Xoshiro128 for single values.
+
+//--------------------------------------BOX-------------------------------------
+
+/**Fills an array with vectors uniformly distributed in a box
+@param lower the corner of the box with the smallest components
+@param upper the corner of the box with the largest components
+@param out returns the random vectors
+@param n the number of vectors
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomInBox(
+        const Vector2& lower,
+        const Vector2& upper,
+        Vector2* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomInBox(Vector2)");
+
+    Vector2 extent = upper - lower;
+    float params[4] = { lower.x, lower.y, extent.x, extent.y };
+    detail::randomChunks<2>(UTIL_SIMD_DISPATCH(detail, randomBox<2>), seed,
+        params, &out[0].x, n, execution);
+}
+
+/**Fills an array with vectors uniformly distributed in a box
+@param lower the corner of the box with the smallest components
+@param upper the corner of the box with the largest components
+@param out returns the random vectors
+@param n the number of vectors
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomInBox(
+        const Vector3& lower,
+        const Vector3& upper,
+        Vector3* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomInBox(Vector3)");
+
+    Vector3 extent = upper - lower;
+    float params[6] =
+        { lower.x, lower.y, lower.z, extent.x, extent.y, extent.z };
+    detail::randomChunks<3>(UTIL_SIMD_DISPATCH(detail, randomBox<3>), seed,
+        params, &out[0].x, n, execution);
+}
+
+/**Fills an array with vectors uniformly distributed in a box
+@param lower the corner of the box with the smallest components
+@param upper the corner of the box with the largest components
+@param out returns the random vectors
+@param n the number of vectors
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomInBox(
+        const Vector4& lower,
+        const Vector4& upper,
+        Vector4* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomInBox(Vector4)");
+
+    Vector4 extent = upper - lower;
+    float params[8] = { lower.x, lower.y, lower.z, lower.w,
+        extent.x, extent.y, extent.z, extent.w };
+    detail::randomChunks<4>(UTIL_SIMD_DISPATCH(detail, randomBox<4>), seed,
+        params, &out[0].x, n, execution);
+}
+
+//-------------------------------CIRCLE AND SPHERE------------------------------
+
+/**Fills an array with points uniformly distributed on a circle
+@param centre the centre of the circle
+@param radius the radius of the circle
+@param out returns the random points
+@param n the number of points
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomOnCircle(
+        const Vector2& centre,
+        float radius,
+        Vector2* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomOnCircle(Vector2)");
+
+    float params[3] = { centre.x, centre.y, radius };
+    detail::randomChunks<2>(UTIL_SIMD_DISPATCH(detail, randomCircle<false>),
+        seed, params, &out[0].x, n, execution);
+}
+
+/**Fills an array with points uniformly distributed in a disc
+@param centre the centre of the disc
+@param radius the radius of the disc
+@param out returns the random points
+@param n the number of points
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomInDisc(
+        const Vector2& centre,
+        float radius,
+        Vector2* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomInDisc(Vector2)");
+
+    float params[3] = { centre.x, centre.y, radius };
+    detail::randomChunks<2>(UTIL_SIMD_DISPATCH(detail, randomCircle<true>),
+        seed, params, &out[0].x, n, execution);
+}
+
+/**Fills an array with points uniformly distributed on the surface of a sphere
+@param centre the centre of the sphere
+@param radius the radius of the sphere
+@param out returns the random points
+@param n the number of points
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomOnSphere(
+        const Vector3& centre,
+        float radius,
+        Vector3* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomOnSphere(Vector3)");
+
+    float params[4] = { centre.x, centre.y, centre.z, radius };
+    detail::randomChunks<3>(UTIL_SIMD_DISPATCH(detail, randomSphere<false>),
+        seed, params, &out[0].x, n, execution);
+}
+
+/**Fills an array with points uniformly distributed in a sphere
+@param centre the centre of the sphere
+@param radius the radius of the sphere
+@param out returns the random points
+@param n the number of points
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomInSphere(
+        const Vector3& centre,
+        float radius,
+        Vector3* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomInSphere(Vector3)");
+
+    float params[4] = { centre.x, centre.y, centre.z, radius };
+    detail::randomChunks<3>(UTIL_SIMD_DISPATCH(detail, randomSphere<true>),
+        seed, params, &out[0].x, n, execution);
+}
+
+//-----------------------------------GAUSSIAN-----------------------------------
+
+/**Fills an array with vectors whose components are independent and normally
+distributed
+@param mean the mean of the vectors
+@param deviation the standard deviation of each component
+@param out returns the random vectors
+@param n the number of vectors
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomGaussian(
+        const Vector2& mean,
+        float deviation,
+        Vector2* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomGaussian(Vector2)");
+
+    float params[3] = { mean.x, mean.y, deviation };
+    detail::randomChunks<2>(UTIL_SIMD_DISPATCH(detail, randomGaussian<2>),
+        seed, params, &out[0].x, n, execution);
+}
+
+/**Fills an array with vectors whose components are independent and normally
+distributed
+@param mean the mean of the vectors
+@param deviation the standard deviation of each component
+@param out returns the random vectors
+@param n the number of vectors
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomGaussian(
+        const Vector3& mean,
+        float deviation,
+        Vector3* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomGaussian(Vector3)");
+
+    float params[4] = { mean.x, mean.y, mean.z, deviation };
+    detail::randomChunks<3>(UTIL_SIMD_DISPATCH(detail, randomGaussian<3>),
+        seed, params, &out[0].x, n, execution);
+}
+
+/**Fills an array with vectors whose components are independent and normally
+distributed
+@param mean the mean of the vectors
+@param deviation the standard deviation of each component
+@param out returns the random vectors
+@param n the number of vectors
+@param seed the seed of the random sequence
+@param execution whether to split large arrays across the thread pool*/
+inline void randomGaussian(
+        const Vector4& mean,
+        float deviation,
+        Vector4* out,
+        std::size_t n,
+        std::uint64_t seed,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::randomGaussian(Vector4)");
+
+    float params[5] = { mean.x, mean.y, mean.z, mean.w, deviation };
+    detail::randomChunks<4>(UTIL_SIMD_DISPATCH(detail, randomGaussian<4>),
+        seed, params, &out[0].x, n, execution);
+}
+
+} } //util //vec
+
+#endif
@@ -0,0 +1,553 @@
+#ifndef UTILITRON_VECTOR_VECTORRAY_H_
+#   define UTILITRON_VECTOR_VECTORRAY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+#include "VectorBounds.hpp"
+
+namespace util { namespace vec {
+
+//------------------------------------------------------------------------------
+//                                    STRUCTS
+//------------------------------------------------------------------------------
+
+/*****************************************************************************\
+| A half line from an origin. Distances along a ray are measured in multiples |
+| of its direction, so they are true distances when the direction has unit    |
+| length.                                                                     |
+\*****************************************************************************/
+struct Ray {
+
+    //!the point the ray starts at
+    Vector3 origin;
+    //!the direction the ray travels in
+    Vector3 direction;
+};
+
+/*****************************************************\
+| A triangle given by its corners, hit on both sides. |
+\*****************************************************/
+struct Triangle {
+
+    //!the first corner
+    Vector3 a;
+    //!the second corner
+    Vector3 b;
+    //!the third corner
+    Vector3 c;
+};
+
+/****************************************************************************\
+| The plane of points p where dot(normal, p) == distance, hit on both sides. |
+\****************************************************************************/
+struct Plane {
+
+    //!the normal of the plane
+    Vector3 normal;
+    //!the distance of the plane from the origin along the normal, in
+    //!multiples of the normal
+    float distance;
+};
+
+/***************************************************************************\
+| A packet of Width rays stored as structure of arrays, so that the packet  |
+| functions can intersect a whole SIMD register of rays at once. Width must |
+| be 4, 8, or 16. Only the rays whose bit is set in active take part in the |
+| packet functions.                                                         |
+\***************************************************************************/
+template<unsigned Width>
+struct RayPacket {
+
+    static_assert(Width == 4 || Width == 8 || Width == 16,
+        "ray packets hold 4, 8, or 16 rays");
+
+    //!the x, y, and z components of the origins of the rays
+    float origin[3][Width];
+    //!the x, y, and z components of the directions of the rays
+    float direction[3][Width];
+    //!bit i is set if ray i is in use
+    unsigned active;
+};
+
+namespace detail {
+
+/**The kinds of shape rays can be intersected with*/
+enum RayShape {
+
+    RAY_SPHERE,
+    RAY_BOX,
+    RAY_TRIANGLE,
+    RAY_PLANE
+};
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorRay.inl"
+#include "../SimdForEachIsa.hpp"
+
+//!the number of rays each thread intersects at a time in parallel mode
+static const std::size_t RAY_CHUNK = 1 << 14;
+
+/**Lays a shape out as the floats the ray kernels read*/
+template<typename Shape>
+struct RayTarget;
+
+template<>
+struct RayTarget<BoundingSphere> {
+
+    static const unsigned KIND = RAY_SPHERE;
+    static const unsigned SIZE = 4;
+
+    static inline void layout(const BoundingSphere& s, float* out) {
+
+        out[0] = s.centre.x;
+        out[1] = s.centre.y;
+        out[2] = s.centre.z;
+        out[3] = s.radius;
+    }
+};
+
+template<>
+struct RayTarget<BoundingBox3> {
+
+    static const unsigned KIND = RAY_BOX;
+    static const unsigned SIZE = 6;
+
+    static inline void layout(const BoundingBox3& s, float* out) {
+
+        out[0] = s.lower.x;
+        out[1] = s.lower.y;
+        out[2] = s.lower.z;
+        out[3] = s.upper.x;
+        out[4] = s.upper.y;
+        out[5] = s.upper.z;
+    }
+};
+
+template<>
+struct RayTarget<Triangle> {
+
+    static const unsigned KIND = RAY_TRIANGLE;
+    static const unsigned SIZE = 9;
+
+    //the edges are found once here rather than for every pack of rays
+    static inline void layout(const Triangle& s, float* out) {
+
+        Vector3 e1 = s.b - s.a;
+        Vector3 e2 = s.c - s.a;
+        out[0] = s.a.x;
+        out[1] = s.a.y;
+        out[2] = s.a.z;
+        out[3] = e1.x;
+        out[4] = e1.y;
+        out[5] = e1.z;
+        out[6] = e2.x;
+        out[7] = e2.y;
+        out[8] = e2.z;
+    }
+};
+
+template<>
+struct RayTarget<Plane> {
+
+    static const unsigned KIND = RAY_PLANE;
+    static const unsigned SIZE = 4;
+
+    static inline void layout(const Plane& s, float* out) {
+
+        out[0] = s.normal.x;
+        out[1] = s.normal.y;
+        out[2] = s.normal.z;
+        out[3] = s.distance;
+    }
+};
+
+/**Intersects the active rays of a packet with a shape*/
+template<typename Shape, unsigned Width>
+inline unsigned castPacket(
+        const RayPacket<Width>& packet,
+        const Shape& shape,
+        float* distances) {
+
+    typedef RayTarget<Shape> Target;
+
+    unsigned (*kernel)(const float*, unsigned, unsigned, const float*,
+        float*) = UTIL_SIMD_DISPATCH(detail, intersectPacket<Target::KIND>);
+
+    float layout[Target::SIZE];
+    Target::layout(shape, layout);
+
+    return kernel(packet.origin[0], Width, packet.active, layout, distances);
+}
+
+/**Intersects an array of rays with a shape*/
+template<typename Shape>
+inline void castRays(
+        const Ray* rays,
+        std::size_t n,
+        const Shape& shape,
+        float* distances,
+        util::thread::Execution execution) {
+
+    typedef RayTarget<Shape> Target;
+
+    void (*kernel)(const float*, std::size_t, const float*, float*) =
+        UTIL_SIMD_DISPATCH(detail, intersectRays<Target::KIND>);
+
+    float layout[Target::SIZE];
+    Target::layout(shape, layout);
+    const float* l = layout;
+
+    util::thread::execute(execution, n, RAY_CHUNK,
+        [=](std::size_t begin, std::size_t end) {
+
+            kernel(&rays[begin].origin.x, end - begin, l, distances + begin);
+        });
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+// Every intersection test takes the distance along the ray to the closest hit
+// found so far, which should start as the greatest distance of interest or
+// +infinity. The distance is only replaced by a hit that is closer, so testing
+// a ray against many shapes leaves it at the closest of them. Spheres and boxes
+// are solid: a ray that starts inside one hits it at 0.
+
+//----------------------------------SINGLE RAYS---------------------------------
+// The reference implementations of the packet and bulk functions, which compute
+// the same distances to within rounding.
+
+/**Intersects a ray with a sphere
+@param ray the ray
+@param sphere the sphere
+@param distance the distance to the closest hit so far, returns the distance
+to the sphere if it is closer
+@return whether the distance was shortened*/
+inline bool intersect(
+        const Ray& ray, const BoundingSphere& sphere, float& distance) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(Ray, BoundingSphere)");
+
+    Vector3 offset = ray.origin - sphere.centre;
+    float a = dot(ray.direction, ray.direction);
+    float b = dot(offset, ray.direction);
+    float c = dot(offset, offset) - sphere.radius * sphere.radius;
+    float discriminant = b * b - a * c;
+    if (!(discriminant >= 0.0f)) {
+
+        return false;
+    }
+
+    float root = std::sqrt(discriminant);
+    float nearT = (-b - root) / a;
+    float farT = (root - b) / a;
+    if (!(farT >= 0.0f)) {
+
+        return false;
+    }
+
+    float t = nearT > 0.0f ? nearT : 0.0f;
+    if (!(t < distance)) {
+
+        return false;
+    }
+    distance = t;
+
+    return true;
+}
+
+/**Intersects a ray with an axis aligned box
+@param ray the ray
+@param box the box
+@param distance the distance to the closest hit so far, returns the distance
+to the box if it is closer
+@return whether the distance was shortened*/
+inline bool intersect(
+        const Ray& ray, const BoundingBox3& box, float& distance) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(Ray, BoundingBox3)");
+
+    float enter = 0.0f;
+    float exit = std::numeric_limits<float>::infinity();
+    for (unsigned c = 0; c < 3; ++c) {
+
+        float inverse = 1.0f / ray.direction[c];
+        float t0 = (box.lower[c] - ray.origin[c]) * inverse;
+        float t1 = (box.upper[c] - ray.origin[c]) * inverse;
+
+        //a ray lying in one of the slab's planes gives 0 * infinity = NaN,
+        //it never leaves the slab so the slab is skipped
+        if (!(t0 == t0 && t1 == t1)) {
+
+            continue;
+        }
+        enter = std::max(enter, std::min(t0, t1));
+        exit = std::min(exit, std::max(t0, t1));
+    }
+    if (!(enter <= exit) || !(enter < distance)) {
+
+        return false;
+    }
+    distance = enter;
+
+    return true;
+}
+
+/**Intersects a ray with a triangle
+@param ray the ray
+@param triangle the triangle
+@param distance the distance to the closest hit so far, returns the distance
+to the triangle if it is closer
+@return whether the distance was shortened*/
+inline bool intersect(
+        const Ray& ray, const Triangle& triangle, float& distance) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(Ray, Triangle)");
+
+    Vector3 e1 = triangle.b - triangle.a;
+    Vector3 e2 = triangle.c - triangle.a;
+    Vector3 offset = ray.origin - triangle.a;
+
+    //Moller-Trumbore: solve for the barycentric coordinates of the hit
+    Vector3 p = cross(ray.direction, e2);
+    float inverse = 1.0f / dot(e1, p);
+    float u = dot(offset, p) * inverse;
+    if (!(u >= 0.0f && u <= 1.0f)) {
+
+        return false;
+    }
+
+    Vector3 q = cross(offset, e1);
+    float v = dot(ray.direction, q) * inverse;
+    float t = dot(e2, q) * inverse;
+    if (!(v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < distance)) {
+
+        return false;
+    }
+    distance = t;
+
+    return true;
+}
+
+/**Intersects a ray with a plane
+@param ray the ray
+@param plane the plane
+@param distance the distance to the closest hit so far, returns the distance
+to the plane if it is closer
+@return whether the distance was shortened*/
+inline bool intersect(const Ray& ray, const Plane& plane, float& distance) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(Ray, Plane)");
+
+    float t = (plane.distance - dot(plane.normal, ray.origin)) /
+        dot(plane.normal, ray.direction);
+    if (!(t >= 0.0f && t < distance)) {
+
+        return false;
+    }
+    distance = t;
+
+    return true;
+}
+
+//-----------------------------------PACKETS------------------------------------
+
+/**Sets one of the rays of a packet and marks it as active
+@param packet the packet
+@param lane the index of the ray in the packet
+@param ray the ray*/
+template<unsigned Width>
+inline void setRay(RayPacket<Width>& packet, unsigned lane, const Ray& ray) {
+
+    for (unsigned c = 0; c < 3; ++c) {
+
+        packet.origin[c][lane] = ray.origin[c];
+        packet.direction[c][lane] = ray.direction[c];
+    }
+    packet.active |= 1u << lane;
+}
+
+/**Fills a packet from an array of rays, the lanes past the end of the array
+are zeroed and left inactive
+@param rays the rays
+@param count the number of rays, at most Width
+@param packet returns the packet*/
+template<unsigned Width>
+inline void loadRays(
+        const Ray* rays, unsigned count, RayPacket<Width>& packet) {
+
+    UTIL_PROFILE_PROBE("vec::loadRays(Ray[])");
+
+    packet.active = 0;
+    for (unsigned lane = 0; lane < Width; ++lane) {
+
+        for (unsigned c = 0; c < 3; ++c) {
+
+            packet.origin[c][lane] = 0.0f;
+            packet.direction[c][lane] = 0.0f;
+        }
+    }
+    for (unsigned lane = 0; lane < count && lane < Width; ++lane) {
+
+        setRay(packet, lane, rays[lane]);
+    }
+}
+
+/**Intersects the active rays of a packet with a sphere
+@param packet the rays
+@param sphere the sphere
+@param distances the Width distances to the closest hits so far, the distances
+of active rays that hit the sphere closer are replaced
+@return the bits of the rays whose distance was shortened*/
+template<unsigned Width>
+inline unsigned intersect(
+        const RayPacket<Width>& packet,
+        const BoundingSphere& sphere,
+        float* distances) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(RayPacket, BoundingSphere)");
+
+    return detail::castPacket(packet, sphere, distances);
+}
+
+/**Intersects the active rays of a packet with an axis aligned box
+@param packet the rays
+@param box the box
+@param distances the Width distances to the closest hits so far, the distances
+of active rays that hit the box closer are replaced
+@return the bits of the rays whose distance was shortened*/
+template<unsigned Width>
+inline unsigned intersect(
+        const RayPacket<Width>& packet,
+        const BoundingBox3& box,
+        float* distances) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(RayPacket, BoundingBox3)");
+
+    return detail::castPacket(packet, box, distances);
+}
+
+/**Intersects the active rays of a packet with a triangle
+@param packet the rays
+@param triangle the triangle
+@param distances the Width distances to the closest hits so far, the distances
+of active rays that hit the triangle closer are replaced
+@return the bits of the rays whose distance was shortened*/
+template<unsigned Width>
+inline unsigned intersect(
+        const RayPacket<Width>& packet,
+        const Triangle& triangle,
+        float* distances) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(RayPacket, Triangle)");
+
+    return detail::castPacket(packet, triangle, distances);
+}
+
+/**Intersects the active rays of a packet with a plane
+@param packet the rays
+@param plane the plane
+@param distances the Width distances to the closest hits so far, the distances
+of active rays that hit the plane closer are replaced
+@return the bits of the rays whose distance was shortened*/
+template<unsigned Width>
+inline unsigned intersect(
+        const RayPacket<Width>& packet,
+        const Plane& plane,
+        float* distances) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(RayPacket, Plane)");
+
+    return detail::castPacket(packet, plane, distances);
+}
+
+//-------------------------------------BULK-------------------------------------
+// These gather an array of rays into packets of the widest instruction set the
+// CPU supports, and spread them across the thread pool when given
+// EXECUTE_PARALLEL.
+
+/**Intersects an array of rays with a sphere
+@param rays the rays
+@param n the number of rays
+@param sphere the sphere
+@param distances the distances to the closest hits so far, each is replaced if
+its ray hits the sphere closer
+@param execution whether to split large arrays across the thread pool*/
+inline void intersect(
+        const Ray* rays,
+        std::size_t n,
+        const BoundingSphere& sphere,
+        float* distances,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(Ray[], BoundingSphere)");
+
+    detail::castRays(rays, n, sphere, distances, execution);
+}
+
+/**Intersects an array of rays with an axis aligned box
+@param rays the rays
+@param n the number of rays
+@param box the box
+@param distances the distances to the closest hits so far, each is replaced if
+its ray hits the box closer
+@param execution whether to split large arrays across the thread pool*/
+inline void intersect(
+        const Ray* rays,
+        std::size_t n,
+        const BoundingBox3& box,
+        float* distances,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(Ray[], BoundingBox3)");
+
+    detail::castRays(rays, n, box, distances, execution);
+}
+
+/**Intersects an array of rays with a triangle
+@param rays the rays
+@param n the number of rays
+@param triangle the triangle
+@param distances the distances to the closest hits so far, each is replaced if
+its ray hits the triangle closer
+@param execution whether to split large arrays across the thread pool*/
+inline void intersect(
+        const Ray* rays,
+        std::size_t n,
+        const Triangle& triangle,
+        float* distances,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(Ray[], Triangle)");
+
+    detail::castRays(rays, n, triangle, distances, execution);
+}
+
+/**Intersects an array of rays with a plane
+@param rays the rays
+@param n the number of rays
+@param plane the plane
+@param distances the distances to the closest hits so far, each is replaced if
+its ray hits the plane closer
+@param execution whether to split large arrays across the thread pool*/
+inline void intersect(
+        const Ray* rays,
+        std::size_t n,
+        const Plane& plane,
+        float* distances,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::intersect(Ray[], Plane)");
+
+    detail::castRays(rays, n, plane, distances, execution);
+}
+
+} } //util //vec
+
+#endif
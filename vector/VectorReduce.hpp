@@ -0,0 +1,481 @@
+#ifndef UTILITRON_VECTOR_VECTORREDUCE_H_
+#   define UTILITRON_VECTOR_VECTORREDUCE_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "../SimdUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+#include "VectorBounds.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+#define UTIL_SIMD_KERNELS "vector/detail/VectorReduce.inl"
+#include "../SimdForEachIsa.hpp"
+
+//!the number of vectors in each chunk of a reduction, the chunks are fixed so
+//!a reduction gives the same result however many threads run it
+static const std::size_t REDUCE_CHUNK = 1 << 16;
+
+/**Runs a reduction kernel over each chunk of n vectors, then adds the chunk
+results together in chunk order
+@param n the number of vectors
+@param width the number of doubles the kernel writes
+@param kernel called as kernel(begin, end, out) for each chunk
+@param out returns the sums of the chunk results
+@param execution whether to run the chunks across the thread pool when there
+is more than one*/
+template<typename Kernel>
+inline void reduceChunks(
+        std::size_t n,
+        std::size_t width,
+        Kernel kernel,
+        double* out,
+        util::thread::Execution execution) {
+
+    if (n <= REDUCE_CHUNK) {
+
+        kernel(0, n, out);
+
+        return;
+    }
+
+    std::size_t chunks = (n + REDUCE_CHUNK - 1) / REDUCE_CHUNK;
+    std::vector<double> partial(chunks * width);
+    if (execution == util::thread::EXECUTE_SERIAL) {
+
+        //the same chunks as in parallel so the result is the same
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+            std::size_t begin = chunk * REDUCE_CHUNK;
+            std::size_t end = begin + REDUCE_CHUNK < n ?
+                begin + REDUCE_CHUNK : n;
+            kernel(begin, end, &partial[chunk * width]);
+        }
+    }
+    else {
+
+        util::thread::parallelFor(n, REDUCE_CHUNK,
+            [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+
+                kernel(begin, end, &partial[chunk * width]);
+            });
+    }
+
+    for (std::size_t k = 0; k < width; ++k) {
+
+        out[k] = 0.0;
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+
+            out[k] += partial[chunk * width + k];
+        }
+    }
+}
+
+/**Sums the components of n N component vectors*/
+template<unsigned N>
+inline void sum(
+        const float* v,
+        std::size_t n,
+        double* out,
+        util::thread::Execution execution) {
+
+    void (*kernel)(const float*, std::size_t, double*) =
+        UTIL_SIMD_DISPATCH(detail, compensatedSum<N>);
+
+    reduceChunks(n, N,
+        [=](std::size_t begin, std::size_t end, double* partial) {
+
+            kernel(v + begin * N, end - begin, partial);
+        },
+        out, execution);
+}
+
+/**Computes the mean of n N component vectors, which is zero if n is 0*/
+template<unsigned N>
+inline void mean(
+        const float* v,
+        std::size_t n,
+        float* out,
+        util::thread::Execution execution) {
+
+    double total[N];
+    sum<N>(v, n, total, execution);
+    for (unsigned c = 0; c < N; ++c) {
+
+        out[c] = n > 0 ? static_cast<float>(total[c] / n) : 0.0f;
+    }
+}
+
+/**Computes the component-wise population variance of n N component vectors,
+which is zero if n is 0*/
+template<unsigned N>
+inline void variance(
+        const float* v,
+        std::size_t n,
+        float* out,
+        util::thread::Execution execution) {
+
+    void (*kernel)(const float*, std::size_t, const float*, double*) =
+        UTIL_SIMD_DISPATCH(detail, squaredDeviations<N>);
+
+    float m[N];
+    mean<N>(v, n, m, execution);
+
+    double total[N];
+    reduceChunks(n, N,
+        [=, &m](std::size_t begin, std::size_t end, double* partial) {
+
+            kernel(v + begin * N, end - begin, m, partial);
+        },
+        total, execution);
+    for (unsigned c = 0; c < N; ++c) {
+
+        out[c] = n > 0 ? static_cast<float>(total[c] / n) : 0.0f;
+    }
+}
+
+/**Computes the row-major N by N population covariance matrix of n N component
+vectors, which is zero if n is 0*/
+template<unsigned N>
+inline void covariance(
+        const float* v,
+        std::size_t n,
+        float* out,
+        util::thread::Execution execution) {
+
+    void (*kernel)(const float*, std::size_t, const float*, double*) =
+        UTIL_SIMD_DISPATCH(detail, deviationProducts<N>);
+
+    float m[N];
+    mean<N>(v, n, m, execution);
+
+    double total[N * N];
+    reduceChunks(n, N * N,
+        [=, &m](std::size_t begin, std::size_t end, double* partial) {
+
+            kernel(v + begin * N, end - begin, m, partial);
+        },
+        total, execution);
+    for (unsigned k = 0; k < N * N; ++k) {
+
+        out[k] = n > 0 ? static_cast<float>(total[k] / n) : 0.0f;
+    }
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                  REDUCTIONS
+//------------------------------------------------------------------------------
+// These reduce whole arrays of vectors using the widest instruction set the CPU
+// supports. Sums are accumulated per SIMD lane with Kahan compensation over
+// fixed chunks of vectors, and the chunk sums are added together in double
+// precision, so accuracy holds for arrays of billions of vectors. Large arrays
+// can be reduced across the thread pool (see ThreadUtil.hpp); since the chunks
+// do not depend on the number of threads the results are the same serially or
+// on any number of threads, though they may differ in the last bit between
+// instruction sets.
+// Variance and covariance take a second pass over the array to sum deviations
+// from the mean rather than using the unstable sum of squares formula.
+
+//-----------------------------------VECTOR2------------------------------------
+
+/**Sums an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the component-wise sum of the vectors*/
+inline Vector2 sum(
+        const Vector2* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::sum(Vector2[])");
+
+    double total[2];
+    detail::sum<2>(&v->x, n, total, execution);
+
+    Vector2 result;
+    for (unsigned c = 0; c < 2; ++c) {
+
+        (&result.x)[c] = static_cast<float>(total[c]);
+    }
+
+    return result;
+}
+
+/**Computes the mean of an array of vectors, for points this is their centroid
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the mean of the vectors, or the zero vector if n is 0*/
+inline Vector2 mean(
+        const Vector2* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::mean(Vector2[])");
+
+    Vector2 result;
+    detail::mean<2>(&v->x, n, &result.x, execution);
+
+    return result;
+}
+
+/**Computes the component-wise population variance of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the variance of each component, or the zero vector if n is 0*/
+inline Vector2 variance(
+        const Vector2* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::variance(Vector2[])");
+
+    Vector2 result;
+    detail::variance<2>(&v->x, n, &result.x, execution);
+
+    return result;
+}
+
+/**Computes the population covariance matrix of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param out returns the row-major 2x2 covariance matrix, which is zero if n
+is 0
+@param execution whether to split large arrays across the thread pool*/
+inline void covariance(
+        const Vector2* v,
+        std::size_t n,
+        float* out,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::covariance(Vector2[])");
+
+    detail::covariance<2>(&v->x, n, out, execution);
+}
+
+/**Computes the component-wise minimum and maximum of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param lower returns the component-wise minimum, +infinity if n is 0
+@param upper returns the component-wise maximum, -infinity if n is 0
+@param execution whether to split large arrays across the thread pool*/
+inline void minMax(
+        const Vector2* v,
+        std::size_t n,
+        Vector2& lower,
+        Vector2& upper,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::minMax(Vector2[])");
+
+    detail::bounds<2>(
+        &v->x, n, &lower.x, &upper.x, execution);
+}
+
+//-----------------------------------VECTOR3------------------------------------
+
+/**Sums an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the component-wise sum of the vectors*/
+inline Vector3 sum(
+        const Vector3* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::sum(Vector3[])");
+
+    double total[3];
+    detail::sum<3>(&v->x, n, total, execution);
+
+    Vector3 result;
+    for (unsigned c = 0; c < 3; ++c) {
+
+        (&result.x)[c] = static_cast<float>(total[c]);
+    }
+
+    return result;
+}
+
+/**Computes the mean of an array of vectors, for points this is their centroid
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the mean of the vectors, or the zero vector if n is 0*/
+inline Vector3 mean(
+        const Vector3* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::mean(Vector3[])");
+
+    Vector3 result;
+    detail::mean<3>(&v->x, n, &result.x, execution);
+
+    return result;
+}
+
+/**Computes the component-wise population variance of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the variance of each component, or the zero vector if n is 0*/
+inline Vector3 variance(
+        const Vector3* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::variance(Vector3[])");
+
+    Vector3 result;
+    detail::variance<3>(&v->x, n, &result.x, execution);
+
+    return result;
+}
+
+/**Computes the population covariance matrix of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param out returns the row-major 3x3 covariance matrix, which is zero if n
+is 0
+@param execution whether to split large arrays across the thread pool*/
+inline void covariance(
+        const Vector3* v,
+        std::size_t n,
+        float* out,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::covariance(Vector3[])");
+
+    detail::covariance<3>(&v->x, n, out, execution);
+}
+
+/**Computes the component-wise minimum and maximum of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param lower returns the component-wise minimum, +infinity if n is 0
+@param upper returns the component-wise maximum, -infinity if n is 0
+@param execution whether to split large arrays across the thread pool*/
+inline void minMax(
+        const Vector3* v,
+        std::size_t n,
+        Vector3& lower,
+        Vector3& upper,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::minMax(Vector3[])");
+
+    detail::bounds<3>(
+        &v->x, n, &lower.x, &upper.x, execution);
+}
+
+//-----------------------------------VECTOR4------------------------------------
+
+/**Sums an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the component-wise sum of the vectors*/
+inline Vector4 sum(
+        const Vector4* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::sum(Vector4[])");
+
+    double total[4];
+    detail::sum<4>(&v->x, n, total, execution);
+
+    Vector4 result;
+    for (unsigned c = 0; c < 4; ++c) {
+
+        (&result.x)[c] = static_cast<float>(total[c]);
+    }
+
+    return result;
+}
+
+/**Computes the mean of an array of vectors, for points this is their centroid
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the mean of the vectors, or the zero vector if n is 0*/
+inline Vector4 mean(
+        const Vector4* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::mean(Vector4[])");
+
+    Vector4 result;
+    detail::mean<4>(&v->x, n, &result.x, execution);
+
+    return result;
+}
+
+/**Computes the component-wise population variance of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param execution whether to split large arrays across the thread pool
+@return the variance of each component, or the zero vector if n is 0*/
+inline Vector4 variance(
+        const Vector4* v,
+        std::size_t n,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::variance(Vector4[])");
+
+    Vector4 result;
+    detail::variance<4>(&v->x, n, &result.x, execution);
+
+    return result;
+}
+
+/**Computes the population covariance matrix of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param out returns the row-major 4x4 covariance matrix, which is zero if n
+is 0
+@param execution whether to split large arrays across the thread pool*/
+inline void covariance(
+        const Vector4* v,
+        std::size_t n,
+        float* out,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::covariance(Vector4[])");
+
+    detail::covariance<4>(&v->x, n, out, execution);
+}
+
+/**Computes the component-wise minimum and maximum of an array of vectors
+@param v the array of vectors
+@param n the number of vectors
+@param lower returns the component-wise minimum, +infinity if n is 0
+@param upper returns the component-wise maximum, -infinity if n is 0
+@param execution whether to split large arrays across the thread pool*/
+inline void minMax(
+        const Vector4* v,
+        std::size_t n,
+        Vector4& lower,
+        Vector4& upper,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::minMax(Vector4[])");
+
+    detail::bounds<4>(
+        &v->x, n, &lower.x, &upper.x, execution);
+}
+
+} } //util //vec
+
+#endif
@@ -0,0 +1,583 @@
+#ifndef UTILITRON_VECTOR_VECTORRING_H_
+#   define UTILITRON_VECTOR_VECTORRING_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "../MacroUtil.hpp"
+#include "../MemoryUtil.hpp"
+#include "../SimdUtil.hpp"
+#include "../Vector.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the padding between the fields of a ring buffer written by different
+//!threads, so that they never share a cache line
+static const std::size_t RING_PADDING = util::mem::SIMD_ALIGNMENT;
+//!the number of times a blocked ring buffer call spins before yielding
+static const unsigned RING_SPINS = 64;
+//!the number of times a blocked ring buffer call yields before sleeping
+static const unsigned RING_YIELDS = 1024;
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return the smallest power of two that is at least n, and at least 2*/
+inline std::size_t ringCapacity(std::size_t n) {
+
+    std::size_t capacity = 2;
+    while (capacity < n) {
+
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+/**Waits a little before a blocked call retries, spinning at first, then
+yielding, then sleeping so a long wait does not hold a core
+@param attempts the number of times the call has waited so far*/
+inline void ringBackoff(unsigned& attempts) {
+
+    if (attempts < RING_SPINS) {
+
+#ifdef UTIL_SIMD_X86
+        _mm_pause();
+#endif
+    }
+    else if (attempts < RING_YIELDS) {
+
+        std::this_thread::yield();
+    }
+    else {
+
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    ++attempts;
+}
+
+/**Pushes every vector into a ring buffer, waiting for space
+@return the number of vectors pushed, which is less than n only if the ring
+was closed*/
+template<typename Ring, typename VectorType>
+inline std::size_t ringPush(Ring& ring, const VectorType* v, std::size_t n) {
+
+    std::size_t pushed = 0;
+    unsigned attempts = 0;
+    while (pushed < n && !ring.closed()) {
+
+        std::size_t count = ring.tryPush(v + pushed, n - pushed);
+        pushed += count;
+        if (count == 0) {
+
+            ringBackoff(attempts);
+        }
+    }
+
+    return pushed;
+}
+
+/**Pops up to n vectors from a ring buffer, waiting for at least one
+@return the number of vectors popped, which is 0 only if the ring was closed
+and is empty*/
+template<typename Ring, typename VectorType>
+inline std::size_t ringPop(Ring& ring, VectorType* out, std::size_t n) {
+
+    unsigned attempts = 0;
+    for (;;) {
+
+        //check closed first so that vectors pushed before closing are
+        //never missed
+        bool closed = ring.closed();
+        std::size_t count = ring.tryPop(out, n);
+        if (count > 0 || closed || n == 0) {
+
+            return count;
+        }
+        ringBackoff(attempts);
+    }
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+// Bounded lock-free queues for handing vectors between threads. The try
+// functions never block and move as many vectors as they can at once. The
+// blocking push() and pop() wait for space or data, spinning briefly and then
+// backing off, and return early once the ring is closed. Closing lets the
+// consumers drain what is left and then stop. The payloads are copied by
+// assignment, so rings suit Vector2, Vector3, Vector4, and other types that
+// are cheap to copy.
+
+/***************************************************************************\
+| A ring buffer with a single producer thread and a single consumer thread. |
+| Each side keeps a cached copy of the other side's index, so it only reads |
+| the other side's cache line when the cached copy says the ring is full or |
+| empty.                                                                    |
+\***************************************************************************/
+template<typename VectorType>
+class SpscRing {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new empty ring
+    @param capacity the least number of vectors the ring can hold, rounded up
+    to a power of two*/
+    inline explicit SpscRing(std::size_t capacity) :
+        mBuffer(detail::ringCapacity(capacity)),
+        mMask(mBuffer.size() - 1),
+        mHead(0),
+        mTailCache(0),
+        mTail(0),
+        mHeadCache(0),
+        mClosed(false) {
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the number of vectors the ring can hold*/
+    inline std::size_t capacity() const {
+
+        return mBuffer.size();
+    }
+
+    /**@return the number of vectors in the ring, which may be out of date by
+    the time it is returned*/
+    inline std::size_t size() const {
+
+        //the head is read first as it never passes the tail, which can only
+        //have moved further on by the time it is read
+        std::size_t head = mHead.load(std::memory_order_acquire);
+        std::size_t tail = mTail.load(std::memory_order_acquire);
+
+        return tail > head ? tail - head : 0;
+    }
+
+    /**Pushes as many vectors as there is space for without blocking, this
+    must only be called by the producer
+    @param v the vectors to push
+    @param n the number of vectors
+    @return the number of vectors pushed*/
+    inline std::size_t tryPush(const VectorType* v, std::size_t n) {
+
+        UTIL_PROFILE_PROBE("vec::SpscRing::tryPush");
+
+        std::size_t tail = mTail.load(std::memory_order_relaxed);
+        if (mBuffer.size() - (tail - mHeadCache) < n) {
+
+            mHeadCache = mHead.load(std::memory_order_acquire);
+        }
+        std::size_t space = mBuffer.size() - (tail - mHeadCache);
+        std::size_t count = n < space ? n : space;
+        for (std::size_t i = 0; i < count; ++i) {
+
+            mBuffer[(tail + i) & mMask] = v[i];
+        }
+        mTail.store(tail + count, std::memory_order_release);
+
+        return count;
+    }
+
+    /**Pushes a vector without blocking, this must only be called by the
+    producer
+    @return whether there was space for the vector*/
+    inline bool tryPush(const VectorType& v) {
+
+        return tryPush(&v, 1) == 1;
+    }
+
+    /**Pops as many vectors as are available, up to n, without blocking, this
+    must only be called by the consumer
+    @param out returns the vectors in the order they were pushed
+    @param n the greatest number of vectors to pop
+    @return the number of vectors popped*/
+    inline std::size_t tryPop(VectorType* out, std::size_t n) {
+
+        UTIL_PROFILE_PROBE("vec::SpscRing::tryPop");
+
+        std::size_t head = mHead.load(std::memory_order_relaxed);
+        if (mTailCache - head < n) {
+
+            mTailCache = mTail.load(std::memory_order_acquire);
+        }
+        std::size_t available = mTailCache - head;
+        std::size_t count = n < available ? n : available;
+        for (std::size_t i = 0; i < count; ++i) {
+
+            out[i] = mBuffer[(head + i) & mMask];
+        }
+        mHead.store(head + count, std::memory_order_release);
+
+        return count;
+    }
+
+    /**Pops a vector without blocking, this must only be called by the
+    consumer
+    @return whether there was a vector to pop*/
+    inline bool tryPop(VectorType& out) {
+
+        return tryPop(&out, 1) == 1;
+    }
+
+    /**Pushes every vector, waiting for space, this must only be called by the
+    producer
+    @param v the vectors to push
+    @param n the number of vectors
+    @return the number of vectors pushed, which is less than n only if the
+    ring was closed*/
+    inline std::size_t push(const VectorType* v, std::size_t n) {
+
+        UTIL_PROFILE_PROBE("vec::SpscRing::push");
+
+        return detail::ringPush(*this, v, n);
+    }
+
+    /**Pops up to n vectors, waiting until there is at least one, this must
+    only be called by the consumer
+    @param out returns the vectors in the order they were pushed
+    @param n the greatest number of vectors to pop
+    @return the number of vectors popped, which is 0 only if the ring was
+    closed and is empty*/
+    inline std::size_t pop(VectorType* out, std::size_t n) {
+
+        UTIL_PROFILE_PROBE("vec::SpscRing::pop");
+
+        return detail::ringPop(*this, out, n);
+    }
+
+    /**Closes the ring, blocked and later pushes return early and pops return
+    0 once the ring is empty*/
+    inline void close() {
+
+        mClosed.store(true, std::memory_order_release);
+    }
+
+    /**@return whether the ring has been closed*/
+    inline bool closed() const {
+
+        return mClosed.load(std::memory_order_acquire);
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the slots of the ring, read only after construction
+    std::vector<VectorType, util::mem::AlignedAllocator<VectorType> > mBuffer;
+    //the mask that wraps an index into the slots
+    std::size_t mMask;
+    char mPadding0[detail::RING_PADDING];
+
+    //the consumer's line: the number of vectors popped and its copy of the
+    //number pushed
+    std::atomic<std::size_t> mHead;
+    std::size_t mTailCache;
+    char mPadding1[detail::RING_PADDING];
+
+    //the producer's line: the number of vectors pushed and its copy of the
+    //number popped
+    std::atomic<std::size_t> mTail;
+    std::size_t mHeadCache;
+    char mPadding2[detail::RING_PADDING];
+
+    //whether the ring has been closed
+    std::atomic<bool> mClosed;
+
+    //--------------------------------------------------------------------------
+    //                          PRIVATE MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    DISALLOW_COPY_AND_ASSIGN(SpscRing);
+};
+
+/*****************************************************************************\
+| A ring buffer that any number of threads can push to and pop from, after D. |
+| Vyukov's bounded MPMC queue. Each slot carries a sequence number that tells |
+| producers and consumers whether it is free for the current lap, so a thread |
+| claims a run of slots with a single compare and swap and then fills or      |
+| empties them without further synchronisation. Vectors pushed by one thread  |
+| are popped in the order that thread pushed them.                            |
+\*****************************************************************************/
+template<typename VectorType>
+class MpmcRing {
+public:
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new empty ring
+    @param capacity the least number of vectors the ring can hold, rounded up
+    to a power of two*/
+    inline explicit MpmcRing(std::size_t capacity) :
+        mSlots(detail::ringCapacity(capacity)),
+        mMask(mSlots.size() - 1),
+        mEnqueue(0),
+        mDequeue(0),
+        mClosed(false) {
+
+        for (std::size_t i = 0; i < mSlots.size(); ++i) {
+
+            mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**@return the number of vectors the ring can hold*/
+    inline std::size_t capacity() const {
+
+        return mSlots.size();
+    }
+
+    /**@return the number of vectors claimed for pushing but not yet for
+    popping, which may be out of date by the time it is returned*/
+    inline std::size_t size() const {
+
+        std::size_t dequeue = mDequeue.load(std::memory_order_acquire);
+        std::size_t enqueue = mEnqueue.load(std::memory_order_acquire);
+
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+    /**Pushes as many vectors as there are free slots in a row for without
+    blocking
+    @param v the vectors to push
+    @param n the number of vectors
+    @return the number of vectors pushed*/
+    inline std::size_t tryPush(const VectorType* v, std::size_t n) {
+
+        UTIL_PROFILE_PROBE("vec::MpmcRing::tryPush");
+
+        std::size_t position = mEnqueue.load(std::memory_order_relaxed);
+        for (;;) {
+
+            //the slots free for this lap, a slot's sequence equals its
+            //position when it is free
+            std::size_t count = 0;
+            std::size_t sequence = 0;
+            while (count < n) {
+
+                sequence = slot(position + count).sequence.load(
+                    std::memory_order_acquire);
+                if (sequence != position + count) {
+
+                    break;
+                }
+                ++count;
+            }
+
+            if (count == 0) {
+
+                //the slot is still full from the last lap or another
+                //producer has claimed it
+                if (n == 0 || lapsBehind(sequence, position)) {
+
+                    return 0;
+                }
+                position = mEnqueue.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            //the slots cannot change until they are claimed, so they are
+            //still free if no other producer has moved the position
+            if (mEnqueue.compare_exchange_weak(position, position + count,
+                    std::memory_order_relaxed)) {
+
+                for (std::size_t i = 0; i < count; ++i) {
+
+                    Slot& s = slot(position + i);
+                    s.value = v[i];
+                    s.sequence.store(
+                        position + i + 1, std::memory_order_release);
+                }
+
+                return count;
+            }
+        }
+    }
+
+    /**Pushes a vector without blocking
+    @return whether there was space for the vector*/
+    inline bool tryPush(const VectorType& v) {
+
+        return tryPush(&v, 1) == 1;
+    }
+
+    /**Pops as many vectors as are ready in a row, up to n, without blocking
+    @param out returns the vectors
+    @param n the greatest number of vectors to pop
+    @return the number of vectors popped*/
+    inline std::size_t tryPop(VectorType* out, std::size_t n) {
+
+        UTIL_PROFILE_PROBE("vec::MpmcRing::tryPop");
+
+        std::size_t position = mDequeue.load(std::memory_order_relaxed);
+        for (;;) {
+
+            //a slot is full for this lap when its sequence is one past its
+            //position
+            std::size_t count = 0;
+            std::size_t sequence = 0;
+            while (count < n) {
+
+                sequence = slot(position + count).sequence.load(
+                    std::memory_order_acquire);
+                if (sequence != position + count + 1) {
+
+                    break;
+                }
+                ++count;
+            }
+
+            if (count == 0) {
+
+                if (n == 0 || lapsBehind(sequence, position + 1)) {
+
+                    return 0;
+                }
+                position = mDequeue.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (mDequeue.compare_exchange_weak(position, position + count,
+                    std::memory_order_relaxed)) {
+
+                for (std::size_t i = 0; i < count; ++i) {
+
+                    Slot& s = slot(position + i);
+                    out[i] = s.value;
+                    s.sequence.store(position + i + mSlots.size(),
+                        std::memory_order_release);
+                }
+
+                return count;
+            }
+        }
+    }
+
+    /**Pops a vector without blocking
+    @return whether there was a vector to pop*/
+    inline bool tryPop(VectorType& out) {
+
+        return tryPop(&out, 1) == 1;
+    }
+
+    /**Pushes every vector, waiting for space. Vectors pushed by other threads
+    at the same time may be interleaved with them
+    @param v the vectors to push
+    @param n the number of vectors
+    @return the number of vectors pushed, which is less than n only if the
+    ring was closed*/
+    inline std::size_t push(const VectorType* v, std::size_t n) {
+
+        UTIL_PROFILE_PROBE("vec::MpmcRing::push");
+
+        return detail::ringPush(*this, v, n);
+    }
+
+    /**Pops up to n vectors, waiting until there is at least one
+    @param out returns the vectors
+    @param n the greatest number of vectors to pop
+    @return the number of vectors popped, which is 0 only if the ring was
+    closed and is empty*/
+    inline std::size_t pop(VectorType* out, std::size_t n) {
+
+        UTIL_PROFILE_PROBE("vec::MpmcRing::pop");
+
+        return detail::ringPop(*this, out, n);
+    }
+
+    /**Closes the ring, blocked and later pushes return early and pops return
+    0 once the ring is empty*/
+    inline void close() {
+
+        mClosed.store(true, std::memory_order_release);
+    }
+
+    /**@return whether the ring has been closed*/
+    inline bool closed() const {
+
+        return mClosed.load(std::memory_order_acquire);
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                  STRUCTS
+    //--------------------------------------------------------------------------
+
+    /**A slot of the ring*/
+    struct Slot {
+
+        //the lap state of the slot
+        std::atomic<std::size_t> sequence;
+        //the vector in the slot
+        VectorType value;
+    };
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the slots of the ring
+    std::vector<Slot, util::mem::AlignedAllocator<Slot> > mSlots;
+    //the mask that wraps a position into the slots
+    std::size_t mMask;
+    char mPadding0[detail::RING_PADDING];
+
+    //the position of the next slot to push to
+    std::atomic<std::size_t> mEnqueue;
+    char mPadding1[detail::RING_PADDING];
+
+    //the position of the next slot to pop from
+    std::atomic<std::size_t> mDequeue;
+    char mPadding2[detail::RING_PADDING];
+
+    //whether the ring has been closed
+    std::atomic<bool> mClosed;
+
+    //--------------------------------------------------------------------------
+    //                          PRIVATE MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    DISALLOW_COPY_AND_ASSIGN(MpmcRing);
+
+    /**@return the slot at a position*/
+    inline Slot& slot(std::size_t position) {
+
+        return mSlots[position & mMask];
+    }
+
+    /**@return whether a slot's sequence is behind the one expected at a
+    position, which means the ring is full for a push or empty for a pop*/
+    inline static bool lapsBehind(std::size_t sequence, std::size_t expected) {
+
+        return static_cast<std::ptrdiff_t>(sequence - expected) < 0;
+    }
+};
+
+} } //util //vec
+
+#endif
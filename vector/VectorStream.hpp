@@ -0,0 +1,327 @@
+#ifndef UTILITRON_VECTOR_VECTORSTREAM_H_
+#   define UTILITRON_VECTOR_VECTORSTREAM_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "../Vector.hpp"
+#include "../exceptions/IOException.hpp"
+#include "VectorKernels.hpp"
+#include "VectorReduce.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the default number of vectors in each chunk of a stream pipeline
+static const std::size_t STREAM_CHUNK = 1 << 16;
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                    CLASSES
+//------------------------------------------------------------------------------
+
+/*****************************************************************************\
+| Applies a chain of stages to a stream of vectors one fixed size chunk at a  |
+| time, so data sets larger than memory are processed without ever being held |
+| whole. Vectors are read and written as their raw float components. While    |
+| the stages run over one chunk the next chunk is read and the previous one   |
+| is written on other threads, so IO overlaps compute. Stages run in the      |
+| order they were added, on the calling thread, and see every chunk in order. |
+\*****************************************************************************/
+template<typename VectorType>
+class StreamPipeline {
+public:
+
+    /**A stage of the pipeline, called with each chunk to update in place*/
+    typedef std::function<void(VectorType*, std::size_t)> Stage;
+
+    //--------------------------------------------------------------------------
+    //                                CONSTRUCTORS
+    //--------------------------------------------------------------------------
+
+    /**Creates a new pipeline without any stages
+    @param chunkSize the number of vectors in each chunk*/
+    inline explicit StreamPipeline(
+            std::size_t chunkSize = detail::STREAM_CHUNK)
+        :
+        mChunkSize(chunkSize > 0 ? chunkSize : 1) {
+    }
+
+    //--------------------------------------------------------------------------
+    //                          PUBLIC MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**Adds a stage to the end of the pipeline
+    @param stage the stage
+    @return this pipeline*/
+    inline StreamPipeline& then(const Stage& stage) {
+
+        mStages.push_back(stage);
+
+        return *this;
+    }
+
+    /**Adds a stage that transforms each vector by a matrix, see
+    util::vec::transform()
+    @param matrix the row-major 4x4 matrix to transform by
+    @return this pipeline*/
+    inline StreamPipeline& transform(const float matrix[16]) {
+
+        std::shared_ptr<std::vector<float> > m(
+            new std::vector<float>(matrix, matrix + 16));
+
+        return then([m](VectorType* v, std::size_t n) {
+
+            util::vec::transform(v, m->data(), v, n);
+        });
+    }
+
+    /**Adds a stage that normalises each vector
+    @return this pipeline*/
+    inline StreamPipeline& normalise() {
+
+        return then([](VectorType* v, std::size_t n) {
+
+            util::vec::normalise(v, v, n);
+        });
+    }
+
+    /**Adds a stage that clamps each component of each vector
+    @param lower the smallest value of each component
+    @param upper the largest value of each component
+    @return this pipeline*/
+    inline StreamPipeline& clamp(
+            const VectorType& lower, const VectorType& upper) {
+
+        return then([lower, upper](VectorType* v, std::size_t n) {
+
+            const unsigned components = sizeof(VectorType) / sizeof(float);
+            float* c = &v->x;
+            for (std::size_t i = 0; i < n * components; ++i) {
+
+                float l = (&lower.x)[i % components];
+                float u = (&upper.x)[i % components];
+                c[i] = std::min(std::max(c[i], l), u);
+            }
+        });
+    }
+
+    /**Adds a stage that sums the vectors that reach it over every run of the
+    pipeline. The chunk sums are combined in double, and total is updated
+    after each chunk
+    @param total returns the sum of the vectors, it must outlive the runs of
+    the pipeline
+    @return this pipeline*/
+    inline StreamPipeline& sum(VectorType& total) {
+
+        const unsigned components = sizeof(VectorType) / sizeof(float);
+        std::shared_ptr<std::vector<double> > running(
+            new std::vector<double>(components, 0.0));
+        total = VectorType();
+
+        return then([running, &total](VectorType* v, std::size_t n) {
+
+            VectorType chunk = util::vec::sum(v, n);
+            for (unsigned c = 0; c < components; ++c) {
+
+                (*running)[c] += (&chunk.x)[c];
+                (&total.x)[c] = static_cast<float>((*running)[c]);
+            }
+        });
+    }
+
+    /**Adds a stage that finds the component-wise minimum and maximum of the
+    vectors that reach it over every run of the pipeline, updated after each
+    chunk
+    @param lower returns the component-wise minimum, it must outlive the runs
+    of the pipeline
+    @param upper returns the component-wise maximum, it must outlive the runs
+    of the pipeline
+    @return this pipeline*/
+    inline StreamPipeline& minMax(VectorType& lower, VectorType& upper) {
+
+        const unsigned components = sizeof(VectorType) / sizeof(float);
+        const float inf = std::numeric_limits<float>::infinity();
+        for (unsigned c = 0; c < components; ++c) {
+
+            (&lower.x)[c] = inf;
+            (&upper.x)[c] = -inf;
+        }
+
+        return then([&lower, &upper](VectorType* v, std::size_t n) {
+
+            VectorType l;
+            VectorType u;
+            util::vec::minMax(v, n, l, u);
+            for (unsigned c = 0; c < components; ++c) {
+
+                (&lower.x)[c] = std::min((&lower.x)[c], (&l.x)[c]);
+                (&upper.x)[c] = std::max((&upper.x)[c], (&u.x)[c]);
+            }
+        });
+    }
+
+    /**Runs the pipeline over every vector of a stream and writes the results
+    to another stream
+    @param in the binary stream to read vectors from until it ends
+    @param out the binary stream to write the processed vectors to
+    @return the number of vectors processed
+    @throws util::ex::StreamException if either stream fails or the input
+    ends part way through a vector*/
+    inline std::size_t run(std::istream& in, std::ostream& out) const {
+
+        UTIL_PROFILE_PROBE("vec::StreamPipeline::run");
+
+        return process(in, &out);
+    }
+
+    /**Runs the pipeline over every vector of a stream without writing the
+    results anywhere, for pipelines that end in reductions
+    @param in the binary stream to read vectors from until it ends
+    @return the number of vectors processed
+    @throws util::ex::StreamException if the stream fails or ends part way
+    through a vector*/
+    inline std::size_t run(std::istream& in) const {
+
+        UTIL_PROFILE_PROBE("vec::StreamPipeline::run");
+
+        return process(in, nullptr);
+    }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //                                 VARIABLES
+    //--------------------------------------------------------------------------
+
+    //the number of vectors in each chunk
+    std::size_t mChunkSize;
+    //the stages in the order they run
+    std::vector<Stage> mStages;
+
+    //--------------------------------------------------------------------------
+    //                          PRIVATE MEMBER FUNCTIONS
+    //--------------------------------------------------------------------------
+
+    /**Reads up to a chunk of vectors
+    @return the number of vectors read, less than a chunk at the end*/
+    inline std::size_t read(std::istream& in, VectorType* chunk) const {
+
+        in.read(reinterpret_cast<char*>(chunk),
+            static_cast<std::streamsize>(mChunkSize * sizeof(VectorType)));
+        if (in.bad()) {
+
+            throw util::ex::StreamException("failed to read vectors");
+        }
+
+        std::size_t bytes = static_cast<std::size_t>(in.gcount());
+        if (bytes % sizeof(VectorType) != 0) {
+
+            throw util::ex::StreamException(
+                "stream ends part way through a vector");
+        }
+
+        return bytes / sizeof(VectorType);
+    }
+
+    /**Writes a chunk of vectors*/
+    inline static void write(
+            std::ostream& out, const VectorType* chunk, std::size_t n) {
+
+        out.write(reinterpret_cast<const char*>(chunk),
+            static_cast<std::streamsize>(n * sizeof(VectorType)));
+        if (!out) {
+
+            throw util::ex::StreamException("failed to write vectors");
+        }
+    }
+
+    /**Streams every chunk through the stages. Chunk k is read into buffer
+    k % 3, so while it is processed chunk k + 1 is read into the next buffer
+    and chunk k - 1 is written from the previous one*/
+    inline std::size_t process(std::istream& in, std::ostream* out) const {
+
+        //the buffers are declared first so that they outlive the futures,
+        //which wait for their tasks when they are destroyed
+        std::vector<VectorType> buffers[3];
+        for (unsigned b = 0; b < 3; ++b) {
+
+            buffers[b].resize(mChunkSize);
+        }
+        std::future<std::size_t> reading;
+        std::future<void> writing;
+
+        //a stream that has already failed would otherwise read as empty
+        if (!in) {
+
+            throw util::ex::StreamException("failed to read vectors");
+        }
+        if (out && !*out) {
+
+            throw util::ex::StreamException("failed to write vectors");
+        }
+
+        reading = std::async(std::launch::async,
+            &StreamPipeline::read, this, std::ref(in), buffers[0].data());
+        std::size_t total = 0;
+        for (std::size_t k = 0;; ++k) {
+
+            std::size_t count = reading.get();
+            if (count == 0) {
+
+                break;
+            }
+
+            //a short chunk is the last
+            VectorType* chunk = buffers[k % 3].data();
+            if (count == mChunkSize) {
+
+                reading = std::async(std::launch::async, &StreamPipeline::read,
+                    this, std::ref(in), buffers[(k + 1) % 3].data());
+            }
+
+            for (const Stage& stage : mStages) {
+
+                stage(chunk, count);
+            }
+            total += count;
+
+            if (writing.valid()) {
+
+                writing.get();
+            }
+            if (out) {
+
+                writing = std::async(std::launch::async,
+                    &StreamPipeline::write, std::ref(*out), chunk, count);
+            }
+            if (count < mChunkSize) {
+
+                break;
+            }
+        }
+        if (writing.valid()) {
+
+            writing.get();
+        }
+
+        return total;
+    }
+};
+
+} } //util //vec
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef UTILITRON_VECTOR_VECTORWELD_H_
+#   define UTILITRON_VECTOR_VECTORWELD_H_
+
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+#include "../MathUtil.hpp"
+#include "../ThreadUtil.hpp"
+#include "../Vector.hpp"
+#include "VectorHash.hpp"
+
+namespace util { namespace vec {
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//                                   CONSTANTS
+//------------------------------------------------------------------------------
+
+//!the number of points each thread prepares or copies at a time in parallel
+//!mode
+static const std::size_t WELD_CHUNK = 1 << 16;
+//!the width of the cells of the spatial hash in tolerances
+static const float WELD_CELL = 8.0f;
+//!how near in tolerances a point must be to a face of its cell for the
+//!neighbouring cell to be searched, with a margin for rounding
+static const float WELD_REACH = 1.5f;
+//!marks the end of a list of unique points
+static const unsigned WELD_NONE = ~0u;
+
+//------------------------------------------------------------------------------
+//                               DETAIL FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**@return whether every component of two points is within the tolerance of
+the other, as util::math::withinDistance()*/
+inline bool weldable(const Vector3& a, const Vector3& b, float tolerance) {
+
+    return util::math::withinDistance(a.x, b.x, tolerance) &&
+        util::math::withinDistance(a.y, b.y, tolerance) &&
+        util::math::withinDistance(a.z, b.z, tolerance);
+}
+
+} //detail
+
+//------------------------------------------------------------------------------
+//                                   FUNCTIONS
+//------------------------------------------------------------------------------
+
+/**Welds together the points of an array that are within a tolerance of each
+other. Points are taken in order and each is welded to the earliest unique
+point so far that it is within the tolerance of, following
+util::math::withinDistance() on every component, or becomes a unique point
+itself. The unique points keep the position of the point that created them.
+Candidates are found with a spatial hash of cells several tolerances wide, so
+most points search only their own cell and the rest also search the neighbours
+across the faces they are near.
+The result does not depend on the execution mode: the cells are found and the
+unique points are copied out in parallel, and the welding pass itself runs in
+order on the calling thread. Unique points are indexed with unsigned, so there
+must be fewer than 2^32 - 1 points
+@param points the points to weld
+@param n the number of points
+@param tolerance the greatest distance along each axis between points that are
+welded, 0 welds only equal points and a negative tolerance is taken as 0
+@param unique returns the unique points, in the order they were created, and
+must have room for n points
+@param remap returns the index in unique of the point each point was welded to
+@param execution whether to split the parallel passes across the thread pool
+@return the number of unique points*/
+inline std::size_t weld(
+        const Vector3* points,
+        std::size_t n,
+        float tolerance,
+        Vector3* unique,
+        unsigned* remap,
+        util::thread::Execution execution = util::thread::EXECUTE_SERIAL) {
+
+    UTIL_PROFILE_PROBE("vec::weld(Vector3[])");
+
+    //a negative tolerance would weld nothing, not even equal points
+    bool exact = !(tolerance > 0.0f);
+    tolerance = exact ? 0.0f : tolerance;
+    float cellSize = exact ? 1.0f : detail::WELD_CELL * tolerance;
+    float reach = exact ? 0.0f : detail::WELD_REACH / detail::WELD_CELL;
+    SpatialHashMap<Vector3, unsigned> heads(cellSize);
+
+    std::vector<GridCell<3> > cells(n);
+    std::vector<GridCell<3> > neighbours(n);
+    std::vector<unsigned char> near(n);
+    util::thread::execute(execution, n, detail::WELD_CHUNK,
+        [&](std::size_t begin, std::size_t end) {
+
+            float inverse = 1.0f / cellSize;
+            for (std::size_t i = begin; i < end; ++i) {
+
+                //the neighbour along each axis is the cell across the face
+                //the point is within reach of, if any
+                cells[i] = heads.cell(points[i]);
+                near[i] = 0;
+                for (unsigned a = 0; a < 3; ++a) {
+
+                    int index = cells[i].index[a];
+                    float offset = points[i][a] * inverse -
+                        static_cast<float>(index);
+                    neighbours[i].index[a] = index;
+                    if (offset < reach && index != INT_MIN) {
+
+                        neighbours[i].index[a] = index - 1;
+                    }
+                    else if (offset > 1.0f - reach && index != INT_MAX) {
+
+                        neighbours[i].index[a] = index + 1;
+                    }
+                    if (neighbours[i].index[a] != index) {
+
+                        near[i] |= 1u << a;
+                    }
+                }
+            }
+        });
+
+    //the unique points in each cell as linked lists, newest first
+    std::vector<unsigned> first;
+    std::vector<unsigned> next;
+    for (std::size_t i = 0; i < n; ++i) {
+
+        //the points may fall in far fewer cells than n, so the map grows
+        //with the cells found so far rather than starting with room for n
+        if (i % detail::WELD_CHUNK == 0) {
+
+            heads.reserve(detail::expectedCells(
+                heads.size(), heads.size(), i, n - i));
+        }
+
+        unsigned found = detail::WELD_NONE;
+        for (unsigned corner = 0; corner < 8; ++corner) {
+
+            //only the corners made of axes with a neighbour
+            if (corner & ~near[i]) {
+
+                continue;
+            }
+            GridCell<3> cell = cells[i];
+            for (unsigned a = 0; a < 3; ++a) {
+
+                if ((corner >> a) & 1u) {
+
+                    cell.index[a] = neighbours[i].index[a];
+                }
+            }
+
+            const unsigned* head = heads.find(cell);
+            for (unsigned u = head ? *head : detail::WELD_NONE;
+                    u != detail::WELD_NONE; u = next[u]) {
+
+                if (u < found &&
+                    detail::weldable(points[first[u]], points[i], tolerance)) {
+
+                    found = u;
+                }
+            }
+        }
+
+        if (found == detail::WELD_NONE) {
+
+            found = static_cast<unsigned>(first.size());
+            first.push_back(static_cast<unsigned>(i));
+            unsigned* head = heads.find(cells[i]);
+            if (head) {
+
+                next.push_back(*head);
+                *head = found;
+            }
+            else {
+
+                next.push_back(detail::WELD_NONE);
+                heads.insert(cells[i], found);
+            }
+        }
+        remap[i] = found;
+    }
+
+    util::thread::execute(execution, first.size(), detail::WELD_CHUNK,
+        [&](std::size_t begin, std::size_t end) {
+
+            for (std::size_t u = begin; u < end; ++u) {
+
+                unique[u] = points[first[u]];
+            }
+        });
+
+    return first.size();
+}
+
+} } //util //vec
+
+#endif
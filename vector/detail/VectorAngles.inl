@@ -0,0 +1,155 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//------------------------------------------------------------------------------
+//                               TRIG EVALUATORS
+//------------------------------------------------------------------------------
+// Pack versions of the util::math fast trigonometric functions, each step
+// mirrors the scalar version.
+
+/**Evaluates x * (c[0] + c[1]x^2 + c[2]x^4 ...) with N coefficients*/
+template<unsigned N>
+inline Pack::Type oddPolynomial(const float* c, Pack::Type x) {
+
+    Pack::Type x2 = Pack::mul(x, x);
+    Pack::Type sum = Pack::set(c[N - 1]);
+    for (unsigned i = N - 1; i > 0; --i) {
+
+        sum = Pack::fmadd(sum, x2, Pack::set(c[i - 1]));
+    }
+
+    return Pack::mul(sum, x);
+}
+
+/**@return the given angles wrapped into [-pi, pi]*/
+inline Pack::Type wrapAngle(Pack::Type angle) {
+
+    using namespace util::math::detail;
+
+    Pack::Type k = Pack::floor(
+        Pack::fmadd(angle, Pack::set(INV_TWO_PI), Pack::set(0.5f)));
+    angle = Pack::sub(angle, Pack::mul(k, Pack::set(TWO_PI_HI)));
+    angle = Pack::sub(angle, Pack::mul(k, Pack::set(TWO_PI_MID)));
+
+    return Pack::sub(angle, Pack::mul(k, Pack::set(TWO_PI_LO)));
+}
+
+/**Approximates atan2 for each lane*/
+template<util::math::TrigPrecision P>
+inline Pack::Type atan2(Pack::Type y, Pack::Type x) {
+
+    typedef util::math::detail::TrigPolynomials<P> Poly;
+
+    const Pack::Type zero = Pack::zero();
+
+    Pack::Type ax = Pack::abs(x);
+    Pack::Type ay = Pack::abs(y);
+    Pack::Type high = Pack::max(ax, ay);
+    Pack::Type low = Pack::min(ax, ay);
+    Pack::Type t = Pack::select(
+        Pack::cmpLt(zero, high), Pack::div(low, high), zero);
+
+    Pack::Type angle = oddPolynomial<Poly::ATAN_TERMS>(Poly::atan(), t);
+    angle = Pack::select(Pack::cmpLt(ax, ay),
+        Pack::sub(Pack::set(util::math::detail::HALF_PI), angle), angle);
+    angle = Pack::select(Pack::cmpLt(x, zero),
+        Pack::sub(Pack::set(util::math::detail::PI), angle), angle);
+
+    return Pack::select(Pack::cmpLt(y, zero), Pack::sub(zero, angle), angle);
+}
+
+/**Approximates the sine and cosine of each lane*/
+template<util::math::TrigPrecision P>
+inline void sincos(Pack::Type angle, Pack::Type& s, Pack::Type& c) {
+
+    typedef util::math::detail::TrigPolynomials<P> Poly;
+
+    const Pack::Type halfPi = Pack::set(util::math::detail::HALF_PI);
+
+    Pack::Type r = wrapAngle(angle);
+    Pack::Type ar = Pack::abs(r);
+    Pack::Type folded = Pack::sub(halfPi, Pack::abs(Pack::sub(halfPi, ar)));
+
+    s = oddPolynomial<Poly::SIN_TERMS>(Poly::sin(), folded);
+    s = Pack::select(
+        Pack::cmpLt(r, Pack::zero()), Pack::sub(Pack::zero(), s), s);
+    c = oddPolynomial<Poly::SIN_TERMS>(Poly::sin(), Pack::sub(halfPi, ar));
+}
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**out[i] = angleBetween(a[i], b[i]) for interleaved 2d vectors*/
+template<util::math::TrigPrecision P>
+inline void angleBetween(
+        const float* a, const float* b, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type ca[2];
+        Pack::Type cb[2];
+        Pack::loadInterleaved<2>(a + i * 2, ca);
+        Pack::loadInterleaved<2>(b + i * 2, cb);
+
+        Pack::Type angle = atan2<P>(
+            Pack::sub(ca[1], cb[1]), Pack::sub(ca[0], cb[0]));
+        Pack::store(out + i, Pack::sub(Pack::zero(), angle));
+    }
+    for (; i < n; ++i) {
+
+        out[i] = -util::math::fastAtan2<P>(
+            a[i * 2 + 1] - b[i * 2 + 1], a[i * 2] - b[i * 2]);
+    }
+}
+
+/**out[i] = (cos(angles[i]), sin(angles[i])) for interleaved 2d vectors*/
+template<util::math::TrigPrecision P>
+inline void direction(const float* angles, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[2];
+        sincos<P>(Pack::load(angles + i), c[1], c[0]);
+        Pack::storeInterleaved<2>(out + i * 2, c);
+    }
+    for (; i < n; ++i) {
+
+        util::math::fastSincos<P>(angles[i], out[i * 2 + 1], out[i * 2]);
+    }
+}
+
+/**Rotates each interleaved 2d vector of v anticlockwise by the angle at the
+same index*/
+template<util::math::TrigPrecision P>
+inline void rotate(
+        const float* v, const float* angles, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[2];
+        Pack::loadInterleaved<2>(v + i * 2, c);
+
+        Pack::Type s;
+        Pack::Type co;
+        sincos<P>(Pack::load(angles + i), s, co);
+
+        Pack::Type r[2];
+        r[0] = Pack::sub(Pack::mul(c[0], co), Pack::mul(c[1], s));
+        r[1] = Pack::add(Pack::mul(c[0], s), Pack::mul(c[1], co));
+        Pack::storeInterleaved<2>(out + i * 2, r);
+    }
+    for (; i < n; ++i) {
+
+        float s;
+        float co;
+        util::math::fastSincos<P>(angles[i], s, co);
+
+        float x = v[i * 2];
+        float y = v[i * 2 + 1];
+        out[i * 2] = x * co - y * s;
+        out[i * 2 + 1] = x * s + y * co;
+    }
+}
@@ -0,0 +1,198 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+/**Computes the component-wise minimum and maximum of n interleaved N component
+vectors. The array is streamed as flat packs rather than split into
+components: lane j of accumulator k always holds component (k * WIDTH + j) % N
+so the lanes are only sorted back into components at the end*/
+template<unsigned N>
+inline void minMax(const float* v, std::size_t n, float* lower, float* upper) {
+
+    const float inf = std::numeric_limits<float>::infinity();
+
+    Pack::Type lo[N];
+    Pack::Type hi[N];
+    for (unsigned k = 0; k < N; ++k) {
+
+        lo[k] = Pack::set(inf);
+        hi[k] = Pack::set(-inf);
+    }
+
+    std::size_t count = n * N;
+    std::size_t i = 0;
+    for (; i + N * Pack::WIDTH <= count; i += N * Pack::WIDTH) {
+
+        for (unsigned k = 0; k < N; ++k) {
+
+            Pack::Type x = Pack::load(v + i + k * Pack::WIDTH);
+            lo[k] = Pack::min(lo[k], x);
+            hi[k] = Pack::max(hi[k], x);
+        }
+    }
+
+    for (unsigned c = 0; c < N; ++c) {
+
+        lower[c] = inf;
+        upper[c] = -inf;
+    }
+    for (unsigned k = 0; k < N; ++k) {
+
+        float l[Pack::WIDTH];
+        float h[Pack::WIDTH];
+        Pack::store(l, lo[k]);
+        Pack::store(h, hi[k]);
+        for (unsigned j = 0; j < Pack::WIDTH; ++j) {
+
+            unsigned c = (k * Pack::WIDTH + j) % N;
+            lower[c] = l[j] < lower[c] ? l[j] : lower[c];
+            upper[c] = h[j] > upper[c] ? h[j] : upper[c];
+        }
+    }
+
+    //i is a multiple of N so the tail starts on a whole vector
+    for (; i < count; ++i) {
+
+        unsigned c = static_cast<unsigned>(i % N);
+        lower[c] = v[i] < lower[c] ? v[i] : lower[c];
+        upper[c] = v[i] > upper[c] ? v[i] : upper[c];
+    }
+}
+
+/**Computes the component-wise minimum and maximum of the interleaved N
+component vectors at the given indices*/
+template<unsigned N>
+inline void minMaxIndexed(
+        const float* v,
+        const unsigned* indices,
+        std::size_t count,
+        float* lower,
+        float* upper) {
+
+    const float inf = std::numeric_limits<float>::infinity();
+
+    Pack::Type lo[N];
+    Pack::Type hi[N];
+    for (unsigned c = 0; c < N; ++c) {
+
+        lo[c] = Pack::set(inf);
+        hi[c] = Pack::set(-inf);
+    }
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+
+        Pack::Type x[N];
+        Pack::gatherInterleaved<N>(v, indices + i, x);
+        for (unsigned c = 0; c < N; ++c) {
+
+            lo[c] = Pack::min(lo[c], x[c]);
+            hi[c] = Pack::max(hi[c], x[c]);
+        }
+    }
+
+    for (unsigned c = 0; c < N; ++c) {
+
+        lower[c] = Pack::hmin(lo[c]);
+        upper[c] = Pack::hmax(hi[c]);
+    }
+    for (; i < count; ++i) {
+
+        const float* p = v + static_cast<std::size_t>(indices[i]) * N;
+        for (unsigned c = 0; c < N; ++c) {
+
+            lower[c] = p[c] < lower[c] ? p[c] : lower[c];
+            upper[c] = p[c] > upper[c] ? p[c] : upper[c];
+        }
+    }
+}
+
+/**@return the greatest squared distance of the n interleaved N component
+vectors from the given point*/
+template<unsigned N>
+inline float maxDistanceSquared(
+        const float* v, std::size_t n, const float* point) {
+
+    Pack::Type p[N];
+    for (unsigned c = 0; c < N; ++c) {
+
+        p[c] = Pack::set(point[c]);
+    }
+
+    Pack::Type furthest = Pack::zero();
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type x[N];
+        Pack::loadInterleaved<N>(v + i * N, x);
+
+        Pack::Type d = Pack::sub(x[0], p[0]);
+        Pack::Type sum = Pack::mul(d, d);
+        for (unsigned c = 1; c < N; ++c) {
+
+            d = Pack::sub(x[c], p[c]);
+            sum = Pack::fmadd(d, d, sum);
+        }
+        furthest = Pack::max(furthest, sum);
+    }
+
+    float result = Pack::hmax(furthest);
+    for (; i < n; ++i) {
+
+        float sum = 0.0f;
+        for (unsigned c = 0; c < N; ++c) {
+
+            float d = v[i * N + c] - point[c];
+            sum += d * d;
+        }
+        result = sum > result ? sum : result;
+    }
+
+    return result;
+}
+
+/**@return the greatest squared distance of the interleaved N component
+vectors at the given indices from the given point*/
+template<unsigned N>
+inline float maxDistanceSquaredIndexed(
+        const float* v,
+        const unsigned* indices,
+        std::size_t count,
+        const float* point) {
+
+    Pack::Type p[N];
+    for (unsigned c = 0; c < N; ++c) {
+
+        p[c] = Pack::set(point[c]);
+    }
+
+    Pack::Type furthest = Pack::zero();
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+
+        Pack::Type x[N];
+        Pack::gatherInterleaved<N>(v, indices + i, x);
+
+        Pack::Type d = Pack::sub(x[0], p[0]);
+        Pack::Type sum = Pack::mul(d, d);
+        for (unsigned c = 1; c < N; ++c) {
+
+            d = Pack::sub(x[c], p[c]);
+            sum = Pack::fmadd(d, d, sum);
+        }
+        furthest = Pack::max(furthest, sum);
+    }
+
+    float result = Pack::hmax(furthest);
+    for (; i < count; ++i) {
+
+        const float* x = v + static_cast<std::size_t>(indices[i]) * N;
+        float sum = 0.0f;
+        for (unsigned c = 0; c < N; ++c) {
+
+            float d = x[c] - point[c];
+            sum += d * d;
+        }
+        result = sum > result ? sum : result;
+    }
+
+    return result;
+}
@@ -0,0 +1,241 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//------------------------------------------------------------------------------
+//                               COLOUR EVALUATORS
+//------------------------------------------------------------------------------
+
+/**Evaluates c[0] + c[1]x + c[2]x^2 ... with N coefficients*/
+template<unsigned N>
+inline Pack::Type polynomial(const float* c, Pack::Type x) {
+
+    Pack::Type sum = Pack::set(c[N - 1]);
+    for (unsigned i = N - 1; i > 0; --i) {
+
+        sum = Pack::fmadd(sum, x, Pack::set(c[i - 1]));
+    }
+
+    return sum;
+}
+
+/**@return the lanes clamped to [0, 1]*/
+inline Pack::Type saturate(Pack::Type x) {
+
+    return Pack::min(Pack::max(x, Pack::zero()), Pack::set(1.0f));
+}
+
+/**Encodes linear lanes with the sRGB transfer function*/
+inline Pack::Type encodeSrgb(Pack::Type x) {
+
+    using namespace util::vec::detail;
+
+    x = saturate(x);
+    //the curved segment is fitted against the fourth root of the value
+    Pack::Type curve = polynomial<SRGB_ENCODE_TERMS>(
+        SRGB_ENCODE, Pack::sqrt(Pack::sqrt(x)));
+
+    return Pack::select(Pack::cmpLe(x, Pack::set(SRGB_LINEAR_LIMIT)),
+        Pack::mul(x, Pack::set(12.92f)), curve);
+}
+
+/**Decodes sRGB lanes to linear values*/
+inline Pack::Type decodeSrgb(Pack::Type s) {
+
+    using namespace util::vec::detail;
+
+    s = saturate(s);
+    //((s + 0.055) / 1.055)^2.4 as v^2 times a fit of v^0.4 against sqrt(v)
+    Pack::Type v = Pack::mul(
+        Pack::add(s, Pack::set(0.055f)), Pack::set(1.0f / 1.055f));
+    Pack::Type curve = Pack::mul(Pack::mul(v, v),
+        polynomial<SRGB_DECODE_TERMS>(SRGB_DECODE, Pack::sqrt(v)));
+
+    return Pack::select(Pack::cmpLe(s, Pack::set(SRGB_ENCODED_LIMIT)),
+        Pack::mul(s, Pack::set(1.0f / 12.92f)), curve);
+}
+
+/**Applies a colour operation to WIDTH interleaved RGBA colours*/
+template<unsigned OPERATION>
+inline void colourPack(const float* in, float* out) {
+
+    using namespace util::vec::detail;
+
+    Pack::Type c[4];
+    Pack::loadInterleaved<4>(in, c);
+    for (unsigned k = 0; k < 3; ++k) {
+
+        switch (OPERATION) {
+
+            case COLOUR_TO_LINEAR: {
+
+                c[k] = decodeSrgb(c[k]);
+                break;
+            }
+            case COLOUR_TO_SRGB: {
+
+                c[k] = encodeSrgb(c[k]);
+                break;
+            }
+            case COLOUR_PREMULTIPLY: {
+
+                c[k] = Pack::mul(c[k], c[3]);
+                break;
+            }
+            default: {
+
+                //unpremultiplying a transparent colour gives black
+                c[k] = Pack::select(Pack::cmpLt(Pack::zero(), c[3]),
+                    Pack::div(c[k], c[3]), Pack::zero());
+                break;
+            }
+        }
+    }
+    Pack::storeInterleaved<4>(out, c);
+}
+
+/**Converts WIDTH interleaved float RGBA colours to 8-bit channels*/
+inline void packColourPack(
+        const float* in, unsigned char* out, bool bgra, bool srgb) {
+
+    Pack::Type c[4];
+    Pack::loadInterleaved<4>(in, c);
+    for (unsigned k = 0; k < 3; ++k) {
+
+        c[k] = srgb ? encodeSrgb(c[k]) : saturate(c[k]);
+    }
+    c[3] = saturate(c[3]);
+    if (bgra) {
+
+        std::swap(c[0], c[2]);
+    }
+
+    //back to pixel order, then round to bytes four channels at a time
+    float scaled[4 * Pack::WIDTH];
+    for (unsigned k = 0; k < 4; ++k) {
+
+        c[k] = Pack::mul(c[k], Pack::set(255.0f));
+    }
+    Pack::storeInterleaved<4>(scaled, c);
+    for (unsigned k = 0; k < 4; ++k) {
+
+        Pack::storeBytes(
+            out + k * Pack::WIDTH, Pack::load(scaled + k * Pack::WIDTH));
+    }
+}
+
+/**Converts WIDTH colours of 8-bit channels to interleaved float RGBA*/
+inline void unpackColourPack(
+        const unsigned char* in, float* out, bool bgra, bool srgb) {
+
+    float scaled[4 * Pack::WIDTH];
+    for (unsigned k = 0; k < 4; ++k) {
+
+        Pack::store(scaled + k * Pack::WIDTH, Pack::mul(
+            Pack::loadBytes(in + k * Pack::WIDTH), Pack::set(1.0f / 255.0f)));
+    }
+
+    Pack::Type c[4];
+    Pack::loadInterleaved<4>(scaled, c);
+    if (bgra) {
+
+        std::swap(c[0], c[2]);
+    }
+    if (srgb) {
+
+        for (unsigned k = 0; k < 3; ++k) {
+
+            c[k] = decodeSrgb(c[k]);
+        }
+    }
+    Pack::storeInterleaved<4>(out, c);
+}
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+// The tails are run through the same pack evaluators on zero padded copies.
+
+/**Applies a colour operation to n interleaved RGBA colours*/
+template<unsigned OPERATION>
+inline void colour(const float* in, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        colourPack<OPERATION>(in + i * 4, out + i * 4);
+    }
+    if (i < n) {
+
+        float pi[4 * Pack::WIDTH] = {};
+        float po[4 * Pack::WIDTH];
+        std::copy(in + i * 4, in + n * 4, pi);
+        colourPack<OPERATION>(pi, po);
+        std::copy(po, po + (n - i) * 4, out + i * 4);
+    }
+}
+
+/**out[i] = the luminance of the interleaved RGBA colour in[i]*/
+inline void luminance(const float* in, float* out, std::size_t n) {
+
+    using namespace util::vec::detail;
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[4];
+        Pack::loadInterleaved<4>(in + i * 4, c);
+        Pack::store(out + i, Pack::fmadd(c[0], Pack::set(LUMINANCE_RED),
+            Pack::fmadd(c[1], Pack::set(LUMINANCE_GREEN),
+            Pack::mul(c[2], Pack::set(LUMINANCE_BLUE)))));
+    }
+    for (; i < n; ++i) {
+
+        out[i] = in[i * 4] * LUMINANCE_RED + in[i * 4 + 1] * LUMINANCE_GREEN +
+            in[i * 4 + 2] * LUMINANCE_BLUE;
+    }
+}
+
+/**Converts n interleaved float RGBA colours to 8-bit channels*/
+inline void packColours(
+        const float* in,
+        unsigned char* out,
+        std::size_t n,
+        bool bgra,
+        bool srgb) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        packColourPack(in + i * 4, out + i * 4, bgra, srgb);
+    }
+    if (i < n) {
+
+        float pi[4 * Pack::WIDTH] = {};
+        unsigned char po[4 * Pack::WIDTH];
+        std::copy(in + i * 4, in + n * 4, pi);
+        packColourPack(pi, po, bgra, srgb);
+        std::copy(po, po + (n - i) * 4, out + i * 4);
+    }
+}
+
+/**Converts n colours of 8-bit channels to interleaved float RGBA*/
+inline void unpackColours(
+        const unsigned char* in,
+        float* out,
+        std::size_t n,
+        bool bgra,
+        bool srgb) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        unpackColourPack(in + i * 4, out + i * 4, bgra, srgb);
+    }
+    if (i < n) {
+
+        unsigned char pi[4 * Pack::WIDTH] = {};
+        float po[4 * Pack::WIDTH];
+        std::copy(in + i * 4, in + n * 4, pi);
+        unpackColourPack(pi, po, bgra, srgb);
+        std::copy(po, po + (n - i) * 4, out + i * 4);
+    }
+}
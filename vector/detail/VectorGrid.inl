@@ -0,0 +1,98 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+/**Fills n interleaved N component vectors with the same value. The value is
+repeated across N packs so that lane j of pack k holds component
+(k * WIDTH + j) % N and the array is written as flat packs*/
+template<unsigned N>
+inline void fill(float* out, const float* value, std::size_t n) {
+
+    float pattern[N * Pack::WIDTH];
+    for (unsigned i = 0; i < N * Pack::WIDTH; ++i) {
+
+        pattern[i] = value[i % N];
+    }
+    Pack::Type p[N];
+    for (unsigned k = 0; k < N; ++k) {
+
+        p[k] = Pack::load(pattern + k * Pack::WIDTH);
+    }
+
+    std::size_t count = n * N;
+    std::size_t i = 0;
+    for (; i + N * Pack::WIDTH <= count; i += N * Pack::WIDTH) {
+
+        for (unsigned k = 0; k < N; ++k) {
+
+            Pack::store(out + i + k * Pack::WIDTH, p[k]);
+        }
+    }
+    for (; i < count; ++i) {
+
+        out[i] = value[i % N];
+    }
+}
+
+/**Bilinearly samples a tiled grid of N component vectors at WIDTH interleaved
+2d coordinates*/
+template<unsigned N>
+inline void bilinearPack(
+        const float* data,
+        const util::vec::detail::GridLayout& layout,
+        const float* coordinates,
+        float* out) {
+
+    unsigned corners[4][Pack::WIDTH];
+    float fx[Pack::WIDTH];
+    float fy[Pack::WIDTH];
+    for (unsigned j = 0; j < Pack::WIDTH; ++j) {
+
+        util::vec::detail::locateTexel(layout, coordinates[j * 2],
+            coordinates[j * 2 + 1], corners[0][j], corners[1][j],
+            corners[2][j], corners[3][j], fx[j], fy[j]);
+    }
+
+    Pack::Type c00[N];
+    Pack::Type c10[N];
+    Pack::Type c01[N];
+    Pack::Type c11[N];
+    Pack::gatherInterleaved<N>(data, corners[0], c00);
+    Pack::gatherInterleaved<N>(data, corners[1], c10);
+    Pack::gatherInterleaved<N>(data, corners[2], c01);
+    Pack::gatherInterleaved<N>(data, corners[3], c11);
+
+    Pack::Type px = Pack::load(fx);
+    Pack::Type py = Pack::load(fy);
+    for (unsigned c = 0; c < N; ++c) {
+
+        Pack::Type top = Pack::fmadd(Pack::sub(c10[c], c00[c]), px, c00[c]);
+        Pack::Type bottom =
+            Pack::fmadd(Pack::sub(c11[c], c01[c]), px, c01[c]);
+        c00[c] = Pack::fmadd(Pack::sub(bottom, top), py, top);
+    }
+    Pack::storeInterleaved<N>(out, c00);
+}
+
+/**Bilinearly samples a tiled grid of N component vectors at n interleaved 2d
+coordinates*/
+template<unsigned N>
+inline void bilinear(
+        const float* data,
+        const util::vec::detail::GridLayout& layout,
+        const float* coordinates,
+        float* out,
+        std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        bilinearPack<N>(data, layout, coordinates + i * 2, out + i * N);
+    }
+    if (i < n) {
+
+        float pc[2 * Pack::WIDTH] = {};
+        float po[N * Pack::WIDTH];
+        std::copy(coordinates + i * 2, coordinates + n * 2, pc);
+        bilinearPack<N>(data, layout, pc, po);
+        std::copy(po, po + (n - i) * N, out + i * N);
+    }
+}
@@ -0,0 +1,410 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//------------------------------------------------------------------------------
+//                                 PACK EVALUATORS
+//------------------------------------------------------------------------------
+// Each evaluator interpolates WIDTH interleaved vectors. The kernels run them
+// on whole packs of the arrays and once more on a padded copy of the tail.
+
+/**out = a + (b - a)t for WIDTH interleaved N component vectors*/
+template<unsigned N>
+inline void lerpPack(
+        const float* a, const float* b, const float* t, float* out) {
+
+    Pack::Type ca[N];
+    Pack::Type cb[N];
+    Pack::loadInterleaved<N>(a, ca);
+    Pack::loadInterleaved<N>(b, cb);
+
+    Pack::Type pt = Pack::load(t);
+    for (unsigned c = 0; c < N; ++c) {
+
+        ca[c] = Pack::fmadd(Pack::sub(cb[c], ca[c]), pt, ca[c]);
+    }
+    Pack::storeInterleaved<N>(out, ca);
+}
+
+/**Scales WIDTH 3d vectors to unit length*/
+inline void normalisePack(Pack::Type* c) {
+
+    Pack::Type length = Pack::sqrt(Pack::fmadd(c[0], c[0],
+        Pack::fmadd(c[1], c[1], Pack::mul(c[2], c[2]))));
+    for (unsigned k = 0; k < 3; ++k) {
+
+        c[k] = Pack::div(c[k], length);
+    }
+}
+
+/**Normalised linear interpolation of WIDTH interleaved 3d vectors*/
+inline void nlerpPack(
+        const float* a, const float* b, const float* t, float* out) {
+
+    Pack::Type ca[3];
+    Pack::Type cb[3];
+    Pack::loadInterleaved<3>(a, ca);
+    Pack::loadInterleaved<3>(b, cb);
+
+    Pack::Type pt = Pack::load(t);
+    for (unsigned c = 0; c < 3; ++c) {
+
+        ca[c] = Pack::fmadd(Pack::sub(cb[c], ca[c]), pt, ca[c]);
+    }
+    normalisePack(ca);
+    Pack::storeInterleaved<3>(out, ca);
+}
+
+/**Finds the sine and cosine of the angles between WIDTH pairs of unit 3d
+vectors*/
+inline void sineCosinePack(
+        const Pack::Type* a,
+        const Pack::Type* b,
+        Pack::Type& sine,
+        Pack::Type& cosine) {
+
+    cosine = Pack::fmadd(a[0], b[0],
+        Pack::fmadd(a[1], b[1], Pack::mul(a[2], b[2])));
+    Pack::Type cx = Pack::sub(Pack::mul(a[1], b[2]), Pack::mul(a[2], b[1]));
+    Pack::Type cy = Pack::sub(Pack::mul(a[2], b[0]), Pack::mul(a[0], b[2]));
+    Pack::Type cz = Pack::sub(Pack::mul(a[0], b[1]), Pack::mul(a[1], b[0]));
+    sine = Pack::sqrt(Pack::fmadd(cx, cx,
+        Pack::fmadd(cy, cy, Pack::mul(cz, cz))));
+}
+
+/**Finds unit vectors perpendicular to WIDTH unit 3d vectors, made from their
+two largest components like util::vec::detail::perpendicular()*/
+inline void perpendicularPack(const Pack::Type* v, Pack::Type* out) {
+
+    const Pack::Type zero = Pack::zero();
+
+    Pack::Mask xLarger = Pack::cmpLt(Pack::abs(v[2]), Pack::abs(v[0]));
+    out[0] = Pack::select(xLarger, Pack::sub(zero, v[1]), zero);
+    out[1] = Pack::select(xLarger, v[0], Pack::sub(zero, v[2]));
+    out[2] = Pack::select(xLarger, zero, v[1]);
+    normalisePack(out);
+}
+
+/**Spherical linear interpolation of WIDTH interleaved unit 3d vectors*/
+inline void slerpPack(
+        const float* a, const float* b, const float* t, float* out) {
+
+    const util::math::TrigPrecision P = util::math::TRIG_PRECISE;
+    const Pack::Type one = Pack::set(1.0f);
+    const Pack::Type threshold = Pack::set(1.0e-4f);
+
+    Pack::Type ca[3];
+    Pack::Type cb[3];
+    Pack::loadInterleaved<3>(a, ca);
+    Pack::loadInterleaved<3>(b, cb);
+    Pack::Type pt = Pack::load(t);
+
+    //the angle between the vectors from the sine and cosine of the angle,
+    //which stays accurate where acos of the dot product would not
+    Pack::Type sine;
+    Pack::Type cosine;
+    sineCosinePack(ca, cb, sine, cosine);
+
+    //nearly opposite vectors are interpolated through a vector perpendicular
+    //to a, from a to it over the first half of t and from it to b over the
+    //second
+    Pack::Mask opposite = Pack::maskAnd(
+        Pack::cmpLt(sine, threshold), Pack::cmpLt(cosine, Pack::zero()));
+    if (Pack::maskBits(opposite) != 0) {
+
+        Pack::Type middle[3];
+        perpendicularPack(ca, middle);
+        Pack::Type twice = Pack::add(pt, pt);
+        Pack::Mask second = Pack::maskAnd(opposite, Pack::cmpLe(one, twice));
+        for (unsigned c = 0; c < 3; ++c) {
+
+            ca[c] = Pack::select(second, middle[c], ca[c]);
+            cb[c] = Pack::select(
+                opposite, Pack::select(second, cb[c], middle[c]), cb[c]);
+        }
+        pt = Pack::select(opposite,
+            Pack::select(second, Pack::sub(twice, one), twice), pt);
+        sineCosinePack(ca, cb, sine, cosine);
+    }
+    Pack::Type angle = atan2<P>(sine, cosine);
+
+    Pack::Type s0;
+    Pack::Type s1;
+    Pack::Type unused;
+    sincos<P>(Pack::mul(Pack::sub(one, pt), angle), s0, unused);
+    sincos<P>(Pack::mul(pt, angle), s1, unused);
+
+    //nearly parallel vectors fall back to normalised linear interpolation
+    Pack::Mask parallel = Pack::cmpLt(sine, threshold);
+    Pack::Type inverse = Pack::div(one, sine);
+    Pack::Type w0 = Pack::select(parallel,
+        Pack::sub(one, pt), Pack::mul(s0, inverse));
+    Pack::Type w1 = Pack::select(parallel, pt, Pack::mul(s1, inverse));
+
+    Pack::Type r[3];
+    for (unsigned c = 0; c < 3; ++c) {
+
+        r[c] = Pack::fmadd(ca[c], w0, Pack::mul(cb[c], w1));
+    }
+    Pack::Type length = Pack::select(parallel, Pack::sqrt(Pack::fmadd(r[0],
+        r[0], Pack::fmadd(r[1], r[1], Pack::mul(r[2], r[2])))),
+        Pack::set(1.0f));
+    for (unsigned c = 0; c < 3; ++c) {
+
+        r[c] = Pack::div(r[c], length);
+    }
+    Pack::storeInterleaved<3>(out, r);
+}
+
+/**Finds the key or control point indices and local parameters of WIDTH track
+parameters
+@param t the track parameters
+@param segments the number of segments in the track
+@param stride the number of points between the starts of segments
+@param centred whether the four points are centred on the segment, as they
+are for Catmull-Rom splines, rather than starting at it
+@param pointCount the number of points in the track
+@param indices returns the WIDTH indices of each of the four points
+@param local returns the local parameter of each lane*/
+inline void locateSegments(
+        const float* t,
+        std::size_t segments,
+        std::size_t stride,
+        bool centred,
+        std::size_t pointCount,
+        unsigned (*indices)[Pack::WIDTH],
+        float* local) {
+
+    float last = static_cast<float>(segments);
+    std::size_t lastPoint = pointCount - 1;
+    for (unsigned j = 0; j < Pack::WIDTH; ++j) {
+
+        //clamp to the track, also sending NaN to the start
+        float u = t[j] > 0.0f ? (t[j] < last ? t[j] : last) : 0.0f;
+        std::size_t segment = static_cast<std::size_t>(u);
+        if (segment >= segments) {
+
+            segment = segments > 0 ? segments - 1 : 0;
+        }
+        local[j] = u - static_cast<float>(segment);
+
+        //points beyond either end of the track repeat the end point
+        std::size_t start = segment * stride;
+        for (unsigned k = 0; k < 4; ++k) {
+
+            std::size_t index = start + k;
+            if (centred) {
+
+                index = index > 0 ? index - 1 : 0;
+            }
+            indices[k][j] = static_cast<unsigned>(
+                index < lastPoint ? index : lastPoint);
+        }
+    }
+}
+
+/**Evaluates a uniform Catmull-Rom spline through keys at WIDTH parameters*/
+template<unsigned N>
+inline void catmullRomPack(
+        const float* keys, std::size_t keyCount, const float* t, float* out) {
+
+    unsigned indices[4][Pack::WIDTH];
+    float local[Pack::WIDTH];
+    locateSegments(t, keyCount - 1, 1, true, keyCount, indices, local);
+
+    Pack::Type p[4][N];
+    for (unsigned k = 0; k < 4; ++k) {
+
+        Pack::gatherInterleaved<N>(keys, indices[k], p[k]);
+    }
+
+    Pack::Type u = Pack::load(local);
+    Pack::Type r[N];
+    for (unsigned c = 0; c < N; ++c) {
+
+        Pack::Type p0 = p[0][c];
+        Pack::Type p1 = p[1][c];
+        Pack::Type p2 = p[2][c];
+        Pack::Type p3 = p[3][c];
+
+        //2p1 + (p2 - p0)u + (2p0 - 5p1 + 4p2 - p3)u^2 +
+        //(3p1 - 3p2 + p3 - p0)u^3, halved
+        Pack::Type b = Pack::sub(p2, p0);
+        Pack::Type cc = Pack::sub(Pack::fmadd(Pack::set(2.0f), p0,
+            Pack::fmadd(Pack::set(4.0f), p2,
+            Pack::mul(Pack::set(-5.0f), p1))), p3);
+        Pack::Type d = Pack::sub(Pack::fmadd(Pack::set(3.0f),
+            Pack::sub(p1, p2), p3), p0);
+
+        Pack::Type sum = Pack::fmadd(d, u, cc);
+        sum = Pack::fmadd(sum, u, b);
+        sum = Pack::fmadd(sum, u, Pack::add(p1, p1));
+        r[c] = Pack::mul(sum, Pack::set(0.5f));
+    }
+    Pack::storeInterleaved<N>(out, r);
+}
+
+/**Evaluates a piecewise cubic Bezier curve at WIDTH parameters*/
+template<unsigned N>
+inline void bezierPack(
+        const float* controls,
+        std::size_t controlCount,
+        const float* t,
+        float* out) {
+
+    unsigned indices[4][Pack::WIDTH];
+    float local[Pack::WIDTH];
+    locateSegments(
+        t, (controlCount - 1) / 3, 3, false, controlCount, indices, local);
+
+    Pack::Type u = Pack::load(local);
+    Pack::Type v = Pack::sub(Pack::set(1.0f), u);
+    Pack::Type w[4];
+    w[0] = Pack::mul(Pack::mul(v, v), v);
+    w[1] = Pack::mul(Pack::mul(Pack::set(3.0f), Pack::mul(v, v)), u);
+    w[2] = Pack::mul(Pack::mul(Pack::set(3.0f), Pack::mul(u, u)), v);
+    w[3] = Pack::mul(Pack::mul(u, u), u);
+
+    Pack::Type r[N];
+    for (unsigned c = 0; c < N; ++c) {
+
+        r[c] = Pack::zero();
+    }
+    for (unsigned k = 0; k < 4; ++k) {
+
+        Pack::Type p[N];
+        Pack::gatherInterleaved<N>(controls, indices[k], p);
+        for (unsigned c = 0; c < N; ++c) {
+
+            r[c] = Pack::fmadd(p[c], w[k], r[c]);
+        }
+    }
+    Pack::storeInterleaved<N>(out, r);
+}
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**out[i] = lerp(a[i], b[i], t[i]) for interleaved N component vectors*/
+template<unsigned N>
+inline void lerp(
+        const float* a,
+        const float* b,
+        const float* t,
+        float* out,
+        std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        lerpPack<N>(a + i * N, b + i * N, t + i, out + i * N);
+    }
+    if (i < n) {
+
+        float pa[N * Pack::WIDTH] = {};
+        float pb[N * Pack::WIDTH] = {};
+        float pt[Pack::WIDTH] = {};
+        float po[N * Pack::WIDTH];
+        std::copy(a + i * N, a + n * N, pa);
+        std::copy(b + i * N, b + n * N, pb);
+        std::copy(t + i, t + n, pt);
+        lerpPack<N>(pa, pb, pt, po);
+        std::copy(po, po + (n - i) * N, out + i * N);
+    }
+}
+
+/**out[i] = nlerp(a[i], b[i], t[i]) or slerp(a[i], b[i], t[i]) for
+interleaved 3d vectors*/
+template<bool SPHERICAL>
+inline void interpolateUnit(
+        const float* a,
+        const float* b,
+        const float* t,
+        float* out,
+        std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        if (SPHERICAL) {
+
+            slerpPack(a + i * 3, b + i * 3, t + i, out + i * 3);
+        }
+        else {
+
+            nlerpPack(a + i * 3, b + i * 3, t + i, out + i * 3);
+        }
+    }
+    if (i < n) {
+
+        //the padding lanes interpolate unit x with itself
+        float pa[3 * Pack::WIDTH] = {};
+        float pb[3 * Pack::WIDTH] = {};
+        float pt[Pack::WIDTH] = {};
+        float po[3 * Pack::WIDTH];
+        for (unsigned j = 0; j < Pack::WIDTH; ++j) {
+
+            pa[j * 3] = 1.0f;
+            pb[j * 3] = 1.0f;
+        }
+        std::copy(a + i * 3, a + n * 3, pa);
+        std::copy(b + i * 3, b + n * 3, pb);
+        std::copy(t + i, t + n, pt);
+        if (SPHERICAL) {
+
+            slerpPack(pa, pb, pt, po);
+        }
+        else {
+
+            nlerpPack(pa, pb, pt, po);
+        }
+        std::copy(po, po + (n - i) * 3, out + i * 3);
+    }
+}
+
+/**Samples a uniform Catmull-Rom spline through keys at n parameters*/
+template<unsigned N>
+inline void catmullRom(
+        const float* keys,
+        std::size_t keyCount,
+        const float* t,
+        float* out,
+        std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        catmullRomPack<N>(keys, keyCount, t + i, out + i * N);
+    }
+    if (i < n) {
+
+        float pt[Pack::WIDTH] = {};
+        float po[N * Pack::WIDTH];
+        std::copy(t + i, t + n, pt);
+        catmullRomPack<N>(keys, keyCount, pt, po);
+        std::copy(po, po + (n - i) * N, out + i * N);
+    }
+}
+
+/**Samples a piecewise cubic Bezier curve at n parameters*/
+template<unsigned N>
+inline void bezier(
+        const float* controls,
+        std::size_t controlCount,
+        const float* t,
+        float* out,
+        std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        bezierPack<N>(controls, controlCount, t + i, out + i * N);
+    }
+    if (i < n) {
+
+        float pt[Pack::WIDTH] = {};
+        float po[N * Pack::WIDTH];
+        std::copy(t + i, t + n, pt);
+        bezierPack<N>(controls, controlCount, pt, po);
+        std::copy(po, po + (n - i) * N, out + i * N);
+    }
+}
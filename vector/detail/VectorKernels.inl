@@ -0,0 +1,333 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//------------------------------------------------------------------------------
+//                              COMPONENT KERNELS
+//------------------------------------------------------------------------------
+// These treat vector arrays as flat arrays of floats so count is the number of
+// vectors multiplied by the number of components.
+
+/**out = a + b for each component*/
+inline void add(const float* a, const float* b, float* out, std::size_t count) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+
+        Pack::store(out + i, Pack::add(Pack::load(a + i), Pack::load(b + i)));
+    }
+    for (; i < count; ++i) {
+
+        out[i] = a[i] + b[i];
+    }
+}
+
+/**out = a - b for each component*/
+inline void subtract(
+        const float* a, const float* b, float* out, std::size_t count) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+
+        Pack::store(out + i, Pack::sub(Pack::load(a + i), Pack::load(b + i)));
+    }
+    for (; i < count; ++i) {
+
+        out[i] = a[i] - b[i];
+    }
+}
+
+/**out = a + scalar for each component*/
+inline void addScalar(
+        const float* a, float scalar, float* out, std::size_t count) {
+
+    const Pack::Type s = Pack::set(scalar);
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+
+        Pack::store(out + i, Pack::add(Pack::load(a + i), s));
+    }
+    for (; i < count; ++i) {
+
+        out[i] = a[i] + scalar;
+    }
+}
+
+/**out = a * scalar for each component*/
+inline void multiplyScalar(
+        const float* a, float scalar, float* out, std::size_t count) {
+
+    const Pack::Type s = Pack::set(scalar);
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+
+        Pack::store(out + i, Pack::mul(Pack::load(a + i), s));
+    }
+    for (; i < count; ++i) {
+
+        out[i] = a[i] * scalar;
+    }
+}
+
+/**out = a / scalar for each component*/
+inline void divideScalar(
+        const float* a, float scalar, float* out, std::size_t count) {
+
+    const Pack::Type s = Pack::set(scalar);
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+
+        Pack::store(out + i, Pack::div(Pack::load(a + i), s));
+    }
+    for (; i < count; ++i) {
+
+        out[i] = a[i] / scalar;
+    }
+}
+
+//------------------------------------------------------------------------------
+//                                VECTOR KERNELS
+//------------------------------------------------------------------------------
+// These operate on n interleaved vectors of N components. Each block of WIDTH
+// vectors is split into one pack per component so every lane works on a whole
+// vector.
+
+/**out[i] = dot(a[i], b[i])*/
+template<unsigned N>
+inline void dot(const float* a, const float* b, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type ca[N];
+        Pack::Type cb[N];
+        Pack::loadInterleaved<N>(a + i * N, ca);
+        Pack::loadInterleaved<N>(b + i * N, cb);
+
+        Pack::Type sum = Pack::mul(ca[0], cb[0]);
+        for (unsigned c = 1; c < N; ++c) {
+
+            sum = Pack::fmadd(ca[c], cb[c], sum);
+        }
+        Pack::store(out + i, sum);
+    }
+    for (; i < n; ++i) {
+
+        float sum = a[i * N] * b[i * N];
+        for (unsigned c = 1; c < N; ++c) {
+
+            sum += a[i * N + c] * b[i * N + c];
+        }
+        out[i] = sum;
+    }
+}
+
+/**out[i] = magnitude(v[i])*/
+template<unsigned N>
+inline void magnitude(const float* v, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[N];
+        Pack::loadInterleaved<N>(v + i * N, c);
+
+        Pack::Type sum = Pack::mul(c[0], c[0]);
+        for (unsigned j = 1; j < N; ++j) {
+
+            sum = Pack::fmadd(c[j], c[j], sum);
+        }
+        Pack::store(out + i, Pack::sqrt(sum));
+    }
+    for (; i < n; ++i) {
+
+        float sum = v[i * N] * v[i * N];
+        for (unsigned j = 1; j < N; ++j) {
+
+            sum += v[i * N + j] * v[i * N + j];
+        }
+        out[i] = std::sqrt(sum);
+    }
+}
+
+/**out[i] = normalise(v[i])*/
+template<unsigned N>
+inline void normalise(const float* v, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[N];
+        Pack::loadInterleaved<N>(v + i * N, c);
+
+        Pack::Type sum = Pack::mul(c[0], c[0]);
+        for (unsigned j = 1; j < N; ++j) {
+
+            sum = Pack::fmadd(c[j], c[j], sum);
+        }
+        //divide rather than multiply by a reciprocal, which would round
+        //twice, though the fused sum of squares may still differ from the
+        //scalar normalise() in the last bit
+        Pack::Type mag = Pack::sqrt(sum);
+        for (unsigned j = 0; j < N; ++j) {
+
+            c[j] = Pack::div(c[j], mag);
+        }
+        Pack::storeInterleaved<N>(out + i * N, c);
+    }
+    for (; i < n; ++i) {
+
+        float sum = v[i * N] * v[i * N];
+        for (unsigned j = 1; j < N; ++j) {
+
+            sum += v[i * N + j] * v[i * N + j];
+        }
+        float mag = std::sqrt(sum);
+        for (unsigned j = 0; j < N; ++j) {
+
+            out[i * N + j] = v[i * N + j] / mag;
+        }
+    }
+}
+
+/**out[i] = distance(a[i], b[i])*/
+template<unsigned N>
+inline void distance(
+        const float* a, const float* b, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type ca[N];
+        Pack::Type cb[N];
+        Pack::loadInterleaved<N>(a + i * N, ca);
+        Pack::loadInterleaved<N>(b + i * N, cb);
+
+        Pack::Type d = Pack::sub(ca[0], cb[0]);
+        Pack::Type sum = Pack::mul(d, d);
+        for (unsigned c = 1; c < N; ++c) {
+
+            d = Pack::sub(ca[c], cb[c]);
+            sum = Pack::fmadd(d, d, sum);
+        }
+        Pack::store(out + i, Pack::sqrt(sum));
+    }
+    for (; i < n; ++i) {
+
+        float sum = 0.0f;
+        for (unsigned c = 0; c < N; ++c) {
+
+            float d = a[i * N + c] - b[i * N + c];
+            sum += d * d;
+        }
+        out[i] = std::sqrt(sum);
+    }
+}
+
+//the products of the cross product are rounded on their own, as fusing one
+//into the subtraction makes cross(a, a) non-zero and cross(a, b) differ from
+//-cross(b, a), and GCC otherwise fuses them
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC push_options
+#   pragma GCC optimize("fp-contract=off")
+#endif
+
+/**out[i] = cross(a[i], b[i]) for three component vectors*/
+inline void cross(const float* a, const float* b, float* out, std::size_t n) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type ca[3];
+        Pack::Type cb[3];
+        Pack::loadInterleaved<3>(a + i * 3, ca);
+        Pack::loadInterleaved<3>(b + i * 3, cb);
+
+        Pack::Type c[3];
+        for (unsigned j = 0; j < 3; ++j) {
+
+            unsigned k = (j + 1) % 3;
+            unsigned l = (j + 2) % 3;
+            c[j] = Pack::sub(
+                Pack::mul(ca[k], cb[l]), Pack::mul(ca[l], cb[k]));
+        }
+        Pack::storeInterleaved<3>(out + i * 3, c);
+    }
+    for (; i < n; ++i) {
+
+        float c[3];
+        for (unsigned j = 0; j < 3; ++j) {
+
+            unsigned k = (j + 1) % 3;
+            unsigned l = (j + 2) % 3;
+            c[j] = a[i * 3 + k] * b[i * 3 + l] - a[i * 3 + l] * b[i * 3 + k];
+        }
+        for (unsigned j = 0; j < 3; ++j) {
+
+            out[i * 3 + j] = c[j];
+        }
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC pop_options
+#endif
+
+/**out[i] = matrix * v[i] where matrix is a row-major 4x4 matrix. Two and three
+component vectors are treated as points (z = 0 and w = 1) and only the rows of
+their components are used*/
+template<unsigned N>
+inline void transform(
+        const float* v, const float* matrix, float* out, std::size_t n) {
+
+    Pack::Type m[4][4];
+    for (unsigned r = 0; r < 4; ++r) {
+
+        for (unsigned c = 0; c < 4; ++c) {
+
+            m[r][c] = Pack::set(matrix[r * 4 + c]);
+        }
+    }
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[N];
+        Pack::loadInterleaved<N>(v + i * N, c);
+
+        Pack::Type r[N];
+        for (unsigned row = 0; row < N; ++row) {
+
+            //the implicit w of a point is 1 so its column is a translation
+            Pack::Type sum = N < 4 ?
+                m[row][3] :
+                Pack::mul(m[row][3], c[3 % N]);
+            for (unsigned col = 0; col < N && col < 3; ++col) {
+
+                sum = Pack::fmadd(m[row][col], c[col], sum);
+            }
+            r[row] = sum;
+        }
+        Pack::storeInterleaved<N>(out + i * N, r);
+    }
+    for (; i < n; ++i) {
+
+        float r[N];
+        for (unsigned row = 0; row < N; ++row) {
+
+            float sum = N < 4 ?
+                matrix[row * 4 + 3] :
+                matrix[row * 4 + 3] * v[i * N + 3 % N];
+            for (unsigned col = 0; col < N && col < 3; ++col) {
+
+                sum += matrix[row * 4 + col] * v[i * N + col];
+            }
+            r[row] = sum;
+        }
+        for (unsigned row = 0; row < N; ++row) {
+
+            out[i * N + row] = r[row];
+        }
+    }
+}
@@ -0,0 +1,159 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//the cross product of parallel edges is only exactly zero if each product is
+//rounded on its own, and GCC otherwise fuses them into the subtraction
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC push_options
+#   pragma GCC optimize("fp-contract=off")
+#endif
+
+//------------------------------------------------------------------------------
+//                                 PACK EVALUATORS
+//------------------------------------------------------------------------------
+
+/**Finds the unit normals of a pack of triangles and the weight each corner
+gives the normal in its vertex normal
+@param positions the interleaved positions of the vertices
+@param corners the indices of the first, second, and third corners of each
+triangle of the pack
+@param normal returns the x, y, and z components of the unit normals, which
+are 0 for triangles without area
+@param weight returns the weight of each corner: twice the area of the
+triangle, or the angle of the corner if ANGLES is set*/
+template<bool ANGLES>
+inline void trianglePack(
+        const float* positions,
+        const unsigned (*corners)[Pack::WIDTH],
+        Pack::Type* normal,
+        Pack::Type* weight) {
+
+    Pack::Type p[3][3];
+    for (unsigned k = 0; k < 3; ++k) {
+
+        Pack::gatherInterleaved<3>(positions, corners[k], p[k]);
+    }
+
+    Pack::Type e[3][3];
+    for (unsigned k = 0; k < 3; ++k) {
+
+        for (unsigned c = 0; c < 3; ++c) {
+
+            //e[k] runs from corner k to the next corner
+            e[k][c] = Pack::sub(p[(k + 1) % 3][c], p[k][c]);
+        }
+    }
+
+    //the cross product of the edges from the first corner
+    Pack::Type n[3];
+    for (unsigned c = 0; c < 3; ++c) {
+
+        unsigned u = (c + 1) % 3;
+        unsigned v = (c + 2) % 3;
+        n[c] = Pack::sub(Pack::mul(e[0][u], Pack::sub(Pack::zero(), e[2][v])),
+            Pack::mul(e[0][v], Pack::sub(Pack::zero(), e[2][u])));
+    }
+
+    Pack::Type areaSquared = Pack::fmadd(n[0], n[0],
+        Pack::fmadd(n[1], n[1], Pack::mul(n[2], n[2])));
+    Pack::Type area = Pack::sqrt(areaSquared);
+
+    //the area is the product of the lengths of the edges and the sine of the
+    //angle between them, so slivers are found relative to the edges
+    Pack::Type lengths[2];
+    for (unsigned k = 0; k < 2; ++k) {
+
+        const Pack::Type* edge = e[k * 2];
+        lengths[k] = Pack::fmadd(edge[0], edge[0],
+            Pack::fmadd(edge[1], edge[1], Pack::mul(edge[2], edge[2])));
+    }
+    Pack::Mask solid = Pack::cmpLt(
+        Pack::mul(Pack::mul(lengths[0], lengths[1]),
+            Pack::set(MESH_SLIVER_SINE * MESH_SLIVER_SINE)),
+        areaSquared);
+    for (unsigned c = 0; c < 3; ++c) {
+
+        normal[c] = Pack::select(solid, Pack::div(n[c], area), Pack::zero());
+    }
+
+    if (!ANGLES) {
+
+        for (unsigned k = 0; k < 3; ++k) {
+
+            weight[k] = area;
+        }
+
+        return;
+    }
+
+    //the angle at corner k is between the edge leaving it and the reversed
+    //edge arriving at it, and the sine of every corner is proportional to
+    //the area
+    for (unsigned k = 0; k < 3; ++k) {
+
+        const Pack::Type* out = e[k];
+        const Pack::Type* in = e[(k + 2) % 3];
+        Pack::Type d = Pack::mul(out[0], in[0]);
+        d = Pack::fmadd(out[1], in[1], d);
+        d = Pack::fmadd(out[2], in[2], d);
+        weight[k] = Pack::select(solid,
+            atan2<util::math::TRIG_PRECISE>(area, Pack::sub(Pack::zero(), d)),
+            Pack::zero());
+    }
+}
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**Finds the unit normals of n triangles, and the weights of their corners if
+weights is not null*/
+template<bool ANGLES>
+inline void triangleNormals(
+        const float* positions,
+        const unsigned* indices,
+        std::size_t n,
+        float* normals,
+        float* weights) {
+
+    for (std::size_t i = 0; i < n; i += Pack::WIDTH) {
+
+        //the lanes past the last triangle repeat it
+        unsigned corners[3][Pack::WIDTH];
+        for (unsigned j = 0; j < Pack::WIDTH; ++j) {
+
+            std::size_t t = i + j < n ? i + j : n - 1;
+            for (unsigned k = 0; k < 3; ++k) {
+
+                corners[k][j] = indices[t * 3 + k];
+            }
+        }
+
+        Pack::Type normal[3];
+        Pack::Type weight[3];
+        trianglePack<ANGLES>(positions, corners, normal, weight);
+
+        std::size_t count = n - i < Pack::WIDTH ? n - i : Pack::WIDTH;
+        if (count == Pack::WIDTH) {
+
+            Pack::storeInterleaved<3>(normals + i * 3, normal);
+            if (weights) {
+
+                Pack::storeInterleaved<3>(weights + i * 3, weight);
+            }
+            continue;
+        }
+
+        float block[Pack::WIDTH * 3];
+        Pack::storeInterleaved<3>(block, normal);
+        std::copy(block, block + count * 3, normals + i * 3);
+        if (weights) {
+
+            Pack::storeInterleaved<3>(block, weight);
+            std::copy(block, block + count * 3, weights + i * 3);
+        }
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC pop_options
+#endif
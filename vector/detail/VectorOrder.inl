@@ -0,0 +1,83 @@
+//no include guard: compiled with and without BMI2 by VectorOrder.hpp
+
+/**Spreads the low 64 / N bits of x so that there are N - 1 zero bits between
+each of them, with pdep when UTIL_ORDER_PDEP is set and with shifts and masks
+otherwise*/
+template<unsigned N>
+inline std::uint64_t spreadBits(std::uint32_t x);
+
+template<>
+inline std::uint64_t spreadBits<2>(std::uint32_t x) {
+
+#if UTIL_ORDER_PDEP
+
+    return _pdep_u64(x, 0x5555555555555555ULL);
+
+#else
+
+    std::uint64_t s = x;
+    s = (s | (s << 16)) & 0x0000FFFF0000FFFFULL;
+    s = (s | (s << 8))  & 0x00FF00FF00FF00FFULL;
+    s = (s | (s << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+    s = (s | (s << 2))  & 0x3333333333333333ULL;
+    s = (s | (s << 1))  & 0x5555555555555555ULL;
+
+    return s;
+
+#endif
+}
+
+template<>
+inline std::uint64_t spreadBits<3>(std::uint32_t x) {
+
+#if UTIL_ORDER_PDEP
+
+    return _pdep_u64(x, 0x1249249249249249ULL);
+
+#else
+
+    std::uint64_t s = x & 0x1FFFFFu;
+    s = (s | (s << 32)) & 0x001F00000000FFFFULL;
+    s = (s | (s << 16)) & 0x001F0000FF0000FFULL;
+    s = (s | (s << 8))  & 0x100F00F00F00F00FULL;
+    s = (s | (s << 4))  & 0x10C30C30C30C30C3ULL;
+    s = (s | (s << 2))  & 0x1249249249249249ULL;
+
+    return s;
+
+#endif
+}
+
+/**Encodes n interleaved N component vectors as Morton or Hilbert codes
+@param v the vectors
+@param n the number of vectors
+@param lower the lower corner of the grid
+@param scale the number of grid cells per unit along each axis
+@param codes returns the codes*/
+template<unsigned N, bool HILBERT>
+inline void encodeOrder(
+        const float* v,
+        std::size_t n,
+        const double* lower,
+        const double* scale,
+        std::uint64_t* codes) {
+
+    for (std::size_t i = 0; i < n; ++i) {
+
+        std::uint32_t q[N];
+        quantiseOrder<N>(v + i * N, lower, scale, q);
+        if (HILBERT) {
+
+            hilbertTranspose<N, ORDER_BITS / N>(q);
+        }
+
+        //the Hilbert transpose puts the most significant bit of each group in
+        //its first axis, Morton codes put the first axis in the lowest bit
+        std::uint64_t code = 0;
+        for (unsigned k = 0; k < N; ++k) {
+
+            code |= spreadBits<N>(q[HILBERT ? N - 1 - k : k]) << k;
+        }
+        codes[i] = code;
+    }
+}
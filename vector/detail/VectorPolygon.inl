@@ -0,0 +1,99 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//points on an edge or vertex are only classified as crossesEdge() classifies
+//them if each product of the side test is rounded on its own, and GCC
+//otherwise fuses them into the subtraction
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC push_options
+#   pragma GCC optimize("fp-contract=off")
+#endif
+
+//------------------------------------------------------------------------------
+//                                 PACK EVALUATORS
+//------------------------------------------------------------------------------
+
+/**Tests a pack of points against every edge of a polygon with the even-odd
+rule, see crossesEdge() for the test of each edge
+@param x the x components of the points
+@param y the y components of the points
+@param polygon the interleaved vertices of the polygon
+@param count the number of vertices
+@return a pack that is negative in the lanes of the points inside*/
+inline Pack::Type insidePack(
+        Pack::Type x, Pack::Type y, const float* polygon, std::size_t count) {
+
+    const Pack::Type zero = Pack::zero();
+    const Pack::Type one = Pack::set(1.0f);
+
+    //the sign flips each time a ray from the point towards +x crosses an edge
+    Pack::Type parity = one;
+    const float* a = polygon + (count - 1) * 2;
+    for (std::size_t i = 0; i < count; ++i) {
+
+        const float* b = polygon + i * 2;
+
+        //+1 if only b is above the point, -1 if only a is
+        Pack::Type ay = Pack::set(a[1]);
+        Pack::Type by = Pack::set(b[1]);
+        Pack::Type up = Pack::sub(
+            Pack::select(Pack::cmpLt(y, by), one, zero),
+            Pack::select(Pack::cmpLt(y, ay), one, zero));
+
+        Pack::Type ax = Pack::set(a[0]);
+        Pack::Type side = Pack::sub(
+            Pack::mul(Pack::sub(x, ax), Pack::set(b[1] - a[1])),
+            Pack::mul(Pack::set(b[0] - a[0]), Pack::sub(y, ay)));
+
+        Pack::Mask crosses = Pack::cmpLt(Pack::mul(up, side), zero);
+        parity = Pack::select(crosses, Pack::sub(zero, parity), parity);
+        a = b;
+    }
+
+    return parity;
+}
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**Tests whether each of n interleaved 2d points is inside a polygon*/
+inline void insidePolygon(
+        const float* points,
+        std::size_t n,
+        const float* polygon,
+        std::size_t count,
+        bool* inside) {
+
+    const Pack::Type zero = Pack::zero();
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[2];
+        Pack::loadInterleaved<2>(points + i * 2, c);
+        unsigned bits = Pack::maskBits(
+            Pack::cmpLt(insidePack(c[0], c[1], polygon, count), zero));
+        for (unsigned j = 0; j < Pack::WIDTH; ++j) {
+
+            inside[i + j] = ((bits >> j) & 1u) != 0;
+        }
+    }
+
+    if (i < n) {
+
+        float tail[Pack::WIDTH * 2] = {};
+        std::copy(points + i * 2, points + n * 2, tail);
+        Pack::Type c[2];
+        Pack::loadInterleaved<2>(tail, c);
+        unsigned bits = Pack::maskBits(
+            Pack::cmpLt(insidePack(c[0], c[1], polygon, count), zero));
+        for (unsigned j = 0; i + j < n; ++j) {
+
+            inside[i + j] = ((bits >> j) & 1u) != 0;
+        }
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC pop_options
+#endif
@@ -0,0 +1,443 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//the error terms are only exact if every product is rounded on its own, and
+//GCC otherwise fuses products into the additions that follow them
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC push_options
+#   pragma GCC optimize("fp-contract=off")
+#endif
+
+//------------------------------------------------------------------------------
+//                                 PACK EVALUATORS
+//------------------------------------------------------------------------------
+// These take the pack type as a parameter so that the scalar tails of the
+// kernels run the same arithmetic through util::simd::PackScalar. The error
+// terms are exact on every instruction set, so the compensated results do not
+// depend on the instruction set. The compensated reductions keep REDUCE_LANES
+// running sums whatever the width of the pack, so they add up the same terms
+// in the same order everywhere too.
+
+//!the number of running sums of a compensated reduction, term i of the
+//!reduction is always added to sum i % REDUCE_LANES
+static const unsigned REDUCE_LANES = 16;
+
+/**@return the exact rounding error of p = a * b, from a fused multiply-add
+where the pack has one and otherwise from the products of halves of a and b
+that are exact (T. J. Dekker, 1971). Products above about 1e34 overflow the
+split*/
+template<typename P>
+inline typename P::Type productError(
+        typename P::Type a, typename P::Type b, typename P::Type p) {
+
+    if (P::FUSED) {
+
+        return P::fmadd(a, b, P::sub(P::zero(), p));
+    }
+
+    //2^12 + 1 splits the 24 bit significand of a float into two halves
+    const typename P::Type split = P::set(4097.0f);
+    typename P::Type ta = P::mul(a, split);
+    typename P::Type ah = P::sub(ta, P::sub(ta, a));
+    typename P::Type al = P::sub(a, ah);
+    typename P::Type tb = P::mul(b, split);
+    typename P::Type bh = P::sub(tb, P::sub(tb, b));
+    typename P::Type bl = P::sub(b, bh);
+
+    typename P::Type e = P::sub(P::mul(ah, bh), p);
+    e = P::add(e, P::mul(ah, bl));
+    e = P::add(e, P::mul(al, bh));
+
+    return P::add(e, P::mul(al, bl));
+}
+
+/**Adds x to a running sum and the exact rounding error of the addition to
+error (Knuth's two-sum)*/
+template<typename P>
+inline void twoSum(
+        typename P::Type& sum, typename P::Type& error, typename P::Type x) {
+
+    typename P::Type s = P::add(sum, x);
+    typename P::Type z = P::sub(s, sum);
+    error = P::add(error,
+        P::add(P::sub(sum, P::sub(s, z)), P::sub(x, z)));
+    sum = s;
+}
+
+/**Adds a * b to a running sum and the rounding errors of the product and the
+sum to error, so that sum + error is as accurate as a sum of products in twice
+the precision (T. Ogita, S. M. Rump and S. Oishi, "Accurate Sum and Dot
+Product", 2005)*/
+template<typename P>
+inline void twoProductSum(
+        typename P::Type& sum,
+        typename P::Type& error,
+        typename P::Type a,
+        typename P::Type b) {
+
+    typename P::Type p = P::mul(a, b);
+    error = P::add(error, productError<P>(a, b, p));
+    twoSum<P>(sum, error, p);
+}
+
+/**@return the compensated dot products of packs of N component vectors*/
+template<typename P, unsigned N>
+inline typename P::Type dotPack(
+        const typename P::Type* a, const typename P::Type* b) {
+
+    typename P::Type sum = P::zero();
+    typename P::Type error = P::zero();
+    for (unsigned c = 0; c < N; ++c) {
+
+        twoProductSum<P>(sum, error, a[c], b[c]);
+    }
+
+    return P::add(sum, error);
+}
+
+/**@return the compensated squared distances between packs of N component
+vectors. Each difference is carried as a rounded difference d and its error
+e, and the 2de term of its square is added to the error while the e^2 term is
+below it*/
+template<typename P, unsigned N>
+inline typename P::Type distanceSquaredPack(
+        const typename P::Type* a, const typename P::Type* b) {
+
+    typename P::Type sum = P::zero();
+    typename P::Type error = P::zero();
+    for (unsigned c = 0; c < N; ++c) {
+
+        typename P::Type d = a[c];
+        typename P::Type e = P::zero();
+        twoSum<P>(d, e, P::sub(P::zero(), b[c]));
+
+        twoProductSum<P>(sum, error, d, d);
+        error = P::fmadd(P::add(d, d), e, error);
+    }
+
+    return P::add(sum, error);
+}
+
+/**Computes the cross products of packs of three component vectors, each
+component as the difference of two products plus the exact errors of the
+products and of the difference*/
+template<typename P>
+inline void crossPack(
+        const typename P::Type* a,
+        const typename P::Type* b,
+        typename P::Type* out) {
+
+    for (unsigned j = 0; j < 3; ++j) {
+
+        unsigned k = (j + 1) % 3;
+        unsigned l = (j + 2) % 3;
+        typename P::Type p = P::mul(a[k], b[l]);
+        typename P::Type q = P::mul(a[l], b[k]);
+        typename P::Type e = P::sub(
+            productError<P>(a[k], b[l], p), productError<P>(a[l], b[k], q));
+        twoSum<P>(p, e, P::sub(P::zero(), q));
+        out[j] = P::add(p, e);
+    }
+}
+
+/**@return the sum of the lanes of a running sum and its error in double*/
+template<typename P>
+inline double laneTotal(typename P::Type sum, typename P::Type error) {
+
+    float s[P::WIDTH];
+    float e[P::WIDTH];
+    P::store(s, sum);
+    P::store(e, error);
+
+    double total = 0.0;
+    for (unsigned j = 0; j < P::WIDTH; ++j) {
+
+        total += static_cast<double>(s[j]) + static_cast<double>(e[j]);
+    }
+
+    return total;
+}
+
+/*****************************************************************************| The REDUCE_LANES running sums of a compensated reduction and their errors.  |
+| Whole blocks of REDUCE_LANES terms are added as packs, then the sums are    |
+| spilled so that the terms left over are added one at a time to the first   |
+| lanes, where they would go in a whole block.                                |
+\*****************************************************************************/
+struct LaneSums {
+
+    //!the number of packs the sums are held in
+    static const unsigned PACKS = REDUCE_LANES / Pack::WIDTH;
+
+    //!the running sums of the lanes
+    Pack::Type sum[PACKS];
+    //!the rounding errors of the lanes
+    Pack::Type error[PACKS];
+    //!the spilled running sums of the lanes
+    float spilledSum[REDUCE_LANES];
+    //!the spilled rounding errors of the lanes
+    float spilledError[REDUCE_LANES];
+
+    LaneSums() {
+
+        for (unsigned k = 0; k < PACKS; ++k) {
+
+            sum[k] = Pack::zero();
+            error[k] = Pack::zero();
+        }
+    }
+
+    /**Stores the sums of the packs to the spilled sums*/
+    inline void spill() {
+
+        for (unsigned k = 0; k < PACKS; ++k) {
+
+            Pack::store(spilledSum + k * Pack::WIDTH, sum[k]);
+            Pack::store(spilledError + k * Pack::WIDTH, error[k]);
+        }
+    }
+
+    /**@return the spilled sums and errors added in lane order in double*/
+    inline double total() const {
+
+        double result = 0.0;
+        for (unsigned j = 0; j < REDUCE_LANES; ++j) {
+
+            result += static_cast<double>(spilledSum[j]) +
+                static_cast<double>(spilledError[j]);
+        }
+
+        return result;
+    }
+};
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**out[i] = the compensated dot(a[i], b[i])*/
+template<unsigned N>
+inline void compensatedDot(
+        const float* a, const float* b, float* out, std::size_t n) {
+
+    typedef util::simd::PackScalar Scalar;
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type ca[N];
+        Pack::Type cb[N];
+        Pack::loadInterleaved<N>(a + i * N, ca);
+        Pack::loadInterleaved<N>(b + i * N, cb);
+        Pack::store(out + i, dotPack<Pack, N>(ca, cb));
+    }
+    for (; i < n; ++i) {
+
+        Scalar::Type ca[N];
+        Scalar::Type cb[N];
+        Scalar::loadInterleaved<N>(a + i * N, ca);
+        Scalar::loadInterleaved<N>(b + i * N, cb);
+        out[i] = dotPack<Scalar, N>(ca, cb);
+    }
+}
+
+/**out[i] = the compensated magnitude(v[i])*/
+template<unsigned N>
+inline void compensatedMagnitude(const float* v, float* out, std::size_t n) {
+
+    typedef util::simd::PackScalar Scalar;
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[N];
+        Pack::loadInterleaved<N>(v + i * N, c);
+        Pack::store(out + i, Pack::sqrt(dotPack<Pack, N>(c, c)));
+    }
+    for (; i < n; ++i) {
+
+        Scalar::Type c[N];
+        Scalar::loadInterleaved<N>(v + i * N, c);
+        out[i] = Scalar::sqrt(dotPack<Scalar, N>(c, c));
+    }
+}
+
+/**out[i] = the compensated distance(a[i], b[i])*/
+template<unsigned N>
+inline void compensatedDistance(
+        const float* a, const float* b, float* out, std::size_t n) {
+
+    typedef util::simd::PackScalar Scalar;
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type ca[N];
+        Pack::Type cb[N];
+        Pack::loadInterleaved<N>(a + i * N, ca);
+        Pack::loadInterleaved<N>(b + i * N, cb);
+        Pack::store(out + i,
+            Pack::sqrt(distanceSquaredPack<Pack, N>(ca, cb)));
+    }
+    for (; i < n; ++i) {
+
+        Scalar::Type ca[N];
+        Scalar::Type cb[N];
+        Scalar::loadInterleaved<N>(a + i * N, ca);
+        Scalar::loadInterleaved<N>(b + i * N, cb);
+        out[i] = Scalar::sqrt(distanceSquaredPack<Scalar, N>(ca, cb));
+    }
+}
+
+/**out[i] = the compensated cross(a[i], b[i])*/
+inline void compensatedCross(
+        const float* a, const float* b, float* out, std::size_t n) {
+
+    typedef util::simd::PackScalar Scalar;
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type ca[3];
+        Pack::Type cb[3];
+        Pack::Type c[3];
+        Pack::loadInterleaved<3>(a + i * 3, ca);
+        Pack::loadInterleaved<3>(b + i * 3, cb);
+        crossPack<Pack>(ca, cb, c);
+        Pack::storeInterleaved<3>(out + i * 3, c);
+    }
+    for (; i < n; ++i) {
+
+        Scalar::Type ca[3];
+        Scalar::Type cb[3];
+        Scalar::Type c[3];
+        Scalar::loadInterleaved<3>(a + i * 3, ca);
+        Scalar::loadInterleaved<3>(b + i * 3, cb);
+        crossPack<Scalar>(ca, cb, c);
+        Scalar::storeInterleaved<3>(out + i * 3, c);
+    }
+}
+
+/**@return the sum of a[i] * b[i] over count floats*/
+inline double productSum(const float* a, const float* b, std::size_t count) {
+
+    Pack::Type sum = Pack::zero();
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+
+        sum = Pack::fmadd(Pack::load(a + i), Pack::load(b + i), sum);
+    }
+
+    float tail = 0.0f;
+    for (; i < count; ++i) {
+
+        tail = util::simd::PackScalar::fmadd(a[i], b[i], tail);
+    }
+
+    return laneTotal<Pack>(sum, Pack::zero()) + tail;
+}
+
+/**@return the compensated sum of a[i] * b[i] over count floats*/
+inline double compensatedProductSum(
+        const float* a, const float* b, std::size_t count) {
+
+    typedef util::simd::PackScalar Scalar;
+
+    LaneSums lanes;
+    std::size_t i = 0;
+    for (; i + REDUCE_LANES <= count; i += REDUCE_LANES) {
+
+        for (unsigned k = 0; k < LaneSums::PACKS; ++k) {
+
+            std::size_t offset = i + k * Pack::WIDTH;
+            twoProductSum<Pack>(lanes.sum[k], lanes.error[k],
+                Pack::load(a + offset), Pack::load(b + offset));
+        }
+    }
+
+    lanes.spill();
+    for (unsigned j = 0; i < count; ++i, ++j) {
+
+        twoProductSum<Scalar>(
+            lanes.spilledSum[j], lanes.spilledError[j], a[i], b[i]);
+    }
+
+    return lanes.total();
+}
+
+/**@return the length of the path through n + 1 interleaved N component
+points*/
+template<unsigned N>
+inline double segmentSum(const float* points, std::size_t n) {
+
+    Pack::Type sum = Pack::zero();
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type ca[N];
+        Pack::Type cb[N];
+        Pack::loadInterleaved<N>(points + i * N, ca);
+        Pack::loadInterleaved<N>(points + (i + 1) * N, cb);
+
+        Pack::Type squared = Pack::zero();
+        for (unsigned c = 0; c < N; ++c) {
+
+            Pack::Type d = Pack::sub(ca[c], cb[c]);
+            squared = Pack::fmadd(d, d, squared);
+        }
+        sum = Pack::add(sum, Pack::sqrt(squared));
+    }
+
+    float tail = 0.0f;
+    for (; i < n; ++i) {
+
+        const float* a = points + i * N;
+        const float* b = a + N;
+
+        float squared = 0.0f;
+        for (unsigned c = 0; c < N; ++c) {
+
+            squared = util::simd::PackScalar::fmadd(
+                a[c] - b[c], a[c] - b[c], squared);
+        }
+        tail += std::sqrt(squared);
+    }
+
+    return laneTotal<Pack>(sum, Pack::zero()) + tail;
+}
+
+/**@return the compensated length of the path through n + 1 interleaved N
+component points*/
+template<unsigned N>
+inline double compensatedSegmentSum(const float* points, std::size_t n) {
+
+    typedef util::simd::PackScalar Scalar;
+
+    LaneSums lanes;
+    std::size_t i = 0;
+    for (; i + REDUCE_LANES <= n; i += REDUCE_LANES) {
+
+        for (unsigned k = 0; k < LaneSums::PACKS; ++k) {
+
+            const float* a = points + (i + k * Pack::WIDTH) * N;
+            Pack::Type ca[N];
+            Pack::Type cb[N];
+            Pack::loadInterleaved<N>(a, ca);
+            Pack::loadInterleaved<N>(a + N, cb);
+            twoSum<Pack>(lanes.sum[k], lanes.error[k],
+                Pack::sqrt(distanceSquaredPack<Pack, N>(ca, cb)));
+        }
+    }
+
+    lanes.spill();
+    for (unsigned j = 0; i < n; ++i, ++j) {
+
+        const float* a = points + i * N;
+        twoSum<Scalar>(lanes.spilledSum[j], lanes.spilledError[j],
+            Scalar::sqrt(distanceSquaredPack<Scalar, N>(a, a + N)));
+    }
+
+    return lanes.total();
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC pop_options
+#endif
@@ -0,0 +1,291 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//------------------------------------------------------------------------------
+//                                 PACK EVALUATORS
+//------------------------------------------------------------------------------
+
+/**Advances RANDOM_LANES xoshiro128++ generators stored as structure of arrays
+and turns each output into a uniform float in [0, 1). The lanes are
+independent so the compiler can run the loop on the integer registers of the
+instruction set*/
+inline void uniformBlock(std::uint32_t (*s)[RANDOM_LANES], float* u) {
+
+    for (unsigned j = 0; j < RANDOM_LANES; ++j) {
+
+        std::uint32_t sum = s[0][j] + s[3][j];
+        std::uint32_t result = ((sum << 7) | (sum >> 25)) + s[0][j];
+        std::uint32_t t = s[1][j] << 9;
+        s[2][j] ^= s[0][j];
+        s[3][j] ^= s[1][j];
+        s[1][j] ^= s[2][j];
+        s[0][j] ^= s[3][j];
+        s[2][j] ^= t;
+        s[3][j] = (s[3][j] << 11) | (s[3][j] >> 21);
+
+        u[j] = static_cast<float>(static_cast<std::int32_t>(result >> 8)) *
+            (1.0f / 16777216.0f);
+    }
+}
+
+/**Approximates the natural logarithm of each lane of x in (0, 1], to within
+3e-7 relative error for x >= 2^-24*/
+inline Pack::Type logUnit(Pack::Type x) {
+
+    //2 atanh(z) as an odd polynomial in z
+    static const float c[4] = { 2.0f, 2.0f / 3.0f, 2.0f / 5.0f, 2.0f / 7.0f };
+
+    //scale x into [1, 2) by powers of two, counting them in k
+    const Pack::Type two = Pack::set(2.0f);
+    Pack::Type k = Pack::zero();
+    for (unsigned step = 16; step > 0; step /= 2) {
+
+        Pack::Type scaled =
+            Pack::mul(x, Pack::set(static_cast<float>(1u << step)));
+        Pack::Mask fits = Pack::cmpLt(scaled, two);
+        x = Pack::select(fits, scaled, x);
+        k = Pack::select(fits,
+            Pack::add(k, Pack::set(static_cast<float>(step))), k);
+    }
+
+    //centre the range on 1 so that log(x) = 2 atanh((x - 1) / (x + 1)) with
+    //|(x - 1) / (x + 1)| below 0.172
+    Pack::Mask high = Pack::cmpLt(Pack::set(1.41421356f), x);
+    x = Pack::select(high, Pack::mul(x, Pack::set(0.5f)), x);
+    k = Pack::select(high, Pack::sub(k, Pack::set(1.0f)), k);
+
+    const Pack::Type one = Pack::set(1.0f);
+    Pack::Type z = Pack::div(Pack::sub(x, one), Pack::add(x, one));
+
+    return Pack::sub(oddPolynomial<4>(c, z),
+        Pack::mul(k, Pack::set(0.693147181f)));
+}
+
+/**@return the angles 2 pi u - pi in [-pi, pi) of uniforms u in [0, 1)*/
+inline Pack::Type uniformAngle(Pack::Type u) {
+
+    return Pack::fmadd(u, Pack::set(2.0f * util::math::detail::PI),
+        Pack::set(-util::math::detail::PI));
+}
+
+//----------------------------------SAMPLERS------------------------------------
+// Each sampler turns UNIFORMS packs of uniforms in [0, 1) into a pack of N
+// component vectors drawn from its distribution.
+
+/**Uniform in the box with params lower[N] and extent[N]*/
+template<unsigned N>
+struct BoxSampler {
+
+    static const unsigned COMPONENTS = N;
+    static const unsigned UNIFORMS = N;
+
+    static inline void sample(
+            const Pack::Type* u, const float* params, Pack::Type* c) {
+
+        for (unsigned k = 0; k < N; ++k) {
+
+            c[k] = Pack::fmadd(
+                u[k], Pack::set(params[N + k]), Pack::set(params[k]));
+        }
+    }
+};
+
+/**Uniform on or in the circle with params centre[2] and radius, the radius of
+a point in the disc is the larger of two uniforms whose distribution r^2 is
+the area within r*/
+template<bool FILLED>
+struct CircleSampler {
+
+    static const unsigned COMPONENTS = 2;
+    static const unsigned UNIFORMS = FILLED ? 3 : 1;
+
+    static inline void sample(
+            const Pack::Type* u, const float* params, Pack::Type* c) {
+
+        Pack::Type s;
+        Pack::Type cs;
+        sincos<util::math::TRIG_PRECISE>(uniformAngle(u[0]), s, cs);
+
+        Pack::Type radius = Pack::set(params[2]);
+        if (FILLED) {
+
+            radius = Pack::mul(radius, Pack::max(u[1], u[2]));
+        }
+        c[0] = Pack::fmadd(cs, radius, Pack::set(params[0]));
+        c[1] = Pack::fmadd(s, radius, Pack::set(params[1]));
+    }
+};
+
+/**Uniform on or in the sphere with params centre[3] and radius. Points on the
+sphere take a uniform height, and a point in the ball is scaled by the largest
+of three uniforms whose distribution r^3 is the volume within r*/
+template<bool FILLED>
+struct SphereSampler {
+
+    static const unsigned COMPONENTS = 3;
+    static const unsigned UNIFORMS = FILLED ? 5 : 2;
+
+    static inline void sample(
+            const Pack::Type* u, const float* params, Pack::Type* c) {
+
+        const Pack::Type one = Pack::set(1.0f);
+
+        Pack::Type z = Pack::sub(one, Pack::add(u[0], u[0]));
+        Pack::Type ring = Pack::sqrt(
+            Pack::max(Pack::sub(one, Pack::mul(z, z)), Pack::zero()));
+        Pack::Type s;
+        Pack::Type cs;
+        sincos<util::math::TRIG_PRECISE>(uniformAngle(u[1]), s, cs);
+
+        Pack::Type radius = Pack::set(params[3]);
+        if (FILLED) {
+
+            radius = Pack::mul(
+                radius, Pack::max(u[2], Pack::max(u[3], u[4])));
+        }
+        Pack::Type across = Pack::mul(ring, radius);
+        c[0] = Pack::fmadd(cs, across, Pack::set(params[0]));
+        c[1] = Pack::fmadd(s, across, Pack::set(params[1]));
+        c[2] = Pack::fmadd(z, radius, Pack::set(params[2]));
+    }
+};
+
+/**Normally distributed with params mean[N] and the standard deviation, using
+the Box-Muller transform to make each pair of components*/
+template<unsigned N>
+struct GaussianSampler {
+
+    static const unsigned COMPONENTS = N;
+    static const unsigned UNIFORMS = (N + 1) / 2 * 2;
+
+    static inline void sample(
+            const Pack::Type* u, const float* params, Pack::Type* c) {
+
+        const Pack::Type one = Pack::set(1.0f);
+        const Pack::Type deviation = Pack::set(params[N]);
+
+        for (unsigned k = 0; k < N; k += 2) {
+
+            //1 - u is in (0, 1] so the logarithm is finite
+            Pack::Type radius = Pack::mul(deviation, Pack::sqrt(Pack::mul(
+                Pack::set(-2.0f), logUnit(Pack::sub(one, u[k])))));
+            Pack::Type s;
+            Pack::Type cs;
+            sincos<util::math::TRIG_PRECISE>(uniformAngle(u[k + 1]), s, cs);
+
+            c[k] = Pack::fmadd(cs, radius, Pack::set(params[k]));
+            if (k + 1 < N) {
+
+                c[k + 1] = Pack::fmadd(s, radius, Pack::set(params[k + 1]));
+            }
+        }
+    }
+};
+
+/**Fills n vectors of one chunk of a bulk fill from a sampler. Vector i of the
+chunk is drawn by generator i % RANDOM_LANES of the chunk, and the generators
+are the streams chunk * RANDOM_LANES onwards of the seed, so each vector
+depends only on the seed and its index in the whole array*/
+template<typename Sampler>
+inline void sampleChunk(
+        std::uint64_t seed,
+        std::size_t chunk,
+        const float* params,
+        float* out,
+        std::size_t n) {
+
+    const unsigned N = Sampler::COMPONENTS;
+    const unsigned U = Sampler::UNIFORMS;
+
+    std::uint32_t state[4][RANDOM_LANES];
+    for (unsigned j = 0; j < RANDOM_LANES; ++j) {
+
+        std::uint32_t lane[4];
+        util::random::detail::seedState(seed,
+            static_cast<std::uint64_t>(chunk) * RANDOM_LANES + j, lane);
+        for (unsigned k = 0; k < 4; ++k) {
+
+            state[k][j] = lane[k];
+        }
+    }
+
+    float u[U][RANDOM_LANES];
+    float block[N * RANDOM_LANES];
+    for (std::size_t i = 0; i < n; i += RANDOM_LANES) {
+
+        for (unsigned k = 0; k < U; ++k) {
+
+            uniformBlock(state, u[k]);
+        }
+
+        //whole blocks are written in place and the last is copied out
+        std::size_t count = n - i < RANDOM_LANES ? n - i : RANDOM_LANES;
+        float* target = count == RANDOM_LANES ? out + i * N : block;
+        for (unsigned j = 0; j < RANDOM_LANES; j += Pack::WIDTH) {
+
+            Pack::Type pu[U];
+            for (unsigned k = 0; k < U; ++k) {
+
+                pu[k] = Pack::load(u[k] + j);
+            }
+            Pack::Type c[N];
+            Sampler::sample(pu, params, c);
+            Pack::storeInterleaved<N>(target + j * N, c);
+        }
+        if (target == block) {
+
+            std::copy(block, block + count * N, out + i * N);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**Fills a chunk with N component vectors uniform in a box*/
+template<unsigned N>
+inline void randomBox(
+        std::uint64_t seed,
+        std::size_t chunk,
+        const float* params,
+        float* out,
+        std::size_t n) {
+
+    sampleChunk<BoxSampler<N> >(seed, chunk, params, out, n);
+}
+
+/**Fills a chunk with 2d vectors uniform on or in a circle*/
+template<bool FILLED>
+inline void randomCircle(
+        std::uint64_t seed,
+        std::size_t chunk,
+        const float* params,
+        float* out,
+        std::size_t n) {
+
+    sampleChunk<CircleSampler<FILLED> >(seed, chunk, params, out, n);
+}
+
+/**Fills a chunk with 3d vectors uniform on or in a sphere*/
+template<bool FILLED>
+inline void randomSphere(
+        std::uint64_t seed,
+        std::size_t chunk,
+        const float* params,
+        float* out,
+        std::size_t n) {
+
+    sampleChunk<SphereSampler<FILLED> >(seed, chunk, params, out, n);
+}
+
+/**Fills a chunk with normally distributed N component vectors*/
+template<unsigned N>
+inline void randomGaussian(
+        std::uint64_t seed,
+        std::size_t chunk,
+        const float* params,
+        float* out,
+        std::size_t n) {
+
+    sampleChunk<GaussianSampler<N> >(seed, chunk, params, out, n);
+}
@@ -0,0 +1,300 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+//------------------------------------------------------------------------------
+//                                 PACK EVALUATORS
+//------------------------------------------------------------------------------
+// Each evaluator intersects WIDTH rays, given as the components of their
+// origins o and directions d, with one shape laid out by its RayTarget. They
+// return the distance along each ray to where it first meets the shape, or
+// +infinity where it misses, and return early once every ray has missed.
+
+/**Intersects WIDTH rays with one kind of shape*/
+template<unsigned KIND>
+struct RayHit;
+
+template<>
+struct RayHit<RAY_SPHERE> {
+
+    /**@param s the centre and radius of the sphere*/
+    static inline Pack::Type distance(
+            const Pack::Type* o, const Pack::Type* d, const float* s) {
+
+        const Pack::Type zero = Pack::zero();
+        const Pack::Type miss =
+            Pack::set(std::numeric_limits<float>::infinity());
+
+        Pack::Type oc[3];
+        for (unsigned c = 0; c < 3; ++c) {
+
+            oc[c] = Pack::sub(o[c], Pack::set(s[c]));
+        }
+
+        //solve |o + td - centre|^2 = r^2 for t
+        Pack::Type a = Pack::fmadd(d[0], d[0],
+            Pack::fmadd(d[1], d[1], Pack::mul(d[2], d[2])));
+        Pack::Type b = Pack::fmadd(oc[0], d[0],
+            Pack::fmadd(oc[1], d[1], Pack::mul(oc[2], d[2])));
+        Pack::Type c = Pack::sub(Pack::fmadd(oc[0], oc[0],
+            Pack::fmadd(oc[1], oc[1], Pack::mul(oc[2], oc[2]))),
+            Pack::set(s[3] * s[3]));
+        Pack::Type discriminant = Pack::sub(Pack::mul(b, b), Pack::mul(a, c));
+        if (Pack::maskBits(Pack::cmpLe(zero, discriminant)) == 0) {
+
+            return miss;
+        }
+
+        Pack::Type root = Pack::sqrt(discriminant);
+        Pack::Type nearT = Pack::div(Pack::sub(Pack::sub(zero, b), root), a);
+        Pack::Type farT = Pack::div(Pack::sub(root, b), a);
+
+        //a ray that starts inside the sphere hits it at 0
+        return Pack::select(
+            Pack::cmpLe(zero, farT), Pack::max(nearT, zero), miss);
+    }
+};
+
+template<>
+struct RayHit<RAY_BOX> {
+
+    /**@param s the lower then the upper corner of the box*/
+    static inline Pack::Type distance(
+            const Pack::Type* o, const Pack::Type* d, const float* s) {
+
+        const Pack::Type one = Pack::set(1.0f);
+        const Pack::Type miss =
+            Pack::set(std::numeric_limits<float>::infinity());
+
+        //clip the ray against each pair of slabs in turn, a ray that starts
+        //inside the box hits it at 0
+        Pack::Type enter = Pack::zero();
+        Pack::Type exit = miss;
+        for (unsigned c = 0; c < 3; ++c) {
+
+            Pack::Type inverse = Pack::div(one, d[c]);
+            Pack::Type t0 =
+                Pack::mul(Pack::sub(Pack::set(s[c]), o[c]), inverse);
+            Pack::Type t1 =
+                Pack::mul(Pack::sub(Pack::set(s[3 + c]), o[c]), inverse);
+            //a ray lying in one of the slab's planes gives 0 * infinity = NaN,
+            //it never leaves the slab so the slab is skipped, the same way as
+            //the scalar reference on every instruction set
+            Pack::Mask inSlab = Pack::maskAnd(
+                Pack::cmpLe(t0, t0), Pack::cmpLe(t1, t1));
+            enter = Pack::select(
+                inSlab, Pack::max(enter, Pack::min(t0, t1)), enter);
+            exit = Pack::select(
+                inSlab, Pack::min(exit, Pack::max(t0, t1)), exit);
+            if (c < 2 && Pack::maskBits(Pack::cmpLe(enter, exit)) == 0) {
+
+                return miss;
+            }
+        }
+
+        return Pack::select(Pack::cmpLe(enter, exit), enter, miss);
+    }
+};
+
+template<>
+struct RayHit<RAY_TRIANGLE> {
+
+    /**@param s the first corner of the triangle then the edges from it to
+    the second and third corners*/
+    static inline Pack::Type distance(
+            const Pack::Type* o, const Pack::Type* d, const float* s) {
+
+        const Pack::Type zero = Pack::zero();
+        const Pack::Type one = Pack::set(1.0f);
+        const Pack::Type miss =
+            Pack::set(std::numeric_limits<float>::infinity());
+
+        Pack::Type e1[3];
+        Pack::Type e2[3];
+        Pack::Type offset[3];
+        for (unsigned c = 0; c < 3; ++c) {
+
+            e1[c] = Pack::set(s[3 + c]);
+            e2[c] = Pack::set(s[6 + c]);
+            offset[c] = Pack::sub(o[c], Pack::set(s[c]));
+        }
+
+        //Moller-Trumbore: solve for the barycentric coordinates u and v of
+        //the hit, rays parallel to the triangle give an infinite or NaN u
+        Pack::Type p[3];
+        crossPack(d, e2, p);
+        Pack::Type inverse = Pack::div(one, dotPack(e1, p));
+        Pack::Type u = Pack::mul(dotPack(offset, p), inverse);
+        Pack::Mask hit = Pack::maskAnd(
+            Pack::cmpLe(zero, u), Pack::cmpLe(u, one));
+        if (Pack::maskBits(hit) == 0) {
+
+            return miss;
+        }
+
+        Pack::Type q[3];
+        crossPack(offset, e1, q);
+        Pack::Type v = Pack::mul(dotPack(d, q), inverse);
+        Pack::Type t = Pack::mul(dotPack(e2, q), inverse);
+        hit = Pack::maskAnd(hit, Pack::maskAnd(Pack::cmpLe(zero, v),
+            Pack::maskAnd(Pack::cmpLe(Pack::add(u, v), one),
+                Pack::cmpLe(zero, t))));
+
+        return Pack::select(hit, t, miss);
+    }
+
+    /**@return the dot products of WIDTH pairs of 3d vectors*/
+    static inline Pack::Type dotPack(const Pack::Type* a, const Pack::Type* b) {
+
+        return Pack::fmadd(a[0], b[0],
+            Pack::fmadd(a[1], b[1], Pack::mul(a[2], b[2])));
+    }
+
+    /**Computes the cross products of WIDTH pairs of 3d vectors*/
+    static inline void crossPack(
+            const Pack::Type* a, const Pack::Type* b, Pack::Type* out) {
+
+        out[0] = Pack::sub(Pack::mul(a[1], b[2]), Pack::mul(a[2], b[1]));
+        out[1] = Pack::sub(Pack::mul(a[2], b[0]), Pack::mul(a[0], b[2]));
+        out[2] = Pack::sub(Pack::mul(a[0], b[1]), Pack::mul(a[1], b[0]));
+    }
+};
+
+template<>
+struct RayHit<RAY_PLANE> {
+
+    /**@param s the normal of the plane then its distance from the origin*/
+    static inline Pack::Type distance(
+            const Pack::Type* o, const Pack::Type* d, const float* s) {
+
+        const Pack::Type miss =
+            Pack::set(std::numeric_limits<float>::infinity());
+
+        Pack::Type n[3] = { Pack::set(s[0]), Pack::set(s[1]), Pack::set(s[2]) };
+        Pack::Type along = Pack::fmadd(n[0], d[0],
+            Pack::fmadd(n[1], d[1], Pack::mul(n[2], d[2])));
+        Pack::Type height = Pack::sub(Pack::set(s[3]), Pack::fmadd(n[0], o[0],
+            Pack::fmadd(n[1], o[1], Pack::mul(n[2], o[2]))));
+
+        //rays parallel to the plane give an infinite or NaN distance
+        Pack::Type t = Pack::div(height, along);
+
+        return Pack::select(Pack::cmpLe(Pack::zero(), t), t, miss);
+    }
+};
+
+//------------------------------------------------------------------------------
+//                                    KERNELS
+//------------------------------------------------------------------------------
+
+/**Shortens the distances of the active rays of a packet to their hits with a
+shape. The packet holds each component of the origins then of the directions
+as a row of width floats
+@return the bits of the rays whose distance was shortened*/
+template<unsigned KIND>
+inline unsigned intersectPacket(
+        const float* rays,
+        unsigned width,
+        unsigned active,
+        const float* shape,
+        float* distances) {
+
+    const unsigned full = (1u << Pack::WIDTH) - 1;
+
+    unsigned hits = 0;
+    for (unsigned i = 0; i < width; i += Pack::WIDTH) {
+
+        //skip the rays that are all inactive without touching them
+        unsigned lanes = width - i < Pack::WIDTH ? width - i : Pack::WIDTH;
+        unsigned live = (active >> i) & ((1u << lanes) - 1);
+        if (live == 0) {
+
+            continue;
+        }
+
+        Pack::Type c[6];
+        Pack::Type limit;
+        if (lanes == Pack::WIDTH) {
+
+            for (unsigned k = 0; k < 6; ++k) {
+
+                c[k] = Pack::load(rays + k * width + i);
+            }
+            limit = Pack::load(distances + i);
+        }
+        else {
+
+            //packets narrower than the pack are padded with inactive rays
+            float padded[Pack::WIDTH] = {};
+            for (unsigned k = 0; k < 6; ++k) {
+
+                std::copy(rays + k * width + i, rays + k * width + i + lanes,
+                    padded);
+                c[k] = Pack::load(padded);
+            }
+            std::copy(distances + i, distances + i + lanes, padded);
+            limit = Pack::load(padded);
+        }
+
+        Pack::Type t = RayHit<KIND>::distance(c, c + 3, shape);
+        Pack::Mask closer = Pack::cmpLt(t, limit);
+        unsigned shortened = Pack::maskBits(closer) & live;
+        if (shortened == 0) {
+
+            continue;
+        }
+
+        if (live == full) {
+
+            Pack::store(distances + i, Pack::select(closer, t, limit));
+        }
+        else {
+
+            float found[Pack::WIDTH];
+            Pack::store(found, t);
+            for (unsigned j = 0; j < lanes; ++j) {
+
+                if ((shortened >> j) & 1u) {
+
+                    distances[i + j] = found[j];
+                }
+            }
+        }
+        hits |= shortened << i;
+    }
+
+    return hits;
+}
+
+/**Shortens the distances of n rays, stored as an interleaved origin and
+direction each, to their hits with a shape*/
+template<unsigned KIND>
+inline void intersectRays(
+        const float* rays,
+        std::size_t n,
+        const float* shape,
+        float* distances) {
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type c[6];
+        Pack::loadInterleaved<6>(rays + i * 6, c);
+        Pack::Type t = RayHit<KIND>::distance(c, c + 3, shape);
+        Pack::Type limit = Pack::load(distances + i);
+        Pack::store(distances + i,
+            Pack::select(Pack::cmpLt(t, limit), t, limit));
+    }
+    if (i < n) {
+
+        float pr[6 * Pack::WIDTH] = {};
+        float pd[Pack::WIDTH] = {};
+        std::copy(rays + i * 6, rays + n * 6, pr);
+        std::copy(distances + i, distances + n, pd);
+
+        Pack::Type c[6];
+        Pack::loadInterleaved<6>(pr, c);
+        Pack::Type t = RayHit<KIND>::distance(c, c + 3, shape);
+        Pack::Type limit = Pack::load(pd);
+        Pack::store(pd, Pack::select(Pack::cmpLt(t, limit), t, limit));
+        std::copy(pd, pd + (n - i), distances + i);
+    }
+}
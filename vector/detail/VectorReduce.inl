@@ -0,0 +1,188 @@
+//no include guard: compiled once per instruction set by SimdForEachIsa.hpp
+
+/**A running sum held per lane with Kahan compensation*/
+struct CompensatedPack {
+
+    //the running sum of each lane
+    Pack::Type sum;
+    //the low order bits lost from the sum of each lane
+    Pack::Type error;
+};
+
+/**@return an empty compensated sum*/
+inline CompensatedPack compensatedZero() {
+
+    CompensatedPack a;
+    a.sum = Pack::zero();
+    a.error = Pack::zero();
+
+    return a;
+}
+
+/**Adds the lanes of x to a compensated sum*/
+inline void compensatedAdd(CompensatedPack& a, Pack::Type x) {
+
+    Pack::Type y = Pack::sub(x, a.error);
+    Pack::Type t = Pack::add(a.sum, y);
+    a.error = Pack::sub(Pack::sub(t, a.sum), y);
+    a.sum = t;
+}
+
+/**@return the sum of the lanes of a compensated sum*/
+inline double compensatedTotal(const CompensatedPack& a) {
+
+    float sum[Pack::WIDTH];
+    float error[Pack::WIDTH];
+    Pack::store(sum, a.sum);
+    Pack::store(error, a.error);
+
+    double total = 0.0;
+    for (unsigned j = 0; j < Pack::WIDTH; ++j) {
+
+        total += static_cast<double>(sum[j]) - static_cast<double>(error[j]);
+    }
+
+    return total;
+}
+
+/**Sums the components of n interleaved N component vectors*/
+template<unsigned N>
+inline void compensatedSum(const float* v, std::size_t n, double* out) {
+
+    CompensatedPack acc[N];
+    for (unsigned c = 0; c < N; ++c) {
+
+        acc[c] = compensatedZero();
+    }
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type x[N];
+        Pack::loadInterleaved<N>(v + i * N, x);
+        for (unsigned c = 0; c < N; ++c) {
+
+            compensatedAdd(acc[c], x[c]);
+        }
+    }
+
+    for (unsigned c = 0; c < N; ++c) {
+
+        out[c] = compensatedTotal(acc[c]);
+    }
+    for (; i < n; ++i) {
+
+        for (unsigned c = 0; c < N; ++c) {
+
+            out[c] += v[i * N + c];
+        }
+    }
+}
+
+/**Sums the squared deviations of the components of n interleaved N component
+vectors from the given mean*/
+template<unsigned N>
+inline void squaredDeviations(
+        const float* v, std::size_t n, const float* mean, double* out) {
+
+    Pack::Type m[N];
+    CompensatedPack acc[N];
+    for (unsigned c = 0; c < N; ++c) {
+
+        m[c] = Pack::set(mean[c]);
+        acc[c] = compensatedZero();
+    }
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type x[N];
+        Pack::loadInterleaved<N>(v + i * N, x);
+        for (unsigned c = 0; c < N; ++c) {
+
+            Pack::Type d = Pack::sub(x[c], m[c]);
+            compensatedAdd(acc[c], Pack::mul(d, d));
+        }
+    }
+
+    for (unsigned c = 0; c < N; ++c) {
+
+        out[c] = compensatedTotal(acc[c]);
+    }
+    for (; i < n; ++i) {
+
+        for (unsigned c = 0; c < N; ++c) {
+
+            float d = v[i * N + c] - mean[c];
+            out[c] += d * d;
+        }
+    }
+}
+
+/**Sums the products of the deviations of each pair of components of n
+interleaved N component vectors from the given mean, into a row-major N by N
+matrix*/
+template<unsigned N>
+inline void deviationProducts(
+        const float* v, std::size_t n, const float* mean, double* out) {
+
+    //only the upper triangle is accumulated, the matrix is symmetric
+    Pack::Type m[N];
+    CompensatedPack acc[N * N];
+    for (unsigned r = 0; r < N; ++r) {
+
+        m[r] = Pack::set(mean[r]);
+        for (unsigned c = r; c < N; ++c) {
+
+            acc[r * N + c] = compensatedZero();
+        }
+    }
+
+    std::size_t i = 0;
+    for (; i + Pack::WIDTH <= n; i += Pack::WIDTH) {
+
+        Pack::Type d[N];
+        Pack::loadInterleaved<N>(v + i * N, d);
+        for (unsigned r = 0; r < N; ++r) {
+
+            d[r] = Pack::sub(d[r], m[r]);
+        }
+        for (unsigned r = 0; r < N; ++r) {
+
+            for (unsigned c = r; c < N; ++c) {
+
+                compensatedAdd(acc[r * N + c], Pack::mul(d[r], d[c]));
+            }
+        }
+    }
+
+    for (unsigned r = 0; r < N; ++r) {
+
+        for (unsigned c = r; c < N; ++c) {
+
+            out[r * N + c] = compensatedTotal(acc[r * N + c]);
+        }
+    }
+    for (; i < n; ++i) {
+
+        float d[N];
+        for (unsigned r = 0; r < N; ++r) {
+
+            d[r] = v[i * N + r] - mean[r];
+        }
+        for (unsigned r = 0; r < N; ++r) {
+
+            for (unsigned c = r; c < N; ++c) {
+
+                out[r * N + c] += d[r] * d[c];
+            }
+        }
+    }
+    for (unsigned r = 1; r < N; ++r) {
+
+        for (unsigned c = 0; c < r; ++c) {
+
+            out[r * N + c] = out[c * N + r];
+        }
+    }
+}